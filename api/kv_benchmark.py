@@ -0,0 +1,64 @@
+#
+ # Licensed to the Apache Software Foundation (ASF) under one
+ # or more contributor license agreements.  See the NOTICE file
+ # distributed with this work for additional information
+ # regarding copyright ownership.  The ASF licenses this file
+ # to you under the Apache License, Version 2.0 (the
+ # "License"); you may not use this file except in compliance
+ # with the License.  You may obtain a copy of the License at
+ #
+ #   http://www.apache.org/licenses/LICENSE-2.0
+ #
+ # Unless required by applicable law or agreed to in writing,
+ # software distributed under the License is distributed on an
+ # "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ # KIND, either express or implied.  See the License for the
+ # specific language governing permissions and limitations
+ # under the License.
+ #
+
+
+"""
+Compare the ops/sec of the module functions, which load the config and build a new client for each call, with the
+long-lived Client.
+
+Usage: python3 kv_benchmark.py [config_path] [op_num]
+"""
+
+import asyncio
+import sys
+import time
+
+from kv_operation import Client, current_dir, get_value, set_value
+
+
+def run(name: str, op_num: int, func) -> None:
+    start = time.time()
+    func()
+    run_time = time.time() - start
+    print("%s: %d ops %.0f ops/s" % (name, op_num, op_num / run_time))
+
+
+def main() -> None:
+    config_path = sys.argv[1] if len(sys.argv) > 1 else current_dir + "/ip_address.config"
+    op_num = int(sys.argv[2]) if len(sys.argv) > 2 else 1000
+    keys = ["key%d" % i for i in range(op_num)]
+    # The module functions pay the setup for every op, keep their run short.
+    sync_keys = keys[:max(1, op_num // 10)]
+
+    run("module set_value", len(sync_keys), lambda: [set_value(key, "value", config_path) for key in sync_keys])
+    run("module get_value", len(sync_keys), lambda: [get_value(key, config_path) for key in sync_keys])
+
+    client = Client(config_path)
+    run("Client.set", len(sync_keys), lambda: [client.set(key, "value") for key in sync_keys])
+    run("Client.set_many", op_num, lambda: client.set_many({key: "value" for key in keys}))
+    run("Client.get_many", op_num, lambda: client.get_many(keys))
+
+    async def get_all():
+        await asyncio.gather(*[client.get_async(key) for key in keys])
+
+    run("Client.get_async", op_num, lambda: asyncio.run(get_all()))
+
+
+if __name__ == "__main__":
+    main()
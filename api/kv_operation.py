@@ -17,6 +17,7 @@
  # under the License.
  #
 
+import asyncio
 import os
 import sys
 current_file_path = os.path.abspath(__file__)
@@ -44,3 +45,67 @@ def get_value(key: str or int or float, config_path: str = current_dir + "/ip_ad
     :return: A string of the key's corresponding value.
     """
     return pybind_kv.get(str(key), os.path.abspath(config_path))
+
+
+class Client:
+    """
+    A long-lived client. The config is loaded once and requests from all the calls share connections and batches.
+    """
+
+    def __init__(self, config_path: str = current_dir + "/ip_address.config", max_inflight: int = 16,
+                 max_batch_size: int = 64):
+        """
+        :param config_path: Default is connect to the main chain, users can specify the path to connect to their local blockchain.
+        :param max_inflight: The number of batches sent at the same time.
+        :param max_batch_size: The max number of operations in a batch.
+        """
+        self._client = pybind_kv.Client(os.path.abspath(config_path), max_inflight, max_batch_size)
+
+    def get(self, key: str or int or float) -> str:
+        return self._client.get(str(key))
+
+    def set(self, key: str or int or float, value: str or int or float) -> bool:
+        return self._client.set(str(key), str(value))
+
+    def get_many(self, keys: list) -> list:
+        """
+        :return: The values of the keys, in the same order.
+        """
+        return self._client.get_many([str(key) for key in keys])
+
+    def set_many(self, items: dict) -> list:
+        """
+        :return: True for each key-value pair that has been set successfully.
+        """
+        return self._client.set_many([(str(key), str(value)) for key, value in items.items()])
+
+    async def get_async(self, key: str or int or float) -> str:
+        """
+        :return: The value of the key, or None if the request failed.
+        """
+        return await self._wait(self._client.get_async, str(key))
+
+    async def set_async(self, key: str or int or float, value: str or int or float) -> bool:
+        """
+        :return: True if value has been set successfully, or None if the request failed.
+        """
+        return await self._wait(self._client.set_async, str(key), str(value))
+
+    @staticmethod
+    def _wait(func, *args) -> asyncio.Future:
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+
+        def set_result(result):
+            if not future.done():
+                future.set_result(result)
+
+        def done(result):
+            # The loop may have been closed while the request was in flight.
+            try:
+                loop.call_soon_threadsafe(set_result, result)
+            except RuntimeError:
+                pass
+
+        func(*args, done)
+        return future
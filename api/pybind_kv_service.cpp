@@ -19,7 +19,10 @@
 
 #include <fcntl.h>
 #include <getopt.h>
+#include <glog/logging.h>
+#include <pybind11/functional.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -27,12 +30,18 @@
 #include <fstream>
 
 #include "common/proto/signature_info.pb.h"
+#include "interface/kv/async_kv_client.h"
 #include "interface/kv/kv_client.h"
 #include "platform/config/resdb_config_utils.h"
 
+namespace py = pybind11;
+
+using resdb::AsyncKVClient;
 using resdb::GenerateReplicaInfo;
 using resdb::GenerateResDBConfig;
 using resdb::KVClient;
+using resdb::KVRequest;
+using resdb::KVResponse;
 using resdb::ReplicaInfo;
 using resdb::ResDBConfig;
 
@@ -60,7 +69,132 @@ bool set(std::string key, std::string value, std::string config_path) {
   }
 }
 
+// A long-lived client. The config and the keys are loaded once and the
+// requests are sent through AsyncKVClient, so calls from several Python
+// threads and the *_many calls share batches. The GIL is released while
+// waiting for the network.
+class Client {
+ public:
+  Client(const std::string& config_path, int max_inflight, int max_batch_size)
+      : config_(GenerateResDBConfig(config_path)) {
+    config_.SetClientTimeoutMs(100000);
+    client_ = std::make_unique<AsyncKVClient>(config_, max_inflight,
+                                              max_batch_size);
+  }
+
+  ~Client() {
+    // The client threads may be waiting for the GIL to run a callback.
+    py::gil_scoped_release release;
+    client_.reset();
+  }
+
+  std::string Get(const std::string& key) {
+    py::gil_scoped_release release;
+    auto result_ptr = client_->Get(key).get();
+    return result_ptr ? *result_ptr : "";
+  }
+
+  bool Set(const std::string& key, const std::string& value) {
+    py::gil_scoped_release release;
+    return client_->Set(key, value).get() == 0;
+  }
+
+  std::vector<std::string> GetMany(const std::vector<std::string>& keys) {
+    py::gil_scoped_release release;
+    std::vector<std::future<std::unique_ptr<std::string>>> results;
+    for (const std::string& key : keys) {
+      results.push_back(client_->Get(key));
+    }
+    std::vector<std::string> values;
+    for (auto& result : results) {
+      auto result_ptr = result.get();
+      values.push_back(result_ptr ? *result_ptr : "");
+    }
+    return values;
+  }
+
+  std::vector<bool> SetMany(
+      const std::vector<std::pair<std::string, std::string>>& items) {
+    py::gil_scoped_release release;
+    std::vector<std::future<int>> results;
+    for (const auto& item : items) {
+      results.push_back(client_->Set(item.first, item.second));
+    }
+    std::vector<bool> rets;
+    for (auto& result : results) {
+      rets.push_back(result.get() == 0);
+    }
+    return rets;
+  }
+
+  // callback(value) is called from a client thread once the response
+  // arrives; value is None if the request failed.
+  void GetAsync(const std::string& key, py::function callback) {
+    KVRequest request;
+    request.set_cmd(KVRequest::GET);
+    request.set_key(key);
+    SendAsync(request, callback, [](const KVResponse& response) {
+      return py::cast(response.value());
+    });
+  }
+
+  // callback(ok) is called from a client thread once the response arrives.
+  void SetAsync(const std::string& key, const std::string& value,
+                py::function callback) {
+    KVRequest request;
+    request.set_cmd(KVRequest::SET);
+    request.set_key(key);
+    request.set_value(value);
+    SendAsync(request, callback,
+              [](const KVResponse& response) { return py::cast(true); });
+  }
+
+ private:
+  void SendAsync(const KVRequest& request, py::function callback,
+                 std::function<py::object(const KVResponse&)> to_object) {
+    // The Python callback must only be touched with the GIL held, including
+    // when it is released.
+    auto func = std::shared_ptr<py::function>(
+        new py::function(std::move(callback)), [](py::function* f) {
+          py::gil_scoped_acquire acquire;
+          delete f;
+        });
+    client_->Send(request, [func, to_object](
+                               std::unique_ptr<KVResponse> response) {
+      py::gil_scoped_acquire acquire;
+      try {
+        if (response == nullptr) {
+          (*func)(py::none());
+        } else {
+          (*func)(to_object(*response));
+        }
+      } catch (py::error_already_set& e) {
+        // There is no Python frame to raise into on a client thread; report
+        // it the way Python reports errors from finalizers.
+        e.restore();
+        PyErr_WriteUnraisable(func->ptr());
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "python callback fail:" << e.what();
+      }
+    });
+  }
+
+ private:
+  ResDBConfig config_;
+  std::unique_ptr<AsyncKVClient> client_;
+};
+
 PYBIND11_MODULE(pybind_kv, m) {
   m.def("get", &get, "A function that gets a value from the key-value store");
   m.def("set", &set, "A function that sets a value in the key-value store");
+
+  py::class_<Client>(m, "Client")
+      .def(py::init<const std::string&, int, int>(), py::arg("config_path"),
+           py::arg("max_inflight") = 16, py::arg("max_batch_size") = 64)
+      .def("get", &Client::Get)
+      .def("set", &Client::Set)
+      .def("get_many", &Client::GetMany)
+      .def("set_many", &Client::SetMany)
+      .def("get_async", &Client::GetAsync)
+      .def("set_async", &Client::SetAsync);
 }
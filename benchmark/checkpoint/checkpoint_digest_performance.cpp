@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/crypto/hash.h"
+#include "common/utils/utils.h"
+#include "platform/consensus/checkpoint/checkpoint_digest.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[window_size] [window_num] [thread_num]\n"); }
+
+std::vector<std::string> GetHashes(int window_size) {
+  std::vector<std::string> hashes(window_size);
+  for (int i = 0; i < window_size; ++i) {
+    hashes[i] = utils::CalculateSHA256Hash("request_" + std::to_string(i));
+  }
+  return hashes;
+}
+
+void Print(const std::string& name, int window_size, int window_num,
+           uint64_t run_time) {
+  printf("%s window:%d windows:%d time:%.3fms per window:%.3fms %.2fM req/s\n",
+         name.c_str(), window_size, window_num, run_time / 1e3,
+         run_time / 1e3 / window_num,
+         1.0 * window_size * window_num / run_time);
+}
+
+// The digest chained one request at a time as the checkpoint manager used
+// to do: SHA256(last digest + request hash).
+void RunChain(const std::vector<std::string>& hashes, int window_num) {
+  std::string digest;
+  uint64_t start_time = GetCurrentTime();
+  for (int i = 0; i < window_num; ++i) {
+    for (const std::string& hash : hashes) {
+      digest = utils::CalculateSHA256Hash(digest + hash);
+    }
+  }
+  Print("chain", hashes.size(), window_num, GetCurrentTime() - start_time);
+}
+
+void RunTree(const std::vector<std::string>& hashes, int window_num,
+             int thread_num) {
+  CheckPointDigest checkpoint_digest(thread_num);
+  std::string digest;
+  uint64_t start_time = GetCurrentTime();
+  for (int i = 0; i < window_num; ++i) {
+    digest = checkpoint_digest.GetDigest(digest, hashes);
+  }
+  Print("tree threads:" + std::to_string(thread_num), hashes.size(),
+        window_num, GetCurrentTime() - start_time);
+}
+
+int main(int argc, char** argv) {
+  int window_size = argc > 1 ? atoi(argv[1]) : 10000;
+  int window_num = argc > 2 ? atoi(argv[2]) : 100;
+  int thread_num = argc > 3 ? atoi(argv[3]) : 4;
+  if (window_size <= 0 || window_num <= 0 || thread_num < 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  std::vector<std::string> hashes = GetHashes(window_size);
+  RunChain(hashes, window_num);
+  RunTree(hashes, window_num, 0);
+  RunTree(hashes, window_num, thread_num);
+  return 0;
+}
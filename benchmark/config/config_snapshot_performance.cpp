@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/utils/utils.h"
+#include "platform/config/resdb_config.h"
+
+using resdb::CertificateInfo;
+using resdb::GetCurrentTime;
+using resdb::KeyInfo;
+using resdb::RegionInfo;
+using resdb::ReplicaInfo;
+using resdb::ResConfigData;
+using resdb::ResDBConfig;
+
+// Compare the per-message cost of reading enable_viewchange through a copy of
+// ResConfigData with reading it from the config snapshot.
+int main(int argc, char** argv) {
+  int region_num = argc > 1 ? atoi(argv[1]) : 3;
+  int replica_num = argc > 2 ? atoi(argv[2]) : 16;
+  int round = argc > 3 ? atoi(argv[3]) : 1000000;
+
+  ResConfigData config_data;
+  config_data.set_enable_viewchange(true);
+  for (int i = 0; i < region_num; ++i) {
+    RegionInfo* region = config_data.add_region();
+    region->set_region_id(i + 1);
+    for (int j = 0; j < replica_num; ++j) {
+      ReplicaInfo* replica = region->add_replica_info();
+      replica->set_id(i * replica_num + j + 1);
+      replica->set_ip("127.0.0.1");
+      replica->set_port(10000 + j);
+      // Roughly the size of a certificate with its admin signature.
+      replica->mutable_certificate_info()
+          ->mutable_public_key()
+          ->mutable_public_key_info()
+          ->mutable_key()
+          ->set_key(std::string(512, 'k'));
+      replica->mutable_certificate_info()
+          ->mutable_public_key()
+          ->mutable_certificate()
+          ->set_signature(std::string(512, 's'));
+    }
+  }
+  ResDBConfig config(config_data, ReplicaInfo(), KeyInfo(), CertificateInfo());
+
+  int enabled = 0;
+  uint64_t start = GetCurrentTime();
+  for (int i = 0; i < round; ++i) {
+    enabled += config.GetConfigData().enable_viewchange();
+  }
+  uint64_t copy_time = GetCurrentTime() - start;
+
+  start = GetCurrentTime();
+  for (int i = 0; i < round; ++i) {
+    enabled += config.IsViewChangeEnabled();
+  }
+  uint64_t snapshot_time = GetCurrentTime() - start;
+
+  printf("config size:%zu bytes, %d reads\n", config_data.ByteSizeLong(),
+         enabled);
+  printf("GetConfigData: %.1f ns/msg\n", copy_time * 1000.0 / round);
+  printf("snapshot: %.1f ns/msg\n", snapshot_time * 1000.0 / round);
+}
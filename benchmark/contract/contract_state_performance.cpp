@@ -0,0 +1,150 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include "benchmark/contract/storage_counter.h"
+#include "common/utils/utils.h"
+#include "eEVM/util.h"
+#include "executor/contract/manager/address_manager.h"
+#include "executor/contract/manager/global_view.h"
+
+using namespace resdb;
+using namespace resdb::contract;
+
+void ShowUsage() { printf("[account_num] [transfer_num]\n"); }
+
+// The slot of the balance mapping in the ERC-20 contract.
+const uint256_t kBalanceSlot = 0;
+
+// The storage of a contract as it was kept before ContractState: the slot and
+// the value as hex strings, without the contract address, each store written
+// on its own and remove left as a no-op.
+class HexView : public eevm::Storage {
+ public:
+  HexView(resdb::Storage* storage) : storage_(storage) {}
+
+  void store(const uint256_t& key, const uint256_t& value) override {
+    storage_->SetValue(eevm::to_hex_string(key), eevm::to_hex_string(value));
+  }
+  uint256_t load(const uint256_t& key) override {
+    return eevm::to_uint256(storage_->GetValue(eevm::to_hex_string(key)));
+  }
+  bool remove(const uint256_t& key) override { return true; }
+
+ private:
+  resdb::Storage* storage_;
+};
+
+// The slot holding the balance of account: keccak256(account . slot).
+uint256_t GetBalanceSlot(const Address& account) {
+  uint8_t data[64];
+  eevm::to_big_endian(account, data);
+  eevm::to_big_endian(kBalanceSlot, data + 32);
+  uint8_t h[32];
+  eevm::keccak_256(data, sizeof(data), h);
+  return eevm::from_big_endian(h, sizeof(h));
+}
+
+// The storage accesses of transfer(to, amount): load both balances and store
+// them back. The EVM removes a slot set to zero instead of storing it.
+bool Transfer(eevm::Storage* st, const uint256_t& from, const uint256_t& to,
+              const uint256_t& amount) {
+  uint256_t from_balance = st->load(from);
+  if (from_balance < amount) {
+    return false;
+  }
+  uint256_t to_balance = st->load(to);
+  if (from_balance == amount) {
+    st->remove(from);
+  } else {
+    st->store(from, from_balance - amount);
+  }
+  st->store(to, to_balance + amount);
+  return true;
+}
+
+// Replays the workload of erc20_storage_performance without the EVM, so it
+// only counts the cost of the contract storage.
+void Run(const std::string& name, eevm::Storage* st, ContractState* state,
+         StorageCounter* storage, int account_num, int transfer_num) {
+  const uint64_t kBalance = 100;
+  std::vector<uint256_t> slots;
+  std::vector<uint64_t> balance(account_num, kBalance);
+  for (int i = 0; i < account_num; ++i) {
+    slots.push_back(GetBalanceSlot(AddressManager().CreateRandomAddress()));
+    st->store(slots[i], kBalance);
+    if (state) {
+      state->Commit();
+    }
+  }
+
+  // Every other transfer moves all the balance of the sender, so its slot is
+  // cleared.
+  int done = 0;
+  uint64_t start_time = GetCurrentTime();
+  for (int i = 0; i < transfer_num; ++i) {
+    int from = i % account_num;
+    int to = (i * 7 + 3) % account_num;
+    if (from == to || balance[from] == 0) {
+      continue;
+    }
+    uint64_t amount = i % 2 == 0 ? balance[from] : 1;
+    if (Transfer(st, slots[from], slots[to], amount)) {
+      balance[from] -= amount;
+      balance[to] += amount;
+      ++done;
+    }
+    if (state) {
+      state->Commit();
+    }
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+
+  printf(
+      "%s transfers:%d tx/s:%.0f storage keys:%lu bytes:%lu writes:%lu "
+      "batches:%lu\n",
+      name.c_str(), done, done * 1000000.0 / run_time, storage->GetKeyNum(),
+      storage->GetSize(), storage->GetWriteNum(), storage->GetBatchNum());
+}
+
+int main(int argc, char** argv) {
+  int account_num = argc > 1 ? atoi(argv[1]) : 1000;
+  int transfer_num = argc > 2 ? atoi(argv[2]) : 100000;
+  if (account_num <= 1 || transfer_num <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+  google::InitGoogleLogging(argv[0]);
+
+  Address contract_address = AddressManager().CreateRandomAddress();
+  {
+    StorageCounter storage;
+    HexView view(&storage);
+    Run("hex", &view, nullptr, &storage, account_num, transfer_num);
+  }
+  {
+    StorageCounter storage;
+    ContractState state(&storage);
+    GlobalView view(&state, contract_address);
+    Run("contract state", &view, &state, &storage, account_num,
+        transfer_num);
+  }
+  return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <fstream>
+
+#include "benchmark/contract/storage_counter.h"
+#include "common/utils/utils.h"
+#include "executor/contract/manager/address_manager.h"
+#include "executor/contract/manager/contract_manager.h"
+
+using namespace resdb;
+using namespace resdb::contract;
+
+void ShowUsage() {
+  printf("[contract.json] [account_num] [transfer_num]\n");
+}
+
+bool Transfer(ContractManager* manager, const Address& contract_address,
+              const Address& from, const Address& to, uint64_t amount) {
+  Params func_params;
+  func_params.set_func_name("transfer(address,uint256)");
+  func_params.add_param(eevm::to_hex_string(to));
+  func_params.add_param(eevm::to_hex_string(amount));
+  auto result = manager->ExecContract(from, contract_address, func_params);
+  return result.ok() && eevm::to_uint256(*result) == 1;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    ShowUsage();
+    exit(0);
+  }
+  std::string contract_path = argv[1];
+  int account_num = argc > 2 ? atoi(argv[2]) : 1000;
+  int transfer_num = argc > 3 ? atoi(argv[3]) : 100000;
+  google::InitGoogleLogging(argv[0]);
+
+  std::ifstream contract_fstream(contract_path);
+  if (!contract_fstream) {
+    LOG(ERROR) << "open contract file fail:" << contract_path;
+    return 1;
+  }
+  const auto contract_json = nlohmann::json::parse(
+      contract_fstream)["contracts"]["ERC20.sol:ERC20Token"];
+
+  StorageCounter storage;
+  ContractManager manager(&storage);
+
+  DeployInfo deploy_info;
+  deploy_info.set_contract_bin(contract_json["bin"]);
+  for (auto& func : contract_json["hashes"].items()) {
+    FuncInfo* new_func = deploy_info.add_func_info();
+    new_func->set_func_name(func.key());
+    new_func->set_hash(func.value());
+  }
+  const uint64_t kBalance = 100;
+  deploy_info.add_init_param(eevm::to_hex_string(kBalance * account_num));
+
+  Address owner = AddressManager().CreateRandomAddress();
+  Address contract_address = manager.DeployContract(owner, deploy_info);
+  if (contract_address == 0) {
+    LOG(ERROR) << "deploy contract fail";
+    return 1;
+  }
+
+  std::vector<Address> accounts;
+  std::vector<uint64_t> balance(account_num, kBalance);
+  for (int i = 0; i < account_num; ++i) {
+    accounts.push_back(AddressManager().CreateRandomAddress());
+    Transfer(&manager, contract_address, owner, accounts[i], kBalance);
+  }
+
+  // Every other transfer moves all the balance of the sender, so its slot is
+  // cleared.
+  int done = 0;
+  uint64_t start_time = GetCurrentTime();
+  for (int i = 0; i < transfer_num; ++i) {
+    int from = i % account_num;
+    int to = (i * 7 + 3) % account_num;
+    if (from == to || balance[from] == 0) {
+      continue;
+    }
+    uint64_t amount = i % 2 == 0 ? balance[from] : 1;
+    if (Transfer(&manager, contract_address, accounts[from], accounts[to],
+                 amount)) {
+      balance[from] -= amount;
+      balance[to] += amount;
+      ++done;
+    }
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+
+  printf(
+      "transfers:%d tx/s:%.0f storage keys:%lu bytes:%lu writes:%lu "
+      "batches:%lu\n",
+      done, done * 1000000.0 / run_time, storage.GetKeyNum(), storage.GetSize(),
+      storage.GetWriteNum(), storage.GetBatchNum());
+  return 0;
+}
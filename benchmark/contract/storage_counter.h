@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <map>
+
+#include "chain/storage/memory_db.h"
+
+namespace resdb {
+
+// A MemoryDB which tracks the bytes held and the writes done.
+class StorageCounter : public storage::MemoryDB {
+ public:
+  int SetValue(const std::string& key, const std::string& value) override {
+    ++write_num_;
+    size_[key] = key.size() + value.size();
+    return MemoryDB::SetValue(key, value);
+  }
+
+  int DelValue(const std::string& key) override {
+    ++write_num_;
+    size_.erase(key);
+    return MemoryDB::DelValue(key);
+  }
+
+  int SetValues(
+      const std::vector<std::pair<std::string, std::string>>& values) override {
+    ++batch_num_;
+    return MemoryDB::SetValues(values);
+  }
+
+  uint64_t GetSize() const {
+    uint64_t size = 0;
+    for (const auto& it : size_) {
+      size += it.second;
+    }
+    return size;
+  }
+  uint64_t GetKeyNum() const { return size_.size(); }
+  uint64_t GetWriteNum() const { return write_num_; }
+  uint64_t GetBatchNum() const { return batch_num_; }
+
+ private:
+  std::map<std::string, uint64_t> size_;
+  uint64_t write_num_ = 0, batch_num_ = 0;
+};
+
+}  // namespace resdb
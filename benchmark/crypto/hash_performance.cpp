@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string_view>
+
+#include "common/crypto/digest.h"
+#include "common/crypto/signature_verifier.h"
+#include "common/utils/thread_pool.h"
+#include "common/utils/utils.h"
+
+using namespace resdb;
+
+void ShowUsage() {
+  printf("[batch_size] [request_size] [round] [thread_num]\n");
+}
+
+// Hash and check each request on its own, keeping the digests as strings.
+void RunString(const std::vector<std::string>& requests,
+               const std::vector<std::string>& hashes, int round) {
+  int mismatch = 0;
+  uint64_t start_time = GetCurrentTime();
+  for (int r = 0; r < round; ++r) {
+    for (size_t i = 0; i < requests.size(); ++i) {
+      if (SignatureVerifier::CalculateHash(requests[i]) != hashes[i]) {
+        mismatch++;
+      }
+    }
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  printf("string batch:%lu hashes/s:%.0f mismatch:%d\n", requests.size(),
+         requests.size() * round * 1e6 / run_time, mismatch);
+}
+
+// Hash each request into a Digest on the stack and compare it in place.
+void RunDigest(const std::vector<std::string>& requests,
+               const std::vector<std::string>& hashes, int round) {
+  int mismatch = 0;
+  uint64_t start_time = GetCurrentTime();
+  for (int r = 0; r < round; ++r) {
+    for (size_t i = 0; i < requests.size(); ++i) {
+      if (!CalculateSHA256(requests[i]).Equals(hashes[i])) {
+        mismatch++;
+      }
+    }
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  printf("digest batch:%lu hashes/s:%.0f mismatch:%d\n", requests.size(),
+         requests.size() * round * 1e6 / run_time, mismatch);
+}
+
+// Hash the whole batch on the pool and the calling thread.
+void RunBatch(const std::vector<std::string>& requests,
+              const std::vector<std::string>& hashes, int round,
+              ThreadPool* pool) {
+  int mismatch = 0;
+  std::vector<std::string_view> inputs(requests.begin(), requests.end());
+  std::vector<Digest> digests;
+  uint64_t start_time = GetCurrentTime();
+  for (int r = 0; r < round; ++r) {
+    CalculateSHA256Batch(inputs, &digests, pool);
+    for (size_t i = 0; i < requests.size(); ++i) {
+      if (!digests[i].Equals(hashes[i])) {
+        mismatch++;
+      }
+    }
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  printf("batch batch:%lu threads:%d hashes/s:%.0f mismatch:%d\n",
+         requests.size(), pool->Size() + 1,
+         requests.size() * round * 1e6 / run_time, mismatch);
+}
+
+int main(int argc, char** argv) {
+  int batch_size = argc > 1 ? atoi(argv[1]) : 128;
+  int request_size = argc > 2 ? atoi(argv[2]) : 128;
+  int round = argc > 3 ? atoi(argv[3]) : 10000;
+  int thread_num = argc > 4 ? atoi(argv[4]) : 4;
+  if (batch_size <= 0 || request_size <= 0 || round <= 0 || thread_num <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  std::vector<std::string> requests(batch_size), hashes(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    requests[i] = std::string(request_size, 'a' + i % 26);
+    hashes[i] = CalculateSHA256(requests[i]).ToString();
+  }
+  RunString(requests, hashes, round);
+  RunDigest(requests, hashes, round);
+  ThreadPool pool("hash_performance", thread_num);
+  RunBatch(requests, hashes, round, &pool);
+  return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include "common/utils/utils.h"
+#include "platform/consensus/execution/transaction_executor.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[txn_num] [execute_us] [key_num]\n"); }
+
+// Sleeps for a fixed time per batch to stand in for the storage access of a
+// commutative transaction, e.g. an increment on a key.
+class SimulatedTransactionManager : public TransactionManager {
+ public:
+  SimulatedTransactionManager(int execute_us)
+      : TransactionManager(/*is_out_of_order=*/true),
+        execute_us_(execute_us) {}
+
+  // The transactions are "<key>:<payload>".
+  uint64_t GetPartitionKey(const BatchUserRequest& request) override {
+    const std::string& data = request.user_requests(0).request().data();
+    return std::hash<std::string>()(data.substr(0, data.find(':')));
+  }
+
+  std::unique_ptr<BatchUserResponse> ExecuteBatch(
+      const BatchUserRequest& request) override {
+    usleep(execute_us_);
+    num_++;
+    return nullptr;
+  }
+
+  uint64_t Num() const { return num_; }
+
+ private:
+  int execute_us_;
+  std::atomic<uint64_t> num_ = 0;
+};
+
+ResDBConfig GetConfig(int worker_num) {
+  ReplicaInfo self_info;
+  self_info.set_id(1);
+  self_info.set_ip("127.0.0.1");
+  self_info.set_port(1234);
+  ResDBConfig config({self_info}, self_info);
+  config.SetOutOfOrderWorkerNum(worker_num);
+  return config;
+}
+
+std::vector<std::unique_ptr<Request>> GetRequests(int txn_num, int key_num) {
+  std::vector<std::unique_ptr<Request>> requests;
+  for (int i = 1; i <= txn_num; ++i) {
+    BatchUserRequest batch_request;
+    batch_request.add_user_requests()->mutable_request()->set_data(
+        "key_" + std::to_string(i % key_num) + ":" + std::string(1024, 'a'));
+    auto request = std::make_unique<Request>();
+    request->set_seq(i);
+    batch_request.SerializeToString(request->mutable_data());
+    requests.push_back(std::move(request));
+  }
+  return requests;
+}
+
+void Run(int worker_num, int txn_num, int execute_us, int key_num) {
+  ResDBConfig config = GetConfig(worker_num);
+  auto manager = std::make_unique<SimulatedTransactionManager>(execute_us);
+  SimulatedTransactionManager* manager_ptr = manager.get();
+  std::atomic<int> response_num = 0;
+  SystemInfo system_info(config);
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request>, std::unique_ptr<BatchUserResponse>) {
+        response_num++;
+      },
+      &system_info, std::move(manager));
+
+  std::vector<std::unique_ptr<Request>> requests =
+      GetRequests(txn_num, key_num);
+  uint64_t start_time = GetCurrentTime();
+  for (auto& request : requests) {
+    executor.Commit(std::move(request));
+  }
+  while (manager_ptr->Num() < static_cast<uint64_t>(txn_num) ||
+         response_num < txn_num) {
+    usleep(100);
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  executor.Stop();
+
+  printf("workers:%d txn:%d execute:%dus keys:%d time:%.3fs "
+         "throughput:%.0f batch/s\n",
+         worker_num, txn_num, execute_us, key_num, run_time / 1e6,
+         txn_num * 1e6 / run_time);
+}
+
+int main(int argc, char** argv) {
+  int txn_num = argc > 1 ? atoi(argv[1]) : 20000;
+  int execute_us = argc > 2 ? atoi(argv[2]) : 50;
+  int key_num = argc > 3 ? atoi(argv[3]) : 1024;
+  if (txn_num <= 0 || execute_us < 0 || key_num <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  for (int worker_num : {1, 4, 16}) {
+    Run(worker_num, txn_num, execute_us, key_num);
+  }
+  return 0;
+}
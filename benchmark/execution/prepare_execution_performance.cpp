@@ -0,0 +1,166 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <mutex>
+#include <unordered_set>
+
+#include "common/utils/utils.h"
+#include "platform/consensus/execution/transaction_executor.h"
+#include "proto/kv/kv.pb.h"
+
+using namespace resdb;
+
+void ShowUsage() {
+  printf("[batch_num] [batch_size] [miss_us] [interval_us] [pipeline]\n");
+}
+
+// A key value manager whose storage costs miss_us to load a key that is not
+// cached yet, standing in for a read from disk.
+class SimulatedKVManager : public TransactionManager {
+ public:
+  SimulatedKVManager(int miss_us) : miss_us_(miss_us) {}
+
+  std::unique_ptr<google::protobuf::Message> ParseData(
+      const std::string& data) override {
+    auto kv_request = std::make_unique<KVRequest>();
+    if (!kv_request->ParseFromString(data)) {
+      return nullptr;
+    }
+    return kv_request;
+  }
+
+  void Prefetch(const google::protobuf::Message& request) override {
+    Load(dynamic_cast<const KVRequest&>(request).key());
+  }
+
+  std::unique_ptr<std::string> ExecuteRequest(
+      const google::protobuf::Message& request) override {
+    const KVRequest& kv_request = dynamic_cast<const KVRequest&>(request);
+    Load(kv_request.key());
+    std::unique_lock<std::mutex> lk(mutex_);
+    values_[kv_request.key()] = kv_request.value();
+    return std::make_unique<std::string>();
+  }
+
+ private:
+  void Load(const std::string& key) {
+    {
+      std::unique_lock<std::mutex> lk(mutex_);
+      if (cached_.count(key)) {
+        return;
+      }
+    }
+    usleep(miss_us_);
+    std::unique_lock<std::mutex> lk(mutex_);
+    cached_.insert(key);
+  }
+
+ private:
+  int miss_us_;
+  std::mutex mutex_;
+  std::unordered_set<std::string> cached_;
+  std::map<std::string, std::string> values_;
+};
+
+std::unique_ptr<Request> GetRequest(int seq, int batch_size) {
+  BatchUserRequest batch_request;
+  for (int i = 0; i < batch_size; ++i) {
+    KVRequest kv_request;
+    kv_request.set_cmd(KVRequest::SET);
+    kv_request.set_key("key_" + std::to_string(seq) + "_" + std::to_string(i));
+    kv_request.set_value(std::string(128, 'a'));
+    kv_request.SerializeToString(
+        batch_request.add_user_requests()->mutable_request()->mutable_data());
+  }
+  auto request = std::make_unique<Request>();
+  request->set_seq(seq);
+  request->set_hash("hash_" + std::to_string(seq));
+  batch_request.SerializeToString(request->mutable_data());
+  return request;
+}
+
+// Proposes a batch every interval_us and commits it pipeline batches later,
+// as the agreement of a proposal overlaps with the following ones.
+void Run(bool prepare, int batch_num, int batch_size, int miss_us,
+         int interval_us, int pipeline) {
+  ResDBConfig config({ReplicaInfo()}, ReplicaInfo());
+  SystemInfo system_info(config);
+  std::vector<uint64_t> commit_time(batch_num + 1);
+  std::atomic<uint64_t> total_latency = 0, max_latency = 0;
+  std::atomic<int> response_num = 0;
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request> request,
+          std::unique_ptr<BatchUserResponse>) {
+        uint64_t latency = GetCurrentTime() - commit_time[request->seq()];
+        total_latency += latency;
+        if (latency > max_latency) {
+          max_latency = latency;
+        }
+        response_num++;
+      },
+      &system_info, std::make_unique<SimulatedKVManager>(miss_us));
+
+  std::vector<std::unique_ptr<Request>> requests(batch_num + 1);
+  for (int i = 1; i <= batch_num; ++i) {
+    requests[i] = GetRequest(i, batch_size);
+  }
+
+  uint64_t start_time = GetCurrentTime();
+  for (int i = 1; i <= batch_num + pipeline; ++i) {
+    if (prepare && i <= batch_num) {
+      executor.Prepare(std::make_unique<Request>(*requests[i]));
+    }
+    int seq = i - pipeline;
+    if (seq >= 1) {
+      commit_time[seq] = GetCurrentTime();
+      executor.Commit(std::move(requests[seq]));
+    }
+    usleep(interval_us);
+  }
+  while (response_num < batch_num) {
+    usleep(100);
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  executor.Stop();
+
+  printf("prepare:%d batches:%d batch size:%d miss:%dus time:%.3fs "
+         "avg commit-to-response:%.3fms max:%.3fms\n",
+         prepare, batch_num, batch_size, miss_us, run_time / 1e6,
+         total_latency / 1e3 / batch_num, max_latency / 1e3);
+}
+
+int main(int argc, char** argv) {
+  int batch_num = argc > 1 ? atoi(argv[1]) : 1000;
+  int batch_size = argc > 2 ? atoi(argv[2]) : 100;
+  int miss_us = argc > 3 ? atoi(argv[3]) : 20;
+  int interval_us = argc > 4 ? atoi(argv[4]) : 10000;
+  int pipeline = argc > 5 ? atoi(argv[5]) : 4;
+  if (batch_num <= 0 || batch_size <= 0 || miss_us < 0 || interval_us < 0 ||
+      pipeline < 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  Run(false, batch_num, batch_size, miss_us, interval_us, pipeline);
+  Run(true, batch_num, batch_size, miss_us, interval_us, pipeline);
+  return 0;
+}
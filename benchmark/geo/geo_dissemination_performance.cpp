@@ -0,0 +1,152 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <glog/logging.h>
+
+#include "common/utils/utils.h"
+#include "platform/consensus/execution/geo_fragment.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[batch_size] [txn_size] [bandwidth_mbps]\n"); }
+
+// A WAN uplink of a fixed bandwidth. Sending only adds the time the bytes
+// occupy the link.
+class SimulatedLink {
+ public:
+  SimulatedLink(double bandwidth_mbps) : bytes_per_us_(bandwidth_mbps / 8) {}
+
+  void Send(size_t bytes) {
+    bytes_ += bytes;
+    busy_us_ += bytes / bytes_per_us_;
+  }
+
+  uint64_t Bytes() const { return bytes_; }
+  double BusyUs() const { return busy_us_; }
+
+ private:
+  double bytes_per_us_;
+  uint64_t bytes_ = 0;
+  double busy_us_ = 0;
+};
+
+BatchUserRequest GetBatch(int batch_size, int txn_size, int cert_num) {
+  BatchUserRequest batch;
+  batch.set_seq(1);
+  batch.set_hash(std::string(32, 'h'));
+  for (int i = 0; i < batch_size; ++i) {
+    batch.add_user_requests()->mutable_request()->set_data(
+        std::string(txn_size, 'a' + i % 26));
+  }
+  for (int i = 1; i <= cert_num; ++i) {
+    SignatureInfo* cert =
+        batch.mutable_committed_certs()->add_committed_certs();
+    cert->set_hash_type(SignatureInfo::ED25519);
+    cert->set_node_id(i);
+    cert->set_signature(std::string(64, 's'));
+  }
+  return batch;
+}
+
+// Each region has replica_num replicas and sends every committed batch to
+// the other region_num - 1 regions.
+void Run(int replica_num, int region_num, int batch_size, int txn_size,
+         double bandwidth_mbps) {
+  int f = (replica_num - 1) / 3;
+  BatchUserRequest batch = GetBatch(batch_size, txn_size, 2 * f + 1);
+  Request geo_request;
+  geo_request.set_type(Request::TYPE_GEO_REQUEST);
+  geo_request.set_seq(1);
+  batch.SerializeToString(geo_request.mutable_data());
+  size_t full_size = geo_request.ByteSizeLong();
+
+  // Full requests: the primary sends them to f + 1 replicas per region.
+  // The intra region broadcast of the receivers is not counted as WAN
+  // traffic in either mode.
+  SimulatedLink primary(bandwidth_mbps);
+  for (int i = 0; i < (region_num - 1) * (f + 1); ++i) {
+    primary.Send(full_size);
+  }
+
+  // Fragments: every replica sends its own fragment to one replica of each
+  // region, which passes it on inside its region.
+  uint64_t start = GetCurrentTime();
+  std::vector<std::unique_ptr<GeoFragment>> fragments;
+  for (int i = 0; i < replica_num; ++i) {
+    fragments.push_back(NewGeoFragment(batch, 1, i, replica_num));
+  }
+  double encode_us = (GetCurrentTime() - start) * 1.0 / replica_num;
+
+  std::vector<SimulatedLink> replicas(replica_num,
+                                      SimulatedLink(bandwidth_mbps));
+  for (int i = 0; i < replica_num; ++i) {
+    Request fragment_request;
+    fragment_request.set_type(Request::TYPE_GEO_FRAGMENT);
+    fragment_request.set_seq(1);
+    fragments[i]->SerializeToString(fragment_request.mutable_data());
+    for (int j = 0; j < region_num - 1; ++j) {
+      replicas[i].Send(fragment_request.ByteSizeLong());
+    }
+  }
+
+  start = GetCurrentTime();
+  GeoFragmentCollector collector;
+  std::vector<CompactCerts> certs;
+  for (int i = replica_num - 1; i >= 0; --i) {
+    if (collector.AddFragment(*fragments[i], &certs) != nullptr) {
+      break;
+    }
+  }
+  double decode_us = GetCurrentTime() - start;
+
+  uint64_t fragment_bytes = 0;
+  double busiest_us = 0;
+  for (const auto& replica : replicas) {
+    fragment_bytes += replica.Bytes();
+    busiest_us = std::max(busiest_us, replica.BusyUs());
+  }
+  size_t certs_size = batch.committed_certs().ByteSizeLong();
+  size_t compact_size =
+      ToCompactCerts(batch.committed_certs()).ByteSizeLong();
+
+  printf(
+      "replicas:%d batch:%zuB certs:%zuB compact certs:%zuB\n"
+      "  full:     wan bytes/batch:%lu busiest node:%lu geo tput:%.0f "
+      "batch/s\n"
+      "  fragment: wan bytes/batch:%lu busiest node:%lu geo tput:%.0f "
+      "batch/s encode:%.0fus decode:%.0fus\n",
+      replica_num, full_size, certs_size, compact_size, primary.Bytes(),
+      primary.Bytes(), 1e6 / primary.BusyUs(), fragment_bytes,
+      replicas[0].Bytes(), 1e6 / std::max(busiest_us, encode_us), encode_us,
+      decode_us);
+}
+
+int main(int argc, char** argv) {
+  int batch_size = argc > 1 ? atoi(argv[1]) : 100;
+  int txn_size = argc > 2 ? atoi(argv[2]) : 128;
+  double bandwidth_mbps = argc > 3 ? atof(argv[3]) : 100;
+  if (batch_size <= 0 || txn_size <= 0 || bandwidth_mbps <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+  printf("3 regions, %.0f Mbps uplink per node\n", bandwidth_mbps);
+  for (int replica_num : {4, 7, 16}) {
+    Run(replica_num, 3, batch_size, txn_size, bandwidth_mbps);
+  }
+  return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <random>
+
+#include "common/utils/utils.h"
+#include "platform/consensus/execution/geo_global_executor.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[rounds] [execute_us] [interval_us]\n"); }
+
+// Spins for a fixed time per batch to stand in for the real execution and
+// records the commit-to-execution latency of each batch.
+class SimulatedTransactionManager : public TransactionManager {
+ public:
+  SimulatedTransactionManager(int execute_us) : execute_us_(execute_us) {}
+
+  std::unique_ptr<BatchUserResponse> ExecuteBatch(
+      const BatchUserRequest& request) override {
+    uint64_t start = GetCurrentTime();
+    while (GetCurrentTime() - start < static_cast<uint64_t>(execute_us_)) {
+    }
+    total_latency_ += GetCurrentTime() - request.createtime();
+    num_++;
+    return nullptr;
+  }
+
+  uint64_t Num() const { return num_; }
+  uint64_t TotalLatency() const { return total_latency_; }
+
+ private:
+  int execute_us_;
+  std::atomic<uint64_t> num_ = 0;
+  std::atomic<uint64_t> total_latency_ = 0;
+};
+
+ResDBConfig GetConfig(int region_num) {
+  ResConfigData config_data;
+  for (int i = 1; i <= region_num; ++i) {
+    config_data.add_region()->set_region_id(i);
+  }
+  config_data.set_self_region_id(1);
+  ReplicaInfo self_info;
+  self_info.set_id(1);
+  self_info.set_ip("127.0.0.1");
+  self_info.set_port(1234);
+  return ResDBConfig({self_info}, self_info, config_data);
+}
+
+// Every region commits one batch each interval and it reaches this replica
+// after the WAN delay of that region plus some jitter, so batches of
+// different regions and rounds arrive out of order.
+void RunRegion(GeoGlobalExecutor* executor, int region_id, int rounds,
+               int interval_us, int delay_us, uint64_t start_time) {
+  std::mt19937 rng(region_id);
+  std::uniform_int_distribution<int> jitter(0, delay_us / 5 + 1);
+  std::vector<std::pair<uint64_t, uint64_t>> arrivals;
+  for (int seq = 1; seq <= rounds; ++seq) {
+    uint64_t commit_time = start_time + seq * interval_us;
+    arrivals.push_back({commit_time + delay_us + jitter(rng), seq});
+  }
+  std::sort(arrivals.begin(), arrivals.end());
+
+  for (const auto& arrival : arrivals) {
+    uint64_t now = GetCurrentTime();
+    if (arrival.first > now) {
+      usleep(arrival.first - now);
+    }
+    uint64_t seq = arrival.second;
+    BatchUserRequest batch_request;
+    batch_request.set_createtime(start_time + seq * interval_us);
+    batch_request.set_seq(seq);
+    for (int i = 0; i < 100; ++i) {
+      batch_request.add_user_requests()->mutable_request()->set_data(
+          std::string(128, 'a' + i % 26));
+    }
+    auto request = std::make_unique<Request>();
+    request->set_seq(seq);
+    request->mutable_region_info()->set_region_id(region_id);
+    batch_request.SerializeToString(request->mutable_data());
+    executor->OrderGeoRequest(std::move(request));
+  }
+}
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? atoi(argv[1]) : 1000;
+  int execute_us = argc > 2 ? atoi(argv[2]) : 100;
+  int interval_us = argc > 3 ? atoi(argv[3]) : 1000;
+  if (rounds <= 0 || execute_us < 0 || interval_us <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  // One-way delay from each of the 3 regions to this replica.
+  std::vector<int> delays = {0, 20000, 50000};
+  auto manager = std::make_unique<SimulatedTransactionManager>(execute_us);
+  SimulatedTransactionManager* manager_ptr = manager.get();
+  GeoGlobalExecutor executor(std::move(manager), GetConfig(delays.size()));
+
+  uint64_t start_time = GetCurrentTime();
+  std::vector<std::thread> regions;
+  for (size_t i = 0; i < delays.size(); ++i) {
+    regions.push_back(std::thread(RunRegion, &executor, i + 1, rounds,
+                                  interval_us, delays[i], start_time));
+  }
+  for (auto& region : regions) {
+    region.join();
+  }
+  uint64_t total = rounds * delays.size();
+  while (manager_ptr->Num() < total) {
+    usleep(100);
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  executor.Stop();
+
+  printf(
+      "regions:%zu rounds:%d execute:%dus interval:%dus time:%.3fs "
+      "throughput:%.0f batch/s avg latency:%.3fms\n",
+      delays.size(), rounds, execute_us, interval_us, run_time / 1e6,
+      total * 1e6 / run_time,
+      manager_ptr->TotalLatency() / 1e3 / manager_ptr->Num());
+  return 0;
+}
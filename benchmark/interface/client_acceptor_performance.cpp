@@ -0,0 +1,255 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <thread>
+
+#include "common/utils/utils.h"
+#include "platform/common/network/frame.h"
+#include "platform/common/network/tcp_socket.h"
+#include "platform/rdbc/acceptor.h"
+#include "platform/rdbc/async_client_acceptor.h"
+
+using namespace resdb;
+using boost::asio::ip::tcp;
+
+void ShowUsage() {
+  printf("[async|sync] [client_num] [duration_s] [data_size] [worker_num]\n");
+}
+
+const std::string kIp = "127.0.0.1";
+const int kPort = 20001;
+
+// Echoes each request back, standing in for the service.
+std::vector<std::thread> StartWorkers(LockFreeQueue<QueueItem>* input_queue,
+                                      int worker_num, std::atomic<bool>* stop) {
+  std::vector<std::thread> workers;
+  for (int i = 0; i < worker_num; ++i) {
+    workers.push_back(std::thread([input_queue, stop]() {
+      while (!*stop) {
+        auto item = input_queue->Pop(100);
+        if (item == nullptr) {
+          continue;
+        }
+        item->socket->Send(std::string(
+            static_cast<char*>(item->data->buff), item->data->data_len));
+      }
+    }));
+  }
+  return workers;
+}
+
+// A client keeping one request in flight on its long-lived connection.
+class AsyncClient {
+ public:
+  AsyncClient(boost::asio::io_service* io_service, int data_size,
+              std::atomic<bool>* stop)
+      : socket_(*io_service), data_(data_size, 'a'), stop_(stop) {}
+
+  bool Connect() {
+    boost::system::error_code ec;
+    socket_.connect(
+        tcp::endpoint(boost::asio::ip::address::from_string(kIp), kPort), ec);
+    if (ec) {
+      return false;
+    }
+    socket_.set_option(tcp::no_delay(true), ec);
+    return true;
+  }
+
+  void SendNext() {
+    if (*stop_) {
+      return;
+    }
+    frame_.assign(kRequestFrameHeaderSize, 0);
+    EncodeRequestFrameHeader(data_.size(), ++request_id_, frame_.data());
+    frame_.append(data_);
+    start_time_ = GetCurrentTime();
+    boost::asio::async_write(
+        socket_, boost::asio::buffer(frame_),
+        [this](const boost::system::error_code& ec, size_t) {
+          if (!ec) {
+            RecvHeader();
+          }
+        });
+  }
+
+  const std::vector<uint64_t>& GetLatency() const { return latency_; }
+
+ private:
+  void RecvHeader() {
+    boost::asio::async_read(
+        socket_, boost::asio::buffer(header_, sizeof(header_)),
+        [this](const boost::system::error_code& ec, size_t) {
+          if (ec) {
+            return;
+          }
+          uint64_t data_len = 0;
+          DecodeRequestFrameHeader(header_, &data_len, &resp_id_);
+          resp_.resize(data_len);
+          boost::asio::async_read(
+              socket_, boost::asio::buffer(resp_.data(), resp_.size()),
+              [this](const boost::system::error_code& ec, size_t) {
+                if (ec || resp_id_ != request_id_) {
+                  return;
+                }
+                latency_.push_back(GetCurrentTime() - start_time_);
+                SendNext();
+              });
+        });
+  }
+
+ private:
+  tcp::socket socket_;
+  std::string data_, frame_, resp_;
+  char header_[kRequestFrameHeaderSize];
+  uint64_t request_id_ = 0, resp_id_ = 0;
+  uint64_t start_time_ = 0;
+  std::vector<uint64_t> latency_;
+  std::atomic<bool>* stop_;
+};
+
+std::vector<uint64_t> RunAsyncClients(int client_num, int duration_s,
+                                      int data_size) {
+  boost::asio::io_service io_service;
+  std::atomic<bool> stop = false;
+  std::vector<std::unique_ptr<AsyncClient>> clients;
+  for (int i = 0; i < client_num; ++i) {
+    auto client = std::make_unique<AsyncClient>(&io_service, data_size, &stop);
+    if (!client->Connect()) {
+      LOG(ERROR) << "connect fail after " << i
+                 << " connections, raise the open file limit";
+      break;
+    }
+    clients.push_back(std::move(client));
+  }
+  for (auto& client : clients) {
+    client->SendNext();
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([&]() { io_service.run(); }));
+  }
+  sleep(duration_s);
+  stop = true;
+  io_service.stop();
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  std::vector<uint64_t> latency;
+  for (auto& client : clients) {
+    latency.insert(latency.end(), client->GetLatency().begin(),
+                   client->GetLatency().end());
+  }
+  return latency;
+}
+
+// Clients opening a connection for each request, as the blocking acceptor
+// expects.
+std::vector<uint64_t> RunSyncClients(int client_num, int duration_s,
+                                     int data_size) {
+  std::atomic<bool> stop = false;
+  std::vector<std::vector<uint64_t>> latency(client_num);
+  std::vector<std::thread> threads;
+  std::string data(data_size, 'a');
+  for (int i = 0; i < client_num; ++i) {
+    threads.push_back(std::thread([&, i]() {
+      while (!stop) {
+        uint64_t start_time = GetCurrentTime();
+        TcpSocket socket;
+        socket.SetRecvTimeout(1000000);
+        if (socket.Connect(kIp, kPort) != 0 || socket.Send(data) != 0) {
+          continue;
+        }
+        void* buff = nullptr;
+        size_t len = 0;
+        if (socket.Recv(&buff, &len) > 0) {
+          latency[i].push_back(GetCurrentTime() - start_time);
+        }
+        free(buff);
+      }
+    }));
+  }
+  sleep(duration_s);
+  stop = true;
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  std::vector<uint64_t> all_latency;
+  for (auto& l : latency) {
+    all_latency.insert(all_latency.end(), l.begin(), l.end());
+  }
+  return all_latency;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    ShowUsage();
+    exit(0);
+  }
+  std::string mode = argv[1];
+  int client_num = argc > 2 ? atoi(argv[2]) : 10000;
+  int duration_s = argc > 3 ? atoi(argv[3]) : 10;
+  int data_size = argc > 4 ? atoi(argv[4]) : 128;
+  int worker_num = argc > 5 ? atoi(argv[5]) : 16;
+  google::InitGoogleLogging(argv[0]);
+
+  LockFreeQueue<QueueItem> input_queue("input");
+  std::atomic<bool> stop = false;
+  std::vector<std::thread> workers =
+      StartWorkers(&input_queue, worker_num, &stop);
+
+  std::vector<uint64_t> latency;
+  if (mode == "async") {
+    AsyncClientAcceptor acceptor(kIp, kPort, worker_num, &input_queue);
+    acceptor.StartAccept();
+    latency = RunAsyncClients(client_num, duration_s, data_size);
+    acceptor.Stop();
+  } else {
+    ReplicaInfo self_info;
+    self_info.set_ip(kIp);
+    self_info.set_port(kPort);
+    ResDBConfig config({self_info}, self_info);
+    Acceptor acceptor(config, &input_queue);
+    std::thread acceptor_thread([&]() { acceptor.Run(); });
+    latency = RunSyncClients(client_num, duration_s, data_size);
+    acceptor.Stop();
+    acceptor_thread.join();
+  }
+  stop = true;
+  for (auto& th : workers) {
+    th.join();
+  }
+
+  if (latency.empty()) {
+    printf("no request done\n");
+    return 0;
+  }
+  std::sort(latency.begin(), latency.end());
+  printf("%s clients:%d requests/s:%.0f p50:%luus p99:%luus\n", mode.c_str(),
+         client_num, latency.size() * 1.0 / duration_s,
+         latency[latency.size() / 2], latency[latency.size() * 99 / 100]);
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <signal.h>
+#include <sys/resource.h>
+
+#include <atomic>
+#include <thread>
+
+#include "common/utils/utils.h"
+#include "interface/common/async_txn_accessor.h"
+#include "interface/common/resdb_txn_accessor.h"
+#include "platform/common/data_comm/data_comm.h"
+#include "platform/common/network/tcp_socket.h"
+#include "platform/config/resdb_config_utils.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[replica_num] [txn_num] [round] [port]\n"); }
+
+// A replica answering each query with one small transaction per seq. Like
+// the server, it keeps a connection open while the client asks for it.
+class FakeReplica {
+ public:
+  FakeReplica(int port) {
+    socket_.SetRecvTimeout(100000);
+    socket_.Listen("127.0.0.1", port);
+    thread_ = std::thread([this]() {
+      while (!stop_) {
+        std::unique_ptr<Socket> client = socket_.Accept();
+        if (client != nullptr) {
+          std::thread(&FakeReplica::Serve, this, std::move(client)).detach();
+        }
+      }
+    });
+  }
+
+  ~FakeReplica() {
+    stop_ = true;
+    thread_.join();
+  }
+
+ private:
+  void Serve(std::unique_ptr<Socket> client) {
+    client->SetRecvTimeout(1000000);
+    client->SetNoDelay(true);
+    while (!stop_) {
+      std::unique_ptr<DataInfo> data = std::make_unique<DataInfo>();
+      if (client->Recv(&data->buff, &data->data_len) <= 0) {
+        return;
+      }
+      ResDBMessage message;
+      Request request;
+      QueryRequest query;
+      if (!message.ParseFromArray(data->buff, data->data_len) ||
+          !request.ParseFromString(message.data()) ||
+          !query.ParseFromString(request.data())) {
+        return;
+      }
+      QueryResponse response;
+      for (uint64_t seq = query.min_seq(); seq <= query.max_seq(); ++seq) {
+        Request* txn = response.add_transactions();
+        txn->set_seq(seq);
+        txn->set_data(std::string(64, 'a' + seq % 26));
+      }
+      ResDBMessage resp_message;
+      response.SerializeToString(resp_message.mutable_data());
+      client->Send(resp_message.SerializeAsString());
+      if (!query.keep_alive()) {
+        return;
+      }
+    }
+  }
+
+  TcpSocket socket_;
+  std::atomic<bool> stop_ = false;
+  std::thread thread_;
+};
+
+uint64_t GetCpuTime() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+void Run(const std::string& name, ResDBTxnAccessor* accessor, int txn_num,
+         int round) {
+  int fail = 0;
+  uint64_t start_cpu = GetCpuTime();
+  uint64_t start_time = GetCurrentTime();
+  for (int r = 0; r < round; ++r) {
+    auto resp = accessor->GetTxn(1, txn_num);
+    if (!resp.ok() || resp->size() != static_cast<size_t>(txn_num)) {
+      fail++;
+    }
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  uint64_t cpu_time = GetCpuTime() - start_cpu;
+  printf("%s calls:%d latency(us):%.1f cpu(us)/call:%.1f fail:%d\n",
+         name.c_str(), round, run_time * 1.0 / round, cpu_time * 1.0 / round,
+         fail);
+}
+
+int main(int argc, char** argv) {
+  int replica_num = argc > 1 ? atoi(argv[1]) : 4;
+  int txn_num = argc > 2 ? atoi(argv[2]) : 10;
+  int round = argc > 3 ? atoi(argv[3]) : 2000;
+  int port = argc > 4 ? atoi(argv[4]) : 14000;
+  if (replica_num <= 0 || txn_num <= 0 || round <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+  signal(SIGPIPE, SIG_IGN);
+
+  std::vector<std::unique_ptr<FakeReplica>> replicas;
+  std::vector<ReplicaInfo> replica_infos;
+  for (int i = 0; i < replica_num; ++i) {
+    replicas.push_back(std::make_unique<FakeReplica>(port + i));
+    replica_infos.push_back(GenerateReplicaInfo(i + 1, "127.0.0.1", port + i));
+  }
+  ResDBConfig config(replica_infos, replica_infos[0]);
+
+  ResDBTxnAccessor accessor(config);
+  Run("thread per replica", &accessor, txn_num, round);
+  AsyncResDBTxnAccessor async_accessor(config);
+  Run("async", &async_accessor, txn_num, round);
+  return 0;
+}
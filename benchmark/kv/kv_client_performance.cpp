@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <future>
+
+#include "common/utils/utils.h"
+#include "interface/kv/async_kv_client.h"
+#include "interface/kv/kv_client.h"
+#include "platform/config/resdb_config_utils.h"
+
+using resdb::AsyncKVClient;
+using resdb::GenerateResDBConfig;
+using resdb::GetCurrentTime;
+using resdb::KVClient;
+using resdb::ResDBConfig;
+
+// Compare the ops/sec of the blocking KVClient with AsyncKVClient from one
+// client process against a running kv service.
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("<config path> [op num] [max inflight] [max batch size]\n");
+    return 0;
+  }
+  ResDBConfig config = GenerateResDBConfig(argv[1]);
+  config.SetClientTimeoutMs(100000);
+  int op_num = argc > 2 ? atoi(argv[2]) : 10000;
+  int max_inflight = argc > 3 ? atoi(argv[3]) : 16;
+  int max_batch_size = argc > 4 ? atoi(argv[4]) : 64;
+
+  {
+    KVClient client(config);
+    int sync_num = std::max(1, op_num / 100);
+    uint64_t start = GetCurrentTime();
+    for (int i = 0; i < sync_num; ++i) {
+      client.Set("key" + std::to_string(i), "value");
+    }
+    uint64_t run_time = GetCurrentTime() - start;
+    printf("KVClient set: %d ops %.0f ops/s\n", sync_num,
+           sync_num * 1000000.0 / run_time);
+
+    // Set does not wait for the replica, Get waits for the value.
+    start = GetCurrentTime();
+    for (int i = 0; i < sync_num; ++i) {
+      client.Get("key" + std::to_string(i));
+    }
+    run_time = GetCurrentTime() - start;
+    printf("KVClient get: %d ops %.0f ops/s\n", sync_num,
+           sync_num * 1000000.0 / run_time);
+  }
+
+  {
+    AsyncKVClient client(config, max_inflight, max_batch_size);
+    std::vector<std::future<int>> rets;
+    rets.reserve(op_num);
+    uint64_t start = GetCurrentTime();
+    for (int i = 0; i < op_num; ++i) {
+      rets.push_back(client.Set("key" + std::to_string(i), "value"));
+    }
+    int fail_num = 0;
+    for (auto& ret : rets) {
+      fail_num += ret.get() != 0;
+    }
+    uint64_t run_time = GetCurrentTime() - start;
+    printf("AsyncKVClient: %d ops (%d failed) %.0f ops/s\n", op_num, fail_num,
+           op_num * 1000000.0 / run_time);
+  }
+}
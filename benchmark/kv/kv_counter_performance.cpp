@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include "chain/storage/memory_db.h"
+#include "common/utils/utils.h"
+#include "executor/kv/kv_executor.h"
+#include "proto/kv/kv.pb.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[add|get_cas|get_set] [client_num] [add_num]\n"); }
+
+const std::string kCounterKey = "counter";
+
+// A client adding one to the counter add_num times. Each request it sends
+// takes one consensus round.
+class CounterClient {
+ public:
+  CounterClient(const std::string& mode, int add_num)
+      : mode_(mode), remaining_(add_num) {}
+
+  bool Done() const { return remaining_ == 0; }
+
+  KVRequest GetRequest() const {
+    KVRequest request;
+    request.set_key(kCounterKey);
+    if (mode_ == "add") {
+      request.set_cmd(KVRequest::ADD);
+      request.set_delta(1);
+    } else if (!has_value_) {
+      request.set_cmd(KVRequest::GET);
+    } else if (mode_ == "get_cas") {
+      request.set_cmd(KVRequest::CAS);
+      request.set_expected_value(value_);
+      request.set_value(std::to_string(GetNum() + 1));
+    } else {
+      request.set_cmd(KVRequest::SET);
+      request.set_value(std::to_string(GetNum() + 1));
+    }
+    return request;
+  }
+
+  void OnResponse(const KVRequest& request, const KVResponse& response) {
+    if (request.cmd() == KVRequest::GET) {
+      value_ = response.value();
+      has_value_ = true;
+      return;
+    }
+    has_value_ = false;
+    if (response.status() == KVResponse::OK) {
+      --remaining_;
+    }
+  }
+
+ private:
+  int64_t GetNum() const { return value_.empty() ? 0 : std::stoll(value_); }
+
+ private:
+  std::string mode_;
+  int remaining_;
+  std::string value_;
+  bool has_value_ = false;
+};
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    ShowUsage();
+    exit(0);
+  }
+  std::string mode = argv[1];
+  int client_num = argc > 2 ? atoi(argv[2]) : 64;
+  int add_num = argc > 3 ? atoi(argv[3]) : 100;
+  google::InitGoogleLogging(argv[0]);
+  // The executor logs every request.
+  FLAGS_minloglevel = google::GLOG_FATAL;
+
+  KVExecutor executor(std::make_unique<storage::MemoryDB>());
+  std::vector<CounterClient> clients(client_num, CounterClient(mode, add_num));
+
+  // In each round the clients with work left send one request, which the
+  // replicas order and execute one after another.
+  uint64_t round_num = 0, request_num = 0;
+  uint64_t start_time = GetCurrentTime();
+  while (true) {
+    std::vector<std::pair<int, KVRequest>> requests;
+    for (int i = 0; i < client_num; ++i) {
+      // Rotate the order so no client always goes first.
+      int idx = (i + round_num) % client_num;
+      if (!clients[idx].Done()) {
+        requests.push_back(std::make_pair(idx, clients[idx].GetRequest()));
+      }
+    }
+    if (requests.empty()) {
+      break;
+    }
+    for (const auto& [idx, request] : requests) {
+      std::string data;
+      request.SerializeToString(&data);
+      std::unique_ptr<std::string> resp = executor.ExecuteData(data);
+      KVResponse response;
+      if (resp != nullptr) {
+        response.ParseFromString(*resp);
+      }
+      clients[idx].OnResponse(request, response);
+    }
+    ++round_num;
+    request_num += requests.size();
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+
+  KVRequest get;
+  get.set_cmd(KVRequest::GET);
+  get.set_key(kCounterKey);
+  std::string data;
+  get.SerializeToString(&data);
+  KVResponse response;
+  response.ParseFromString(*executor.ExecuteData(data));
+
+  int64_t expected = static_cast<int64_t>(client_num) * add_num;
+  int64_t counter = std::stoll(response.value());
+  printf(
+      "%s clients:%d adds:%ld counter:%ld lost:%ld rounds:%lu requests:%lu "
+      "requests/add:%.2f execute time:%luus\n",
+      mode.c_str(), client_num, expected, counter, expected - counter,
+      round_num, request_num, request_num * 1.0 / expected, run_time);
+  return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include "chain/storage/memory_db.h"
+#include "common/utils/utils.h"
+#include "executor/kv/kv_executor.h"
+#include "executor/kv/kv_index.h"
+#include "proto/kv/kv.pb.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[key_num] [city_num] [lookup_num]\n"); }
+
+KVResponse Execute(KVExecutor* executor, const KVRequest& request) {
+  std::string data;
+  request.SerializeToString(&data);
+  std::unique_ptr<std::string> resp = executor->ExecuteData(data);
+  KVResponse response;
+  if (resp != nullptr) {
+    response.ParseFromString(*resp);
+  }
+  return response;
+}
+
+std::string GetCity(int i) { return "city_" + std::to_string(i); }
+
+int main(int argc, char** argv) {
+  int key_num = argc > 1 ? atoi(argv[1]) : 10000000;
+  int city_num = argc > 2 ? atoi(argv[2]) : 1000;
+  int lookup_num = argc > 3 ? atoi(argv[3]) : 10;
+  if (key_num <= 0 || city_num <= 0 || lookup_num <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+  google::InitGoogleLogging(argv[0]);
+  // The executor logs every request.
+  FLAGS_minloglevel = google::GLOG_FATAL;
+
+  KVExecutor executor(std::make_unique<storage::MemoryDB>());
+  for (int i = 0; i < key_num; ++i) {
+    KVRequest request;
+    request.set_cmd(KVRequest::SET);
+    request.set_key("user_" + std::to_string(i));
+    request.set_value("{\"id\":" + std::to_string(i) + ",\"city\":\"" +
+                      GetCity(i % city_num) + "\"}");
+    Execute(&executor, request);
+  }
+
+  uint64_t start_time = GetCurrentTime();
+  {
+    KVRequest request;
+    request.set_cmd(KVRequest::CREATE_INDEX);
+    request.mutable_index()->set_name("city");
+    request.mutable_index()->set_json_path("city");
+    Execute(&executor, request);
+  }
+  printf("keys:%d create index:%luus\n", key_num,
+         GetCurrentTime() - start_time);
+
+  // Look up the users of a city with the index.
+  uint64_t item_num = 0;
+  start_time = GetCurrentTime();
+  for (int i = 0; i < lookup_num; ++i) {
+    KVRequest request;
+    request.set_cmd(KVRequest::GET_BY_INDEX);
+    request.mutable_index()->set_name("city");
+    request.set_value(GetCity(i % city_num));
+    item_num += Execute(&executor, request).items().item_size();
+  }
+  printf("index lookups:%d items:%lu latency:%luus\n", lookup_num, item_num,
+         (GetCurrentTime() - start_time) / lookup_num);
+
+  // The same through reading all the keys and filtering them on the client.
+  item_num = 0;
+  start_time = GetCurrentTime();
+  for (int i = 0; i < lookup_num; ++i) {
+    KVRequest request;
+    request.set_cmd(KVRequest::GET_BY_PREFIX);
+    std::string city = "\"" + GetCity(i % city_num) + "\"";
+    KVResponse response = Execute(&executor, request);
+    for (const Item& item : response.items().item()) {
+      if (KVIndex::GetField(item.value_info().value(), "city") == city) {
+        ++item_num;
+      }
+    }
+  }
+  printf("scan lookups:%d items:%lu latency:%luus\n", lookup_num, item_num,
+         (GetCurrentTime() - start_time) / lookup_num);
+  return 0;
+}
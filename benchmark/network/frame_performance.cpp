@@ -0,0 +1,159 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <arpa/inet.h>
+#include <glog/logging.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/utils/utils.h"
+#include "platform/common/network/frame.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[split|iov] [request_num] [data_size]\n"); }
+
+const int kPort = 20002;
+
+bool RecvAll(int fd, char* buf, size_t len) {
+  size_t pos = 0;
+  while (pos < len) {
+    int ret = recv(fd, buf + pos, len - pos, 0);
+    if (ret <= 0) {
+      return false;
+    }
+    pos += ret;
+  }
+  return true;
+}
+
+bool RecvFrame(int fd, std::string* data) {
+  char header[kFrameHeaderSize];
+  if (!RecvAll(fd, header, kFrameHeaderSize)) {
+    return false;
+  }
+  data->resize(DecodeFrameHeader(header));
+  return RecvAll(fd, data->data(), data->size());
+}
+
+// The header and the data in two sends on a socket with Nagle enabled, as
+// the sockets used to do.
+bool SendSplit(int fd, const std::string& data) {
+  char header[kFrameHeaderSize];
+  EncodeFrameHeader(data.size(), header);
+  return send(fd, header, kFrameHeaderSize, 0) ==
+             static_cast<int>(kFrameHeaderSize) &&
+         send(fd, data.data(), data.size(), 0) ==
+             static_cast<int>(data.size());
+}
+
+// The whole frame in one sendmsg on a socket with TCP_NODELAY.
+bool SendIov(int fd, const std::string& data) {
+  char header[kFrameHeaderSize];
+  EncodeFrameHeader(data.size(), header);
+  struct iovec iov[2] = {
+      {header, kFrameHeaderSize},
+      {const_cast<char*>(data.data()), data.size()},
+  };
+  return SendIov(fd, iov, 2) >= 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    ShowUsage();
+    exit(0);
+  }
+  std::string mode = argv[1];
+  int request_num = argc > 2 ? atoi(argv[2]) : 10000;
+  int data_size = argc > 3 ? atoi(argv[3]) : 200;
+  google::InitGoogleLogging(argv[0]);
+
+  bool use_iov = mode == "iov";
+  auto send_frame = [use_iov](int fd, const std::string& data) {
+    return use_iov ? SendIov(fd, data) : SendSplit(fd, data);
+  };
+  auto set_no_delay = [use_iov](int fd) {
+    int no_delay = use_iov;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+  };
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(kPort);
+  addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  int reuse = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+      listen(listen_fd, 1) != 0) {
+    LOG(ERROR) << "listen fail:" << strerror(errno);
+    return 1;
+  }
+
+  // Echoes each frame back.
+  std::thread server([&]() {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    set_no_delay(fd);
+    std::string data;
+    while (RecvFrame(fd, &data) && send_frame(fd, data)) {
+    }
+    close(fd);
+  });
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+    LOG(ERROR) << "connect fail:" << strerror(errno);
+    return 1;
+  }
+  set_no_delay(fd);
+
+  std::string data(data_size, 'a'), resp;
+  std::vector<uint64_t> latency;
+  for (int i = 0; i < request_num; ++i) {
+    uint64_t start_time = GetCurrentTime();
+    if (!send_frame(fd, data) || !RecvFrame(fd, &resp)) {
+      LOG(ERROR) << "round trip fail";
+      break;
+    }
+    latency.push_back(GetCurrentTime() - start_time);
+  }
+  close(fd);
+  server.join();
+  close(listen_fd);
+
+  if (latency.empty()) {
+    printf("no request done\n");
+    return 0;
+  }
+  std::sort(latency.begin(), latency.end());
+  printf("%s size:%d requests:%zu p50:%luus p99:%luus\n", mode.c_str(),
+         data_size, latency.size(), latency[latency.size() / 2],
+         latency[latency.size() * 99 / 100]);
+  return 0;
+}
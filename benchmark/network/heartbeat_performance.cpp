@@ -0,0 +1,187 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <string>
+#include <vector>
+
+#include "common/crypto/key_generator.h"
+#include "common/crypto/signature_verifier.h"
+#include "common/utils/utils.h"
+#include "platform/proto/resdb.pb.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[replica_num] [round]\n"); }
+
+KeyInfo GetPrivateKey(const SecretKey& key) {
+  KeyInfo info;
+  info.set_key(key.private_key());
+  info.set_hash_type(key.hash_type());
+  return info;
+}
+
+CertificateInfo GetCertInfo(const SecretKey& admin_key, int64_t node_id) {
+  CertificateInfo cert_info;
+  cert_info.set_node_id(node_id);
+  cert_info.mutable_admin_public_key()->set_key(admin_key.public_key());
+  cert_info.mutable_admin_public_key()->set_hash_type(admin_key.hash_type());
+  return cert_info;
+}
+
+// The certificate of a replica, signed by the admin.
+CertificateKey GetCertificateKey(SignatureVerifier* admin_verifier,
+                                 const SecretKey& key, int64_t node_id) {
+  CertificateKey cert_key;
+  auto* info = cert_key.mutable_public_key_info();
+  info->mutable_key()->set_key(key.public_key());
+  info->mutable_key()->set_hash_type(key.hash_type());
+  info->set_node_id(node_id);
+  info->set_type(CertificateKeyInfo::REPLICA);
+  info->set_ip("127.0.0.1");
+  info->set_port(10000 + node_id);
+  auto cert = admin_verifier->SignCertificateKeyInfo(*info);
+  assert(cert.ok());
+  *cert_key.mutable_certificate() = *cert;
+  return cert_key;
+}
+
+HeartBeatInfo GetBaseHeartBeat() {
+  HeartBeatInfo hb_info;
+  hb_info.set_sender(1);
+  hb_info.set_ip("127.0.0.1");
+  hb_info.set_port(10001);
+  hb_info.set_hb_version(GetCurrentTime());
+  hb_info.set_primary(1);
+  hb_info.set_version(1);
+  return hb_info;
+}
+
+// A heartbeat before the key set was versioned: every one carries all the
+// certificates.
+HeartBeatInfo GetOldHeartBeat(const std::vector<CertificateKey>& keys) {
+  HeartBeatInfo hb_info = GetBaseHeartBeat();
+  for (const auto& key : keys) {
+    *hb_info.add_public_keys() = key;
+    hb_info.add_node_version(GetCurrentTime());
+  }
+  return hb_info;
+}
+
+// A heartbeat once every peer holds the key set: no certificates, one
+// PeerInfo for each of the other replicas.
+HeartBeatInfo GetNewHeartBeat(int replica_num) {
+  HeartBeatInfo hb_info = GetBaseHeartBeat();
+  uint64_t now = GetCurrentTime();
+  hb_info.set_state(HeartBeatInfo::READY);
+  hb_info.set_key_version(replica_num);
+  hb_info.set_timestamp(now);
+  for (int i = 2; i <= replica_num; ++i) {
+    auto* peer_info = hb_info.add_peers();
+    peer_info->set_node_id(i);
+    peer_info->set_key_version(replica_num);
+    peer_info->set_timestamp(now - 60000000);
+    peer_info->set_delay(59000000);
+  }
+  return hb_info;
+}
+
+// Parse the heartbeat, check its signature and take in the certificates it
+// carries. need_verify checks each certificate against the admin key, which
+// the receiver did for every heartbeat before the key set was versioned.
+void Run(const std::string& name, const HeartBeatInfo& hb_info,
+         SignatureVerifier* sender, SignatureVerifier* receiver,
+         bool need_verify, int round) {
+  std::string data;
+  hb_info.SerializeToString(&data);
+  auto signature = sender->SignMessage(data);
+  assert(signature.ok());
+
+  int fail = 0;
+  uint64_t start_time = GetCurrentTime();
+  for (int r = 0; r < round; ++r) {
+    HeartBeatInfo recv_info;
+    if (!recv_info.ParseFromString(data) ||
+        !receiver->VerifyMessage(data, *signature)) {
+      fail++;
+      continue;
+    }
+    for (const auto& public_key : recv_info.public_keys()) {
+      if (need_verify) {
+        if (!receiver->VerifyKey(public_key.public_key_info(),
+                                 public_key.certificate())) {
+          fail++;
+        }
+      } else if (!receiver->AddPublicKey(public_key)) {
+        fail++;
+      }
+    }
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  printf("%s size:%lu keys:%d peers:%d us/hb:%.1f fail:%d\n", name.c_str(),
+         data.size(), hb_info.public_keys_size(), hb_info.peers_size(),
+         static_cast<double>(run_time) / round, fail);
+}
+
+int main(int argc, char** argv) {
+  int replica_num = argc > 1 ? atoi(argv[1]) : 16;
+  int round = argc > 2 ? atoi(argv[2]) : 1000;
+  if (replica_num <= 1 || round <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  SecretKey admin_key = KeyGenerator::GeneratorKeys(SignatureInfo::ED25519);
+  SignatureVerifier admin_verifier(GetPrivateKey(admin_key),
+                                   GetCertInfo(admin_key, 0));
+
+  std::vector<SecretKey> replica_keys;
+  std::vector<CertificateKey> cert_keys;
+  for (int i = 1; i <= replica_num; ++i) {
+    replica_keys.push_back(
+        KeyGenerator::GeneratorKeys(SignatureInfo::ED25519));
+    cert_keys.push_back(
+        GetCertificateKey(&admin_verifier, replica_keys.back(), i));
+  }
+
+  // Replica 1 sends, replica 2 receives and already holds the key set.
+  CertificateInfo sender_cert = GetCertInfo(admin_key, 1);
+  *sender_cert.mutable_public_key() = cert_keys[0];
+  SignatureVerifier sender(GetPrivateKey(replica_keys[0]), sender_cert);
+  CertificateInfo receiver_cert = GetCertInfo(admin_key, 2);
+  *receiver_cert.mutable_public_key() = cert_keys[1];
+  SignatureVerifier receiver(GetPrivateKey(replica_keys[1]), receiver_cert);
+  for (const auto& cert_key : cert_keys) {
+    receiver.AddPublicKey(cert_key);
+  }
+
+  HeartBeatInfo old_hb = GetOldHeartBeat(cert_keys);
+  HeartBeatInfo new_hb = GetNewHeartBeat(replica_num);
+  Run("old", old_hb, &sender, &receiver, true, round);
+  // The certificates are still attached until every peer acks the key set,
+  // a receiver holding them skips the check.
+  HeartBeatInfo new_with_keys = new_hb;
+  for (const auto& key : old_hb.public_keys()) {
+    *new_with_keys.add_public_keys() = key;
+  }
+  Run("new with keys", new_with_keys, &sender, &receiver, false, round);
+  Run("new", new_hb, &sender, &receiver, false, round);
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <future>
+#include <mutex>
+
+#include "common/crypto/digest.h"
+#include "common/utils/utils.h"
+#include "platform/consensus/ordering/pbft/catch_up_manager.h"
+
+using namespace resdb;
+
+void ShowUsage() {
+  printf(
+      "[seq_num] [replica_num] [rtt_us] [txn_us] [chunk_size] "
+      "[fetch_thread] [water_mark]\n");
+}
+
+// Serves the committed requests from memory. Each replica answers one call
+// at a time, taking a round trip plus txn_us for each request sent.
+class SimulatedTxnAccessor : public ResDBTxnAccessor {
+ public:
+  SimulatedTxnAccessor(const ResDBConfig& config,
+                       const std::vector<Request>& requests, int replica_num,
+                       int rtt_us, int txn_us)
+      : ResDBTxnAccessor(config),
+        requests_(requests),
+        replica_mutex_(replica_num),
+        rtt_us_(rtt_us),
+        txn_us_(txn_us) {}
+
+  absl::StatusOr<std::vector<Request>> GetRequestFromReplica(
+      uint64_t min_seq, uint64_t max_seq, const ReplicaInfo& replica) override {
+    std::unique_lock<std::mutex> lk(replica_mutex_[replica.id() - 1]);
+    usleep(rtt_us_ + txn_us_ * (max_seq - min_seq + 1));
+    return std::vector<Request>(requests_.begin() + min_seq - 1,
+                                requests_.begin() + max_seq);
+  }
+
+ private:
+  const std::vector<Request>& requests_;
+  std::vector<std::mutex> replica_mutex_;
+  int rtt_us_;
+  int txn_us_;
+};
+
+void Run(const std::vector<Request>& requests, const std::string& hash,
+         int replica_num, int rtt_us, int txn_us, int chunk_size,
+         int fetch_thread, int water_mark) {
+  ResDBConfig config({ReplicaInfo()}, ReplicaInfo());
+  SimulatedTxnAccessor accessor(config, requests, replica_num, rtt_us, txn_us);
+  std::vector<ReplicaInfo> replicas(replica_num);
+  for (int i = 0; i < replica_num; ++i) {
+    replicas[i].set_id(i + 1);
+  }
+
+  uint64_t start_time = GetCurrentTime();
+  uint64_t first_commit_time = 0;
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  CatchUpManager manager(
+      &accessor,
+      [&](std::unique_ptr<Request> request) {
+        if (first_commit_time == 0) {
+          first_commit_time = GetCurrentTime();
+        }
+      },
+      water_mark, chunk_size, fetch_thread);
+  manager.SetDoneFunc([&](uint64_t seq) { done.set_value(true); });
+  manager.AddTarget(0, "", requests.size(), hash, replicas);
+  done_future.get();
+  uint64_t run_time = GetCurrentTime() - start_time;
+  manager.Stop();
+
+  printf("seqs:%lu replicas:%d chunk:%d threads:%d catch-up time:%.3fs "
+         "first commit:%.3fs\n",
+         requests.size(), replica_num, chunk_size, fetch_thread,
+         run_time / 1e6, (first_commit_time - start_time) / 1e6);
+}
+
+int main(int argc, char** argv) {
+  int seq_num = argc > 1 ? atoi(argv[1]) : 100000;
+  int replica_num = argc > 2 ? atoi(argv[2]) : 3;
+  int rtt_us = argc > 3 ? atoi(argv[3]) : 2000;
+  int txn_us = argc > 4 ? atoi(argv[4]) : 10;
+  int chunk_size = argc > 5 ? atoi(argv[5]) : 1000;
+  int fetch_thread = argc > 6 ? atoi(argv[6]) : 4;
+  int water_mark = argc > 7 ? atoi(argv[7]) : 5000;
+  if (seq_num <= 0 || replica_num <= 0 || rtt_us < 0 || txn_us < 0 ||
+      chunk_size <= 0 || fetch_thread <= 0 || water_mark <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  std::vector<Request> requests(seq_num);
+  CheckPointDigest digest;
+  std::string hash;
+  std::vector<std::string> window;
+  for (int i = 0; i < seq_num; ++i) {
+    requests[i].set_seq(i + 1);
+    requests[i].set_data(std::string(128, 'a') + std::to_string(i));
+    requests[i].set_hash(CalculateSHA256(requests[i].data()).ToString());
+    window.push_back(requests[i].hash());
+    if (static_cast<int>(window.size()) == water_mark || i + 1 == seq_num) {
+      hash = digest.GetDigest(hash, window);
+      window.clear();
+    }
+  }
+
+  // A single fetch of the whole range from one replica, as the checkpoint
+  // manager used to do.
+  Run(requests, hash, replica_num, rtt_us, txn_us, seq_num, 1, water_mark);
+  Run(requests, hash, replica_num, rtt_us, txn_us, chunk_size, fetch_thread,
+      water_mark);
+  return 0;
+}
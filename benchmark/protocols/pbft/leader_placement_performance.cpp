@@ -0,0 +1,131 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "platform/consensus/execution/system_info.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[replica_num]\n"); }
+
+// Round trip times between the regions in ms: asia, eu, us-east, us-west.
+const int kRegionNum = 4;
+const double kRegionRtt[kRegionNum][kRegionNum] = {
+    {1, 220, 180, 110},
+    {220, 1, 80, 140},
+    {180, 80, 1, 60},
+    {110, 140, 60, 1},
+};
+const char* kRegionName[kRegionNum] = {"asia", "eu", "us-east", "us-west"};
+
+// Replica i + 1 sits in region i % kRegionNum, so the first primary of the
+// config is in the region furthest from the others.
+int GetRegion(int replica_idx) { return replica_idx % kRegionNum; }
+
+double GetRtt(int a, int b) { return kRegionRtt[GetRegion(a)][GetRegion(b)]; }
+
+// The time the quorum-th message arrives at each replica, if replica j sends
+// its message at send_time[j].
+std::vector<double> GetQuorumTime(const std::vector<double>& send_time,
+                                  int quorum) {
+  int n = send_time.size();
+  std::vector<double> quorum_time(n);
+  for (int i = 0; i < n; ++i) {
+    std::vector<double> arrive_time;
+    for (int j = 0; j < n; ++j) {
+      arrive_time.push_back(send_time[j] + (i == j ? 0 : GetRtt(i, j) / 2));
+    }
+    std::nth_element(arrive_time.begin(), arrive_time.begin() + quorum - 1,
+                     arrive_time.end());
+    quorum_time[i] = arrive_time[quorum - 1];
+  }
+  return quorum_time;
+}
+
+// The commit latency of a request a client sends to the proxy in its region:
+// forwarding to the primary, pre-prepare, prepare and commit, until a quorum
+// of the replicas has committed it.
+double GetCommitLatency(int replica_num, int primary_idx, int proxy_idx,
+                        int quorum) {
+  std::vector<double> pre_prepare(replica_num);
+  for (int i = 0; i < replica_num; ++i) {
+    pre_prepare[i] = i == primary_idx ? 0 : GetRtt(primary_idx, i) / 2;
+  }
+  std::vector<double> prepared = GetQuorumTime(pre_prepare, quorum);
+  std::vector<double> committed = GetQuorumTime(prepared, quorum);
+  std::nth_element(committed.begin(), committed.begin() + quorum - 1,
+                   committed.end());
+  double forward =
+      proxy_idx == primary_idx ? 0 : GetRtt(proxy_idx, primary_idx) / 2;
+  return forward + committed[quorum - 1];
+}
+
+void Run(const std::vector<ReplicaInfo>& replicas, const ResConfigData& data,
+         const std::string& name) {
+  ResDBConfig config(replicas, replicas[0], data);
+  SystemInfo system_info(config);
+  int replica_num = replicas.size();
+  int quorum = std::clamp(config.GetMinDataReceiveNum(), 1, replica_num);
+
+  // Only a view change moves the primary, so the first few views matter.
+  printf("%s:\n", name.c_str());
+  for (int view = 1; view <= replica_num; ++view) {
+    int primary_idx = system_info.GetPrimaryOfView(view) - 1;
+    double latency = 0;
+    // One client in each region, going through the proxy in its region.
+    for (int region = 0; region < kRegionNum; ++region) {
+      latency += GetCommitLatency(replica_num, primary_idx, region, quorum);
+    }
+    printf("  view:%d primary:%d in %s commit latency:%.1fms\n", view,
+           primary_idx + 1, kRegionName[GetRegion(primary_idx)],
+           latency / kRegionNum);
+  }
+}
+
+int main(int argc, char** argv) {
+  int replica_num = argc > 1 ? atoi(argv[1]) : 8;
+  if (replica_num < kRegionNum) {
+    ShowUsage();
+    exit(0);
+  }
+
+  std::vector<ReplicaInfo> replicas(replica_num);
+  for (int i = 0; i < replica_num; ++i) {
+    replicas[i].set_id(i + 1);
+    replicas[i].set_ip("127.0.0.1");
+    replicas[i].set_port(10000 + i);
+  }
+
+  ResConfigData latency_data;
+  for (int i = 0; i < replica_num; ++i) {
+    for (int j = i + 1; j < replica_num; ++j) {
+      auto latency = latency_data.add_replica_latency();
+      latency->set_src_id(i + 1);
+      latency->set_dst_id(j + 1);
+      latency->set_rtt_ms(GetRtt(i, j));
+    }
+  }
+
+  Run(replicas, ResConfigData(), "config order");
+  Run(replicas, latency_data, "latency aware order");
+  return 0;
+}
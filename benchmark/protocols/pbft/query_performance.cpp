@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/utils/utils.h"
+#include "platform/consensus/execution/system_info.h"
+#include "platform/consensus/ordering/pbft/checkpoint_manager.h"
+#include "platform/consensus/ordering/pbft/message_manager.h"
+#include "platform/consensus/ordering/pbft/query.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[txn_num] [data_size] [page_bytes] [hot_num]\n"); }
+
+// Builds one response for the whole range, as the query used to.
+void RunSingle(MessageManager* message_manager, uint64_t txn_num) {
+  uint64_t start_time = GetCurrentTime();
+  QueryResponse response;
+  for (uint64_t i = 1; i <= txn_num; ++i) {
+    Request* ret_request = message_manager->GetRequest(i);
+    if (ret_request == nullptr) {
+      break;
+    }
+    Request* txn = response.add_transactions();
+    txn->set_data(ret_request->data());
+    txn->set_hash(ret_request->hash());
+    txn->set_seq(ret_request->seq());
+    txn->set_proxy_id(ret_request->proxy_id());
+  }
+  std::string message_str = NetChannel::GetRawMessageString(response);
+  uint64_t run_time = GetCurrentTime() - start_time;
+  printf("single txns:%lu time:%.3fs message:%.1fMB\n", txn_num, run_time / 1e6,
+         message_str.size() / 1e6);
+}
+
+// Follows the cursor from min_seq to max_seq.
+void RunPaged(const std::string& name, Query* query, uint64_t min_seq,
+              uint64_t max_seq, uint64_t page_bytes) {
+  QueryRequest request;
+  request.set_min_seq(min_seq);
+  request.set_max_seq(max_seq);
+  request.set_max_bytes(page_bytes);
+
+  int pages = 0;
+  size_t max_page = 0;
+  uint64_t run_time = 0;
+  while (true) {
+    uint64_t start_time = GetCurrentTime();
+    std::string message_str = query->GetQueryPage(request);
+    run_time += GetCurrentTime() - start_time;
+    ResDBMessage message;
+    QueryResponse response;
+    if (!message.ParseFromString(message_str) ||
+        !response.ParseFromString(message.data())) {
+      printf("parse page fail\n");
+      return;
+    }
+    pages++;
+    max_page = std::max(max_page, message_str.size());
+    if (response.next_seq() == 0) {
+      break;
+    }
+    request.set_min_seq(response.next_seq());
+  }
+  printf("%s txns:%lu time:%.3fs pages:%d max page:%.1fMB\n", name.c_str(),
+         max_seq - min_seq + 1, run_time / 1e6, pages, max_page / 1e6);
+}
+
+int main(int argc, char** argv) {
+  int txn_num = argc > 1 ? atoi(argv[1]) : 1000000;
+  int data_size = argc > 2 ? atoi(argv[2]) : 128;
+  int page_bytes = argc > 3 ? atoi(argv[3]) : 4 << 20;
+  int hot_num = argc > 4 ? atoi(argv[4]) : 50000;
+  if (txn_num <= 0 || data_size <= 0 || page_bytes <= 0 || hot_num <= 0 ||
+      hot_num > txn_num) {
+    ShowUsage();
+    exit(0);
+  }
+
+  ResDBConfig config({ReplicaInfo()}, ReplicaInfo());
+  SystemInfo system_info(config);
+  CheckPointManager checkpoint_manager(config, nullptr, nullptr);
+  MessageManager message_manager(config, nullptr, &checkpoint_manager,
+                                 &system_info);
+  Query query(config, &message_manager);
+  for (int i = 1; i <= txn_num; ++i) {
+    auto request = std::make_unique<Request>();
+    request->set_seq(i);
+    request->set_proxy_id(1);
+    request->set_data(std::string(data_size, 'a' + i % 26));
+    request->set_hash(std::string(32, 'h'));
+    checkpoint_manager.GetTxnDB()->Put(std::move(request));
+  }
+
+  RunSingle(&message_manager, txn_num);
+  // The latest blocks, which explorers poll, are served from the cache the
+  // second time.
+  RunPaged("paged recent", &query, txn_num - hot_num + 1, txn_num,
+           page_bytes);
+  RunPaged("paged recent cached", &query, txn_num - hot_num + 1, txn_num,
+           page_bytes);
+  RunPaged("paged all", &query, 1, txn_num, page_bytes);
+  return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include "common/utils/utils.h"
+#include "interface/rdbc/net_channel.h"
+#include "platform/common/queue/lock_free_queue.h"
+#include "platform/consensus/ordering/common/framework/message_dispatcher.h"
+#include "platform/consensus/ordering/poe/algorithm/poe.h"
+
+using namespace resdb;
+using namespace resdb::poe;
+
+void ShowUsage() { printf("[txn_num] [data_size]\n"); }
+
+// Runs 4 replicas in process. Messages are framed the same way
+// common::Consensus sends them and every replica parses the frames back
+// before handing them to PoE.
+class Cluster {
+ public:
+  Cluster(int replica_num, bool typed)
+      : replica_num_(replica_num), typed_(typed) {
+    int f = (replica_num - 1) / 3;
+    for (int i = 1; i <= replica_num; ++i) {
+      queues_.push_back(std::make_unique<LockFreeQueue<std::string>>("poe"));
+    }
+    for (int i = 1; i <= replica_num; ++i) {
+      auto poe = std::make_unique<PoE>(i, f, replica_num, nullptr);
+      if (typed_) {
+        channels_.push_back(std::make_unique<ReplicaChannel>(this, i));
+        poe->SetChannel(channels_.back().get());
+      } else {
+        // The callbacks and the serialization used before ProtocolChannel.
+        poe->SetBroadcastCallFunc(
+            [this, i](int type, const google::protobuf::Message& msg) {
+              Request request;
+              msg.SerializeToString(request.mutable_data());
+              request.set_type(Request::TYPE_CUSTOM_CONSENSUS);
+              request.set_user_type(type);
+              request.set_sender_id(i);
+              Deliver(NetChannel::GetRawMessageString(request));
+              return 0;
+            });
+        poe->SetCommitFunc([this](const google::protobuf::Message& msg) {
+          committed_num_++;
+          return 0;
+        });
+      }
+      replicas_.push_back(std::move(poe));
+    }
+    dispatcher_.Register<Transaction, &PoE::ReceivePropose>(
+        MessageType::Propose);
+    dispatcher_.Register<Proposal, &PoE::ReceivePrepare>(MessageType::Prepare);
+    dispatcher_.Register<CheckpointInfo, &PoE::ReceiveCheckpoint>(
+        MessageType::Checkpoint);
+    for (int i = 0; i < replica_num; ++i) {
+      threads_.push_back(std::thread([this, i]() { Process(i); }));
+    }
+  }
+
+  ~Cluster() {
+    stop_ = true;
+    for (auto& th : threads_) {
+      th.join();
+    }
+  }
+
+  PoE* GetPrimary() { return replicas_[0].get(); }
+  uint64_t CommittedNum() const { return committed_num_; }
+
+ private:
+  // The channel of the replica id, standing in for common::Consensus.
+  class ReplicaChannel : public common::ProtocolChannel {
+   public:
+    ReplicaChannel(Cluster* cluster, int id) : cluster_(cluster), id_(id) {}
+
+    int SendMsg(int type, const google::protobuf::Message& msg,
+                int node_id) override {
+      return 0;
+    }
+
+    int Broadcast(int type, const google::protobuf::Message& msg) override {
+      Request request;
+      request.set_type(Request::TYPE_CUSTOM_CONSENSUS);
+      request.set_user_type(type);
+      request.set_sender_id(id_);
+      cluster_->Deliver(NetChannel::GetRawRequestString(request, msg));
+      return 0;
+    }
+
+    int CommitMsg(const google::protobuf::Message& msg) override {
+      cluster_->committed_num_++;
+      return 0;
+    }
+
+   private:
+    Cluster* cluster_;
+    int id_;
+  };
+
+  void Deliver(const std::string& data) {
+    for (auto& queue : queues_) {
+      queue->Push(std::make_unique<std::string>(data));
+    }
+  }
+
+  void Process(int idx) {
+    PoE* poe = replicas_[idx].get();
+    while (!stop_) {
+      std::unique_ptr<std::string> data = queues_[idx]->Pop();
+      if (data == nullptr) {
+        continue;
+      }
+      ResDBMessage message;
+      Request request;
+      if (!message.ParseFromString(*data) ||
+          !request.ParseFromString(message.data())) {
+        LOG(ERROR) << "parse message fail";
+        continue;
+      }
+      if (typed_) {
+        dispatcher_.Dispatch(poe, request.user_type(), request.sender_id(),
+                             request.data());
+        continue;
+      }
+      // The dispatching used before MessageDispatcher.
+      if (request.user_type() == MessageType::Propose) {
+        auto txn = std::make_unique<Transaction>();
+        txn->ParseFromString(request.data());
+        poe->ReceivePropose(request.sender_id(), std::move(txn));
+      } else if (request.user_type() == MessageType::Prepare) {
+        auto proposal = std::make_unique<Proposal>();
+        proposal->ParseFromString(request.data());
+        poe->ReceivePrepare(request.sender_id(), std::move(proposal));
+      } else if (request.user_type() == MessageType::Checkpoint) {
+        auto checkpoint = std::make_unique<CheckpointInfo>();
+        checkpoint->ParseFromString(request.data());
+        poe->ReceiveCheckpoint(request.sender_id(), std::move(checkpoint));
+      }
+    }
+  }
+
+ private:
+  int replica_num_;
+  bool typed_;
+  std::vector<std::unique_ptr<PoE>> replicas_;
+  std::vector<std::unique_ptr<ReplicaChannel>> channels_;
+  std::vector<std::unique_ptr<LockFreeQueue<std::string>>> queues_;
+  std::vector<std::thread> threads_;
+  common::MessageDispatcher<PoE> dispatcher_;
+  std::atomic<bool> stop_ = false;
+  std::atomic<uint64_t> committed_num_ = 0;
+};
+
+// Only the framing: a Propose is sent through the framework and parsed back
+// by the receiver, with no consensus work.
+class FramingChannel : public common::ProtocolChannel {
+ public:
+  int SendMsg(int type, const google::protobuf::Message& msg,
+              int node_id) override {
+    return 0;
+  }
+  int Broadcast(int type, const google::protobuf::Message& msg) override {
+    Request request;
+    request.set_type(Request::TYPE_CUSTOM_CONSENSUS);
+    request.set_user_type(type);
+    data = NetChannel::GetRawRequestString(request, msg);
+    return 0;
+  }
+  int CommitMsg(const google::protobuf::Message& msg) override { return 0; }
+
+  std::string data;
+};
+
+struct FramingReceiver {
+  bool ReceivePropose(int sender, std::unique_ptr<Transaction> txn) {
+    num++;
+    return true;
+  }
+  int num = 0;
+};
+
+void RunFraming(bool typed, int msg_num, int data_size) {
+  Transaction txn;
+  txn.set_data(std::string(data_size, 'a'));
+  txn.set_hash(std::string(32, 'h'));
+  txn.set_seq(1);
+
+  FramingChannel channel;
+  common::ProtocolChannel* channel_ptr = &channel;
+  std::string legacy_data;
+  std::function<int(int, const google::protobuf::Message&)> broadcast =
+      [&](int type, const google::protobuf::Message& msg) {
+        Request request;
+        msg.SerializeToString(request.mutable_data());
+        request.set_type(Request::TYPE_CUSTOM_CONSENSUS);
+        request.set_user_type(type);
+        legacy_data = NetChannel::GetRawMessageString(request);
+        return 0;
+      };
+  common::MessageDispatcher<FramingReceiver> dispatcher;
+  dispatcher.Register<Transaction, &FramingReceiver::ReceivePropose>(
+      MessageType::Propose);
+  FramingReceiver receiver;
+
+  uint64_t start_time = GetCurrentTime();
+  for (int i = 0; i < msg_num; ++i) {
+    if (typed) {
+      channel_ptr->Broadcast(MessageType::Propose, txn);
+    } else {
+      broadcast(MessageType::Propose, txn);
+    }
+    ResDBMessage message;
+    Request request;
+    message.ParseFromString(typed ? channel.data : legacy_data);
+    request.ParseFromString(message.data());
+    if (typed) {
+      dispatcher.Dispatch(&receiver, request.user_type(), request.sender_id(),
+                          request.data());
+    } else if (request.user_type() == MessageType::Propose) {
+      auto recv_txn = std::make_unique<Transaction>();
+      recv_txn->ParseFromString(request.data());
+      receiver.ReceivePropose(request.sender_id(), std::move(recv_txn));
+    }
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  printf("%s framing msg:%d data:%dB time:%.3fs throughput:%.0f msg/s\n",
+         typed ? "typed" : "legacy", receiver.num, data_size, run_time / 1e6,
+         msg_num * 1e6 / run_time);
+}
+
+void Run(bool typed, int txn_num, int data_size) {
+  int replica_num = 4;
+  Cluster cluster(replica_num, typed);
+  std::string data(data_size, 'a');
+
+  uint64_t start_time = GetCurrentTime();
+  for (int i = 0; i < txn_num; ++i) {
+    auto txn = std::make_unique<Transaction>();
+    txn->set_data(data);
+    txn->set_hash(std::to_string(i));
+    cluster.GetPrimary()->ReceiveTransaction(std::move(txn));
+  }
+  uint64_t total = static_cast<uint64_t>(txn_num) * replica_num;
+  while (cluster.CommittedNum() < total) {
+    usleep(100);
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  printf("%s txn:%d data:%dB time:%.3fs throughput:%.0f txn/s\n",
+         typed ? "typed" : "legacy", txn_num, data_size, run_time / 1e6,
+         txn_num * 1e6 / run_time);
+}
+
+int main(int argc, char** argv) {
+  int txn_num = argc > 1 ? atoi(argv[1]) : 100000;
+  int data_size = argc > 2 ? atoi(argv[2]) : 1024;
+  if (txn_num <= 0 || data_size < 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  RunFraming(false, txn_num * 10, data_size);
+  RunFraming(true, txn_num * 10, data_size);
+  Run(false, txn_num, data_size);
+  Run(true, txn_num, data_size);
+  return 0;
+}
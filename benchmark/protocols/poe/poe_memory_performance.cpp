@@ -0,0 +1,152 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include "common/utils/utils.h"
+#include "platform/common/queue/lock_free_queue.h"
+#include "platform/consensus/ordering/poe/algorithm/poe.h"
+
+using namespace resdb;
+using namespace resdb::poe;
+
+void ShowUsage() {
+  printf("[txn_num] [window_size] [checkpoint_interval] [data_size]\n");
+}
+
+struct Message {
+  int type;
+  int sender;
+  std::string data;
+};
+
+// Resident memory of the process in MB.
+double GetRSS() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  statm >> size >> resident;
+  return resident * sysconf(_SC_PAGESIZE) / 1024.0 / 1024.0;
+}
+
+// Runs the replicas in process, each handling its messages in its own
+// thread, and reports the memory and the committed proposals over time.
+int main(int argc, char** argv) {
+  int txn_num = argc > 1 ? atoi(argv[1]) : 200000;
+  int window_size = argc > 2 ? atoi(argv[2]) : 4096;
+  int checkpoint_interval = argc > 3 ? atoi(argv[3]) : 1024;
+  int data_size = argc > 4 ? atoi(argv[4]) : 1024;
+  if (txn_num <= 0 || window_size <= 0 || checkpoint_interval <= 0 ||
+      checkpoint_interval > window_size) {
+    ShowUsage();
+    exit(0);
+  }
+
+  int replica_num = 4;
+  int f = (replica_num - 1) / 3;
+  std::atomic<bool> stop = false;
+  std::atomic<uint64_t> committed_num = 0;
+  std::vector<std::unique_ptr<LockFreeQueue<Message>>> queues;
+  std::vector<std::unique_ptr<PoE>> replicas;
+  for (int i = 1; i <= replica_num; ++i) {
+    queues.push_back(std::make_unique<LockFreeQueue<Message>>("poe"));
+  }
+  for (int i = 1; i <= replica_num; ++i) {
+    auto poe = std::make_unique<PoE>(i, f, replica_num, nullptr, window_size,
+                                     checkpoint_interval);
+    poe->SetBroadcastCallFunc(
+        [&, i](int type, const google::protobuf::Message& msg) {
+          for (auto& queue : queues) {
+            auto message = std::make_unique<Message>();
+            message->type = type;
+            message->sender = i;
+            msg.SerializeToString(&message->data);
+            queue->Push(std::move(message));
+          }
+          return 0;
+        });
+    poe->SetCommitFunc([&](const google::protobuf::Message& msg) {
+      committed_num++;
+      return 0;
+    });
+    replicas.push_back(std::move(poe));
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < replica_num; ++i) {
+    threads.push_back(std::thread([&, i]() {
+      while (!stop) {
+        std::unique_ptr<Message> message = queues[i]->Pop();
+        if (message == nullptr) {
+          continue;
+        }
+        if (message->type == MessageType::Propose) {
+          auto txn = std::make_unique<Transaction>();
+          txn->ParseFromString(message->data);
+          replicas[i]->ReceivePropose(message->sender, std::move(txn));
+        } else if (message->type == MessageType::Prepare) {
+          auto proposal = std::make_unique<Proposal>();
+          proposal->ParseFromString(message->data);
+          replicas[i]->ReceivePrepare(message->sender, std::move(proposal));
+        } else if (message->type == MessageType::Checkpoint) {
+          auto checkpoint = std::make_unique<CheckpointInfo>();
+          checkpoint->ParseFromString(message->data);
+          replicas[i]->ReceiveCheckpoint(message->sender,
+                                         std::move(checkpoint));
+        }
+      }
+    }));
+  }
+
+  uint64_t start_time = GetCurrentTime();
+  std::thread client([&]() {
+    std::string data(data_size, 'a');
+    for (int i = 0; i < txn_num; ++i) {
+      auto txn = std::make_unique<Transaction>();
+      txn->set_data(data);
+      txn->set_hash(std::to_string(i));
+      replicas[0]->ReceiveTransaction(std::move(txn));
+    }
+  });
+
+  uint64_t total = static_cast<uint64_t>(txn_num) * replica_num;
+  while (committed_num < total) {
+    usleep(500000);
+    printf(
+        "time:%.1fs committed:%lu stable:%ld pending:%d rss:%.1fMB\n",
+        (GetCurrentTime() - start_time) / 1e6,
+        committed_num.load() / replica_num, replicas[0]->GetStableSeq(),
+        replicas[0]->GetPendingNum(), GetRSS());
+  }
+  uint64_t run_time = GetCurrentTime() - start_time;
+  client.join();
+  stop = true;
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  printf(
+      "replicas:%d txn:%d window:%d checkpoint:%d data:%dB time:%.3fs "
+      "throughput:%.0f txn/s rss:%.1fMB\n",
+      replica_num, txn_num, window_size, checkpoint_interval, data_size,
+      run_time / 1e6, txn_num * 1e6 / run_time, GetRSS());
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+
+#include "chain/storage/leveldb.h"
+#include "common/utils/utils.h"
+#include "executor/common/transaction_manager.h"
+#include "platform/consensus/execution/transaction_executor.h"
+#include "platform/consensus/recovery/recovery.h"
+#include "proto/kv/kv.pb.h"
+
+using namespace resdb;
+
+constexpr int kKeyNum = 100000;
+
+void ShowUsage() {
+  printf("[txn_num] [batch_size] [suffix_batch_num] [dir]\n");
+}
+
+// Sets the keys of the requests in the storage.
+class KVManager : public TransactionManager {
+ public:
+  KVManager(std::unique_ptr<Storage> storage) : storage_(std::move(storage)) {}
+
+  std::unique_ptr<google::protobuf::Message> ParseData(
+      const std::string& data) override {
+    auto kv_request = std::make_unique<KVRequest>();
+    if (!kv_request->ParseFromString(data)) {
+      return nullptr;
+    }
+    return kv_request;
+  }
+
+  std::unique_ptr<std::string> ExecuteRequest(
+      const google::protobuf::Message& request) override {
+    const KVRequest& kv_request = dynamic_cast<const KVRequest&>(request);
+    storage_->SetValue(kv_request.key(), kv_request.value());
+    return std::make_unique<std::string>();
+  }
+
+  Storage* GetStorage() override { return storage_.get(); }
+
+ private:
+  std::unique_ptr<Storage> storage_;
+};
+
+std::unique_ptr<Request> GetRequest(int seq, int batch_size) {
+  BatchUserRequest batch_request;
+  for (int i = 0; i < batch_size; ++i) {
+    KVRequest kv_request;
+    kv_request.set_cmd(KVRequest::SET);
+    kv_request.set_key("key_" +
+                       std::to_string((seq * batch_size + i) % kKeyNum));
+    kv_request.set_value(std::to_string(seq));
+    kv_request.SerializeToString(
+        batch_request.add_user_requests()->mutable_request()->mutable_data());
+  }
+  auto request = std::make_unique<Request>();
+  request->set_type(Request::TYPE_PRE_PREPARE);
+  request->set_seq(seq);
+  request->set_hash("hash_" + std::to_string(seq));
+  batch_request.SerializeToString(request->mutable_data());
+  return request;
+}
+
+ResDBConfig GetConfig(const std::string& dir, bool checkpoint) {
+  ResConfigData config_data;
+  config_data.set_recovery_enabled(true);
+  config_data.set_recovery_path(dir + "/wal_log/log");
+  config_data.set_recovery_buffer_size(1 << 20);
+  config_data.set_enable_execution_checkpoint(checkpoint);
+  return ResDBConfig({ReplicaInfo()}, ReplicaInfo(), config_data);
+}
+
+// A replica with a leveldb storage and a recovery log. It executes the
+// requests committed and the ones read from the log on start.
+class Replica {
+ public:
+  Replica(const ResDBConfig& config, const std::string& dir)
+      : system_info_(config) {
+    auto manager =
+        std::make_unique<KVManager>(storage::NewResLevelDB(dir + "/leveldb"));
+    Storage* storage = manager->GetStorage();
+    executor_ = std::make_unique<TransactionExecutor>(
+        config,
+        [&](std::unique_ptr<Request> request,
+            std::unique_ptr<BatchUserResponse>) {
+          // The responses may come out of order from the execution workers.
+          std::lock_guard<std::mutex> lk(mutex_);
+          executed_seq_ = std::max(executed_seq_, request->seq());
+        },
+        &system_info_, std::move(manager));
+    recovery_ =
+        std::make_unique<Recovery>(config, nullptr, &system_info_, storage);
+    executed_seq_ = executor_->GetMaxPendingExecutedSeq();
+  }
+
+  ~Replica() {
+    recovery_ = nullptr;
+    executor_->Stop();
+  }
+
+  // Returns the number of requests replayed.
+  int Recover() {
+    int num = 0;
+    recovery_->ReadLogs(
+        [&](const SystemInfoData& data) {},
+        [&](std::unique_ptr<Context> context,
+            std::unique_ptr<Request> request) {
+          executor_->Commit(std::move(request));
+          num++;
+        });
+    return num;
+  }
+
+  void Log(const Request& request) {
+    recovery_->AddRequest(nullptr, &request);
+  }
+
+  void Commit(std::unique_ptr<Request> request) {
+    executor_->Commit(std::move(request));
+  }
+
+  void WaitExecuted(uint64_t seq) {
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (executed_seq_ >= seq) {
+          return;
+        }
+      }
+      usleep(100);
+    }
+  }
+
+ private:
+  SystemInfo system_info_;
+  std::unique_ptr<TransactionExecutor> executor_;
+  std::unique_ptr<Recovery> recovery_;
+  std::mutex mutex_;
+  uint64_t executed_seq_ = 0;
+};
+
+// Commits batch_num batches, the last suffix_batch_num of which are only
+// logged as the replica stops before executing them, then restarts the
+// replica and waits until all of them are executed.
+void Run(bool checkpoint, int batch_num, int batch_size, int suffix_batch_num,
+         const std::string& base_dir) {
+  std::string dir = base_dir + (checkpoint ? "/checkpoint" : "/full");
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  ResDBConfig config = GetConfig(dir, checkpoint);
+
+  uint64_t run_time = 0;
+  {
+    uint64_t start_time = GetCurrentTime();
+    Replica replica(config, dir);
+    for (int seq = 1; seq <= batch_num; ++seq) {
+      std::unique_ptr<Request> request = GetRequest(seq, batch_size);
+      replica.Log(*request);
+      if (seq <= batch_num - suffix_batch_num) {
+        replica.Commit(std::move(request));
+      }
+    }
+    replica.WaitExecuted(batch_num - suffix_batch_num);
+    run_time = GetCurrentTime() - start_time;
+  }
+
+  // The restart time covers opening the storage, reading the log and
+  // executing the requests replayed.
+  uint64_t restart_time = 0;
+  int replay_num = 0;
+  {
+    uint64_t start_time = GetCurrentTime();
+    Replica replica(config, dir);
+    replay_num = replica.Recover();
+    replica.WaitExecuted(batch_num);
+    restart_time = GetCurrentTime() - start_time;
+  }
+
+  printf("execution checkpoint:%d txns:%lld batch size:%d run:%.3fs "
+         "restart:%.3fs replayed batches:%d\n",
+         checkpoint, static_cast<long long>(batch_num) * batch_size,
+         batch_size, run_time / 1e6, restart_time / 1e6, replay_num);
+  std::filesystem::remove_all(dir);
+}
+
+int main(int argc, char** argv) {
+  int64_t txn_num = argc > 1 ? atoll(argv[1]) : 10000000;
+  int batch_size = argc > 2 ? atoi(argv[2]) : 100;
+  int suffix_batch_num = argc > 3 ? atoi(argv[3]) : 100;
+  std::string dir = argc > 4 ? argv[4] : "/tmp/recovery_performance";
+  if (txn_num <= 0 || batch_size <= 0 || suffix_batch_num < 0 ||
+      txn_num / batch_size < suffix_batch_num) {
+    ShowUsage();
+    exit(0);
+  }
+  google::InitGoogleLogging(argv[0]);
+
+  int batch_num = txn_num / batch_size;
+  Run(false, batch_num, batch_size, suffix_batch_num, dir);
+  Run(true, batch_num, batch_size, suffix_batch_num, dir);
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <filesystem>
+
+#include "common/utils/utils.h"
+#include "executor/common/transaction_manager.h"
+#include "platform/consensus/ordering/pbft/consensus_manager_pbft.h"
+#include "platform/consensus/recovery/recovery.h"
+#include "platform/proto/checkpoint_info.pb.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[batch_num] [batch_size] [dir]\n"); }
+
+ResDBConfig GetConfig(const std::string& dir) {
+  std::vector<ReplicaInfo> replicas;
+  for (int i = 1; i <= 4; ++i) {
+    ReplicaInfo info;
+    info.set_id(i);
+    info.set_ip("127.0.0.1");
+    info.set_port(30000 + i);
+    replicas.push_back(info);
+  }
+  ResConfigData config_data;
+  config_data.set_recovery_enabled(true);
+  config_data.set_recovery_path(dir + "/wal_log/log");
+  config_data.set_recovery_buffer_size(1 << 20);
+  ResDBConfig config(replicas, replicas[0], config_data);
+  config.SetSignatureVerifierEnabled(false);
+  config.SetHeartBeatEnabled(false);
+  return config;
+}
+
+std::unique_ptr<Request> GetProposal(int seq, int batch_size) {
+  BatchUserRequest batch_request;
+  for (int i = 0; i < batch_size; ++i) {
+    batch_request.add_user_requests()->mutable_request()->set_data(
+        std::string(64, 'a'));
+  }
+  auto request = std::make_unique<Request>();
+  request->set_type(Request::TYPE_PRE_PREPARE);
+  request->set_sender_id(1);
+  request->set_seq(seq);
+  request->set_hash("hash_" + std::to_string(seq));
+  batch_request.SerializeToString(request->mutable_data());
+  return request;
+}
+
+// A checkpoint vote off the water mark. It is accepted and then dropped.
+std::unique_ptr<Request> GetCheckPoint() {
+  CheckPointData checkpoint_data;
+  checkpoint_data.set_seq(1);
+  auto request = std::make_unique<Request>();
+  request->set_type(Request::TYPE_CHECKPOINT);
+  request->set_sender_id(2);
+  checkpoint_data.SerializeToString(request->mutable_data());
+  return request;
+}
+
+// Starts a replica with batch_num proposals in its recovery log and
+// measures when it accepts its first message and when it has replayed its
+// logs. Before the staged startup both happened once the logs were
+// replayed. It runs a single replica, so neither the sync with the peers
+// nor the throughput of the cluster during a rolling restart is measured.
+void Run(int batch_num, int batch_size, const std::string& dir) {
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  ResDBConfig config = GetConfig(dir);
+  {
+    SystemInfo system_info(config);
+    Recovery recovery(config, nullptr, &system_info, nullptr);
+    Context context;
+    context.signature.set_signature("signature");
+    for (int seq = 1; seq <= batch_num; ++seq) {
+      recovery.AddRequest(&context, GetProposal(seq, batch_size).get());
+    }
+  }
+
+  uint64_t start_time = GetCurrentTime();
+  ConsensusManagerPBFT manager(config, std::make_unique<TransactionManager>());
+  manager.Start();
+  manager.ConsensusCommit(std::make_unique<Context>(), GetCheckPoint());
+  uint64_t accept_time = GetCurrentTime() - start_time;
+  while (manager.IsRecovering()) {
+    usleep(100);
+  }
+  uint64_t recovery_time = GetCurrentTime() - start_time;
+  manager.Stop();
+
+  printf("batches:%d batch size:%d first accepted message:%.3fms "
+         "logs replayed:%.3fms\n",
+         batch_num, batch_size, accept_time / 1e3, recovery_time / 1e3);
+  std::filesystem::remove_all(dir);
+}
+
+int main(int argc, char** argv) {
+  int batch_num = argc > 1 ? atoi(argv[1]) : 100000;
+  int batch_size = argc > 2 ? atoi(argv[2]) : 100;
+  std::string dir = argc > 3 ? argv[3] : "/tmp/startup_performance";
+  if (batch_num <= 0 || batch_size <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+  google::InitGoogleLogging(argv[0]);
+
+  Run(batch_num, batch_size, dir);
+  return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+#include <queue>
+#include <random>
+
+#include "common/utils/timer_wheel.h"
+#include "common/utils/utils.h"
+
+using namespace resdb;
+
+void ShowUsage() { printf("[timer_num] [timeout_ms]\n"); }
+
+// The bookkeeping the response manager used before the timer wheel: a heap
+// of deadlines holding a copy of the hash and a map checked on expiry.
+class HeapTimers {
+ public:
+  struct Timeout {
+    std::string hash;
+    uint64_t timeout_time;
+    bool operator<(const Timeout& other) const {
+      return timeout_time > other.timeout_time;
+    }
+  };
+
+  void Add(const std::string& hash, uint64_t timeout_us) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    heap_.push(Timeout{hash, GetCurrentTime() + timeout_us});
+    waiting_.insert(std::make_pair(hash, true));
+  }
+
+  void Cancel(const std::string& hash) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    waiting_.erase(hash);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::priority_queue<Timeout> heap_;
+  std::map<std::string, bool> waiting_;
+};
+
+std::vector<std::string> GetHashes(int timer_num) {
+  std::vector<std::string> hashes(timer_num);
+  for (int i = 0; i < timer_num; ++i) {
+    hashes[i] = std::string(24, 'h') + std::to_string(100000000 + i);
+  }
+  return hashes;
+}
+
+void RunHeap(const std::vector<std::string>& hashes, uint64_t timeout_us) {
+  HeapTimers timers;
+  uint64_t start_time = GetCurrentTime();
+  for (const std::string& hash : hashes) {
+    timers.Add(hash, timeout_us);
+  }
+  uint64_t add_time = GetCurrentTime() - start_time;
+  start_time = GetCurrentTime();
+  for (const std::string& hash : hashes) {
+    timers.Cancel(hash);
+  }
+  uint64_t cancel_time = GetCurrentTime() - start_time;
+  printf("heap  timers:%lu add:%.1fns cancel:%.1fns\n", hashes.size(),
+         add_time * 1e3 / hashes.size(), cancel_time * 1e3 / hashes.size());
+}
+
+void RunWheel(const std::vector<std::string>& hashes, uint64_t timeout_us) {
+  TimerWheel timer_wheel("benchmark");
+  std::vector<TimerWheel::TimerId> ids(hashes.size());
+  uint64_t start_time = GetCurrentTime();
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    const std::string* hash = &hashes[i];
+    ids[i] = timer_wheel.Add(timeout_us, [hash]() {});
+  }
+  uint64_t add_time = GetCurrentTime() - start_time;
+  start_time = GetCurrentTime();
+  for (TimerWheel::TimerId id : ids) {
+    timer_wheel.Cancel(id);
+  }
+  uint64_t cancel_time = GetCurrentTime() - start_time;
+  printf("wheel timers:%lu add:%.1fns cancel:%.1fns\n", hashes.size(),
+         add_time * 1e3 / hashes.size(), cancel_time * 1e3 / hashes.size());
+}
+
+// Let the timers spread over timeout_us fire and report how late they are.
+void RunWheelFire(int timer_num, uint64_t timeout_us) {
+  TimerWheel timer_wheel("benchmark");
+  std::atomic<int> fired = 0;
+  std::atomic<uint64_t> total_delay = 0, max_delay = 0;
+  std::mt19937 rand(0);
+  for (int i = 0; i < timer_num; ++i) {
+    uint64_t timeout = rand() % timeout_us;
+    uint64_t deadline = GetCurrentTime() + timeout;
+    timer_wheel.Add(timeout, [&, deadline]() {
+      uint64_t delay = GetCurrentTime() - deadline;
+      total_delay += delay;
+      if (delay > max_delay) {
+        max_delay = delay;
+      }
+      fired++;
+    });
+  }
+  while (fired < timer_num) {
+    usleep(10000);
+  }
+  printf("wheel fire timers:%d avg delay:%.3fms max delay:%.3fms\n",
+         timer_num, total_delay / 1e3 / timer_num, max_delay / 1e3);
+}
+
+int main(int argc, char** argv) {
+  int timer_num = argc > 1 ? atoi(argv[1]) : 1000000;
+  int timeout_ms = argc > 2 ? atoi(argv[2]) : 5000;
+  if (timer_num <= 0 || timeout_ms <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  std::vector<std::string> hashes = GetHashes(timer_num);
+  RunHeap(hashes, timeout_ms * 1000);
+  RunWheel(hashes, timeout_ms * 1000);
+  RunWheelFire(timer_num, timeout_ms * 1000);
+  return 0;
+}
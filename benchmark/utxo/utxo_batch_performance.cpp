@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <glog/logging.h>
+
+#include "common/crypto/key_generator.h"
+#include "common/crypto/signature_utils.h"
+#include "common/utils/utils.h"
+#include "executor/utxo/executor/utxo_executor.h"
+#include "proto/utxo/rpc.pb.h"
+
+using namespace resdb;
+using namespace resdb::utxo;
+
+void ShowUsage() { printf("[verify_thread_num] [rounds]\n"); }
+
+// Each transaction spends its own output of the genesis transaction, so all
+// of them are valid and the run only measures verification and spending.
+Config GetConfig(const SecretKey& key, int num, int verify_thread_num) {
+  Config config;
+  config.set_verify_thread_num(verify_thread_num);
+  UTXO* utxo = config.mutable_genesis_transactions()->add_transactions();
+  for (int i = 0; i < num; ++i) {
+    UTXOOut* out = utxo->add_out();
+    out->set_address("0001");
+    out->set_value(1000);
+    out->set_pub_key(key.public_key());
+  }
+  return config;
+}
+
+BatchUserRequest GetBatch(const SecretKey& key, int num) {
+  std::string sig =
+      utils::ECDSASignString(key.private_key(), "0001" + std::to_string(0));
+  BatchUserRequest batch;
+  for (int i = 0; i < num; ++i) {
+    UTXORequest request;
+    UTXO* utxo = request.mutable_utxo();
+    UTXOIn* in = utxo->add_in();
+    in->set_prev_id(0);
+    in->set_out_idx(i);
+    UTXOOut* out = utxo->add_out();
+    out->set_address("1234");
+    out->set_value(100);
+    utxo->set_address("0001");
+    utxo->set_sig(sig);
+    request.SerializeToString(
+        batch.add_user_requests()->mutable_request()->mutable_data());
+  }
+  return batch;
+}
+
+int main(int argc, char** argv) {
+  int verify_thread_num = argc > 1 ? atoi(argv[1]) : 0;
+  int rounds = argc > 2 ? atoi(argv[2]) : 10;
+  if (rounds <= 0) {
+    ShowUsage();
+    exit(0);
+  }
+
+  SecretKey key = KeyGenerator::GeneratorKeys(SignatureInfo::ECDSA);
+  for (int batch_size : {100, 1000}) {
+    BatchUserRequest batch = GetBatch(key, batch_size);
+    Config config = GetConfig(key, batch_size, verify_thread_num);
+
+    uint64_t serial_time = 0, batch_time = 0;
+    for (int r = 0; r < rounds; ++r) {
+      {
+        Wallet wallet;
+        Transaction transaction(config, &wallet);
+        UTXOExecutor executor(config, &transaction, &wallet);
+        uint64_t start = GetCurrentTime();
+        for (const auto& sub_request : batch.user_requests()) {
+          executor.ExecuteData(sub_request.request().data());
+        }
+        serial_time += GetCurrentTime() - start;
+      }
+      {
+        Wallet wallet;
+        Transaction transaction(config, &wallet);
+        UTXOExecutor executor(config, &transaction, &wallet);
+        uint64_t start = GetCurrentTime();
+        executor.ExecuteBatch(batch);
+        batch_time += GetCurrentTime() - start;
+      }
+    }
+
+    double total = static_cast<double>(batch_size) * rounds * 1000000;
+    printf("batch size:%d serial:%.0f tx/s batch:%.0f tx/s\n", batch_size,
+           total / serial_time, total / batch_time);
+  }
+}
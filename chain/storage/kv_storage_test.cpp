@@ -70,6 +70,56 @@ TEST_P(KVStorageTest, GetValue) {
   EXPECT_EQ(storage->GetValue("test_key"), "");
 }
 
+TEST_P(KVStorageTest, DelValue) {
+  EXPECT_EQ(storage->SetValue("test_key", "test_value"), 0);
+  EXPECT_EQ(storage->DelValue("test_key"), 0);
+  EXPECT_EQ(storage->GetValue("test_key"), "");
+  EXPECT_EQ(storage->GetAllValues(), "[]");
+}
+
+TEST_P(KVStorageTest, SetValues) {
+  EXPECT_EQ(storage->SetValue("test_key_2", "test_value_2"), 0);
+  EXPECT_EQ(storage->SetValues({{"test_key_1", "test_value_1"},
+                                {"test_key_2", ""},
+                                {"test_key_3", "test_value_3"}}),
+            0);
+  EXPECT_EQ(storage->GetValue("test_key_1"), "test_value_1");
+  EXPECT_EQ(storage->GetValue("test_key_2"), "");
+  EXPECT_EQ(storage->GetValue("test_key_3"), "test_value_3");
+}
+
+TEST_P(KVStorageTest, GetPrefix) {
+  EXPECT_EQ(storage->SetValue("a/2", "value_2"), 0);
+  EXPECT_EQ(storage->SetValue("a/1", "value_1"), 0);
+  EXPECT_EQ(storage->SetValue("b/1", "value_3"), 0);
+  EXPECT_EQ(storage->SetValue("a", "value_4"), 0);
+
+  std::vector<std::pair<std::string, std::string>> expected_list{
+      std::make_pair("a/1", "value_1"), std::make_pair("a/2", "value_2")};
+  EXPECT_EQ(storage->GetPrefix("a/"), expected_list);
+  expected_list.pop_back();
+  EXPECT_EQ(storage->GetPrefix("a/", 1), expected_list);
+  EXPECT_TRUE(storage->GetPrefix("c").empty());
+
+  // Go on from the key after the last one.
+  expected_list = {std::make_pair("a/2", "value_2")};
+  EXPECT_EQ(storage->GetPrefix("a/", 1, std::string("a/1") + '\0'),
+            expected_list);
+  EXPECT_TRUE(storage->GetPrefix("a/", 1, "b").empty());
+}
+
+TEST_P(KVStorageTest, SkipReservedKeys) {
+  EXPECT_EQ(storage->SetValue("a", "value_1"), 0);
+  EXPECT_EQ(storage->SetValue("\xff" "index/a", "value_2"), 0);
+
+  EXPECT_EQ(storage->GetAllValues(), "[value_1]");
+  EXPECT_EQ(storage->GetRange("a", "\xff\xff"), "[value_1]");
+
+  std::vector<std::pair<std::string, std::string>> expected_list{
+      std::make_pair("\xff" "index/a", "value_2")};
+  EXPECT_EQ(storage->GetPrefix("\xff"), expected_list);
+}
+
 TEST_P(KVStorageTest, GetEmptyValueWithVersion) {
   EXPECT_EQ(storage->GetValueWithVersion("test_key", 0),
             std::make_pair(std::string(""), 0));
@@ -228,6 +278,39 @@ TEST_P(KVStorageTest, BlockCacheSpecificTest) {
   }
 }
 
+TEST(KVStorageCheckpointTest, GetPrefixWithPendingWrites) {
+  std::string path = "/tmp/leveldb_test";
+  std::filesystem::remove_all(path);
+  std::unique_ptr<Storage> storage = NewResLevelDB(path);
+  EXPECT_TRUE(storage->EnableCheckpoint());
+  EXPECT_EQ(storage->SetValue("a/1", "value_1"), 0);
+  EXPECT_EQ(storage->SetValue("a/3", "value_3"), 0);
+  EXPECT_EQ(storage->SetValue("a/4", "value_4"), 0);
+  EXPECT_TRUE(storage->Checkpoint(1, ""));
+
+  // Held back until the next checkpoint.
+  EXPECT_EQ(storage->SetValue("a/2", "value_2"), 0);
+  EXPECT_EQ(storage->SetValue("a/3", "value_3_new"), 0);
+  EXPECT_EQ(storage->DelValue("a/4"), 0);
+  EXPECT_EQ(storage->SetValue("a/5", "value_5"), 0);
+  EXPECT_EQ(storage->SetValue("b/1", "value_6"), 0);
+
+  std::vector<std::pair<std::string, std::string>> expected_list{
+      std::make_pair("a/1", "value_1"), std::make_pair("a/2", "value_2"),
+      std::make_pair("a/3", "value_3_new"), std::make_pair("a/5", "value_5")};
+  EXPECT_EQ(storage->GetPrefix("a/"), expected_list);
+
+  expected_list = {std::make_pair("a/2", "value_2"),
+                   std::make_pair("a/3", "value_3_new")};
+  EXPECT_EQ(storage->GetPrefix("a/", 2, "a/2"), expected_list);
+
+  EXPECT_TRUE(storage->Checkpoint(2, ""));
+  expected_list = {
+      std::make_pair("a/1", "value_1"), std::make_pair("a/2", "value_2"),
+      std::make_pair("a/3", "value_3_new"), std::make_pair("a/5", "value_5")};
+  EXPECT_EQ(storage->GetPrefix("a/"), expected_list);
+}
+
 INSTANTIATE_TEST_CASE_P(KVStorageTest, KVStorageTest,
                         ::testing::Values(MEM, LEVELDB,
                                           LEVELDB_WITH_BLOCK_CACHE));
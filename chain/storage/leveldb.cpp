@@ -22,7 +22,9 @@
 #include <glog/logging.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <map>
 
 #include "chain/storage/proto/kv.pb.h"
 #include "leveldb/options.h"
@@ -30,6 +32,106 @@
 namespace resdb {
 namespace storage {
 
+namespace {
+
+// Keep the seq of the last execution checkpoint and the states of the
+// checkpoints, one key per seq. The leading 0 sorts them before the user
+// keys, which skip them when scanning.
+const std::string kCheckpointKey("\0checkpoint_seq", 15);
+const std::string kCheckpointStateKey("\0checkpoint_state", 17);
+
+bool IsCheckpointKey(const leveldb::Slice& key) {
+  return key == kCheckpointKey || key.starts_with(kCheckpointStateKey);
+}
+
+// The seq is big endian so that the states sort by seq.
+std::string CheckpointStateKey(uint64_t seq) {
+  std::string key = kCheckpointStateKey;
+  for (int i = 7; i >= 0; --i) {
+    key.push_back(static_cast<char>((seq >> (i * 8)) & 0xff));
+  }
+  return key;
+}
+
+bool ParseCheckpointStateKey(const leveldb::Slice& key, uint64_t* seq) {
+  if (key.size() != kCheckpointStateKey.size() + 8 ||
+      !key.starts_with(kCheckpointStateKey)) {
+    return false;
+  }
+  *seq = 0;
+  for (size_t i = kCheckpointStateKey.size(); i < key.size(); ++i) {
+    *seq = (*seq << 8) | static_cast<uint8_t>(key[i]);
+  }
+  return true;
+}
+
+// The reserved keys sort after the user keys, so the scans over the values
+// stop at the first one.
+bool IsReservedKey(const leveldb::Slice& key) {
+  return resdb::IsReservedKey(std::string_view(key.data(), key.size()));
+}
+
+// Finds the last value of a key put in a write batch.
+class PendingValue : public leveldb::WriteBatch::Handler {
+ public:
+  PendingValue(const std::string& key, std::string* value)
+      : key_(key), value_(value) {}
+
+  void Put(const leveldb::Slice& key, const leveldb::Slice& value) override {
+    if (key == key_) {
+      *value_ = value.ToString();
+      found_ = true;
+    }
+  }
+
+  void Delete(const leveldb::Slice& key) override {
+    if (key == key_) {
+      value_->clear();
+      found_ = true;
+    }
+  }
+
+  bool Found() const { return found_; }
+
+ private:
+  leveldb::Slice key_;
+  std::string* value_;
+  bool found_ = false;
+};
+
+// Collects the last writes put in a write batch to the keys under a prefix,
+// from start_key on. A removed key maps to nullopt.
+class PendingPrefix : public leveldb::WriteBatch::Handler {
+ public:
+  PendingPrefix(const std::string& prefix, const std::string& start_key,
+                std::map<std::string, std::optional<std::string>>* values)
+      : prefix_(prefix), start_key_(start_key), values_(values) {}
+
+  void Put(const leveldb::Slice& key, const leveldb::Slice& value) override {
+    if (Match(key)) {
+      (*values_)[key.ToString()] = value.ToString();
+    }
+  }
+
+  void Delete(const leveldb::Slice& key) override {
+    if (Match(key)) {
+      (*values_)[key.ToString()] = std::nullopt;
+    }
+  }
+
+ private:
+  bool Match(const leveldb::Slice& key) const {
+    return key.starts_with(prefix_) && key.compare(start_key_) >= 0 &&
+           !IsCheckpointKey(key);
+  }
+
+ private:
+  leveldb::Slice prefix_, start_key_;
+  std::map<std::string, std::optional<std::string>>* values_;
+};
+
+}  // namespace
+
 std::unique_ptr<Storage> NewResLevelDB(const std::string& path,
                                        std::optional<LevelDBInfo> config) {
   if (config == std::nullopt) {
@@ -82,6 +184,12 @@ void ResLevelDB::CreateDB(const std::string& path) {
   }
   assert(status.ok());
   LOG(ERROR) << "Successfully opened LevelDB";
+
+  std::string seq;
+  if (db_->Get(leveldb::ReadOptions(), kCheckpointKey, &seq).ok()) {
+    checkpoint_seq_ = std::stoull(seq);
+    LOG(ERROR) << "execution checkpoint seq:" << checkpoint_seq_;
+  }
 }
 
 ResLevelDB::~ResLevelDB() {
@@ -97,9 +205,42 @@ int ResLevelDB::SetValue(const std::string& key, const std::string& value) {
   if (block_cache_) {
     block_cache_->Put(key, value);
   }
+  std::lock_guard<std::mutex> lk(batch_mutex_);
   batch_.Put(key, value);
+  return MaybeWriteBatch();
+}
+
+int ResLevelDB::DelValue(const std::string& key) {
+  if (block_cache_) {
+    // An empty value falls through to the db.
+    block_cache_->Put(key, "");
+  }
+  std::lock_guard<std::mutex> lk(batch_mutex_);
+  batch_.Delete(key);
+  return MaybeWriteBatch();
+}
+
+int ResLevelDB::SetValues(
+    const std::vector<std::pair<std::string, std::string>>& values) {
+  if (block_cache_) {
+    for (const auto& [key, value] : values) {
+      block_cache_->Put(key, value);
+    }
+  }
+  std::lock_guard<std::mutex> lk(batch_mutex_);
+  for (const auto& [key, value] : values) {
+    if (value.empty()) {
+      batch_.Delete(key);
+    } else {
+      batch_.Put(key, value);
+    }
+  }
+  return MaybeWriteBatch();
+}
 
-  if (batch_.ApproximateSize() >= write_batch_size_) {
+int ResLevelDB::MaybeWriteBatch() {
+  // With checkpoints, the batch is only written by Checkpoint().
+  if (!checkpoint_enabled_ && batch_.ApproximateSize() >= write_batch_size_) {
     leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch_);
     if (status.ok()) {
       batch_.Clear();
@@ -122,7 +263,7 @@ std::string ResLevelDB::GetValue(const std::string& key) {
     found_in_cache = !value.empty();
   }
 
-  if (!found_in_cache) {
+  if (!found_in_cache && !GetPendingValue(key, &value)) {
     leveldb::Status status = db_->Get(leveldb::ReadOptions(), key, &value);
     if (!status.ok()) {
       value.clear();  // Ensure value is empty if not found in DB
@@ -133,11 +274,31 @@ std::string ResLevelDB::GetValue(const std::string& key) {
   return value;
 }
 
+bool ResLevelDB::GetPendingValue(const std::string& key, std::string* value) {
+  std::lock_guard<std::mutex> lk(batch_mutex_);
+  if (!checkpoint_enabled_) {
+    return false;
+  }
+  PendingValue pending(key, value);
+  batch_.Iterate(&pending);
+  return pending.Found();
+}
+
+void ResLevelDB::Prefetch(const std::string& key) {
+  // Read through leveldb so the blocks holding the key are loaded into its
+  // block cache. The value cache is not filled here as it is not
+  // thread safe and may hold newer values that are not flushed yet.
+  std::string value;
+  db_->Get(leveldb::ReadOptions(), key, &value);
+}
+
 std::string ResLevelDB::GetAllValues(void) {
   std::string values = "[";
   leveldb::Iterator* it = db_->NewIterator(leveldb::ReadOptions());
   bool first_iteration = true;
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+  for (it->SeekToFirst(); it->Valid() && !IsReservedKey(it->key());
+       it->Next()) {
+    if (IsCheckpointKey(it->key())) continue;
     if (!first_iteration) values.append(",");
     first_iteration = false;
     values.append(it->value().ToString());
@@ -153,8 +314,10 @@ std::string ResLevelDB::GetRange(const std::string& min_key,
   std::string values = "[";
   leveldb::Iterator* it = db_->NewIterator(leveldb::ReadOptions());
   bool first_iteration = true;
-  for (it->Seek(min_key); it->Valid() && it->key().ToString() <= max_key;
+  for (it->Seek(min_key); it->Valid() && it->key().ToString() <= max_key &&
+                          !IsReservedKey(it->key());
        it->Next()) {
+    if (IsCheckpointKey(it->key())) continue;
     if (!first_iteration) values.append(",");
     first_iteration = false;
     values.append(it->value().ToString());
@@ -165,6 +328,50 @@ std::string ResLevelDB::GetRange(const std::string& min_key,
   return values;
 }
 
+std::vector<std::pair<std::string, std::string>> ResLevelDB::GetPrefix(
+    const std::string& prefix, int limit, const std::string& start_key) {
+  std::string begin = std::max(prefix, start_key);
+  // The writes held back for a checkpoint take the place of the values in
+  // the db, as in GetPendingValue().
+  std::map<std::string, std::optional<std::string>> pending;
+  {
+    std::lock_guard<std::mutex> lk(batch_mutex_);
+    if (checkpoint_enabled_) {
+      PendingPrefix pending_prefix(prefix, begin, &pending);
+      batch_.Iterate(&pending_prefix);
+    }
+  }
+
+  std::vector<std::pair<std::string, std::string>> resp;
+  auto pending_it = pending.begin();
+  leveldb::Iterator* it = db_->NewIterator(leveldb::ReadOptions());
+  it->Seek(begin);
+  while (limit <= 0 || resp.size() < static_cast<size_t>(limit)) {
+    bool db_valid = it->Valid() && it->key().starts_with(prefix);
+    if (pending_it != pending.end() &&
+        (!db_valid || it->key().compare(pending_it->first) >= 0)) {
+      if (db_valid && it->key() == pending_it->first) {
+        it->Next();
+      }
+      if (pending_it->second.has_value()) {
+        resp.push_back(std::make_pair(pending_it->first, *pending_it->second));
+      }
+      ++pending_it;
+      continue;
+    }
+    if (!db_valid) {
+      break;
+    }
+    if (!IsCheckpointKey(it->key())) {
+      resp.push_back(
+          std::make_pair(it->key().ToString(), it->value().ToString()));
+    }
+    it->Next();
+  }
+  delete it;
+  return resp;
+}
+
 bool ResLevelDB::UpdateMetrics() {
   if (block_cache_ == nullptr) {
     return false;
@@ -179,6 +386,11 @@ bool ResLevelDB::UpdateMetrics() {
 }
 
 bool ResLevelDB::Flush() {
+  std::lock_guard<std::mutex> lk(batch_mutex_);
+  if (checkpoint_enabled_) {
+    // The batch only holds the writes of a request being executed.
+    return true;
+  }
   leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch_);
   if (status.ok()) {
     batch_.Clear();
@@ -188,6 +400,56 @@ bool ResLevelDB::Flush() {
   return false;
 }
 
+bool ResLevelDB::EnableCheckpoint() {
+  std::lock_guard<std::mutex> lk(batch_mutex_);
+  checkpoint_enabled_ = true;
+  return true;
+}
+
+bool ResLevelDB::Checkpoint(uint64_t seq, const std::string& state) {
+  std::lock_guard<std::mutex> lk(batch_mutex_);
+  batch_.Put(kCheckpointKey, std::to_string(seq));
+  batch_.Put(CheckpointStateKey(seq), state);
+  leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch_);
+  if (!status.ok()) {
+    LOG(ERROR) << "write checkpoint:" << seq << " fail:" << status.ToString();
+    return false;
+  }
+  batch_.Clear();
+  checkpoint_seq_ = seq;
+  return true;
+}
+
+uint64_t ResLevelDB::GetCheckpointSeq() { return checkpoint_seq_; }
+
+std::vector<std::pair<uint64_t, std::string>>
+ResLevelDB::GetCheckpointStates() {
+  std::vector<std::pair<uint64_t, std::string>> states;
+  leveldb::Iterator* it = db_->NewIterator(leveldb::ReadOptions());
+  for (it->Seek(kCheckpointStateKey);
+       it->Valid() && it->key().starts_with(kCheckpointStateKey); it->Next()) {
+    uint64_t seq = 0;
+    if (ParseCheckpointStateKey(it->key(), &seq)) {
+      states.emplace_back(seq, it->value().ToString());
+    }
+  }
+  delete it;
+  return states;
+}
+
+void ResLevelDB::DropCheckpointStates(uint64_t seq) {
+  std::string end_key = CheckpointStateKey(seq);
+  std::lock_guard<std::mutex> lk(batch_mutex_);
+  leveldb::Iterator* it = db_->NewIterator(leveldb::ReadOptions());
+  for (it->Seek(kCheckpointStateKey);
+       it->Valid() && it->key().starts_with(kCheckpointStateKey) &&
+       it->key().compare(end_key) <= 0;
+       it->Next()) {
+    batch_.Delete(it->key());
+  }
+  delete it;
+}
+
 int ResLevelDB::SetValueWithVersion(const std::string& key,
                                     const std::string& value, int version) {
   std::string value_str = GetValue(key);
@@ -248,7 +510,9 @@ std::map<std::string, std::pair<std::string, int>> ResLevelDB::GetAllItems() {
   std::map<std::string, std::pair<std::string, int>> resp;
 
   leveldb::Iterator* it = db_->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+  for (it->SeekToFirst(); it->Valid() && !IsReservedKey(it->key());
+       it->Next()) {
+    if (IsCheckpointKey(it->key())) continue;
     ValueHistory history;
     if (!history.ParseFromString(it->value().ToString()) ||
         history.value_size() == 0) {
@@ -269,8 +533,10 @@ std::map<std::string, std::pair<std::string, int>> ResLevelDB::GetKeyRange(
   std::map<std::string, std::pair<std::string, int>> resp;
 
   leveldb::Iterator* it = db_->NewIterator(leveldb::ReadOptions());
-  for (it->Seek(min_key); it->Valid() && it->key().ToString() <= max_key;
+  for (it->Seek(min_key); it->Valid() && it->key().ToString() <= max_key &&
+                          !IsReservedKey(it->key());
        it->Next()) {
+    if (IsCheckpointKey(it->key())) continue;
     ValueHistory history;
     if (!history.ParseFromString(it->value().ToString()) ||
         history.value_size() == 0) {
@@ -19,7 +19,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 
@@ -45,9 +47,15 @@ class ResLevelDB : public Storage {
   virtual ~ResLevelDB();
   int SetValue(const std::string& key, const std::string& value) override;
   std::string GetValue(const std::string& key) override;
+  int DelValue(const std::string& key) override;
+  int SetValues(
+      const std::vector<std::pair<std::string, std::string>>& values) override;
   std::string GetAllValues(void) override;
   std::string GetRange(const std::string& min_key,
                        const std::string& max_key) override;
+  std::vector<std::pair<std::string, std::string>> GetPrefix(
+      const std::string& prefix, int limit = 0,
+      const std::string& start_key = "") override;
 
   int SetValueWithVersion(const std::string& key, const std::string& value,
                           int version) override;
@@ -71,14 +79,29 @@ class ResLevelDB : public Storage {
 
   bool Flush() override;
 
+  void Prefetch(const std::string& key) override;
+
+  bool EnableCheckpoint() override;
+  bool Checkpoint(uint64_t seq, const std::string& state) override;
+  uint64_t GetCheckpointSeq() override;
+  std::vector<std::pair<uint64_t, std::string>> GetCheckpointStates() override;
+  void DropCheckpointStates(uint64_t seq) override;
+
  private:
   void CreateDB(const std::string& path);
+  bool GetPendingValue(const std::string& key, std::string* value);
+  // Write the batch once it is large enough. batch_mutex_ must be held.
+  int MaybeWriteBatch();
 
  private:
   std::unique_ptr<leveldb::DB> db_ = nullptr;
   ::leveldb::WriteBatch batch_;
   unsigned int write_buffer_size_ = 64 << 20;
   unsigned int write_batch_size_ = 1;
+  // Guards batch_, which the query path may read while it is written.
+  std::mutex batch_mutex_;
+  bool checkpoint_enabled_ = false;
+  std::atomic<uint64_t> checkpoint_seq_ = 0;
 
  protected:
   Stats* global_stats_ = nullptr;
@@ -29,6 +29,9 @@ namespace resdb {
 namespace storage {
 namespace {
 
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
 enum class CacheConfig { DISABLED, ENABLED };
 
 class TestableResLevelDB : public ResLevelDB {
@@ -112,6 +115,59 @@ INSTANTIATE_TEST_CASE_P(LevelDBTest, LevelDBTest,
                         ::testing::Values(CacheConfig::ENABLED,
                                           CacheConfig::DISABLED));
 
+TEST(LevelDBCheckpointTest, WriteValuesAtCheckpoint) {
+  std::string path = "/tmp/leveldb_checkpoint_test";
+  std::filesystem::remove_all(path);
+  {
+    std::unique_ptr<Storage> storage = NewResLevelDB(path);
+    EXPECT_EQ(storage->GetCheckpointSeq(), 0);
+    EXPECT_TRUE(storage->EnableCheckpoint());
+
+    EXPECT_EQ(storage->SetValue("key1", "value1"), 0);
+    EXPECT_EQ(storage->GetValue("key1"), "value1");
+    EXPECT_EQ(storage->GetAllValues(), "[]");
+    EXPECT_TRUE(storage->Checkpoint(1, "state1"));
+    EXPECT_EQ(storage->GetCheckpointSeq(), 1);
+    EXPECT_THAT(storage->GetCheckpointStates(),
+                ElementsAre(Pair(1, "state1")));
+    EXPECT_EQ(storage->GetAllValues(), "[value1]");
+
+    // Not written without a checkpoint.
+    EXPECT_EQ(storage->SetValue("key2", "value2"), 0);
+    EXPECT_TRUE(storage->Flush());
+  }
+  {
+    std::unique_ptr<Storage> storage = NewResLevelDB(path);
+    EXPECT_EQ(storage->GetCheckpointSeq(), 1);
+    EXPECT_THAT(storage->GetCheckpointStates(),
+                ElementsAre(Pair(1, "state1")));
+    EXPECT_EQ(storage->GetValue("key1"), "value1");
+    EXPECT_EQ(storage->GetValue("key2"), "");
+    EXPECT_EQ(storage->GetRange("", "key9"), "[value1]");
+  }
+}
+
+TEST(LevelDBCheckpointTest, DropStates) {
+  std::string path = "/tmp/leveldb_checkpoint_test";
+  std::filesystem::remove_all(path);
+  std::unique_ptr<Storage> storage = NewResLevelDB(path);
+  EXPECT_TRUE(storage->EnableCheckpoint());
+  for (uint64_t seq = 1; seq <= 3; ++seq) {
+    EXPECT_TRUE(storage->Checkpoint(seq, "state" + std::to_string(seq)));
+  }
+  EXPECT_THAT(
+      storage->GetCheckpointStates(),
+      ElementsAre(Pair(1, "state1"), Pair(2, "state2"), Pair(3, "state3")));
+
+  // Removed with the next checkpoint.
+  storage->DropCheckpointStates(2);
+  EXPECT_EQ(storage->GetCheckpointStates().size(), 3);
+  EXPECT_TRUE(storage->Checkpoint(4, "state4"));
+  EXPECT_THAT(storage->GetCheckpointStates(),
+              ElementsAre(Pair(3, "state3"), Pair(4, "state4")));
+  EXPECT_EQ(storage->GetAllValues(), "[]");
+}
+
 }  // namespace
 }  // namespace storage
 }  // namespace resdb
\ No newline at end of file
@@ -21,6 +21,8 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 namespace resdb {
 namespace storage {
 
@@ -33,10 +35,17 @@ int MemoryDB::SetValue(const std::string& key, const std::string& value) {
   return 0;
 }
 
+int MemoryDB::DelValue(const std::string& key) {
+  kv_map_.erase(key);
+  return 0;
+}
+
 std::string MemoryDB::GetAllValues(void) {
   std::string values = "[";
   bool first_iteration = true;
-  for (auto kv : kv_map_) {
+  for (const auto& kv : kv_map_) {
+    // The reserved keys sort last.
+    if (IsReservedKey(kv.first)) break;
     if (!first_iteration) values.append(",");
     first_iteration = false;
     values.append(kv.second);
@@ -49,17 +58,31 @@ std::string MemoryDB::GetRange(const std::string& min_key,
                                const std::string& max_key) {
   std::string values = "[";
   bool first_iteration = true;
-  for (auto kv : kv_map_) {
-    if (kv.first >= min_key && kv.first <= max_key) {
-      if (!first_iteration) values.append(",");
-      first_iteration = false;
-      values.append(kv.second);
-    }
+  for (auto it = kv_map_.lower_bound(min_key);
+       it != kv_map_.end() && it->first <= max_key; ++it) {
+    if (IsReservedKey(it->first)) break;
+    if (!first_iteration) values.append(",");
+    first_iteration = false;
+    values.append(it->second);
   }
   values.append("]");
   return values;
 }
 
+std::vector<std::pair<std::string, std::string>> MemoryDB::GetPrefix(
+    const std::string& prefix, int limit, const std::string& start_key) {
+  std::vector<std::pair<std::string, std::string>> resp;
+  for (auto it = kv_map_.lower_bound(std::max(prefix, start_key));
+       it != kv_map_.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+       ++it) {
+    if (limit > 0 && resp.size() >= static_cast<size_t>(limit)) {
+      break;
+    }
+    resp.push_back(*it);
+  }
+  return resp;
+}
+
 std::string MemoryDB::GetValue(const std::string& key) {
   auto search = kv_map_.find(key);
   if (search != kv_map_.end())
@@ -109,7 +132,8 @@ std::map<std::string, std::pair<std::string, int>> MemoryDB::GetAllItems() {
   std::map<std::string, std::pair<std::string, int>> resp;
 
   for (const auto& it : kv_map_with_v_) {
-    resp.insert(std::make_pair(it.first, it.second.back()));
+    if (IsReservedKey(it.first)) break;
+    resp.insert(resp.end(), std::make_pair(it.first, it.second.back()));
   }
   return resp;
 }
@@ -118,10 +142,10 @@ std::map<std::string, std::pair<std::string, int>> MemoryDB::GetKeyRange(
     const std::string& min_key, const std::string& max_key) {
   LOG(ERROR) << "min key:" << min_key << " max key:" << max_key;
   std::map<std::string, std::pair<std::string, int>> resp;
-  for (const auto& it : kv_map_with_v_) {
-    if (it.first >= min_key && it.first <= max_key) {
-      resp.insert(std::make_pair(it.first, it.second.back()));
-    }
+  for (auto it = kv_map_with_v_.lower_bound(min_key);
+       it != kv_map_with_v_.end() && it->first <= max_key; ++it) {
+    if (IsReservedKey(it->first)) break;
+    resp.insert(resp.end(), std::make_pair(it->first, it->second.back()));
   }
   return resp;
 }
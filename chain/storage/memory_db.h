@@ -55,10 +55,14 @@ class MemoryDB : public Storage {
 
   int SetValue(const std::string& key, const std::string& value);
   std::string GetValue(const std::string& key);
+  int DelValue(const std::string& key) override;
 
   std::string GetAllValues() override;
   std::string GetRange(const std::string& min_key,
                        const std::string& max_key) override;
+  std::vector<std::pair<std::string, std::string>> GetPrefix(
+      const std::string& prefix, int limit = 0,
+      const std::string& start_key = "") override;
 
   int SetValueWithVersion(const std::string& key, const std::string& value,
                           int version) override;
@@ -79,8 +83,9 @@ class MemoryDB : public Storage {
                                                          int number) override;
 
  private:
-  std::unordered_map<std::string, std::string> kv_map_;
-  std::unordered_map<std::string, std::list<std::pair<std::string, int>>>
+  // Ordered for the range and prefix reads.
+  std::map<std::string, std::string> kv_map_;
+  std::map<std::string, std::list<std::pair<std::string, int>>>
       kv_map_with_v_;
 };
 
@@ -32,6 +32,8 @@ class MockStorage : public Storage {
   MOCK_METHOD(std::string, GetAllValues, (), (override));
   MOCK_METHOD(std::string, GetRange, (const std::string&, const std::string&),
               (override));
+  MOCK_METHOD((std::vector<std::pair<std::string, std::string>>), GetPrefix,
+              (const std::string&, int, const std::string&), (override));
 
   MOCK_METHOD(int, SetValueWithVersion,
               (const std::string& key, const std::string& value, int version),
@@ -51,6 +53,16 @@ class MockStorage : public Storage {
   MOCK_METHOD(ValuesType, GetTopHistory, (const std::string&, int), (override));
 
   MOCK_METHOD(bool, Flush, (), (override));
+  MOCK_METHOD(int, DelValue, (const std::string& key), (override));
+  MOCK_METHOD(int, SetValues,
+              ((const std::vector<std::pair<std::string, std::string>>&)),
+              (override));
+  MOCK_METHOD(bool, EnableCheckpoint, (), (override));
+  MOCK_METHOD(bool, Checkpoint, (uint64_t, const std::string&), (override));
+  MOCK_METHOD(uint64_t, GetCheckpointSeq, (), (override));
+  MOCK_METHOD((std::vector<std::pair<uint64_t, std::string>>),
+              GetCheckpointStates, (), (override));
+  MOCK_METHOD(void, DropCheckpointStates, (uint64_t), (override));
 };
 
 }  // namespace resdb
@@ -19,12 +19,24 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace resdb {
 
+// The keys starting with kReservedKeyPrefix hold the data the layers above
+// keep next to the values, like secondary indexes. They sort after the
+// other keys and are left out of GetAllValues, GetRange, GetAllItems and
+// GetKeyRange. GetPrefix returns them only for a prefix asking for them.
+constexpr char kReservedKeyPrefix = '\xff';
+
+inline bool IsReservedKey(std::string_view key) {
+  return !key.empty() && key[0] == kReservedKeyPrefix;
+}
+
 class Storage {
  public:
   Storage() = default;
@@ -35,6 +47,14 @@ class Storage {
   virtual std::string GetAllValues() = 0;
   virtual std::string GetRange(const std::string& min_key,
                                const std::string& max_key) = 0;
+  // Return the <key, value> of the keys starting with prefix in key order,
+  // at most limit of them if limit > 0. The keys before start_key are
+  // skipped, so a scan can go on from the key after the last one returned.
+  virtual std::vector<std::pair<std::string, std::string>> GetPrefix(
+      const std::string& prefix, int limit = 0,
+      const std::string& start_key = "") {
+    return {};
+  }
 
   virtual int SetValueWithVersion(const std::string& key,
                                   const std::string& value, int version) = 0;
@@ -55,6 +75,44 @@ class Storage {
       const std::string& key, int number) = 0;
 
   virtual bool Flush() { return true; };
+
+  // Remove the key. Getting it afterwards returns an empty value.
+  virtual int DelValue(const std::string& key) { return SetValue(key, ""); }
+
+  // Write the values as one batch. A key with an empty value is removed.
+  virtual int SetValues(
+      const std::vector<std::pair<std::string, std::string>>& values) {
+    for (const auto& [key, value] : values) {
+      int ret = value.empty() ? DelValue(key) : SetValue(key, value);
+      if (ret != 0) {
+        return ret;
+      }
+    }
+    return 0;
+  }
+
+  // Execution checkpoints. Once enabled, the values set are held back until
+  // Checkpoint(seq, state) writes them together with seq, the request they
+  // come from, and the state of the caller at seq in one atomic write. The
+  // states are kept per seq, so a state only needs to hold what changed with
+  // its request. Returns false if the storage does not support it.
+  virtual bool EnableCheckpoint() { return false; }
+  virtual bool Checkpoint(uint64_t seq, const std::string& state) {
+    return false;
+  }
+  // The seq of the last checkpoint written, 0 if there is none.
+  virtual uint64_t GetCheckpointSeq() { return 0; }
+  // The states kept, in the order of their seq.
+  virtual std::vector<std::pair<uint64_t, std::string>> GetCheckpointStates() {
+    return {};
+  }
+  // The states up to seq are no longer needed. They are removed by the next
+  // checkpoint write.
+  virtual void DropCheckpointStates(uint64_t seq) {}
+
+  // Load the data of key into the cache ahead of its use. It may be called
+  // concurrently with the other functions and must not change the value.
+  virtual void Prefetch(const std::string& key) {}
 };
 
 }  // namespace resdb
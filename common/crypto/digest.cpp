@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/crypto/digest.h"
+
+#include <cryptopp/sha.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace resdb {
+
+namespace {
+
+// Fewer inputs than this are not worth handing to another thread.
+constexpr int kMinTaskSize = 16;
+
+void HashRange(const std::vector<std::string_view>& inputs, size_t begin,
+               size_t end, std::vector<Digest>* digests) {
+  CryptoPP::SHA256 sha;
+  for (size_t i = begin; i < end; ++i) {
+    sha.CalculateDigest(
+        (*digests)[i].data(),
+        reinterpret_cast<const CryptoPP::byte*>(inputs[i].data()),
+        inputs[i].size());
+  }
+}
+
+}  // namespace
+
+static_assert(Digest::kSize == CryptoPP::SHA256::DIGESTSIZE);
+
+std::string Digest::ToString() const {
+  return std::string(reinterpret_cast<const char*>(bytes_.data()), kSize);
+}
+
+bool Digest::Equals(std::string_view hash) const {
+  return hash.size() == kSize && memcmp(hash.data(), bytes_.data(), kSize) == 0;
+}
+
+Digest CalculateSHA256(std::string_view data) {
+  Digest digest;
+  CryptoPP::SHA256().CalculateDigest(
+      digest.data(), reinterpret_cast<const CryptoPP::byte*>(data.data()),
+      data.size());
+  return digest;
+}
+
+void CalculateSHA256Batch(const std::vector<std::string_view>& inputs,
+                          std::vector<Digest>* digests, ThreadPool* pool) {
+  digests->resize(inputs.size());
+  int num = inputs.size();
+  int task_num =
+      pool == nullptr ? 1 : std::min(pool->Size() + 1, num / kMinTaskSize);
+  if (task_num <= 1) {
+    HashRange(inputs, 0, num, digests);
+    return;
+  }
+  pool->ParallelFor(task_num, [&](int task) {
+    HashRange(inputs, static_cast<int64_t>(num) * task / task_num,
+              static_cast<int64_t>(num) * (task + 1) / task_num, digests);
+  });
+}
+
+}  // namespace resdb
@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/utils/thread_pool.h"
+
+namespace resdb {
+
+// A SHA-256 digest held by value, so that computing or comparing one does
+// not allocate.
+class Digest {
+ public:
+  static constexpr size_t kSize = 32;
+
+  Digest() : bytes_{} {}
+
+  uint8_t* data() { return bytes_.data(); }
+  const uint8_t* data() const { return bytes_.data(); }
+
+  // The raw bytes, as returned by SignatureVerifier::CalculateHash().
+  std::string ToString() const;
+
+  // Compare with a digest kept as raw bytes in a string.
+  bool Equals(std::string_view hash) const;
+
+  bool operator==(const Digest& other) const { return bytes_ == other.bytes_; }
+  bool operator!=(const Digest& other) const { return bytes_ != other.bytes_; }
+
+ private:
+  std::array<uint8_t, kSize> bytes_;
+};
+
+// The SHA-256 of data. CryptoPP picks the SHA instructions of the CPU
+// (SHA-NI on x86, the ARMv8 SHA extension) at runtime and falls back to the
+// portable code otherwise.
+Digest CalculateSHA256(std::string_view data);
+
+// The SHA-256 of each of the inputs. With a pool, the inputs are split
+// across its workers and the calling thread, each part hashed with its own
+// context; batches too small to split are hashed on the calling thread.
+void CalculateSHA256Batch(const std::vector<std::string_view>& inputs,
+                          std::vector<Digest>* digests,
+                          ThreadPool* pool = nullptr);
+
+}  // namespace resdb
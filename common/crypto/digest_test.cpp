@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/crypto/digest.h"
+
+#include <gtest/gtest.h>
+
+#include "common/crypto/hash.h"
+
+namespace resdb {
+namespace {
+
+TEST(DigestTest, CalculateSHA256) {
+  std::string expected_str =
+      "\x9F\x86\xD0\x81\x88L}e\x9A/"
+      "\xEA\xA0\xC5Z\xD0\x15\xA3\xBFO\x1B+\v\x82,\xD1]l\x15\xB0\xF0\n\b";
+  Digest digest = CalculateSHA256("test");
+  EXPECT_EQ(digest.ToString(), expected_str);
+  EXPECT_TRUE(digest.Equals(expected_str));
+  EXPECT_FALSE(digest.Equals(expected_str.substr(1)));
+  EXPECT_FALSE(digest.Equals(utils::CalculateSHA256Hash("test1")));
+}
+
+TEST(DigestTest, Compare) {
+  EXPECT_EQ(CalculateSHA256("test"), CalculateSHA256("test"));
+  EXPECT_NE(CalculateSHA256("test"), CalculateSHA256("test1"));
+  EXPECT_EQ(Digest(), Digest());
+}
+
+TEST(DigestTest, CalculateSHA256Batch) {
+  std::vector<std::string> data;
+  for (int i = 0; i < 128; ++i) {
+    data.push_back(std::string(i * 7, 'a' + i % 26));
+  }
+  std::vector<std::string_view> inputs(data.begin(), data.end());
+  ThreadPool pool("digest_test", 3);
+  for (ThreadPool* p : {static_cast<ThreadPool*>(nullptr), &pool}) {
+    std::vector<Digest> digests;
+    CalculateSHA256Batch(inputs, &digests, p);
+    ASSERT_EQ(digests.size(), data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+      EXPECT_EQ(digests[i].ToString(), utils::CalculateSHA256Hash(data[i]));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace resdb
@@ -20,19 +20,15 @@
 #include "common/crypto/hash.h"
 
 #include <cryptopp/ripemd.h>
-#include <cryptopp/sha.h>
 #include <glog/logging.h>
 
+#include "common/crypto/digest.h"
+
 namespace resdb {
 namespace utils {
 // Funtion to calculate hash of a string.
 std::string CalculateSHA256Hash(const std::string& str) {
-  CryptoPP::byte const* pData = (CryptoPP::byte*)str.data();
-  unsigned int nDataLen = str.size();
-  CryptoPP::byte aDigest[CryptoPP::SHA256::DIGESTSIZE];
-
-  CryptoPP::SHA256().CalculateDigest(aDigest, pData, nDataLen);
-  return std::string((char*)aDigest, CryptoPP::SHA256::DIGESTSIZE);
+  return CalculateSHA256(str).ToString();
 }
 
 std::string CalculateRIPEMD160Hash(const std::string& str) {
@@ -32,6 +32,7 @@
 #include <cryptopp/whrlpool.h>
 #include <glog/logging.h>
 
+#include "common/crypto/digest.h"
 #include "common/crypto/signature_utils.h"
 
 namespace resdb {
@@ -143,6 +144,11 @@ SignatureVerifier::SignatureVerifier(const KeyInfo& private_key,
 bool SignatureVerifier::AddPublicKey(const CertificateKey& public_key,
                                      bool need_verify) {
   std::unique_lock<std::shared_mutex> lk(mutex_);
+  auto it = keys_.find(public_key.public_key_info().node_id());
+  if (it != keys_.end() &&
+      it->second.SerializeAsString() == public_key.SerializeAsString()) {
+    return true;
+  }
   if (need_verify &&
       !VerifyKey(public_key.public_key_info(), public_key.certificate())) {
     return false;
@@ -150,6 +156,7 @@ bool SignatureVerifier::AddPublicKey(const CertificateKey& public_key,
   // LOG(ERROR) << "add public key from:"
   //           << public_key.public_key_info().node_id();
   keys_[public_key.public_key_info().node_id()] = public_key;
+  key_version_++;
   return true;
 }
 
@@ -176,14 +183,14 @@ size_t SignatureVerifier::GetPublicKeysSize() const {
   return keys_.size();
 }
 
+uint64_t SignatureVerifier::GetKeyVersion() const {
+  std::shared_lock<std::shared_mutex> lk(mutex_);
+  return key_version_;
+}
+
 // Funtion to calculate hash of a string.
 std::string SignatureVerifier::CalculateHash(const std::string& str) {
-  CryptoPP::byte const* pData = (CryptoPP::byte*)str.data();
-  unsigned int nDataLen = str.size();
-  CryptoPP::byte aDigest[CryptoPP::SHA256::DIGESTSIZE];
-
-  CryptoPP::SHA256().CalculateDigest(aDigest, pData, nDataLen);
-  return std::string((char*)aDigest, CryptoPP::SHA256::DIGESTSIZE);
+  return CalculateSHA256(str).ToString();
 }
 
 absl::StatusOr<SignatureInfo> SignatureVerifier::SignMessage(
@@ -41,7 +41,8 @@ class SignatureVerifier : public SignatureVerifierInterface {
   virtual ~SignatureVerifier() = default;
 
   // Set the public key that contains the public key, node id,
-  // and its certificate.
+  // and its certificate. A key identical to the one already held is
+  // accepted without verifying its certificate again.
   bool AddPublicKey(const CertificateKey& pub_key, bool need_verify = true);
 
   // Get the public key of node id. KeyInfo contains the key and its hash type.
@@ -50,6 +51,9 @@ class SignatureVerifier : public SignatureVerifierInterface {
   std::vector<CertificateKey> GetAllPublicKeys() const;
   // Get the number of public keys it contains.
   size_t GetPublicKeysSize() const;
+  // Get the version of the key set. It changes whenever a key is added or
+  // replaced.
+  uint64_t GetKeyVersion() const;
 
   // Sign messages using the private key.
   virtual absl::StatusOr<SignatureInfo> SignMessage(const std::string& message);
@@ -76,6 +80,7 @@ class SignatureVerifier : public SignatureVerifierInterface {
   KeyInfo private_key_;       // public-private keys of self.
   KeyInfo admin_public_key_;  // public key of admin.
   int64_t node_id_;           // id of current node.
+  uint64_t key_version_ = 0;  // version of keys_.
   std::unique_ptr<CryptoPP::ed25519::Signer> signer_;
   mutable std::shared_mutex mutex_;
 };
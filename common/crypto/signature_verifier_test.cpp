@@ -149,6 +149,27 @@ TEST_P(SignatureVerifyPTest, KeyNotMatch) {
   }
 }
 
+TEST_P(SignatureVerifyPTest, KeyVersion) {
+  SignatureInfo::HashType type = GetParam();
+  SecretKey my_key = KeyGenerator ::GeneratorKeys(type);
+  SecretKey your_key = KeyGenerator ::GeneratorKeys(type);
+  int64_t my_node_id = 1, your_node_id = 2;
+
+  SignatureVerifier verifier(GetKeyInfo(your_key), GetCertInfo(your_node_id));
+  uint64_t version = verifier.GetKeyVersion();
+
+  CertificateKey cert_key = GetPublicKeyInfo(my_key, my_node_id);
+  EXPECT_TRUE(verifier.AddPublicKey(cert_key));
+  EXPECT_EQ(verifier.GetKeyVersion(), version + 1);
+
+  // The same key does not change the version.
+  EXPECT_TRUE(verifier.AddPublicKey(cert_key));
+  EXPECT_EQ(verifier.GetKeyVersion(), version + 1);
+
+  EXPECT_TRUE(verifier.AddPublicKey(GetPublicKeyInfo(your_key, my_node_id)));
+  EXPECT_EQ(verifier.GetKeyVersion(), version + 2);
+}
+
 INSTANTIATE_TEST_SUITE_P(SignatureVerifyPTest, SignatureVerifyPTest,
                          ::testing::Values(SignatureInfo::RSA,
                                            SignatureInfo::ED25519,
@@ -19,6 +19,8 @@
 
 #include "lru_cache.h"
 
+#include <memory>
+
 #include "string"
 
 namespace resdb {
@@ -118,5 +120,6 @@ template class LRUCache<int, int>;
 template class LRUCache<std::string, int>;
 template class LRUCache<int, std::string>;
 template class LRUCache<std::string, std::string>;
+template class LRUCache<uint64_t, std::shared_ptr<const std::string>>;
 
 }  // namespace resdb
\ No newline at end of file
@@ -0,0 +1,202 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "common/utils/reed_solomon.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace resdb {
+
+namespace {
+
+// GF(2^8) with the polynomial x^8 + x^4 + x^3 + x^2 + 1.
+class GaloisField {
+ public:
+  GaloisField() {
+    int x = 1;
+    for (int i = 0; i < 255; ++i) {
+      exp_[i] = exp_[i + 255] = x;
+      log_[x] = i;
+      x <<= 1;
+      if (x & 0x100) {
+        x ^= 0x11d;
+      }
+    }
+    log_[0] = 0;
+  }
+
+  uint8_t Mul(uint8_t a, uint8_t b) const {
+    if (a == 0 || b == 0) {
+      return 0;
+    }
+    return exp_[log_[a] + log_[b]];
+  }
+
+  uint8_t Inv(uint8_t a) const { return exp_[255 - log_[a]]; }
+
+  // dst[i] ^= coef * src[i]
+  void MulAdd(uint8_t coef, const uint8_t* src, uint8_t* dst,
+              size_t size) const {
+    if (coef == 0) {
+      return;
+    }
+    uint8_t table[256];
+    for (int i = 0; i < 256; ++i) {
+      table[i] = Mul(coef, i);
+    }
+    for (size_t i = 0; i < size; ++i) {
+      dst[i] ^= table[src[i]];
+    }
+  }
+
+ private:
+  uint8_t exp_[510];
+  int log_[256];
+};
+
+const GaloisField& GetField() {
+  static GaloisField field;
+  return field;
+}
+
+}  // namespace
+
+ReedSolomon::ReedSolomon(int data_num, int total_num)
+    : data_num_(data_num), total_num_(total_num) {
+  CHECK(data_num_ > 0 && data_num_ <= total_num_ && total_num_ <= 256);
+  const GaloisField& field = GetField();
+  matrix_.resize(total_num_, std::vector<uint8_t>(data_num_, 0));
+  for (int i = 0; i < total_num_; ++i) {
+    for (int j = 0; j < data_num_; ++j) {
+      if (i < data_num_) {
+        matrix_[i][j] = i == j ? 1 : 0;
+      } else {
+        // Cauchy matrix 1 / (x_i + y_j) with x_i = i and y_j = j, i >= k > j.
+        matrix_[i][j] = field.Inv(i ^ j);
+      }
+    }
+  }
+}
+
+int ReedSolomon::DataNum() const { return data_num_; }
+
+int ReedSolomon::TotalNum() const { return total_num_; }
+
+size_t ReedSolomon::FragmentSize(size_t data_size) const {
+  return (data_size + data_num_ - 1) / data_num_;
+}
+
+std::string ReedSolomon::EncodeFragment(const std::string& data,
+                                        int index) const {
+  size_t size = FragmentSize(data.size());
+  std::string fragment(size, 0);
+  uint8_t* dst = reinterpret_cast<uint8_t*>(&fragment[0]);
+  for (int j = 0; j < data_num_; ++j) {
+    size_t begin = j * size;
+    if (begin >= data.size()) {
+      break;
+    }
+    size_t len = std::min(size, data.size() - begin);
+    GetField().MulAdd(matrix_[index][j],
+                      reinterpret_cast<const uint8_t*>(data.data()) + begin,
+                      dst, len);
+  }
+  return fragment;
+}
+
+std::vector<std::string> ReedSolomon::Encode(const std::string& data) const {
+  std::vector<std::string> fragments;
+  for (int i = 0; i < total_num_; ++i) {
+    fragments.push_back(EncodeFragment(data, i));
+  }
+  return fragments;
+}
+
+absl::StatusOr<std::string> ReedSolomon::Decode(
+    const std::map<int, std::string>& fragments, size_t data_size) const {
+  size_t size = FragmentSize(data_size);
+  std::vector<int> rows;
+  std::vector<const std::string*> inputs;
+  for (const auto& it : fragments) {
+    if (it.first < 0 || it.first >= total_num_) {
+      return absl::InvalidArgumentError("invalid fragment index");
+    }
+    if (it.second.size() != size) {
+      return absl::InvalidArgumentError("invalid fragment size");
+    }
+    rows.push_back(it.first);
+    inputs.push_back(&it.second);
+    if (static_cast<int>(rows.size()) == data_num_) {
+      break;
+    }
+  }
+  if (static_cast<int>(rows.size()) < data_num_) {
+    return absl::InvalidArgumentError("not enough fragments");
+  }
+
+  const GaloisField& field = GetField();
+  // Invert the rows of the generator matrix which were received.
+  std::vector<std::vector<uint8_t>> sub(data_num_), inv(data_num_);
+  for (int i = 0; i < data_num_; ++i) {
+    sub[i] = matrix_[rows[i]];
+    inv[i].assign(data_num_, 0);
+    inv[i][i] = 1;
+  }
+  for (int col = 0; col < data_num_; ++col) {
+    int pivot = col;
+    while (pivot < data_num_ && sub[pivot][col] == 0) {
+      pivot++;
+    }
+    if (pivot == data_num_) {
+      return absl::InternalError("singular matrix");
+    }
+    std::swap(sub[col], sub[pivot]);
+    std::swap(inv[col], inv[pivot]);
+    uint8_t scale = field.Inv(sub[col][col]);
+    for (int j = 0; j < data_num_; ++j) {
+      sub[col][j] = field.Mul(sub[col][j], scale);
+      inv[col][j] = field.Mul(inv[col][j], scale);
+    }
+    for (int row = 0; row < data_num_; ++row) {
+      uint8_t factor = sub[row][col];
+      if (row == col || factor == 0) {
+        continue;
+      }
+      for (int j = 0; j < data_num_; ++j) {
+        sub[row][j] ^= field.Mul(factor, sub[col][j]);
+        inv[row][j] ^= field.Mul(factor, inv[col][j]);
+      }
+    }
+  }
+
+  std::string data(size * data_num_, 0);
+  for (int i = 0; i < data_num_; ++i) {
+    uint8_t* dst = reinterpret_cast<uint8_t*>(&data[i * size]);
+    for (int j = 0; j < data_num_; ++j) {
+      field.MulAdd(inv[i][j],
+                   reinterpret_cast<const uint8_t*>(inputs[j]->data()), dst,
+                   size);
+    }
+  }
+  data.resize(data_size);
+  return data;
+}
+
+}  // namespace resdb
@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+
+namespace resdb {
+
+// A systematic Reed-Solomon erasure code over GF(2^8).
+//
+// The data is split into data_num pieces and extended to total_num
+// fragments. Any data_num distinct fragments are enough to rebuild the
+// data. The first data_num fragments are the plain pieces; the rest are
+// built from a Cauchy matrix, so every data_num x data_num sub-matrix of the
+// generator can be inverted.
+class ReedSolomon {
+ public:
+  // Requires 0 < data_num <= total_num <= 256.
+  ReedSolomon(int data_num, int total_num);
+
+  // Returns all the total_num fragments.
+  std::vector<std::string> Encode(const std::string& data) const;
+
+  // Returns the fragment at index only, for a sender that owns one fragment.
+  std::string EncodeFragment(const std::string& data, int index) const;
+
+  // Rebuilds data of data_size bytes from at least data_num fragments,
+  // keyed by fragment index.
+  absl::StatusOr<std::string> Decode(
+      const std::map<int, std::string>& fragments, size_t data_size) const;
+
+  int DataNum() const;
+  int TotalNum() const;
+
+  // Size of each fragment for data of data_size bytes.
+  size_t FragmentSize(size_t data_size) const;
+
+ private:
+  int data_num_;
+  int total_num_;
+  // Coefficients of piece j in fragment i.
+  std::vector<std::vector<uint8_t>> matrix_;
+};
+
+}  // namespace resdb
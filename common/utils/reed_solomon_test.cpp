@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "common/utils/reed_solomon.h"
+
+#include <gtest/gtest.h>
+
+namespace resdb {
+namespace {
+
+std::string GetData(size_t size) {
+  std::string data;
+  for (size_t i = 0; i < size; ++i) {
+    data.push_back(static_cast<char>(i * 31 + 7));
+  }
+  return data;
+}
+
+TEST(ReedSolomonTest, DecodeFromAnyFragments) {
+  ReedSolomon coder(3, 7);
+  std::string data = GetData(1000);
+  std::vector<std::string> fragments = coder.Encode(data);
+  ASSERT_EQ(fragments.size(), 7);
+  EXPECT_EQ(fragments[0].size(), coder.FragmentSize(data.size()));
+
+  for (int a = 0; a < 7; ++a) {
+    for (int b = a + 1; b < 7; ++b) {
+      for (int c = b + 1; c < 7; ++c) {
+        std::map<int, std::string> received = {{a, fragments[a]},
+                                               {b, fragments[b]},
+                                               {c, fragments[c]}};
+        auto ret = coder.Decode(received, data.size());
+        ASSERT_TRUE(ret.ok());
+        EXPECT_EQ(*ret, data);
+      }
+    }
+  }
+}
+
+TEST(ReedSolomonTest, EncodeOneFragment) {
+  ReedSolomon coder(2, 4);
+  std::string data = GetData(101);
+  std::vector<std::string> fragments = coder.Encode(data);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(coder.EncodeFragment(data, i), fragments[i]);
+  }
+}
+
+TEST(ReedSolomonTest, NotEnoughFragments) {
+  ReedSolomon coder(3, 4);
+  std::string data = GetData(10);
+  std::vector<std::string> fragments = coder.Encode(data);
+  std::map<int, std::string> received = {{1, fragments[1]},
+                                         {3, fragments[3]}};
+  EXPECT_FALSE(coder.Decode(received, data.size()).ok());
+
+  received[2] = "bad";
+  EXPECT_FALSE(coder.Decode(received, data.size()).ok());
+}
+
+}  // namespace
+}  // namespace resdb
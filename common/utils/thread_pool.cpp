@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/utils/thread_pool.h"
+
+#include <glog/logging.h>
+
+#include <memory>
+
+namespace resdb {
+
+ThreadPool::ThreadPool(const std::string& name, int thread_num)
+    : name_(name), stop_(false) {
+  if (thread_num <= 0) {
+    thread_num = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (int i = 0; i < thread_num; ++i) {
+    workers_.push_back(std::thread(&ThreadPool::Run, this));
+  }
+  LOG(INFO) << "thread pool:" << name_ << " start with " << thread_num
+            << " workers";
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+int ThreadPool::Size() const { return workers_.size(); }
+
+void ThreadPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void ThreadPool::Run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lk(mutex_);
+      cv_.wait(lk, [&] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void ThreadPool::ParallelFor(int num, const std::function<void(int)>& func) {
+  if (num <= 0) {
+    return;
+  }
+
+  struct Context {
+    std::atomic<int> next = 0;
+    std::atomic<int> done = 0;
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+  auto ctx = std::make_shared<Context>();
+
+  // Each runner keeps pulling indexes until all of them have been taken.
+  auto runner = [ctx, num, &func]() {
+    int finished = 0;
+    for (int i = ctx->next++; i < num; i = ctx->next++) {
+      func(i);
+      finished++;
+    }
+    if (finished > 0 && ctx->done.fetch_add(finished) + finished == num) {
+      std::lock_guard<std::mutex> lk(ctx->mutex);
+      ctx->cv.notify_all();
+    }
+  };
+
+  int helper_num = std::min(num - 1, Size());
+  for (int i = 0; i < helper_num; ++i) {
+    Submit(runner);
+  }
+  runner();
+
+  std::unique_lock<std::mutex> lk(ctx->mutex);
+  ctx->cv.wait(lk, [&] { return ctx->done.load() == num; });
+}
+
+}  // namespace resdb
@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace resdb {
+
+// A fixed size pool of worker threads used to run stateless work (signature
+// checks, parsing, hashing) off the consensus and execution threads.
+class ThreadPool {
+ public:
+  ThreadPool(const std::string& name, int thread_num);
+  ~ThreadPool();
+
+  // Queue a task to run on one of the workers.
+  void Submit(std::function<void()> task);
+
+  // Run func(0) ... func(num - 1) on the pool and wait until all of them
+  // are done. The calling thread takes part in the work, so it is safe to
+  // call it from a worker of the same pool.
+  void ParallelFor(int num, const std::function<void(int)>& func);
+
+  int Size() const;
+
+ private:
+  void Run();
+
+ private:
+  std::string name_;
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<bool> stop_;
+};
+
+}  // namespace resdb
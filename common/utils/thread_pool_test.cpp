@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/utils/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+namespace resdb {
+namespace {
+
+TEST(ThreadPoolTest, Submit) {
+  ThreadPool pool("test", 2);
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  pool.Submit([&]() { done.set_value(true); });
+  EXPECT_TRUE(done_future.get());
+}
+
+TEST(ThreadPoolTest, ParallelFor) {
+  ThreadPool pool("test", 4);
+  std::vector<int> values(1000, 0);
+  pool.ParallelFor(values.size(), [&](int i) { values[i] = i; });
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TEST(ThreadPoolTest, NestedParallelFor) {
+  ThreadPool pool("test", 1);
+  std::atomic<int> count = 0;
+  pool.ParallelFor(4, [&](int i) {
+    pool.ParallelFor(4, [&](int j) { count++; });
+  });
+  EXPECT_EQ(count, 16);
+}
+
+}  // namespace
+}  // namespace resdb
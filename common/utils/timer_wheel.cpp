@@ -0,0 +1,262 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/utils/timer_wheel.h"
+
+#include <glog/logging.h>
+
+#include "common/utils/utils.h"
+
+namespace resdb {
+
+namespace {
+
+// The first level has 256 slots of one tick. Each of the next levels has 64
+// slots covering a whole turn of the level below.
+constexpr int kFirstLevelBits = 8;
+constexpr int kLevelBits = 6;
+constexpr int kLevelNum = 4;
+constexpr uint64_t kFirstLevelSize = 1 << kFirstLevelBits;
+constexpr uint64_t kLevelSize = 1 << kLevelBits;
+constexpr uint64_t kMaxDelta =
+    (1ull << (kFirstLevelBits + kLevelBits * (kLevelNum - 1))) - 1;
+constexpr int32_t kExpired = -2;
+
+int GetShift(int level) {
+  return kFirstLevelBits + kLevelBits * (level - 1);
+}
+
+TimerWheel::TimerId GetTimerId(int32_t index, uint32_t generation) {
+  return (static_cast<uint64_t>(generation) << 32) | index;
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(const std::string& name, uint64_t tick_us)
+    : name_(name),
+      tick_us_(tick_us),
+      start_time_(GetCurrentTime()),
+      slots_(kFirstLevelSize + kLevelSize * (kLevelNum - 1), -1),
+      stop_(false) {
+  thread_ = std::thread(&TimerWheel::Run, this);
+}
+
+TimerWheel::~TimerWheel() { Stop(); }
+
+TimerWheel* TimerWheel::GetGlobalTimerWheel() {
+  static TimerWheel timer_wheel("global_timer");
+  return &timer_wheel;
+}
+
+void TimerWheel::Stop() {
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    stop_ = true;
+    cv_.notify_all();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+uint64_t TimerWheel::GetTick() {
+  return (GetCurrentTime() - start_time_) / tick_us_;
+}
+
+TimerWheel::TimerId TimerWheel::Add(uint64_t timeout_us, Callback callback) {
+  uint64_t expire_tick =
+      (GetCurrentTime() - start_time_ + timeout_us + tick_us_ - 1) / tick_us_;
+  std::lock_guard<std::mutex> lk(mutex_);
+  if (size_ == 0) {
+    // Nothing is linked, so the idle ticks can be skipped.
+    current_tick_ = std::max(current_tick_, GetTick());
+    cv_.notify_all();
+  }
+  int32_t index = AllocNode();
+  Node& node = nodes_[index];
+  node.expire_tick = std::max(expire_tick, current_tick_);
+  node.callback = std::move(callback);
+  Link(index);
+  return GetTimerId(index, node.generation);
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+  if (id == 0) {
+    return false;
+  }
+  int32_t index = id & 0xffffffff;
+  uint32_t generation = id >> 32;
+  std::unique_lock<std::mutex> lk(mutex_);
+  if (index < static_cast<int32_t>(nodes_.size()) &&
+      nodes_[index].generation == generation) {
+    if (nodes_[index].slot >= 0) {
+      Unlink(index);
+    }
+    FreeNode(index);
+    return true;
+  }
+  if (std::this_thread::get_id() != thread_.get_id()) {
+    running_cv_.wait(lk, [&] { return running_id_ != id; });
+  }
+  return false;
+}
+
+size_t TimerWheel::Size() {
+  std::lock_guard<std::mutex> lk(mutex_);
+  return size_;
+}
+
+int32_t TimerWheel::AllocNode() {
+  int32_t index = free_list_;
+  if (index >= 0) {
+    free_list_ = nodes_[index].next;
+  } else {
+    index = nodes_.size();
+    nodes_.emplace_back();
+  }
+  size_++;
+  return index;
+}
+
+void TimerWheel::FreeNode(int32_t index) {
+  Node& node = nodes_[index];
+  node.generation++;
+  node.callback = nullptr;
+  node.slot = -1;
+  node.prev = -1;
+  node.next = free_list_;
+  free_list_ = index;
+  size_--;
+}
+
+void TimerWheel::Link(int32_t index) {
+  Node& node = nodes_[index];
+  uint64_t delta = node.expire_tick - current_tick_;
+  int32_t slot = 0;
+  if (delta < kFirstLevelSize) {
+    slot = node.expire_tick & (kFirstLevelSize - 1);
+  } else {
+    if (delta > kMaxDelta) {
+      node.expire_tick = current_tick_ + kMaxDelta;
+      delta = kMaxDelta;
+    }
+    int level = 1;
+    while ((delta >> GetShift(level + 1)) > 0) {
+      level++;
+    }
+    slot = kFirstLevelSize + kLevelSize * (level - 1) +
+           ((node.expire_tick >> GetShift(level)) & (kLevelSize - 1));
+  }
+  node.slot = slot;
+  node.prev = -1;
+  node.next = slots_[slot];
+  if (node.next >= 0) {
+    nodes_[node.next].prev = index;
+  }
+  slots_[slot] = index;
+}
+
+void TimerWheel::Unlink(int32_t index) {
+  Node& node = nodes_[index];
+  if (node.prev >= 0) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    slots_[node.slot] = node.next;
+  }
+  if (node.next >= 0) {
+    nodes_[node.next].prev = node.prev;
+  }
+  node.slot = -1;
+}
+
+void TimerWheel::Tick() {
+  // Move the timers of a slot of a higher level down once the levels below
+  // have made a whole turn.
+  for (int level = 1; level < kLevelNum; ++level) {
+    if ((current_tick_ & ((1ull << GetShift(level)) - 1)) != 0) {
+      break;
+    }
+    int32_t slot = kFirstLevelSize + kLevelSize * (level - 1) +
+                   ((current_tick_ >> GetShift(level)) & (kLevelSize - 1));
+    int32_t index = slots_[slot];
+    slots_[slot] = -1;
+    while (index >= 0) {
+      int32_t next = nodes_[index].next;
+      Link(index);
+      index = next;
+    }
+  }
+
+  // Collect the timers due at this tick.
+  int32_t slot = current_tick_ & (kFirstLevelSize - 1);
+  int32_t index = slots_[slot];
+  slots_[slot] = -1;
+  while (index >= 0) {
+    nodes_[index].slot = kExpired;
+    expired_.push_back(GetTimerId(index, nodes_[index].generation));
+    index = nodes_[index].next;
+  }
+  current_tick_++;
+}
+
+void TimerWheel::Run() {
+  while (!stop_) {
+    {
+      std::unique_lock<std::mutex> lk(mutex_);
+      if (size_ == 0) {
+        cv_.wait_for(lk, std::chrono::seconds(1),
+                     [&] { return size_ > 0 || stop_; });
+      } else {
+        cv_.wait_for(lk, std::chrono::microseconds(tick_us_),
+                     [&] { return stop_.load(); });
+      }
+      uint64_t now_tick = GetTick();
+      if (size_ == 0) {
+        current_tick_ = std::max(current_tick_, now_tick + 1);
+      }
+      while (current_tick_ <= now_tick) {
+        Tick();
+      }
+    }
+
+    // A timer may be cancelled until its callback is taken.
+    for (TimerId id : expired_) {
+      Callback callback;
+      {
+        std::lock_guard<std::mutex> lk(mutex_);
+        int32_t index = id & 0xffffffff;
+        if (nodes_[index].generation != id >> 32) {
+          continue;
+        }
+        callback = std::move(nodes_[index].callback);
+        FreeNode(index);
+        running_id_ = id;
+      }
+      callback();
+      {
+        std::lock_guard<std::mutex> lk(mutex_);
+        running_id_ = 0;
+      }
+      running_cv_.notify_all();
+    }
+    expired_.clear();
+  }
+}
+
+}  // namespace resdb
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace resdb {
+
+// A hierarchical timer wheel driven by a single tick thread. Adding and
+// cancelling a timer are O(1): a timer is linked into the slot of the level
+// that covers its deadline and is moved to a finer level when the coarser
+// slot comes around. Timer nodes are kept in a slab and reused, so an
+// outstanding timer does not cost an allocation besides its callback.
+//
+// Callbacks run on the tick thread one at a time, outside the wheel lock,
+// and may add or cancel timers.
+class TimerWheel {
+ public:
+  // 0 is never returned by Add().
+  typedef uint64_t TimerId;
+  typedef std::function<void()> Callback;
+
+  // tick_us is the resolution of the wheel. Deadlines are rounded up to the
+  // next tick.
+  TimerWheel(const std::string& name, uint64_t tick_us = 1000);
+  ~TimerWheel();
+
+  // The wheel shared by the consensus managers of this process.
+  static TimerWheel* GetGlobalTimerWheel();
+
+  void Stop();
+
+  // Run callback once timeout_us has passed.
+  TimerId Add(uint64_t timeout_us, Callback callback);
+
+  // Return true if the timer was removed before it fired. If the callback
+  // is running on the tick thread, wait for it to finish so that the caller
+  // may release what the callback refers to.
+  bool Cancel(TimerId id);
+
+  // The number of outstanding timers.
+  size_t Size();
+
+ private:
+  struct Node {
+    uint64_t expire_tick = 0;
+    uint32_t generation = 1;
+    int32_t prev = -1;
+    int32_t next = -1;
+    int32_t slot = -1;
+    Callback callback;
+  };
+
+  void Run();
+  void Tick();
+  void Link(int32_t index);
+  void Unlink(int32_t index);
+  int32_t AllocNode();
+  void FreeNode(int32_t index);
+  uint64_t GetTick();
+
+ private:
+  std::string name_;
+  uint64_t tick_us_;
+  uint64_t start_time_;
+  uint64_t current_tick_ = 0;
+  std::vector<Node> nodes_;
+  int32_t free_list_ = -1;
+  // The head of every slot of every level, the first level first.
+  std::vector<int32_t> slots_;
+  // The timers due in the last round of ticks.
+  std::vector<TimerId> expired_;
+  size_t size_ = 0;
+  TimerId running_id_ = 0;
+  std::mutex mutex_;
+  std::condition_variable cv_, running_cv_;
+  std::thread thread_;
+  std::atomic<bool> stop_;
+};
+
+}  // namespace resdb
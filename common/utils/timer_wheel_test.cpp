@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "common/utils/timer_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <random>
+
+#include "common/utils/utils.h"
+
+namespace resdb {
+namespace {
+
+TEST(TimerWheelTest, Fire) {
+  TimerWheel timer_wheel("test");
+  std::promise<uint64_t> done;
+  std::future<uint64_t> done_future = done.get_future();
+  uint64_t start_time = GetCurrentTime();
+  timer_wheel.Add(20000, [&]() { done.set_value(GetCurrentTime()); });
+  EXPECT_GE(done_future.get() - start_time, 20000);
+  EXPECT_EQ(timer_wheel.Size(), 0);
+}
+
+TEST(TimerWheelTest, FireInOrder) {
+  TimerWheel timer_wheel("test");
+  std::mutex mutex;
+  std::vector<int> order;
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  for (int i = 3; i >= 1; --i) {
+    timer_wheel.Add(i * 20000, [&, i]() {
+      std::lock_guard<std::mutex> lk(mutex);
+      order.push_back(i);
+      if (order.size() == 3) {
+        done.set_value(true);
+      }
+    });
+  }
+  done_future.get();
+  EXPECT_EQ(order, std::vector<int>({1, 2, 3}));
+}
+
+// Deadlines beyond the first level are moved down before they fire.
+TEST(TimerWheelTest, FireFromHigherLevel) {
+  TimerWheel timer_wheel("test", /*tick_us=*/100);
+  std::promise<uint64_t> done;
+  std::future<uint64_t> done_future = done.get_future();
+  uint64_t start_time = GetCurrentTime();
+  timer_wheel.Add(300000, [&]() { done.set_value(GetCurrentTime()); });
+  EXPECT_GE(done_future.get() - start_time, 300000);
+}
+
+TEST(TimerWheelTest, ManyTimers) {
+  // One tick per microsecond puts the longer deadlines on the third level.
+  TimerWheel timer_wheel("test", /*tick_us=*/1);
+  int timer_num = 10000;
+  std::atomic<int> fired = 0, early = 0;
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  std::mt19937 rand(0);
+  for (int i = 0; i < timer_num; ++i) {
+    uint64_t timeout = rand() % 200000;
+    uint64_t deadline = GetCurrentTime() + timeout;
+    timer_wheel.Add(timeout, [&, deadline]() {
+      if (GetCurrentTime() < deadline) {
+        early++;
+      }
+      if (++fired == timer_num) {
+        done.set_value(true);
+      }
+    });
+  }
+  done_future.get();
+  EXPECT_EQ(early, 0);
+  EXPECT_EQ(timer_wheel.Size(), 0);
+}
+
+TEST(TimerWheelTest, Cancel) {
+  TimerWheel timer_wheel("test");
+  std::atomic<int> fired = 0;
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  TimerWheel::TimerId id = timer_wheel.Add(10000, [&]() { fired++; });
+  timer_wheel.Add(30000, [&]() { done.set_value(true); });
+  EXPECT_TRUE(timer_wheel.Cancel(id));
+  EXPECT_FALSE(timer_wheel.Cancel(id));
+  done_future.get();
+  EXPECT_EQ(fired, 0);
+}
+
+TEST(TimerWheelTest, CancelAfterFire) {
+  TimerWheel timer_wheel("test");
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  TimerWheel::TimerId id =
+      timer_wheel.Add(1000, [&]() { done.set_value(true); });
+  done_future.get();
+  EXPECT_FALSE(timer_wheel.Cancel(id));
+  // The node is reused by a new timer, which has a different id.
+  TimerWheel::TimerId new_id = timer_wheel.Add(1000000, []() {});
+  EXPECT_NE(id, new_id);
+  EXPECT_FALSE(timer_wheel.Cancel(id));
+  EXPECT_TRUE(timer_wheel.Cancel(new_id));
+}
+
+// Cancel waits for a running callback before returning.
+TEST(TimerWheelTest, CancelRunning) {
+  TimerWheel timer_wheel("test");
+  std::atomic<bool> running = false, finished = false;
+  TimerWheel::TimerId id = timer_wheel.Add(1000, [&]() {
+    running = true;
+    usleep(50000);
+    finished = true;
+  });
+  while (!running) {
+    usleep(1000);
+  }
+  EXPECT_FALSE(timer_wheel.Cancel(id));
+  EXPECT_TRUE(finished);
+}
+
+TEST(TimerWheelTest, AddFromCallback) {
+  TimerWheel timer_wheel("test");
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  timer_wheel.Add(1000, [&]() {
+    timer_wheel.Add(1000, [&]() { done.set_value(true); });
+  });
+  EXPECT_TRUE(done_future.get());
+}
+
+}  // namespace
+}  // namespace resdb
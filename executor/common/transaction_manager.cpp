@@ -30,6 +30,10 @@ bool TransactionManager::IsOutOfOrder() { return is_out_of_order_; }
 
 bool TransactionManager::NeedResponse() { return need_response_; }
 
+uint64_t TransactionManager::GetPartitionKey(const BatchUserRequest& request) {
+  return 0;
+}
+
 std::unique_ptr<std::string> TransactionManager::ExecuteData(
     const std::string& request) {
   // WHAT THE FUCK DOES THIS DOOOOOOOO
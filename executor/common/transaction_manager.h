@@ -47,8 +47,21 @@ class TransactionManager {
       const std::vector<std::unique_ptr<google::protobuf::Message>>& requests);
   virtual std::unique_ptr<std::string> ExecuteData(const std::string& request);
 
+  // Load the state touched by a request returned from Prepare() before it is
+  // executed. It runs on the pre-execution workers concurrently with the
+  // execution and must not change the state.
+  virtual void Prefetch(const google::protobuf::Message& request) {}
+
   bool IsOutOfOrder();
 
+  // Returns the key used to route a batch to an out-of-order execution
+  // worker. Batches with the same key are executed by the same worker in
+  // the order they were committed, so a manager overriding it must return
+  // the same key for any two batches touching the same state. The payload
+  // format is only known to the manager, so by default every batch gets
+  // the same key and they are executed one by one.
+  virtual uint64_t GetPartitionKey(const BatchUserRequest& request);
+
   bool NeedResponse();
 
   virtual Storage* GetStorage() { return nullptr; };
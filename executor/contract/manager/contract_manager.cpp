@@ -131,6 +131,7 @@ absl::StatusOr<std::vector<uint8_t>> ContractManager::Execute(
         p.run(tx, caller_address, gs_->get(contract_address), input, 0u, &tr);
 
     if (exec_result.er != eevm::ExitReason::returned) {
+      gs_->Rollback();
       // Print the trace if nothing was returned
       if (exec_result.er == eevm::ExitReason::threw) {
         return absl::InternalError(
@@ -138,8 +139,13 @@ absl::StatusOr<std::vector<uint8_t>> ContractManager::Execute(
       }
       return absl::InternalError("Deployment did not return");
     }
+    // The slots stored by the transaction are written at once.
+    if (gs_->Commit() != 0) {
+      return absl::InternalError("Write contract state fail");
+    }
     return exec_result.output;
   } catch (...) {
+    gs_->Rollback();
     return absl::InternalError(fmt::format("Execution error:"));
   }
 }
@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "executor/contract/manager/contract_state.h"
+
+#include <glog/logging.h>
+
+#include "eEVM/util.h"
+
+namespace resdb {
+namespace contract {
+
+ContractState::ContractState(resdb::Storage* storage) : storage_(storage) {}
+
+std::string ContractState::GetKey(const Address& address,
+                                  const uint256_t& slot) {
+  uint8_t buf[kSlotSize];
+  std::string key;
+  key.reserve(kKeySize);
+  // The address takes the low 20 bytes of the big-endian word.
+  eevm::to_big_endian(address, buf);
+  key.append(reinterpret_cast<const char*>(buf) + kSlotSize - kAddressSize,
+             kAddressSize);
+  eevm::to_big_endian(slot, buf);
+  key.append(reinterpret_cast<const char*>(buf), kSlotSize);
+  return key;
+}
+
+uint256_t ContractState::Load(const Address& address, const uint256_t& slot) {
+  std::string key = GetKey(address, slot);
+  auto it = journal_.find(key);
+  if (it != journal_.end()) {
+    return it->second;
+  }
+  std::string value = storage_->GetValue(key);
+  if (value.size() != kSlotSize) {
+    return 0;
+  }
+  return eevm::from_big_endian(reinterpret_cast<const uint8_t*>(value.data()),
+                               kSlotSize);
+}
+
+void ContractState::Store(const Address& address, const uint256_t& slot,
+                          const uint256_t& value) {
+  journal_[GetKey(address, slot)] = value;
+}
+
+int ContractState::Commit() {
+  if (journal_.empty()) {
+    return 0;
+  }
+  std::vector<std::pair<std::string, std::string>> values;
+  values.reserve(journal_.size());
+  for (const auto& [key, value] : journal_) {
+    if (value == 0) {
+      // An empty value removes the slot.
+      values.push_back(std::make_pair(key, std::string()));
+      continue;
+    }
+    std::string data(kSlotSize, 0);
+    eevm::to_big_endian(value, reinterpret_cast<uint8_t*>(data.data()));
+    values.push_back(std::make_pair(key, std::move(data)));
+  }
+  journal_.clear();
+  int ret = storage_->SetValues(values);
+  if (ret != 0) {
+    LOG(ERROR) << "write contract state fail:" << ret;
+  }
+  return ret;
+}
+
+void ContractState::Rollback() { journal_.clear(); }
+
+}  // namespace contract
+}  // namespace resdb
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "chain/storage/storage.h"
+#include "executor/contract/manager/utils.h"
+
+namespace resdb {
+namespace contract {
+
+// The storage slots of the contracts. A slot is kept under a 52-byte key, the
+// 20-byte contract address followed by the 32-byte slot, and holds its
+// 32-byte big-endian value.
+// The slots stored by a transaction stay in a journal until Commit() writes
+// them to the storage in one batch. A slot set to zero is removed.
+class ContractState {
+ public:
+  static constexpr size_t kAddressSize = 20;
+  static constexpr size_t kSlotSize = 32;
+  static constexpr size_t kKeySize = kAddressSize + kSlotSize;
+
+  ContractState(resdb::Storage* storage);
+
+  uint256_t Load(const Address& address, const uint256_t& slot);
+  void Store(const Address& address, const uint256_t& slot,
+             const uint256_t& value);
+
+  // Write the stored slots to the storage. Returns 0 on success.
+  int Commit();
+  // Drop the stored slots, e.g. when the transaction fails.
+  void Rollback();
+
+  static std::string GetKey(const Address& address, const uint256_t& slot);
+
+ private:
+  resdb::Storage* storage_;
+  std::map<std::string, uint256_t> journal_;
+};
+
+}  // namespace contract
+}  // namespace resdb
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "executor/contract/manager/contract_state.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "chain/storage/memory_db.h"
+#include "chain/storage/mock_storage.h"
+
+namespace resdb {
+namespace contract {
+namespace {
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+using ::testing::Return;
+using resdb::storage::MemoryDB;
+
+TEST(ContractStateTest, BinaryKey) {
+  std::string key = ContractState::GetKey(0x1234, 5);
+  ASSERT_EQ(key.size(), ContractState::kKeySize);
+  EXPECT_EQ(key.substr(0, 20), std::string(18, 0) + "\x12\x34");
+  EXPECT_EQ(key.substr(20), std::string(31, 0) + "\x05");
+}
+
+TEST(ContractStateTest, StoreUntilCommit) {
+  MemoryDB db;
+  ContractState state(&db);
+
+  state.Store(1, 5, 100);
+  EXPECT_EQ(state.Load(1, 5), 100);
+  EXPECT_EQ(state.Load(2, 5), 0);
+  EXPECT_EQ(db.GetValue(ContractState::GetKey(1, 5)), "");
+
+  EXPECT_EQ(state.Commit(), 0);
+  std::string value = db.GetValue(ContractState::GetKey(1, 5));
+  EXPECT_EQ(value, std::string(31, 0) + "\x64");
+  EXPECT_EQ(ContractState(&db).Load(1, 5), 100);
+}
+
+TEST(ContractStateTest, RemoveZeroSlot) {
+  MemoryDB db;
+  ContractState state(&db);
+
+  state.Store(1, 5, 100);
+  EXPECT_EQ(state.Commit(), 0);
+  state.Store(1, 5, 0);
+  EXPECT_EQ(state.Commit(), 0);
+  EXPECT_EQ(state.Load(1, 5), 0);
+  EXPECT_EQ(db.GetAllValues(), "[]");
+}
+
+TEST(ContractStateTest, Rollback) {
+  MemoryDB db;
+  ContractState state(&db);
+
+  state.Store(1, 5, 100);
+  EXPECT_EQ(state.Commit(), 0);
+  state.Store(1, 5, 200);
+  state.Rollback();
+  EXPECT_EQ(state.Load(1, 5), 100);
+}
+
+TEST(ContractStateTest, CommitInOneBatch) {
+  MockStorage storage;
+  ContractState state(&storage);
+
+  EXPECT_CALL(storage, SetValue).Times(0);
+  EXPECT_CALL(storage, SetValues(ElementsAre(
+                           Pair(ContractState::GetKey(1, 5), _),
+                           Pair(ContractState::GetKey(1, 6), std::string()))))
+      .WillOnce(Return(0));
+
+  // Only the last value of a slot is written.
+  state.Store(1, 5, 100);
+  state.Store(1, 5, 200);
+  state.Store(1, 6, 0);
+  EXPECT_EQ(state.Commit(), 0);
+  // Nothing is left to write.
+  EXPECT_EQ(state.Commit(), 0);
+}
+
+}  // namespace
+}  // namespace contract
+}  // namespace resdb
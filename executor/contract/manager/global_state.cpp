@@ -42,7 +42,9 @@ uint256_t AccountToAddress(const eevm::Address& account) {
     return eevm::from_big_endian(h, sizeof(h));
 }
 
-GlobalState::GlobalState(resdb::Storage* storage) : storage_(storage) {}
+GlobalState::GlobalState(resdb::Storage* storage)
+    : storage_(storage),
+      contract_state_(std::make_unique<ContractState>(storage)) {}
 
 bool GlobalState::Exists(const eevm::Address& addr) {
   return accounts.find(addr) != accounts.cend();
@@ -59,7 +61,8 @@ AccountState GlobalState::get(const Address& addr) {
 
 AccountState GlobalState::create(const Address& addr, const uint256_t& balance,
                                  const Code& code) {
-  Insert({SimpleAccount(addr, balance, code), GlobalView(storage_)});
+  Insert({SimpleAccount(addr, balance, code),
+          GlobalView(contract_state_.get(), addr)});
 
   return get(addr);
 }
@@ -83,5 +86,9 @@ int GlobalState::SetBalance(const eevm::Address& account, const uint256_t& balan
   return storage_->SetValue(eevm::to_hex_string(AccountToAddress(account)), eevm::to_hex_string(balance));
 }
 
+int GlobalState::Commit() { return contract_state_->Commit(); }
+
+void GlobalState::Rollback() { contract_state_->Rollback(); }
+
 }  // namespace contract
 }  // namespace resdb
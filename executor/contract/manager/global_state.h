@@ -51,12 +51,18 @@ class GlobalState : public EVMState {
   std::string GetBalance(const eevm::Address& account);
   int SetBalance(const eevm::Address& account, const uint256_t& balance);
 
+  // Write the contract storage changed by the transaction, or drop it if the
+  // transaction failed.
+  int Commit();
+  void Rollback();
+
  protected:
   void Insert(const StateEntry& p);
 
  private:
   std::map<eevm::Address, StateEntry> accounts;
   resdb::Storage* storage_;
+  std::unique_ptr<ContractState> contract_state_;
 };
 
 }  // namespace contract
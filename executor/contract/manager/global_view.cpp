@@ -20,24 +20,24 @@
 
 #include "executor/contract/manager/global_view.h"
 
-#include <glog/logging.h>
-
-#include "eEVM/util.h"
-
 namespace resdb {
 namespace contract {
 
-GlobalView::GlobalView(resdb::Storage* storage) : storage_(storage) {}
+GlobalView::GlobalView(ContractState* state, const Address& address)
+    : state_(state), address_(address) {}
 
 void GlobalView::store(const uint256_t& key, const uint256_t& value) {
-  storage_->SetValue(eevm::to_hex_string(key), eevm::to_hex_string(value));
+  state_->Store(address_, key, value);
 }
 
 uint256_t GlobalView::load(const uint256_t& key) {
-  return eevm::to_uint256(storage_->GetValue(eevm::to_hex_string(key)));
+  return state_->Load(address_, key);
 }
 
-bool GlobalView::remove(const uint256_t& key) { return true; }
+bool GlobalView::remove(const uint256_t& key) {
+  state_->Store(address_, key, 0);
+  return true;
+}
 
 }  // namespace contract
 }  // namespace resdb
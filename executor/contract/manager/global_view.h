@@ -22,14 +22,15 @@
 #include <map>
 
 #include "eEVM/storage.h"
-#include "chain/storage/storage.h"
+#include "executor/contract/manager/contract_state.h"
 
 namespace resdb {
 namespace contract {
 
+// The storage of one contract, kept in the contract state.
 class GlobalView : public eevm::Storage {
  public:
-  GlobalView(resdb::Storage* storage);
+  GlobalView(ContractState* state, const Address& address);
   virtual ~GlobalView() = default;
 
   void store(const uint256_t& key, const uint256_t& value) override;
@@ -37,7 +38,8 @@ class GlobalView : public eevm::Storage {
   bool remove(const uint256_t& key) override;
 
  private:
-  resdb::Storage* storage_;
+  ContractState* state_;
+  Address address_;
 };
 
 }  // namespace contract
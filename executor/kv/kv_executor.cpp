@@ -22,10 +22,13 @@
 
 #include <glog/logging.h>
 
+#include <charconv>
+
 namespace resdb {
 
 KVExecutor::KVExecutor(std::unique_ptr<Storage> storage)
-    : storage_(std::move(storage)) {
+    : storage_(std::move(storage)),
+      index_(std::make_unique<KVIndex>(storage_.get())) {
     contract_manager_ = std::make_unique<resdb::contract::ContractTransactionManager>(storage_.get());
 }
 
@@ -43,38 +46,7 @@ std::unique_ptr<std::string> KVExecutor::ExecuteRequest(
     const google::protobuf::Message& request) {
   KVResponse kv_response;
   const KVRequest& kv_request = dynamic_cast<const KVRequest&>(request);
-
-  if (kv_request.cmd() == KVRequest::SET) {
-    Set(kv_request.key(), kv_request.value());
-  } else if (kv_request.cmd() == KVRequest::GET) {
-    kv_response.set_value(Get(kv_request.key()));
-  } else if (kv_request.cmd() == KVRequest::GETALLVALUES) {
-    kv_response.set_value(GetAllValues());
-  } else if (kv_request.cmd() == KVRequest::GETRANGE) {
-    kv_response.set_value(GetRange(kv_request.key(), kv_request.value()));
-  } else if (kv_request.cmd() == KVRequest::SET_WITH_VERSION) {
-    SetWithVersion(kv_request.key(), kv_request.value(), kv_request.version());
-  } else if (kv_request.cmd() == KVRequest::GET_WITH_VERSION) {
-    GetWithVersion(kv_request.key(), kv_request.version(),
-                   kv_response.mutable_value_info());
-  } else if (kv_request.cmd() == KVRequest::GET_ALL_ITEMS) {
-    GetAllItems(kv_response.mutable_items());
-  } else if (kv_request.cmd() == KVRequest::GET_KEY_RANGE) {
-    GetKeyRange(kv_request.min_key(), kv_request.max_key(),
-                kv_response.mutable_items());
-  } else if (kv_request.cmd() == KVRequest::GET_HISTORY) {
-    GetHistory(kv_request.key(), kv_request.min_version(),
-               kv_request.max_version(), kv_response.mutable_items());
-  } else if (kv_request.cmd() == KVRequest::GET_TOP) {
-    GetTopHistory(kv_request.key(), kv_request.top_number(),
-                  kv_response.mutable_items());
-  }
-  else if(!kv_request.smart_contract_request().empty()){
-    std::unique_ptr<std::string> resp = contract_manager_->ExecuteData(kv_request.smart_contract_request());
-    if(resp != nullptr){
-      kv_response.set_smart_contract_response(*resp);
-    }
-  }
+  Execute(kv_request, &kv_response);
 
   std::unique_ptr<std::string> resp_str = std::make_unique<std::string>();
   if (!kv_response.SerializeToString(resp_str.get())) {
@@ -84,6 +56,40 @@ std::unique_ptr<std::string> KVExecutor::ExecuteRequest(
   return resp_str;
 }
 
+void KVExecutor::Prefetch(const google::protobuf::Message& request) {
+  const KVRequest& kv_request = dynamic_cast<const KVRequest&>(request);
+  switch (kv_request.cmd()) {
+    case KVRequest::SET:
+    case KVRequest::GET:
+    case KVRequest::SET_WITH_VERSION:
+    case KVRequest::GET_WITH_VERSION:
+    case KVRequest::GET_HISTORY:
+    case KVRequest::GET_TOP:
+    case KVRequest::CAS:
+    case KVRequest::ADD:
+    case KVRequest::APPEND:
+    case KVRequest::SET_IF_ABSENT:
+      storage_->Prefetch(kv_request.key());
+      break;
+    case KVRequest::TXN:
+      for (const Condition& condition : kv_request.conditions()) {
+        storage_->Prefetch(condition.key());
+      }
+      [[fallthrough]];
+    case KVRequest::BATCH:
+      for (const KVRequest& op : kv_request.ops()) {
+        if (op.cmd() != KVRequest::BATCH && op.cmd() != KVRequest::TXN) {
+          Prefetch(op);
+        }
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+Storage* KVExecutor::GetStorage() { return storage_.get(); }
+
 std::unique_ptr<std::string> KVExecutor::ExecuteData(
     const std::string& request) {
   KVRequest kv_request;
@@ -95,48 +101,93 @@ std::unique_ptr<std::string> KVExecutor::ExecuteData(
   }
 
   LOG(ERROR)<<" execute cmd:"<<kv_request.cmd();
+  Execute(kv_request, &kv_response);
+
+  std::unique_ptr<std::string> resp_str = std::make_unique<std::string>();
+  if (!kv_response.SerializeToString(resp_str.get())) {
+    return nullptr;
+  }
+  return resp_str;
+}
+
+void KVExecutor::Execute(const KVRequest& kv_request,
+                         KVResponse* kv_response) {
   if (kv_request.cmd() == KVRequest::SET) {
     Set(kv_request.key(), kv_request.value());
   } else if (kv_request.cmd() == KVRequest::GET) {
-    kv_response.set_value(Get(kv_request.key()));
+    kv_response->set_value(Get(kv_request.key()));
   } else if (kv_request.cmd() == KVRequest::GETALLVALUES) {
-    kv_response.set_value(GetAllValues());
+    kv_response->set_value(GetAllValues());
   } else if (kv_request.cmd() == KVRequest::GETRANGE) {
-    kv_response.set_value(GetRange(kv_request.key(), kv_request.value()));
+    kv_response->set_value(GetRange(kv_request.key(), kv_request.value()));
   } else if (kv_request.cmd() == KVRequest::SET_WITH_VERSION) {
     SetWithVersion(kv_request.key(), kv_request.value(), kv_request.version());
   } else if (kv_request.cmd() == KVRequest::GET_WITH_VERSION) {
     GetWithVersion(kv_request.key(), kv_request.version(),
-                   kv_response.mutable_value_info());
+                   kv_response->mutable_value_info());
   } else if (kv_request.cmd() == KVRequest::GET_ALL_ITEMS) {
-    GetAllItems(kv_response.mutable_items());
+    GetAllItems(kv_response->mutable_items());
   } else if (kv_request.cmd() == KVRequest::GET_KEY_RANGE) {
     GetKeyRange(kv_request.min_key(), kv_request.max_key(),
-                kv_response.mutable_items());
+                kv_response->mutable_items());
   } else if (kv_request.cmd() == KVRequest::GET_HISTORY) {
     GetHistory(kv_request.key(), kv_request.min_version(),
-               kv_request.max_version(), kv_response.mutable_items());
+               kv_request.max_version(), kv_response->mutable_items());
   } else if (kv_request.cmd() == KVRequest::GET_TOP) {
     GetTopHistory(kv_request.key(), kv_request.top_number(),
-                  kv_response.mutable_items());
+                  kv_response->mutable_items());
+  } else if (kv_request.cmd() == KVRequest::BATCH) {
+    for (const KVRequest& op : kv_request.ops()) {
+      KVResponse* op_response = kv_response->add_ops();
+      // Batches are not nested.
+      if (op.cmd() == KVRequest::BATCH) {
+        op_response->set_status(KVResponse::INVALID);
+      } else {
+        Execute(op, op_response);
+      }
+    }
+  } else if (kv_request.cmd() == KVRequest::CAS) {
+    CompareAndSet(kv_request, kv_response);
+  } else if (kv_request.cmd() == KVRequest::ADD) {
+    Add(kv_request.key(), kv_request.delta(), kv_response);
+  } else if (kv_request.cmd() == KVRequest::APPEND) {
+    Append(kv_request.key(), kv_request.value(), kv_response);
+  } else if (kv_request.cmd() == KVRequest::SET_IF_ABSENT) {
+    SetIfAbsent(kv_request.key(), kv_request.value(), kv_response);
+  } else if (kv_request.cmd() == KVRequest::TXN) {
+    Txn(kv_request, kv_response);
+  } else if (kv_request.cmd() == KVRequest::CREATE_INDEX) {
+    CreateIndex(kv_request.index(), kv_response);
+  } else if (kv_request.cmd() == KVRequest::GET_BY_INDEX) {
+    GetByIndex(kv_request.index().name(), kv_request.value(),
+               kv_request.limit(), kv_response->mutable_items());
+  } else if (kv_request.cmd() == KVRequest::GET_BY_PREFIX) {
+    GetByPrefix(kv_request.key(), kv_request.limit(),
+                kv_response->mutable_items());
   }
   else if(!kv_request.smart_contract_request().empty()){
     std::unique_ptr<std::string> resp = contract_manager_->ExecuteData(kv_request.smart_contract_request());
     if(resp != nullptr){
-      kv_response.set_smart_contract_response(*resp);
+      kv_response->set_smart_contract_response(*resp);
     }
   }
-
-  std::unique_ptr<std::string> resp_str = std::make_unique<std::string>();
-  if (!kv_response.SerializeToString(resp_str.get())) {
-    return nullptr;
-  }
-  return resp_str;
 }
 
 void KVExecutor::Set(const std::string& key, const std::string& value) {
   LOG(ERROR)<<" set key:"<<key;
-  storage_->SetValue(key, value);
+  if (KVIndex::IsReserved(key)) {
+    LOG(ERROR) << "key is reserved for the indexes";
+    return;
+  }
+  if (index_->Empty()) {
+    storage_->SetValue(key, value);
+    return;
+  }
+  // The index entries are written in the same batch as the value.
+  std::vector<std::pair<std::string, std::string>> writes;
+  writes.push_back(std::make_pair(key, value));
+  index_->Update(key, storage_->GetValue(key), value, &writes);
+  storage_->SetValues(writes);
 }
 
 std::string KVExecutor::Get(const std::string& key) {
@@ -211,4 +262,217 @@ void KVExecutor::GetTopHistory(const std::string& key, int top_number,
   }
 }
 
+void KVExecutor::CompareAndSet(const KVRequest& kv_request,
+                               KVResponse* kv_response) {
+  const std::string& key = kv_request.key();
+  if (kv_request.expected_case() == KVRequest::kExpectedVersion) {
+    std::pair<std::string, int> ret = storage_->GetValueWithVersion(key, 0);
+    if (ret.second != kv_request.expected_version() ||
+        storage_->SetValueWithVersion(key, kv_request.value(),
+                                      kv_request.expected_version()) != 0) {
+      kv_response->set_status(KVResponse::CONDITION_FAILED);
+      kv_response->mutable_value_info()->set_value(ret.first);
+      kv_response->mutable_value_info()->set_version(ret.second);
+    }
+    return;
+  }
+
+  std::string value = Get(key);
+  if (value != kv_request.expected_value()) {
+    kv_response->set_status(KVResponse::CONDITION_FAILED);
+    kv_response->mutable_value_info()->set_value(value);
+    return;
+  }
+  Set(key, kv_request.value());
+}
+
+namespace {
+
+// Add delta to the decimal integer in value. A value that is empty counts as
+// 0. Returns false if value is not an integer or the sum overflows.
+bool AddDelta(const std::string& value, int64_t delta, int64_t* num) {
+  *num = 0;
+  if (!value.empty()) {
+    auto [ptr, ec] =
+        std::from_chars(value.data(), value.data() + value.size(), *num);
+    if (ec != std::errc() || ptr != value.data() + value.size()) {
+      return false;
+    }
+  }
+  return !__builtin_add_overflow(*num, delta, num);
+}
+
+}  // namespace
+
+void KVExecutor::Add(const std::string& key, int64_t delta,
+                     KVResponse* kv_response) {
+  std::string value = Get(key);
+  int64_t num = 0;
+  if (!AddDelta(value, delta, &num)) {
+    kv_response->set_status(KVResponse::INVALID);
+    kv_response->mutable_value_info()->set_value(value);
+    return;
+  }
+  Set(key, std::to_string(num));
+  kv_response->set_int_value(num);
+}
+
+void KVExecutor::Append(const std::string& key, const std::string& value,
+                        KVResponse* kv_response) {
+  Set(key, Get(key) + value);
+}
+
+void KVExecutor::SetIfAbsent(const std::string& key, const std::string& value,
+                             KVResponse* kv_response) {
+  std::string old_value = Get(key);
+  if (!old_value.empty()) {
+    kv_response->set_status(KVResponse::CONDITION_FAILED);
+    kv_response->mutable_value_info()->set_value(old_value);
+    return;
+  }
+  Set(key, value);
+}
+
+bool KVExecutor::CheckCondition(const Condition& condition) {
+  switch (condition.type()) {
+    case Condition::VALUE_EQUAL:
+      return Get(condition.key()) == condition.value();
+    case Condition::VERSION_EQUAL:
+      return storage_->GetValueWithVersion(condition.key(), 0).second ==
+             condition.version();
+    case Condition::EXISTS:
+      return !Get(condition.key()).empty();
+    case Condition::NOT_EXISTS:
+      return Get(condition.key()).empty();
+    default:
+      return false;
+  }
+}
+
+void KVExecutor::Txn(const KVRequest& kv_request, KVResponse* kv_response) {
+  for (int i = 0; i < kv_request.conditions_size(); ++i) {
+    if (!CheckCondition(kv_request.conditions(i))) {
+      kv_response->set_status(KVResponse::CONDITION_FAILED);
+      kv_response->set_failed_condition(i);
+      return;
+    }
+  }
+
+  // The ops run against the values staged by the ones before them. Nothing
+  // is written unless all of them succeed.
+  std::map<std::string, std::string> staged;
+  for (const KVRequest& op : kv_request.ops()) {
+    KVResponse* op_response = kv_response->add_ops();
+    if (!StageOp(op, &staged, op_response)) {
+      kv_response->set_status(op_response->status());
+      return;
+    }
+  }
+
+  std::vector<std::pair<std::string, std::string>> writes;
+  for (const auto& [key, value] : staged) {
+    writes.push_back(std::make_pair(key, value));
+    if (!index_->Empty()) {
+      index_->Update(key, storage_->GetValue(key), value, &writes);
+    }
+  }
+  if (!writes.empty() && storage_->SetValues(writes) != 0) {
+    LOG(ERROR) << "write txn fail";
+    kv_response->set_status(KVResponse::INVALID);
+  }
+}
+
+bool KVExecutor::StageOp(const KVRequest& op,
+                         std::map<std::string, std::string>* staged,
+                         KVResponse* op_response) {
+  const std::string& key = op.key();
+  if (KVIndex::IsReserved(key)) {
+    op_response->set_status(KVResponse::INVALID);
+    return false;
+  }
+  auto it = staged->find(key);
+  std::string value = it == staged->end() ? Get(key) : it->second;
+
+  switch (op.cmd()) {
+    case KVRequest::GET:
+      op_response->set_value(value);
+      return true;
+    case KVRequest::SET:
+      (*staged)[key] = op.value();
+      return true;
+    case KVRequest::CAS:
+      // Versioned keys are not written in a batch.
+      if (op.expected_case() == KVRequest::kExpectedVersion) {
+        break;
+      }
+      if (value != op.expected_value()) {
+        op_response->set_status(KVResponse::CONDITION_FAILED);
+        op_response->mutable_value_info()->set_value(value);
+        return false;
+      }
+      (*staged)[key] = op.value();
+      return true;
+    case KVRequest::ADD: {
+      int64_t num = 0;
+      if (!AddDelta(value, op.delta(), &num)) {
+        op_response->set_status(KVResponse::INVALID);
+        op_response->mutable_value_info()->set_value(value);
+        return false;
+      }
+      (*staged)[key] = std::to_string(num);
+      op_response->set_int_value(num);
+      return true;
+    }
+    case KVRequest::APPEND:
+      (*staged)[key] = value + op.value();
+      return true;
+    case KVRequest::SET_IF_ABSENT:
+      if (!value.empty()) {
+        op_response->set_status(KVResponse::CONDITION_FAILED);
+        op_response->mutable_value_info()->set_value(value);
+        return false;
+      }
+      (*staged)[key] = op.value();
+      return true;
+    default:
+      break;
+  }
+  op_response->set_status(KVResponse::INVALID);
+  return false;
+}
+
+void KVExecutor::CreateIndex(const Index& index, KVResponse* kv_response) {
+  int ret = index_->Create(index.name(), index.json_path());
+  if (ret > 0) {
+    kv_response->set_status(KVResponse::CONDITION_FAILED);
+  } else if (ret < 0) {
+    kv_response->set_status(KVResponse::INVALID);
+  }
+}
+
+void KVExecutor::GetByIndex(const std::string& name, const std::string& value,
+                            int limit, Items* items) {
+  for (const std::string& key : index_->Get(name, value, limit)) {
+    Item* item = items->add_item();
+    item->set_key(key);
+    item->mutable_value_info()->set_value(storage_->GetValue(key));
+  }
+}
+
+void KVExecutor::GetByPrefix(const std::string& prefix, int limit,
+                             Items* items) {
+  if (KVIndex::IsReserved(prefix)) {
+    return;
+  }
+  for (const auto& [key, value] : storage_->GetPrefix(prefix, limit)) {
+    // The reserved keys sort last.
+    if (KVIndex::IsReserved(key)) {
+      break;
+    }
+    Item* item = items->add_item();
+    item->set_key(key);
+    item->mutable_value_info()->set_value(value);
+  }
+}
+
 }  // namespace resdb
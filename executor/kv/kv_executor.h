@@ -25,6 +25,7 @@
 
 #include "chain/storage/storage.h"
 #include "executor/common/transaction_manager.h"
+#include "executor/kv/kv_index.h"
 #include "proto/kv/kv.pb.h"
 
 namespace resdb {
@@ -40,7 +41,13 @@ class KVExecutor : public TransactionManager {
       const std::string& request) override;
   std::unique_ptr<std::string> ExecuteRequest(
       const google::protobuf::Message& kv_request) override;
+  void Prefetch(const google::protobuf::Message& kv_request) override;
+
+  Storage* GetStorage() override;
+
  protected:
+  void Execute(const KVRequest& kv_request, KVResponse* kv_response);
+
   virtual void Set(const std::string& key, const std::string& value);
   std::string Get(const std::string& key);
   std::string GetAllValues();
@@ -56,8 +63,30 @@ class KVExecutor : public TransactionManager {
                   Items* items);
   void GetTopHistory(const std::string& key, int top_number, Items* items);
 
+  // Conditional and read-modify-write commands. They are applied as one
+  // step, so no other request runs between the read and the write.
+  void CompareAndSet(const KVRequest& kv_request, KVResponse* kv_response);
+  void Add(const std::string& key, int64_t delta, KVResponse* kv_response);
+  void Append(const std::string& key, const std::string& value,
+              KVResponse* kv_response);
+  void SetIfAbsent(const std::string& key, const std::string& value,
+                   KVResponse* kv_response);
+  // Run the ops of a txn as one write batch, or none of them if one fails.
+  void Txn(const KVRequest& kv_request, KVResponse* kv_response);
+  // Apply op to the values in staged, reading the others from the storage.
+  // Returns false, with the status in op_response, if op fails.
+  bool StageOp(const KVRequest& op, std::map<std::string, std::string>* staged,
+               KVResponse* op_response);
+  bool CheckCondition(const Condition& condition);
+
+  void CreateIndex(const Index& index, KVResponse* kv_response);
+  void GetByIndex(const std::string& name, const std::string& value, int limit,
+                  Items* items);
+  void GetByPrefix(const std::string& prefix, int limit, Items* items);
+
  private:
   std::unique_ptr<Storage> storage_;
+  std::unique_ptr<KVIndex> index_;
 
   std::unique_ptr<TransactionManager> contract_manager_;
 };
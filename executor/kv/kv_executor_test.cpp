@@ -227,6 +227,23 @@ class KVExecutorTest : public Test {
     return kv_response.items();
   }
 
+  KVResponse Execute(const KVRequest& request) {
+    std::string str;
+    if (!request.SerializeToString(&str)) {
+      return KVResponse();
+    }
+
+    auto resp = impl_->ExecuteData(str);
+    if (resp == nullptr) {
+      return KVResponse();
+    }
+    KVResponse kv_response;
+    if (!kv_response.ParseFromString(*resp)) {
+      return KVResponse();
+    }
+    return kv_response;
+  }
+
  protected:
   Storage* storage_ptr_;
 
@@ -338,6 +355,283 @@ TEST_F(KVExecutorTest, SetValueWithVersion) {
   }
 }
 
+TEST_F(KVExecutorTest, Batch) {
+  KVRequest request;
+  request.set_cmd(KVRequest::BATCH);
+  {
+    KVRequest* op = request.add_ops();
+    op->set_cmd(KVRequest::SET);
+    op->set_key("test_key");
+    op->set_value("test_value");
+  }
+  {
+    KVRequest* op = request.add_ops();
+    op->set_cmd(KVRequest::GET);
+    op->set_key("test_key");
+  }
+  {
+    KVRequest* op = request.add_ops();
+    op->set_cmd(KVRequest::BATCH);
+  }
+
+  KVResponse expected_response;
+  expected_response.add_ops();
+  expected_response.add_ops()->set_value("test_value");
+  // A nested batch is not run.
+  expected_response.add_ops()->set_status(KVResponse::INVALID);
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+  EXPECT_EQ(Get("test_key"), "test_value");
+}
+
+TEST_F(KVExecutorTest, CompareAndSet) {
+  KVRequest request;
+  request.set_cmd(KVRequest::CAS);
+  request.set_key("test_key");
+  request.set_expected_value("");
+  request.set_value("test_value");
+  EXPECT_THAT(Execute(request), EqualsProto(KVResponse()));
+  EXPECT_EQ(Get("test_key"), "test_value");
+
+  request.set_value("test_value_2");
+  KVResponse expected_response;
+  expected_response.set_status(KVResponse::CONDITION_FAILED);
+  expected_response.mutable_value_info()->set_value("test_value");
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+
+  request.set_expected_value("test_value");
+  EXPECT_THAT(Execute(request), EqualsProto(KVResponse()));
+  EXPECT_EQ(Get("test_key"), "test_value_2");
+}
+
+TEST_F(KVExecutorTest, CompareAndSetVersion) {
+  KVRequest request;
+  request.set_cmd(KVRequest::CAS);
+  request.set_key("test_key");
+  request.set_expected_version(0);
+  request.set_value("test_value");
+  EXPECT_THAT(Execute(request), EqualsProto(KVResponse()));
+
+  KVResponse expected_response;
+  expected_response.set_status(KVResponse::CONDITION_FAILED);
+  expected_response.mutable_value_info()->set_value("test_value");
+  expected_response.mutable_value_info()->set_version(1);
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+
+  request.set_expected_version(1);
+  request.set_value("test_value_2");
+  EXPECT_THAT(Execute(request), EqualsProto(KVResponse()));
+  EXPECT_EQ(Get("test_key", 0).value(), "test_value_2");
+}
+
+TEST_F(KVExecutorTest, Add) {
+  KVRequest request;
+  request.set_cmd(KVRequest::ADD);
+  request.set_key("test_key");
+  request.set_delta(5);
+  EXPECT_EQ(Execute(request).int_value(), 5);
+  request.set_delta(-2);
+  EXPECT_EQ(Execute(request).int_value(), 3);
+  EXPECT_EQ(Get("test_key"), "3");
+
+  Set("test_key", "test_value");
+  KVResponse expected_response;
+  expected_response.set_status(KVResponse::INVALID);
+  expected_response.mutable_value_info()->set_value("test_value");
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+
+  Set("test_key", std::to_string(INT64_MAX));
+  request.set_delta(1);
+  EXPECT_EQ(Execute(request).status(), KVResponse::INVALID);
+  EXPECT_EQ(Get("test_key"), std::to_string(INT64_MAX));
+}
+
+TEST_F(KVExecutorTest, AppendAndSetIfAbsent) {
+  KVRequest request;
+  request.set_cmd(KVRequest::SET_IF_ABSENT);
+  request.set_key("test_key");
+  request.set_value("test");
+  EXPECT_THAT(Execute(request), EqualsProto(KVResponse()));
+  EXPECT_EQ(Execute(request).status(), KVResponse::CONDITION_FAILED);
+
+  request.set_cmd(KVRequest::APPEND);
+  request.set_value("_value");
+  EXPECT_THAT(Execute(request), EqualsProto(KVResponse()));
+  EXPECT_EQ(Get("test_key"), "test_value");
+}
+
+TEST_F(KVExecutorTest, Txn) {
+  Set("from", "10");
+
+  KVRequest request;
+  request.set_cmd(KVRequest::TXN);
+  {
+    Condition* condition = request.add_conditions();
+    condition->set_type(Condition::VALUE_EQUAL);
+    condition->set_key("from");
+    condition->set_value("10");
+  }
+  {
+    Condition* condition = request.add_conditions();
+    condition->set_type(Condition::NOT_EXISTS);
+    condition->set_key("to");
+  }
+  {
+    KVRequest* op = request.add_ops();
+    op->set_cmd(KVRequest::SET);
+    op->set_key("from");
+    op->set_value("0");
+  }
+  {
+    KVRequest* op = request.add_ops();
+    op->set_cmd(KVRequest::SET);
+    op->set_key("to");
+    op->set_value("10");
+  }
+
+  KVResponse expected_response;
+  expected_response.add_ops();
+  expected_response.add_ops();
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+  EXPECT_EQ(Get("from"), "0");
+  EXPECT_EQ(Get("to"), "10");
+
+  // The first condition does not hold anymore.
+  expected_response.Clear();
+  expected_response.set_status(KVResponse::CONDITION_FAILED);
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+
+  request.mutable_conditions(0)->set_value("0");
+  expected_response.set_failed_condition(1);
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+}
+
+TEST_F(KVExecutorTest, TxnFailedOpAppliesNone) {
+  Set("from", "10");
+  Set("name", "abc");
+
+  KVRequest request;
+  request.set_cmd(KVRequest::TXN);
+  {
+    KVRequest* op = request.add_ops();
+    op->set_cmd(KVRequest::ADD);
+    op->set_key("from");
+    op->set_delta(-5);
+  }
+  {
+    // Sees the value added by the op before it.
+    KVRequest* op = request.add_ops();
+    op->set_cmd(KVRequest::GET);
+    op->set_key("from");
+  }
+  {
+    KVRequest* op = request.add_ops();
+    op->set_cmd(KVRequest::ADD);
+    op->set_key("name");
+    op->set_delta(5);
+  }
+
+  KVResponse expected_response;
+  expected_response.set_status(KVResponse::INVALID);
+  expected_response.add_ops()->set_int_value(5);
+  expected_response.add_ops()->set_value("5");
+  {
+    KVResponse* op_response = expected_response.add_ops();
+    op_response->set_status(KVResponse::INVALID);
+    op_response->mutable_value_info()->set_value("abc");
+  }
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+  EXPECT_EQ(Get("from"), "10");
+
+  // A failed cas also applies none.
+  request.mutable_ops(2)->set_cmd(KVRequest::CAS);
+  request.mutable_ops(2)->set_expected_value("xyz");
+  request.mutable_ops(2)->set_value("def");
+  expected_response.set_status(KVResponse::CONDITION_FAILED);
+  expected_response.mutable_ops(2)->set_status(KVResponse::CONDITION_FAILED);
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+  EXPECT_EQ(Get("from"), "10");
+
+  request.mutable_ops(2)->set_expected_value("abc");
+  expected_response.clear_status();
+  expected_response.mutable_ops(2)->Clear();
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+  EXPECT_EQ(Get("from"), "5");
+  EXPECT_EQ(Get("name"), "def");
+}
+
+TEST_F(KVExecutorTest, GetByIndex) {
+  Set("user_1", R"({"city":"paris"})");
+  Set("user_2", R"({"city":"rome"})");
+
+  KVRequest request;
+  request.set_cmd(KVRequest::CREATE_INDEX);
+  request.mutable_index()->set_name("city");
+  request.mutable_index()->set_json_path("city");
+  EXPECT_THAT(Execute(request), EqualsProto(KVResponse()));
+
+  // Keeps the index up to date.
+  Set("user_3", R"({"city":"paris"})");
+  Set("user_1", R"({"city":"rome"})");
+
+  request.Clear();
+  request.set_cmd(KVRequest::GET_BY_INDEX);
+  request.mutable_index()->set_name("city");
+  request.set_value("\"rome\"");
+
+  KVResponse expected_response;
+  {
+    Item* item = expected_response.mutable_items()->add_item();
+    item->set_key("user_1");
+    item->mutable_value_info()->set_value(R"({"city":"rome"})");
+  }
+  {
+    Item* item = expected_response.mutable_items()->add_item();
+    item->set_key("user_2");
+    item->mutable_value_info()->set_value(R"({"city":"rome"})");
+  }
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+
+  request.set_value("\"paris\"");
+  request.set_limit(1);
+  expected_response.Clear();
+  {
+    Item* item = expected_response.mutable_items()->add_item();
+    item->set_key("user_3");
+    item->mutable_value_info()->set_value(R"({"city":"paris"})");
+  }
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+}
+
+TEST_F(KVExecutorTest, GetByPrefix) {
+  Set("user_1", "value_1");
+  Set("user_2", "value_2");
+  Set("order_1", "value_3");
+  // The keys of the indexes are not written by the users.
+  Set("\xff" "index/a", "value_4");
+
+  KVRequest request;
+  request.set_cmd(KVRequest::GET_BY_PREFIX);
+  request.set_key("user_");
+
+  KVResponse expected_response;
+  {
+    Item* item = expected_response.mutable_items()->add_item();
+    item->set_key("user_1");
+    item->mutable_value_info()->set_value("value_1");
+  }
+  {
+    Item* item = expected_response.mutable_items()->add_item();
+    item->set_key("user_2");
+    item->mutable_value_info()->set_value("value_2");
+  }
+  EXPECT_THAT(Execute(request), EqualsProto(expected_response));
+
+  request.set_key("");
+  EXPECT_EQ(Execute(request).items().item_size(), 3);
+  request.set_key("\xff");
+  EXPECT_EQ(Execute(request).items().item_size(), 0);
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "executor/kv/kv_index.h"
+
+#include <glog/logging.h>
+
+#include <nlohmann/json.hpp>
+
+namespace resdb {
+
+namespace {
+
+const std::string kReservedPrefix(1, kReservedKeyPrefix);
+const std::string kIndexDefPrefix = kReservedPrefix + "index_def/";
+const std::string kIndexEntryPrefix = kReservedPrefix + "index/";
+// The number of keys read at a time when creating an index.
+constexpr int kCreatePageSize = 1000;
+
+// A field given as plain text is taken as a JSON string.
+std::string NormalizeField(const std::string& field) {
+  nlohmann::json json = nlohmann::json::parse(field, nullptr, false);
+  if (json.is_discarded()) {
+    return nlohmann::json(field).dump();
+  }
+  return json.dump();
+}
+
+std::optional<std::string> FindField(const nlohmann::json& json,
+                                     const std::string& json_path) {
+  const nlohmann::json* field = &json;
+  size_t pos = 0;
+  while (pos <= json_path.size()) {
+    size_t end = json_path.find('.', pos);
+    if (end == std::string::npos) {
+      end = json_path.size();
+    }
+    if (!field->is_object()) {
+      return std::nullopt;
+    }
+    auto it = field->find(json_path.substr(pos, end - pos));
+    if (it == field->end()) {
+      return std::nullopt;
+    }
+    field = &*it;
+    pos = end + 1;
+  }
+  return field->dump();
+}
+
+}  // namespace
+
+KVIndex::KVIndex(Storage* storage) : storage_(storage) {
+  for (const auto& [key, json_path] : storage_->GetPrefix(kIndexDefPrefix)) {
+    indexes_[key.substr(kIndexDefPrefix.size())] = json_path;
+  }
+}
+
+bool KVIndex::IsReserved(const std::string& key) {
+  return IsReservedKey(key);
+}
+
+std::optional<std::string> KVIndex::GetField(const std::string& value,
+                                             const std::string& json_path) {
+  return FindField(nlohmann::json::parse(value, nullptr, false), json_path);
+}
+
+std::string KVIndex::GetEntryPrefix(const std::string& name,
+                                    const std::string& field) {
+  // The dumped JSON escapes '\0', so it only separates the parts.
+  std::string prefix = kIndexEntryPrefix + name;
+  prefix.push_back('\0');
+  prefix.append(field);
+  prefix.push_back('\0');
+  return prefix;
+}
+
+int KVIndex::Create(const std::string& name, const std::string& json_path) {
+  if (name.empty() || name.find('\0') != std::string::npos ||
+      json_path.empty()) {
+    return -1;
+  }
+  auto it = indexes_.find(name);
+  if (it != indexes_.end()) {
+    return it->second == json_path ? 0 : 1;
+  }
+
+  // Add the entries a page of keys at a time. The definition goes last, so
+  // the index is not used before it is complete. Entries left by a failed
+  // create are written again by the next one.
+  std::vector<std::pair<std::string, std::string>> writes;
+  std::string start_key;
+  size_t entries = 0;
+  bool done = false;
+  while (!done) {
+    std::vector<std::pair<std::string, std::string>> page =
+        storage_->GetPrefix("", kCreatePageSize, start_key);
+    done = page.size() < static_cast<size_t>(kCreatePageSize);
+    for (const auto& [key, value] : page) {
+      // The reserved keys sort last, so stop at the first one.
+      if (IsReserved(key)) {
+        done = true;
+        break;
+      }
+      std::optional<std::string> field = GetField(value, json_path);
+      if (field.has_value() && !key.empty()) {
+        writes.push_back(
+            std::make_pair(GetEntryPrefix(name, *field) + key, key));
+      }
+    }
+    if (!page.empty()) {
+      start_key = page.back().first + '\0';
+    }
+    if (done) {
+      writes.push_back(std::make_pair(kIndexDefPrefix + name, json_path));
+    }
+    entries += writes.size();
+    if (storage_->SetValues(writes) != 0) {
+      LOG(ERROR) << "write index:" << name << " fail";
+      return -1;
+    }
+    writes.clear();
+  }
+  indexes_[name] = json_path;
+  LOG(ERROR) << "create index:" << name << " path:" << json_path
+             << " entries:" << entries - 1;
+  return 0;
+}
+
+void KVIndex::Update(
+    const std::string& key, const std::string& old_value,
+    const std::string& value,
+    std::vector<std::pair<std::string, std::string>>* writes) const {
+  // An entry holds the key as its value, which can not be empty.
+  if (key.empty()) {
+    return;
+  }
+  nlohmann::json old_json = nlohmann::json::parse(old_value, nullptr, false);
+  nlohmann::json json = nlohmann::json::parse(value, nullptr, false);
+  for (const auto& [name, json_path] : indexes_) {
+    std::optional<std::string> old_field = FindField(old_json, json_path);
+    std::optional<std::string> field = FindField(json, json_path);
+    if (old_field == field) {
+      continue;
+    }
+    if (old_field.has_value()) {
+      writes->push_back(
+          std::make_pair(GetEntryPrefix(name, *old_field) + key, ""));
+    }
+    if (field.has_value()) {
+      writes->push_back(std::make_pair(GetEntryPrefix(name, *field) + key, key));
+    }
+  }
+}
+
+std::vector<std::string> KVIndex::Get(const std::string& name,
+                                      const std::string& field_value,
+                                      int limit) const {
+  std::vector<std::string> keys;
+  if (indexes_.find(name) == indexes_.end()) {
+    return keys;
+  }
+  for (const auto& entry : storage_->GetPrefix(
+           GetEntryPrefix(name, NormalizeField(field_value)), limit)) {
+    keys.push_back(entry.second);
+  }
+  return keys;
+}
+
+}  // namespace resdb
@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "chain/storage/storage.h"
+
+namespace resdb {
+
+// Secondary indexes over a field of the JSON values of the non-version keys.
+// Both the definitions and the entries are kept in the storage under keys
+// starting with '\xff', so they are written in the same batch as the values
+// and sort after the user keys. An entry key is the index name, the field
+// value as JSON and the key, separated by '\0'.
+class KVIndex {
+ public:
+  KVIndex(Storage* storage);
+
+  bool Empty() const { return indexes_.empty(); }
+
+  // Create the index and add the entries of the keys stored. Returns 0 on
+  // success, 1 if an index of the name exists on another path, -1 if the
+  // name or the path is invalid.
+  int Create(const std::string& name, const std::string& json_path);
+
+  // Append to writes the entries to change when key goes from old_value to
+  // value.
+  void Update(const std::string& key, const std::string& old_value,
+              const std::string& value,
+              std::vector<std::pair<std::string, std::string>>* writes) const;
+
+  // Return the keys whose field is field_value, a JSON value like "\"a\"" or
+  // "42". At most limit of them if limit > 0.
+  std::vector<std::string> Get(const std::string& name,
+                               const std::string& field_value,
+                               int limit) const;
+
+  // The keys kept for the indexes, which the users can not write.
+  static bool IsReserved(const std::string& key);
+
+  // Return the field at json_path of value as JSON, or nullopt if value is
+  // not JSON or does not have the field.
+  static std::optional<std::string> GetField(const std::string& value,
+                                             const std::string& json_path);
+
+ private:
+  static std::string GetEntryPrefix(const std::string& name,
+                                    const std::string& field);
+
+ private:
+  Storage* storage_;
+  // Index name -> json path.
+  std::map<std::string, std::string> indexes_;
+};
+
+}  // namespace resdb
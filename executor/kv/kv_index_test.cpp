@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "executor/kv/kv_index.h"
+
+#include <gtest/gtest.h>
+
+#include "chain/storage/memory_db.h"
+
+namespace resdb {
+namespace {
+
+using storage::MemoryDB;
+using Writes = std::vector<std::pair<std::string, std::string>>;
+
+TEST(KVIndexTest, GetField) {
+  std::string value = R"({"name":"a","address":{"city":"paris","zip":75001}})";
+  EXPECT_EQ(KVIndex::GetField(value, "name"), "\"a\"");
+  EXPECT_EQ(KVIndex::GetField(value, "address.city"), "\"paris\"");
+  EXPECT_EQ(KVIndex::GetField(value, "address.zip"), "75001");
+  EXPECT_EQ(KVIndex::GetField(value, "address.street"), std::nullopt);
+  EXPECT_EQ(KVIndex::GetField(value, "name.first"), std::nullopt);
+  EXPECT_EQ(KVIndex::GetField("not json", "name"), std::nullopt);
+}
+
+TEST(KVIndexTest, CreateOnStoredKeys) {
+  MemoryDB db;
+  db.SetValue("key_1", R"({"city":"paris"})");
+  db.SetValue("key_2", R"({"city":"rome"})");
+  db.SetValue("key_3", R"({"city":"paris"})");
+  db.SetValue("key_4", "not json");
+
+  KVIndex index(&db);
+  EXPECT_TRUE(index.Empty());
+  EXPECT_EQ(index.Create("city", "city"), 0);
+  EXPECT_EQ(index.Create("city", "city"), 0);
+  EXPECT_EQ(index.Create("city", "town"), 1);
+  EXPECT_EQ(index.Create("", "city"), -1);
+
+  EXPECT_EQ(index.Get("city", "\"paris\"", 0),
+            std::vector<std::string>({"key_1", "key_3"}));
+  // Plain text is taken as a JSON string.
+  EXPECT_EQ(index.Get("city", "rome", 0), std::vector<std::string>({"key_2"}));
+  EXPECT_EQ(index.Get("city", "paris", 1), std::vector<std::string>({"key_1"}));
+  EXPECT_TRUE(index.Get("town", "paris", 0).empty());
+
+  // The definitions are loaded from the storage.
+  KVIndex loaded_index(&db);
+  EXPECT_FALSE(loaded_index.Empty());
+  EXPECT_EQ(loaded_index.Get("city", "rome", 0),
+            std::vector<std::string>({"key_2"}));
+}
+
+TEST(KVIndexTest, CreateOverPages) {
+  MemoryDB db;
+  // More keys than one page of the create.
+  for (int i = 0; i < 2500; ++i) {
+    db.SetValue("key_" + std::to_string(i),
+                R"({"id":)" + std::to_string(i % 2) + "}");
+  }
+
+  KVIndex index(&db);
+  EXPECT_EQ(index.Create("id", "id"), 0);
+  EXPECT_EQ(index.Get("id", "0", 0).size(), 1250);
+  EXPECT_EQ(index.Get("id", "1", 0).size(), 1250);
+}
+
+TEST(KVIndexTest, Update) {
+  MemoryDB db;
+  KVIndex index(&db);
+  EXPECT_EQ(index.Create("city", "city"), 0);
+
+  Writes writes;
+  index.Update("key_1", "", R"({"city":"paris"})", &writes);
+  ASSERT_EQ(writes.size(), 1);
+  EXPECT_EQ(writes[0].second, "key_1");
+  EXPECT_EQ(db.SetValues(writes), 0);
+  EXPECT_EQ(index.Get("city", "paris", 0),
+            std::vector<std::string>({"key_1"}));
+
+  // The field does not change.
+  writes.clear();
+  index.Update("key_1", R"({"city":"paris"})", R"({"city":"paris","n":1})",
+               &writes);
+  EXPECT_TRUE(writes.empty());
+
+  writes.clear();
+  index.Update("key_1", R"({"city":"paris"})", R"({"city":"rome"})", &writes);
+  ASSERT_EQ(writes.size(), 2);
+  EXPECT_EQ(writes[0].second, "");
+  EXPECT_EQ(db.SetValues(writes), 0);
+  EXPECT_TRUE(index.Get("city", "paris", 0).empty());
+  EXPECT_EQ(index.Get("city", "rome", 0), std::vector<std::string>({"key_1"}));
+}
+
+TEST(KVIndexTest, IsReserved) {
+  EXPECT_TRUE(KVIndex::IsReserved("\xff" "index/a"));
+  EXPECT_FALSE(KVIndex::IsReserved("key"));
+  EXPECT_FALSE(KVIndex::IsReserved(""));
+}
+
+}  // namespace
+}  // namespace resdb
@@ -49,6 +49,37 @@ std::unique_ptr<std::string> UTXOExecutor::ExecuteData(
   return ret_str;
 }
 
+std::unique_ptr<BatchUserResponse> UTXOExecutor::ExecuteBatch(
+    const BatchUserRequest& request) {
+  std::vector<UTXO> utxos;
+  std::vector<int> idx(request.user_requests_size(), -1);
+  for (int i = 0; i < request.user_requests_size(); ++i) {
+    UTXORequest utxo_request;
+    if (!utxo_request.ParseFromString(
+            request.user_requests(i).request().data())) {
+      LOG(ERROR) << "parse data fail";
+      continue;
+    }
+    idx[i] = utxos.size();
+    utxos.push_back(std::move(*utxo_request.mutable_utxo()));
+  }
+
+  std::vector<int64_t> rets = transaction_->AddTransactions(utxos);
+
+  std::unique_ptr<BatchUserResponse> batch_response =
+      std::make_unique<BatchUserResponse>();
+  for (int i = 0; i < request.user_requests_size(); ++i) {
+    std::string* resp_str = batch_response->add_response();
+    if (idx[i] < 0) {
+      continue;
+    }
+    UTXOResponse response;
+    response.set_ret(rets[idx[i]]);
+    response.SerializeToString(resp_str);
+  }
+  return batch_response;
+}
+
 QueryExecutor::QueryExecutor(Transaction* transaction, Wallet* wallet)
     : transaction_(transaction), wallet_(wallet) {}
 
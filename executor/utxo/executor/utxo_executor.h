@@ -36,6 +36,9 @@ class UTXOExecutor : public TransactionManager {
 
   std::unique_ptr<std::string> ExecuteData(const std::string& request) override;
 
+  std::unique_ptr<BatchUserResponse> ExecuteBatch(
+      const BatchUserRequest& request) override;
+
  private:
   Transaction* transaction_;
 };
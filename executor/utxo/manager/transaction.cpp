@@ -22,6 +22,7 @@
 #include <glog/logging.h>
 
 #include <iomanip>
+#include <set>
 #include <sstream>
 
 #include "common/crypto/hash.h"
@@ -33,6 +34,8 @@ namespace utxo {
 Transaction::Transaction(const Config& config, Wallet* wallet)
     : config_(config), wallet_(wallet) {
   tx_mempool_ = std::make_unique<TxMempool>();
+  verify_pool_ =
+      std::make_unique<ThreadPool>("utxo_verify", config_.verify_thread_num());
   for (const UTXO& trans : config_.genesis_transactions().transactions()) {
     int64_t transaction_id = tx_mempool_->AddUTXO(trans);
 
@@ -79,7 +82,59 @@ int64_t Transaction::AddTransaction(const std::string& utxo_str) {
   return AddTransaction(utxo);
 }
 
-absl::StatusOr<std::vector<UTXOOut>> Transaction::GetInput(const UTXO& utxo) {
+std::vector<int64_t> Transaction::AddTransactions(
+    const std::vector<UTXO>& utxos) {
+  // Phase 1: stateless signature checks. The mempool is only read here.
+  std::vector<VerifyState> states(utxos.size(), UNKNOWN);
+  verify_pool_->ParallelFor(
+      utxos.size(), [&](int i) { states[i] = PreVerify(utxos[i]); });
+
+  // Phase 2: apply the spends in the batch order.
+  std::vector<int64_t> ret;
+  ret.reserve(utxos.size());
+  for (size_t i = 0; i < utxos.size(); ++i) {
+    const UTXO& utxo = utxos[i];
+    if (states[i] == INVALID) {
+      ret.push_back(-1);
+      continue;
+    }
+    absl::StatusOr<std::vector<UTXOOut>> ins_or =
+        GetInput(utxo, /*verify_sig=*/states[i] != VERIFIED);
+    if (!ins_or.ok() || !VerifyUTXO(utxo, *ins_or) || AddCoin(utxo)) {
+      ret.push_back(-1);
+      continue;
+    }
+    ret.push_back(tx_mempool_->AddUTXO(utxo));
+  }
+  return ret;
+}
+
+Transaction::VerifyState Transaction::PreVerify(const UTXO& utxo) {
+  if (utxo.in_size() == 0) {
+    return UNKNOWN;
+  }
+  if (utxo.sig().empty()) {
+    return INVALID;
+  }
+  absl::StatusOr<std::string> public_key = tx_mempool_->GetPubKey(
+      utxo.in(0).prev_id(), utxo.in(0).out_idx(), utxo.address());
+  if (!public_key.ok()) {
+    return UNKNOWN;
+  }
+  return VerifySig(utxo, *public_key) ? VERIFIED : INVALID;
+}
+
+bool Transaction::VerifySig(const UTXO& utxo, const std::string& public_key) {
+  int64_t verify_nonce = 0;
+  for (const UTXOIn& input : utxo.in()) {
+    verify_nonce += input.prev_id();
+  }
+  return utils::ECDSAVerifyString(
+      utxo.address() + std::to_string(verify_nonce), public_key, utxo.sig());
+}
+
+absl::StatusOr<std::vector<UTXOOut>> Transaction::GetInput(const UTXO& utxo,
+                                                           bool verify_sig) {
   std::vector<UTXOOut> utxos;
   if (utxo.in_size() == 0) {
     if (utxo.address() == "0000") {
@@ -87,9 +142,14 @@ absl::StatusOr<std::vector<UTXOOut>> Transaction::GetInput(const UTXO& utxo) {
     }
   }
 
-  int64_t verify_nonce = 0;
   std::string public_key;
+  std::set<std::pair<int64_t, int>> spent;
   for (const UTXOIn& input : utxo.in()) {
+    if (!spent.insert(std::make_pair(input.prev_id(), input.out_idx()))
+             .second) {
+      LOG(ERROR) << "input spent twice:" << input.prev_id();
+      return absl::InvalidArgumentError("Input invalid.");
+    }
     absl::StatusOr<UTXOOut> utxo_or =
         tx_mempool_->GetUTXO(input.prev_id(), input.out_idx(), utxo.address());
     if (!utxo_or.ok()) {
@@ -100,7 +160,6 @@ absl::StatusOr<std::vector<UTXOOut>> Transaction::GetInput(const UTXO& utxo) {
     if (public_key.empty()) {
       public_key = (*utxo_or).pub_key();
     }
-    verify_nonce += input.prev_id();
   }
 
   if (utxos.empty()) {
@@ -113,11 +172,7 @@ absl::StatusOr<std::vector<UTXOOut>> Transaction::GetInput(const UTXO& utxo) {
     return absl::InvalidArgumentError("Input invalid.");
   }
 
-  LOG(ERROR) << "get public key:" << public_key << " nonce:" << verify_nonce;
-
-  bool valid = utils::ECDSAVerifyString(
-      utxo.address() + std::to_string(verify_nonce), public_key, utxo.sig());
-  if (!valid) {
+  if (verify_sig && !VerifySig(utxo, public_key)) {
     LOG(ERROR) << "key not valid";
     return absl::InvalidArgumentError("Key invalid.");
   }
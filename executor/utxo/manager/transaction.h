@@ -20,6 +20,7 @@
 #pragma once
 
 #include "absl/status/statusor.h"
+#include "common/utils/thread_pool.h"
 #include "executor/utxo/manager/tx_mempool.h"
 #include "executor/utxo/manager/wallet.h"
 #include "proto/utxo/config.pb.h"
@@ -36,6 +37,12 @@ class Transaction {
   int64_t AddTransaction(const std::string& utxo_string);
   int64_t AddTransaction(const UTXO& utxo);
 
+  // Add a batch of transactions and return the transaction id of each one,
+  // or -1 if it is rejected. The signatures of the whole batch are verified
+  // in parallel first, then the spends are applied one by one in the batch
+  // order, so a coin spent twice inside the batch is only accepted once.
+  std::vector<int64_t> AddTransactions(const std::vector<UTXO>& utxos);
+
   std::vector<UTXO> GetUTXO(int64_t end_id, int num);
 
  private:
@@ -44,12 +51,25 @@ class Transaction {
   int64_t GetUTXOOutValue(int64_t tx_id, int out_idx,
                           const std::string& address);
 
-  absl::StatusOr<std::vector<UTXOOut>> GetInput(const UTXO& utxo);
+  absl::StatusOr<std::vector<UTXOOut>> GetInput(const UTXO& utxo,
+                                                bool verify_sig = true);
+
+  enum VerifyState {
+    UNKNOWN = 0,
+    VERIFIED = 1,
+    INVALID = 2,
+  };
+  // Check the signature using only the owner key of the first input, which
+  // never changes once the input exists. Inputs created by an earlier
+  // transaction of the same batch are left UNKNOWN.
+  VerifyState PreVerify(const UTXO& utxo);
+  bool VerifySig(const UTXO& utxo, const std::string& public_key);
 
  private:
   std::unique_ptr<TxMempool> tx_mempool_;
   Config config_;
   Wallet* wallet_;
+  std::unique_ptr<ThreadPool> verify_pool_;
 };
 
 }  // namespace utxo
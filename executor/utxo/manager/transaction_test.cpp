@@ -112,6 +112,64 @@ TEST(TransanctionTest, DefaultUTXO) {
   EXPECT_EQ(wallet.GetCoin("1234"), 234);
 }
 
+TEST(TransanctionTest, BatchDoubleSpend) {
+  SecretKey key = KeyGenerator ::GeneratorKeys(SignatureInfo::ECDSA);
+  SecretKey key2 = KeyGenerator ::GeneratorKeys(SignatureInfo::ECDSA);
+
+  Config config;
+  {
+    auto* gensis_txn = config.mutable_genesis_transactions();
+    UTXO* utxo = gensis_txn->add_transactions();
+    UTXOOut* out = utxo->add_out();
+    out->set_address("0001");
+    out->set_value(1234);
+    out->set_pub_key(key.public_key());
+  }
+
+  Wallet wallet;
+  Transaction transaction(config, &wallet);
+
+  auto new_utxo = [](const SecretKey& key, const std::string& address,
+                     int64_t prev_id, const std::string& to, int64_t value,
+                     const std::string& pub_key) {
+    UTXO utxo;
+    UTXOIn* in = utxo.add_in();
+    in->set_prev_id(prev_id);
+    in->set_out_idx(0);
+
+    UTXOOut* out = utxo.add_out();
+    out->set_address(to);
+    out->set_value(value);
+    out->set_pub_key(pub_key);
+    utxo.set_address(address);
+    utxo.set_sig(utils::ECDSASignString(
+        key.private_key(), address + std::to_string(prev_id)));
+    return utxo;
+  };
+
+  std::vector<UTXO> utxos;
+  // The address owns the genesis output, but the signature is made with
+  // another key. The owner key is known before the batch, so the
+  // pre-verification rejects it and the output is left for the next one.
+  utxos.push_back(new_utxo(key2, "0001", 0, "4321", 100, key2.public_key()));
+  utxos.push_back(new_utxo(key, "0001", 0, "1234", 234, key2.public_key()));
+  // Spend the genesis output again.
+  utxos.push_back(new_utxo(key, "0001", 0, "4321", 100, key2.public_key()));
+  // Spend the output created by the first transaction of the batch.
+  utxos.push_back(new_utxo(key2, "1234", 1, "4321", 100, key2.public_key()));
+  // The address does not own the input.
+  utxos.push_back(new_utxo(key, "1234", 2, "4321", 10, key2.public_key()));
+  // The address owns the input, created inside the batch, but the signature
+  // is made with another key.
+  utxos.push_back(new_utxo(key, "4321", 2, "1234", 10, key2.public_key()));
+
+  std::vector<int64_t> ret = transaction.AddTransactions(utxos);
+  EXPECT_EQ(ret, std::vector<int64_t>({-1, 1, -1, 2, -1, -1}));
+
+  EXPECT_EQ(wallet.GetCoin("1234"), 0);
+  EXPECT_EQ(wallet.GetCoin("4321"), 100);
+}
+
 }  // namespace
 }  // namespace utxo
 }  // namespace resdb
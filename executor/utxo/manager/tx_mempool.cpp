@@ -28,7 +28,7 @@ TxMempool::TxMempool() : id_(0) {}
 TxMempool::~TxMempool() {}
 
 int64_t TxMempool::AddUTXO(const UTXO& utxo) {
-  LOG(ERROR) << "add utxo id:" << id_;
+  VLOG(2) << "add utxo id:" << id_;
   int64_t cur_id = id_++;
   txs_[cur_id] = std::make_unique<UTXO>(utxo);
   return cur_id;
@@ -61,6 +61,16 @@ absl::StatusOr<UTXOOut> TxMempool::GetUTXO(int64_t id, int out_idx,
   return utxo->out(out_idx);
 }
 
+absl::StatusOr<std::string> TxMempool::GetPubKey(
+    int64_t id, int out_idx, const std::string& address) const {
+  auto it = txs_.find(id);
+  if (it == txs_.end() || it->second->out_size() <= out_idx ||
+      it->second->out(out_idx).address() != address) {
+    return absl::InvalidArgumentError("id invalid.");
+  }
+  return it->second->out(out_idx).pub_key();
+}
+
 int64_t TxMempool::GetUTXOOutValue(int64_t id, int out_idx,
                                    const std::string& address) {
   if (txs_.find(id) == txs_.end()) {
@@ -40,6 +40,11 @@ class TxMempool {
   absl::StatusOr<UTXOOut> GetUTXO(int64_t id, int out_idx,
                                   const std::string& address);
 
+  // Get the owner key of output[out_idx] without touching the mempool, so it
+  // can be called from several threads while no transaction is being added.
+  absl::StatusOr<std::string> GetPubKey(int64_t id, int out_idx,
+                                        const std::string& address) const;
+
   // Mark the output of a trans has been spent.
   // Return the out value.
   int64_t MarkSpend(int64_t id, int out_idx, const std::string& address);
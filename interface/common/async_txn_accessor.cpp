@@ -0,0 +1,354 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "interface/common/async_txn_accessor.h"
+
+#include <glog/logging.h>
+
+#include "platform/common/network/frame.h"
+
+namespace resdb {
+
+namespace {
+
+// Larger answers are taken as a broken connection.
+constexpr size_t kMaxMessageSize = 1 << 30;
+// As many as the replicas serve at once.
+constexpr size_t kConnectionsPerReplica = 4;
+
+}  // namespace
+
+// A query waiting for the answers of the replicas.
+struct AsyncResDBTxnAccessor::Call {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::map<std::string, int> answers;
+  int min_match = 0;
+  // The replicas which have not answered yet.
+  int waiting = 0;
+  bool matched = false;
+  std::string result;
+};
+
+struct AsyncResDBTxnAccessor::Pending {
+  std::shared_ptr<Call> call;
+  std::shared_ptr<const std::string> message;
+  bool retried = false;
+};
+
+// Only used in the I/O thread once created. Queries are answered in the
+// order they were sent.
+struct AsyncResDBTxnAccessor::Connection {
+  Connection(boost::asio::io_context* io_context, const std::string& ip,
+             int port)
+      : socket(*io_context) {
+    boost::system::error_code error;
+    endpoint = boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::make_address(ip, error), port);
+    valid = !error;
+  }
+
+  boost::asio::ip::tcp::socket socket;
+  boost::asio::ip::tcp::endpoint endpoint;
+  bool valid = false;
+  bool connected = false;
+  bool connecting = false;
+  bool writing = false;
+  // Bumped on each error so that the callbacks of the closed socket are
+  // ignored.
+  uint64_t generation = 0;
+  std::deque<Pending> to_write;
+  std::deque<Pending> to_read;
+  char write_header[kFrameHeaderSize];
+  char read_header[kFrameHeaderSize];
+  std::string read_buf;
+};
+
+// The connections to one replica. They are opened when the ones already
+// open are busy.
+struct AsyncResDBTxnAccessor::ConnectionPool {
+  ConnectionPool(boost::asio::io_context* io_context, const std::string& ip,
+                 int port) {
+    for (size_t i = 0; i < kConnectionsPerReplica; ++i) {
+      connections.push_back(
+          std::make_unique<Connection>(io_context, ip, port));
+    }
+  }
+
+  std::vector<std::unique_ptr<Connection>> connections;
+};
+
+AsyncResDBTxnAccessor::AsyncResDBTxnAccessor(const ResDBConfig& config,
+                                             int timeout_ms)
+    : ResDBTxnAccessor(config),
+      timeout_ms_(timeout_ms),
+      work_guard_(boost::asio::make_work_guard(io_context_)) {
+  io_thread_ = std::thread([&]() { io_context_.run(); });
+}
+
+AsyncResDBTxnAccessor::~AsyncResDBTxnAccessor() {
+  work_guard_.reset();
+  io_context_.stop();
+  if (io_thread_.joinable()) {
+    io_thread_.join();
+  }
+}
+
+void AsyncResDBTxnAccessor::SetTimeoutMs(int timeout_ms) {
+  timeout_ms_ = timeout_ms;
+}
+
+absl::StatusOr<QueryResponse> AsyncResDBTxnAccessor::GetTxnPage(
+    const QueryRequest& request) {
+  std::vector<ConnectionPool*> pools;
+  for (const auto& replica : replicas_) {
+    pools.push_back(GetConnectionPool(replica));
+  }
+  return Query(request, pools, config_.GetMinClientReceiveNum());
+}
+
+absl::StatusOr<QueryResponse> AsyncResDBTxnAccessor::GetReplicaPage(
+    const QueryRequest& request, const ReplicaInfo& replica) {
+  return Query(request, {GetConnectionPool(replica)}, 1);
+}
+
+AsyncResDBTxnAccessor::ConnectionPool*
+AsyncResDBTxnAccessor::GetConnectionPool(const ReplicaInfo& replica) {
+  std::lock_guard<std::mutex> lk(mutex_);
+  auto& pool = pools_[std::make_pair(replica.ip(), replica.port())];
+  if (pool == nullptr) {
+    pool = std::make_unique<ConnectionPool>(&io_context_, replica.ip(),
+                                            replica.port());
+  }
+  return pool.get();
+}
+
+absl::StatusOr<QueryResponse> AsyncResDBTxnAccessor::Query(
+    const QueryRequest& request, const std::vector<ConnectionPool*>& pools,
+    int min_match) {
+  // Replicas keep serving queries on the connection.
+  QueryRequest query = request;
+  query.set_keep_alive(true);
+  Request header;
+  header.set_type(Request::TYPE_QUERY);
+  query.SerializeToString(header.mutable_data());
+  ResDBMessage message;
+  header.SerializeToString(message.mutable_data());
+  auto message_str = std::make_shared<const std::string>(
+      message.SerializeAsString());
+
+  auto call = std::make_shared<Call>();
+  call->min_match = min_match;
+  call->waiting = pools.size();
+  for (ConnectionPool* pool : pools) {
+    boost::asio::post(io_context_, [this, pool, call, message_str]() {
+      Send(pool, Pending{call, message_str});
+    });
+  }
+
+  std::unique_lock<std::mutex> lk(call->mutex);
+  bool done = call->cv.wait_for(
+      lk, std::chrono::milliseconds(timeout_ms_.load()),
+      [&]() { return call->matched || call->waiting == 0; });
+  if (!call->matched) {
+    LOG(ERROR) << "query fail, min seq:" << request.min_seq()
+               << " max seq:" << request.max_seq() << " timeout:" << !done;
+    return done ? absl::InternalError("recv data fail.")
+                : absl::DeadlineExceededError("query timeout.");
+  }
+  QueryResponse resp;
+  if (!resp.ParseFromString(call->result)) {
+    LOG(ERROR) << "parse fail len:" << call->result.size();
+    return absl::InternalError("recv data fail.");
+  }
+  return resp;
+}
+
+void AsyncResDBTxnAccessor::Finish(Call* call, const std::string* answer) {
+  std::lock_guard<std::mutex> lk(call->mutex);
+  if (answer != nullptr && ++call->answers[*answer] == call->min_match &&
+      !call->matched) {
+    call->matched = true;
+    call->result = *answer;
+  }
+  call->waiting--;
+  call->cv.notify_all();
+}
+
+void AsyncResDBTxnAccessor::Send(ConnectionPool* pool, Pending pending) {
+  Connection* least_busy = nullptr;
+  size_t least_queries = 0;
+  for (const auto& connection : pool->connections) {
+    size_t queries = connection->to_write.size() + connection->to_read.size();
+    if (least_busy == nullptr || queries < least_queries) {
+      least_busy = connection.get();
+      least_queries = queries;
+    }
+  }
+  Send(least_busy, std::move(pending));
+}
+
+void AsyncResDBTxnAccessor::Send(Connection* connection, Pending pending) {
+  if (!connection->valid) {
+    LOG(ERROR) << "invalid replica address";
+    Finish(pending.call.get(), nullptr);
+    return;
+  }
+  connection->to_write.push_back(std::move(pending));
+  if (connection->connected) {
+    Write(connection);
+  } else {
+    Connect(connection);
+  }
+}
+
+void AsyncResDBTxnAccessor::Connect(Connection* connection) {
+  if (connection->connecting) {
+    return;
+  }
+  connection->connecting = true;
+  uint64_t generation = connection->generation;
+  connection->socket.async_connect(
+      connection->endpoint,
+      [this, connection, generation](const boost::system::error_code& error) {
+        if (generation != connection->generation) {
+          return;
+        }
+        connection->connecting = false;
+        if (error) {
+          LOG(ERROR) << "connect fail:" << connection->endpoint
+                     << " error:" << error.message();
+          OnError(connection);
+          return;
+        }
+        boost::system::error_code ignored;
+        connection->socket.set_option(boost::asio::ip::tcp::no_delay(true),
+                                      ignored);
+        connection->connected = true;
+        Read(connection);
+        Write(connection);
+      });
+}
+
+void AsyncResDBTxnAccessor::Write(Connection* connection) {
+  if (connection->writing || connection->to_write.empty()) {
+    return;
+  }
+  connection->writing = true;
+  const std::string& data = *connection->to_write.front().message;
+  EncodeFrameHeader(data.size(), connection->write_header);
+  std::array<boost::asio::const_buffer, 2> buffers = {
+      boost::asio::buffer(connection->write_header, kFrameHeaderSize),
+      boost::asio::buffer(data)};
+  uint64_t generation = connection->generation;
+  boost::asio::async_write(
+      connection->socket, buffers,
+      [this, connection, generation](const boost::system::error_code& error,
+                                     size_t) {
+        if (generation != connection->generation) {
+          return;
+        }
+        connection->writing = false;
+        if (error) {
+          OnError(connection);
+          return;
+        }
+        connection->to_read.push_back(
+            std::move(connection->to_write.front()));
+        connection->to_write.pop_front();
+        Write(connection);
+      });
+}
+
+void AsyncResDBTxnAccessor::Read(Connection* connection) {
+  uint64_t generation = connection->generation;
+  boost::asio::async_read(
+      connection->socket,
+      boost::asio::buffer(connection->read_header, kFrameHeaderSize),
+      [this, connection, generation](const boost::system::error_code& error,
+                                     size_t) {
+        if (generation != connection->generation) {
+          return;
+        }
+        if (error) {
+          OnError(connection);
+          return;
+        }
+        uint64_t read_size = DecodeFrameHeader(connection->read_header);
+        if (read_size > kMaxMessageSize) {
+          OnError(connection);
+          return;
+        }
+        connection->read_buf.resize(read_size);
+        boost::asio::async_read(
+            connection->socket, boost::asio::buffer(connection->read_buf),
+            [this, connection, generation](
+                const boost::system::error_code& error, size_t) {
+              if (generation != connection->generation) {
+                return;
+              }
+              if (error) {
+                OnError(connection);
+                return;
+              }
+              if (!connection->to_read.empty()) {
+                Pending pending = std::move(connection->to_read.front());
+                connection->to_read.pop_front();
+                ResDBMessage message;
+                Finish(pending.call.get(),
+                       message.ParseFromString(connection->read_buf)
+                           ? &message.data()
+                           : nullptr);
+              }
+              Read(connection);
+            });
+      });
+}
+
+void AsyncResDBTxnAccessor::OnError(Connection* connection) {
+  bool was_connected = connection->connected;
+  connection->generation++;
+  boost::system::error_code ignored;
+  connection->socket.close(ignored);
+  connection->connected = false;
+  connection->connecting = false;
+  connection->writing = false;
+
+  std::deque<Pending> pendings = std::move(connection->to_read);
+  connection->to_read.clear();
+  for (Pending& pending : connection->to_write) {
+    pendings.push_back(std::move(pending));
+  }
+  connection->to_write.clear();
+  for (Pending& pending : pendings) {
+    // Replicas close the connections which stay idle, so a query sent on a
+    // reused connection gets one more try on a new one.
+    if (was_connected && !pending.retried) {
+      pending.retried = true;
+      connection->to_write.push_back(std::move(pending));
+    } else {
+      Finish(pending.call.get(), nullptr);
+    }
+  }
+  if (!connection->to_write.empty()) {
+    Connect(connection);
+  }
+}
+
+}  // namespace resdb
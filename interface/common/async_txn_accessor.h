@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <thread>
+
+#include "interface/common/resdb_txn_accessor.h"
+
+namespace resdb {
+
+// AsyncResDBTxnAccessor reads the replicas like ResDBTxnAccessor, but keeps
+// a few connections to each replica open and drives all of them from a
+// single I/O thread. A query is sent to every replica at once and returns as
+// soon as enough of them give the same answer, or when the deadline passes.
+// A replica answers the queries on a connection in order, so concurrent
+// queries go to its least busy connection.
+class AsyncResDBTxnAccessor : public ResDBTxnAccessor {
+ public:
+  AsyncResDBTxnAccessor(const ResDBConfig& config, int timeout_ms = 1000);
+  ~AsyncResDBTxnAccessor();
+
+  // The deadline of each page of a query.
+  void SetTimeoutMs(int timeout_ms);
+
+ protected:
+  absl::StatusOr<QueryResponse> GetTxnPage(
+      const QueryRequest& request) override;
+  absl::StatusOr<QueryResponse> GetReplicaPage(
+      const QueryRequest& request, const ReplicaInfo& replica) override;
+
+ private:
+  struct Call;
+  struct Pending;
+  struct Connection;
+  struct ConnectionPool;
+
+  // Sends the query to each replica and returns the answer given by
+  // min_match of them.
+  absl::StatusOr<QueryResponse> Query(const QueryRequest& request,
+                                      const std::vector<ConnectionPool*>& pools,
+                                      int min_match);
+  ConnectionPool* GetConnectionPool(const ReplicaInfo& replica);
+
+  // Run in the I/O thread.
+  void Send(ConnectionPool* pool, Pending pending);
+  void Send(Connection* connection, Pending pending);
+  void Connect(Connection* connection);
+  void Write(Connection* connection);
+  void Read(Connection* connection);
+  void OnError(Connection* connection);
+  static void Finish(Call* call, const std::string* answer);
+
+ private:
+  std::atomic<int> timeout_ms_;
+  boost::asio::io_context io_context_;
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+      work_guard_;
+  std::mutex mutex_;
+  // Keyed by ip and port.
+  std::map<std::pair<std::string, int>, std::unique_ptr<ConnectionPool>>
+      pools_;
+  std::thread io_thread_;
+};
+
+}  // namespace resdb
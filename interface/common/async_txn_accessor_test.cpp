@@ -0,0 +1,224 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "interface/common/async_txn_accessor.h"
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <signal.h>
+
+#include "platform/common/data_comm/data_comm.h"
+#include "platform/common/network/tcp_socket.h"
+#include "platform/config/resdb_config_utils.h"
+
+namespace resdb {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Serves each seq of a query as a transaction, page_size of them per page.
+class FakeReplica {
+ public:
+  FakeReplica(int port, int page_size, int delay_ms = 0,
+              bool close_after_answer = false)
+      : page_size_(page_size),
+        delay_ms_(delay_ms),
+        close_after_answer_(close_after_answer) {
+    // The accessor may drop a slow replica's connection before it answers.
+    signal(SIGPIPE, SIG_IGN);
+    socket_.SetRecvTimeout(100000);
+    EXPECT_EQ(socket_.Listen("127.0.0.1", port), 0);
+    thread_ = std::thread([this]() {
+      while (!stop_) {
+        std::unique_ptr<Socket> client = socket_.Accept();
+        if (client == nullptr) {
+          continue;
+        }
+        accept_num_++;
+        workers_.push_back(std::thread(
+            [this](std::unique_ptr<Socket> client) { Serve(client.get()); },
+            std::move(client)));
+      }
+    });
+  }
+
+  ~FakeReplica() {
+    stop_ = true;
+    thread_.join();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  int AcceptNum() { return accept_num_; }
+
+ private:
+  void Serve(Socket* client) {
+    client->SetRecvTimeout(100000);
+    client->SetNoDelay(true);
+    while (!stop_) {
+      std::unique_ptr<DataInfo> data = std::make_unique<DataInfo>();
+      int ret = client->Recv(&data->buff, &data->data_len);
+      if (ret < 0) {
+        continue;
+      }
+      ResDBMessage message;
+      Request request;
+      QueryRequest query;
+      if (ret == 0 ||
+          !message.ParseFromArray(data->buff, data->data_len) ||
+          !request.ParseFromString(message.data()) ||
+          !query.ParseFromString(request.data())) {
+        return;
+      }
+      QueryResponse response;
+      for (uint64_t seq = query.min_seq(); seq <= query.max_seq(); ++seq) {
+        if (response.transactions_size() == page_size_) {
+          response.set_next_seq(seq);
+          break;
+        }
+        Request* txn = response.add_transactions();
+        txn->set_seq(seq);
+        txn->set_data("txn" + std::to_string(seq));
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_));
+      ResDBMessage resp_message;
+      response.SerializeToString(resp_message.mutable_data());
+      client->Send(resp_message.SerializeAsString());
+      if (!query.keep_alive() || close_after_answer_) {
+        return;
+      }
+    }
+  }
+
+  TcpSocket socket_;
+  int page_size_;
+  int delay_ms_;
+  bool close_after_answer_;
+  std::atomic<bool> stop_ = false;
+  std::atomic<int> accept_num_ = 0;
+  std::thread thread_;
+  std::vector<std::thread> workers_;
+};
+
+ResDBConfig GenerateConfig(int port) {
+  return ResDBConfig({GenerateReplicaInfo(1, "127.0.0.1", port),
+                      GenerateReplicaInfo(2, "127.0.0.1", port + 1),
+                      GenerateReplicaInfo(3, "127.0.0.1", port + 2),
+                      GenerateReplicaInfo(4, "127.0.0.1", port + 3)},
+                     GenerateReplicaInfo(1, "127.0.0.1", port));
+}
+
+TEST(AsyncResDBTxnAccessorTest, GetTransactionsOnOneConnection) {
+  std::vector<std::unique_ptr<FakeReplica>> replicas;
+  for (int i = 0; i < 4; ++i) {
+    replicas.push_back(std::make_unique<FakeReplica>(13200 + i, 2));
+  }
+  AsyncResDBTxnAccessor accessor(GenerateConfig(13200));
+  for (int i = 0; i < 2; ++i) {
+    absl::StatusOr<std::vector<std::pair<uint64_t, std::string>>> resp =
+        accessor.GetTxn(1, 3);
+    ASSERT_TRUE(resp.ok());
+    EXPECT_THAT(*resp, ElementsAre(std::make_pair(1, "txn1"),
+                                   std::make_pair(2, "txn2"),
+                                   std::make_pair(3, "txn3")));
+  }
+  for (auto& replica : replicas) {
+    EXPECT_EQ(replica->AcceptNum(), 1);
+  }
+}
+
+TEST(AsyncResDBTxnAccessorTest, ConcurrentQueriesNotSerialized) {
+  std::vector<std::unique_ptr<FakeReplica>> replicas;
+  for (int i = 0; i < 4; ++i) {
+    replicas.push_back(std::make_unique<FakeReplica>(13250 + i, 10, 300));
+  }
+  AsyncResDBTxnAccessor accessor(GenerateConfig(13250), 2000);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> queries;
+  for (int i = 0; i < 4; ++i) {
+    queries.push_back(std::thread([&accessor, i]() {
+      absl::StatusOr<std::vector<std::pair<uint64_t, std::string>>> resp =
+          accessor.GetTxn(i + 1, i + 1);
+      ASSERT_TRUE(resp.ok());
+      std::string txn = "txn" + std::to_string(i + 1);
+      EXPECT_THAT(*resp, ElementsAre(std::make_pair(i + 1, txn)));
+    }));
+  }
+  for (auto& query : queries) {
+    query.join();
+  }
+  // On one connection per replica, the queries would take 4 * 300ms.
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(900));
+  for (auto& replica : replicas) {
+    EXPECT_GT(replica->AcceptNum(), 1);
+  }
+}
+
+TEST(AsyncResDBTxnAccessorTest, NotWaitForSlowReplica) {
+  std::vector<std::unique_ptr<FakeReplica>> replicas;
+  for (int i = 0; i < 4; ++i) {
+    replicas.push_back(
+        std::make_unique<FakeReplica>(13210 + i, 10, i == 3 ? 3000 : 0));
+  }
+  AsyncResDBTxnAccessor accessor(GenerateConfig(13210), 2000);
+  auto start = std::chrono::steady_clock::now();
+  absl::StatusOr<std::vector<std::pair<uint64_t, std::string>>> resp =
+      accessor.GetTxn(1, 1);
+  ASSERT_TRUE(resp.ok());
+  EXPECT_THAT(*resp, ElementsAre(std::make_pair(1, "txn1")));
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(1000));
+}
+
+TEST(AsyncResDBTxnAccessorTest, Deadline) {
+  std::vector<std::unique_ptr<FakeReplica>> replicas;
+  for (int i = 0; i < 4; ++i) {
+    replicas.push_back(std::make_unique<FakeReplica>(13220 + i, 10, 500));
+  }
+  AsyncResDBTxnAccessor accessor(GenerateConfig(13220), 50);
+  absl::StatusOr<std::vector<std::pair<uint64_t, std::string>>> resp =
+      accessor.GetTxn(1, 1);
+  EXPECT_EQ(resp.status().code(), absl::StatusCode::kDeadlineExceeded);
+}
+
+TEST(AsyncResDBTxnAccessorTest, ReplicaNotRunning) {
+  AsyncResDBTxnAccessor accessor(GenerateConfig(13230));
+  absl::StatusOr<std::vector<std::pair<uint64_t, std::string>>> resp =
+      accessor.GetTxn(1, 1);
+  EXPECT_EQ(resp.status().code(), absl::StatusCode::kInternal);
+}
+
+TEST(AsyncResDBTxnAccessorTest, ReconnectClosedConnection) {
+  FakeReplica replica(13240, 10, 0, /*close_after_answer=*/true);
+  AsyncResDBTxnAccessor accessor(GenerateConfig(13240));
+  for (int i = 0; i < 3; ++i) {
+    absl::StatusOr<std::vector<Request>> resp = accessor.GetRequestFromReplica(
+        1, 2, GenerateReplicaInfo(1, "127.0.0.1", 13240));
+    ASSERT_TRUE(resp.ok());
+    ASSERT_EQ(resp->size(), 2);
+    EXPECT_EQ((*resp)[1].data(), "txn2");
+  }
+  EXPECT_EQ(replica.AcceptNum(), 3);
+}
+
+}  // namespace
+}  // namespace resdb
@@ -43,6 +43,25 @@ ResDBTxnAccessor::GetTxn(uint64_t min_seq, uint64_t max_seq) {
   request.set_min_seq(min_seq);
   request.set_max_seq(max_seq);
 
+  std::vector<std::pair<uint64_t, std::string>> txn_resp;
+  while (true) {
+    absl::StatusOr<QueryResponse> resp = GetTxnPage(request);
+    if (!resp.ok()) {
+      return resp.status();
+    }
+    for (auto& transaction : resp->transactions()) {
+      txn_resp.push_back(std::make_pair(transaction.seq(), transaction.data()));
+    }
+    if (resp->next_seq() == 0) {
+      break;
+    }
+    request.set_min_seq(resp->next_seq());
+  }
+  return txn_resp;
+}
+
+absl::StatusOr<QueryResponse> ResDBTxnAccessor::GetTxnPage(
+    const QueryRequest& request) {
   std::vector<std::unique_ptr<NetChannel>> clients;
   std::vector<std::thread> ths;
   std::string final_str;
@@ -97,20 +116,16 @@ ResDBTxnAccessor::GetTxn(uint64_t min_seq, uint64_t max_seq) {
     }
   }
 
-  std::vector<std::pair<uint64_t, std::string>> txn_resp;
   QueryResponse resp;
   if (success && final_str.empty()) {
-    return txn_resp;
+    return resp;
   }
 
   if (final_str.empty() || !resp.ParseFromString(final_str)) {
     LOG(ERROR) << "parse fail len:" << final_str.size();
     return absl::InternalError("recv data fail.");
   }
-  for (auto& transaction : resp.transactions()) {
-    txn_resp.push_back(std::make_pair(transaction.seq(), transaction.data()));
-  }
-  return txn_resp;
+  return resp;
 }
 
 absl::StatusOr<std::vector<Request>> ResDBTxnAccessor::GetRequestFromReplica(
@@ -119,6 +134,25 @@ absl::StatusOr<std::vector<Request>> ResDBTxnAccessor::GetRequestFromReplica(
   request.set_min_seq(min_seq);
   request.set_max_seq(max_seq);
 
+  std::vector<Request> txn_resp;
+  while (true) {
+    absl::StatusOr<QueryResponse> resp = GetReplicaPage(request, replica);
+    if (!resp.ok()) {
+      return resp.status();
+    }
+    for (auto& transaction : *resp->mutable_transactions()) {
+      txn_resp.push_back(std::move(transaction));
+    }
+    if (resp->next_seq() == 0) {
+      break;
+    }
+    request.set_min_seq(resp->next_seq());
+  }
+  return txn_resp;
+}
+
+absl::StatusOr<QueryResponse> ResDBTxnAccessor::GetReplicaPage(
+    const QueryRequest& request, const ReplicaInfo& replica) {
   std::unique_ptr<NetChannel> client =
       GetNetChannel(replica.ip(), replica.port());
 
@@ -139,12 +173,7 @@ absl::StatusOr<std::vector<Request>> ResDBTxnAccessor::GetRequestFromReplica(
     LOG(ERROR) << "parse fail len:" << response_str.size();
     return absl::InternalError("recv data fail.");
   }
-
-  std::vector<Request> txn_resp;
-  for (auto& transaction : resp.transactions()) {
-    txn_resp.push_back(transaction);
-  }
-  return txn_resp;
+  return resp;
 }
 
 absl::StatusOr<uint64_t> ResDBTxnAccessor::GetBlockNumbers() {
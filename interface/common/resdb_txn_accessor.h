@@ -33,7 +33,8 @@ class ResDBTxnAccessor {
   ResDBTxnAccessor(const ResDBConfig& config);
   virtual ~ResDBTxnAccessor() = default;
 
-  // Obtain ReplicaState of each replica.
+  // Obtain ReplicaState of each replica. Replicas answer a large range in
+  // pages, which are fetched one after another.
   virtual absl::StatusOr<std::vector<std::pair<uint64_t, std::string>>> GetTxn(
       uint64_t min_seq, uint64_t max_seq);
 
@@ -45,7 +46,13 @@ class ResDBTxnAccessor {
   virtual std::unique_ptr<NetChannel> GetNetChannel(const std::string& ip,
                                                     int port);
 
- private:
+  // One page of the query, agreed by enough replicas.
+  virtual absl::StatusOr<QueryResponse> GetTxnPage(const QueryRequest& request);
+  // One page of the query, from the replica.
+  virtual absl::StatusOr<QueryResponse> GetReplicaPage(
+      const QueryRequest& request, const ReplicaInfo& replica);
+
+ protected:
   ResDBConfig config_;
   std::vector<ReplicaInfo> replicas_;
   int recv_timeout_ = 1;
@@ -158,5 +158,47 @@ TEST(ResDBTxnAccessorTest, GetTransactionsOneDelay) {
   EXPECT_THAT(*resp, ElementsAre(std::make_pair(1, "test_resp")));
 }
 
+TEST(ResDBTxnAccessorTest, GetTransactionsInPages) {
+  ResDBConfig config({GenerateReplicaInfo(1, "127.0.0.1", 1234),
+                      GenerateReplicaInfo(2, "127.0.0.1", 1235),
+                      GenerateReplicaInfo(3, "127.0.0.1", 1236),
+                      GenerateReplicaInfo(4, "127.0.0.1", 1237)},
+                     GenerateReplicaInfo(1, "127.0.0.1", 1234));
+
+  MockResDBTxnAccessor client(config);
+  EXPECT_CALL(client, GetNetChannel)
+      .Times(8)
+      .WillRepeatedly(Invoke([&](const std::string& ip, int port) {
+        auto client = std::make_unique<MockNetChannel>(ip, port);
+        auto min_seq = std::make_shared<uint64_t>(0);
+        EXPECT_CALL(*client, SendRequest(_, Request::TYPE_QUERY, _))
+            .WillOnce(Invoke([min_seq](const google::protobuf::Message& msg,
+                                       Request::Type, bool) {
+              *min_seq = dynamic_cast<const QueryRequest&>(msg).min_seq();
+              return 0;
+            }));
+        // Each page holds one transaction.
+        EXPECT_CALL(*client, RecvRawMessageStr)
+            .WillOnce(Invoke([min_seq](std::string* resp) {
+              QueryResponse query_resp;
+              auto txn = query_resp.add_transactions();
+              txn->set_seq(*min_seq);
+              txn->set_data("txn" + std::to_string(*min_seq));
+              if (*min_seq == 1) {
+                query_resp.set_next_seq(2);
+              }
+              query_resp.SerializeToString(resp);
+              return 0;
+            }));
+        return client;
+      }));
+
+  absl::StatusOr<std::vector<std::pair<uint64_t, std::string>>> resp =
+      client.GetTxn(1, 2);
+  EXPECT_TRUE(resp.ok());
+  EXPECT_THAT(*resp, ElementsAre(std::make_pair(1, "txn1"),
+                                 std::make_pair(2, "txn2")));
+}
+
 }  // namespace
 }  // namespace resdb
@@ -0,0 +1,205 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "interface/kv/async_kv_client.h"
+
+#include <glog/logging.h>
+
+namespace resdb {
+
+AsyncKVClient::AsyncKVClient(const ResDBConfig& config, int max_inflight,
+                             int max_batch_size)
+    : config_(config),
+      stop_(false),
+      queue_("async_kv_client", max_batch_size) {
+  int async_client_port = config_.GetConfigData().async_client_port();
+  if (async_client_port > 0) {
+    for (const auto& replica : config_.GetReplicaInfos()) {
+      async_channels_.push_back(
+          std::make_unique<AsyncClientChannel>(replica.ip(), async_client_port));
+    }
+  }
+  for (int i = 0; i < max_inflight; ++i) {
+    slots_.push_back(std::thread(&AsyncKVClient::SendBatch, this, i));
+  }
+}
+
+AsyncKVClient::~AsyncKVClient() { Stop(); }
+
+void AsyncKVClient::Stop() {
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    stop_ = true;
+  }
+  for (auto& slot : slots_) {
+    if (slot.joinable()) {
+      slot.join();
+    }
+  }
+  while (true) {
+    std::vector<std::unique_ptr<Operation>> ops = queue_.Pop(0);
+    if (ops.empty()) {
+      break;
+    }
+    for (auto& op : ops) {
+      op->callback(nullptr);
+    }
+  }
+}
+
+std::unique_ptr<TransactionConstructor> AsyncKVClient::NewChannel(int idx) {
+  auto channel = std::make_unique<TransactionConstructor>(config_);
+  channel->SetDestReplicaIndex(idx);
+  return channel;
+}
+
+void AsyncKVClient::Send(const KVRequest& request, Callback callback) {
+  auto op = std::make_unique<Operation>();
+  op->request = request;
+  op->callback = std::move(callback);
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (!stop_) {
+      queue_.Push(std::move(op));
+      return;
+    }
+  }
+  op->callback(nullptr);
+}
+
+std::future<int> AsyncKVClient::Set(const std::string& key,
+                                    const std::string& data) {
+  auto done = std::make_shared<std::promise<int>>();
+  KVRequest request;
+  request.set_cmd(KVRequest::SET);
+  request.set_key(key);
+  request.set_value(data);
+  Send(request, [done](std::unique_ptr<KVResponse> response) {
+    done->set_value(response == nullptr ? -1 : 0);
+  });
+  return done->get_future();
+}
+
+std::future<std::unique_ptr<std::string>> AsyncKVClient::Get(
+    const std::string& key) {
+  auto done = std::make_shared<std::promise<std::unique_ptr<std::string>>>();
+  KVRequest request;
+  request.set_cmd(KVRequest::GET);
+  request.set_key(key);
+  Send(request, [done](std::unique_ptr<KVResponse> response) {
+    if (response == nullptr) {
+      done->set_value(nullptr);
+      return;
+    }
+    done->set_value(std::make_unique<std::string>(response->value()));
+  });
+  return done->get_future();
+}
+
+bool AsyncKVClient::IsReadOnly(const KVRequest& request) {
+  switch (request.cmd()) {
+    case KVRequest::GET:
+    case KVRequest::GETALLVALUES:
+    case KVRequest::GETRANGE:
+    case KVRequest::GET_WITH_VERSION:
+    case KVRequest::GET_ALL_ITEMS:
+    case KVRequest::GET_KEY_RANGE:
+    case KVRequest::GET_HISTORY:
+    case KVRequest::GET_TOP:
+    case KVRequest::GET_BY_INDEX:
+    case KVRequest::GET_BY_PREFIX:
+      return true;
+    case KVRequest::BATCH:
+      for (const KVRequest& op : request.ops()) {
+        if (!IsReadOnly(op)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+int AsyncKVClient::SendWithRetry(TransactionConstructor* channel,
+                                 int* replica_idx, const KVRequest& request,
+                                 KVResponse* response) {
+  for (int i = 0; i < max_retry_time_; ++i) {
+    int ret = SendToReplica(channel, *replica_idx, request, response);
+    if (ret == 0) {
+      return 0;
+    }
+    if (ret != -1 && !IsReadOnly(request)) {
+      // The replica may have executed the writes already.
+      LOG(ERROR) << "no response of a write batch from replica:"
+                 << *replica_idx;
+      *replica_idx = (*replica_idx + 1) % channel->GetReplicaNum();
+      return -1;
+    }
+    // Fail over to the next replica.
+    *replica_idx = (*replica_idx + 1) % channel->GetReplicaNum();
+    LOG(ERROR) << "send batch fail, retry on replica:" << *replica_idx;
+  }
+  return -1;
+}
+
+int AsyncKVClient::SendToReplica(TransactionConstructor* channel,
+                                 int replica_idx, const KVRequest& request,
+                                 KVResponse* response) {
+  if (!async_channels_.empty()) {
+    return async_channels_[replica_idx]->SendRequest(
+        request, response, Request::TYPE_CLIENT_REQUEST,
+        config_.GetClientTimeoutMs());
+  }
+  channel->SetDestReplicaIndex(replica_idx);
+  return channel->SendRequest(request, response);
+}
+
+void AsyncKVClient::SendBatch(int slot) {
+  int replica_idx = slot % config_.GetReplicaInfos().size();
+  std::unique_ptr<TransactionConstructor> channel;
+  while (!stop_) {
+    std::vector<std::unique_ptr<Operation>> ops = queue_.Pop(1000);
+    if (ops.empty()) {
+      continue;
+    }
+    if (channel == nullptr) {
+      channel = NewChannel(replica_idx);
+    }
+
+    KVRequest request;
+    request.set_cmd(KVRequest::BATCH);
+    for (const auto& op : ops) {
+      *request.add_ops() = op->request;
+    }
+
+    KVResponse response;
+    int ret = SendWithRetry(channel.get(), &replica_idx, request, &response);
+    for (size_t i = 0; i < ops.size(); ++i) {
+      if (ret != 0 || static_cast<int>(i) >= response.ops_size()) {
+        ops[i]->callback(nullptr);
+        continue;
+      }
+      ops[i]->callback(
+          std::make_unique<KVResponse>(std::move(*response.mutable_ops(i))));
+    }
+  }
+}
+
+}  // namespace resdb
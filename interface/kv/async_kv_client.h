@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "interface/rdbc/async_client_channel.h"
+#include "interface/rdbc/transaction_constructor.h"
+#include "platform/common/queue/batch_queue.h"
+#include "proto/kv/kv.pb.h"
+
+namespace resdb {
+
+// AsyncKVClient keeps many requests in flight instead of waiting for each
+// one before sending the next. Operations from the caller are queued and
+// coalesced into BATCH KVRequests; each in-flight slot sends its batches to
+// one replica, spreading the slots over all the replicas. If a batch can not
+// be sent, the slot moves to the next replica and sends it again. A batch
+// that was sent but got no response is only resent if all its ops are reads,
+// since the replica may already have executed the writes.
+//
+// If the replicas serve async_client_port, the slots share one multiplexed
+// AsyncClientChannel per replica instead of opening a connection for each
+// batch.
+class AsyncKVClient {
+ public:
+  // The response of an operation, or nullptr if it failed.
+  typedef std::function<void(std::unique_ptr<KVResponse>)> Callback;
+
+  AsyncKVClient(const ResDBConfig& config, int max_inflight = 16,
+                int max_batch_size = 64);
+  ~AsyncKVClient();
+
+  // Stop the slots. Operations still in the queue get a nullptr response.
+  void Stop();
+
+  // Queue one operation. The callback is called from a client thread.
+  void Send(const KVRequest& request, Callback callback);
+
+  std::future<int> Set(const std::string& key, const std::string& data);
+  std::future<std::unique_ptr<std::string>> Get(const std::string& key);
+
+ protected:
+  // The channel used by a slot to talk to the idx-th replica.
+  virtual std::unique_ptr<TransactionConstructor> NewChannel(int idx);
+
+ private:
+  struct Operation {
+    KVRequest request;
+    Callback callback;
+  };
+
+  void SendBatch(int slot);
+  static bool IsReadOnly(const KVRequest& request);
+  int SendWithRetry(TransactionConstructor* channel, int* replica_idx,
+                    const KVRequest& request, KVResponse* response);
+  int SendToReplica(TransactionConstructor* channel, int replica_idx,
+                    const KVRequest& request, KVResponse* response);
+
+ private:
+  ResDBConfig config_;
+  int max_retry_time_ = 3;
+  std::atomic<bool> stop_;
+  std::mutex mutex_;
+  BatchQueue<std::unique_ptr<Operation>> queue_;
+  std::vector<std::unique_ptr<AsyncClientChannel>> async_channels_;
+  std::vector<std::thread> slots_;
+};
+
+}  // namespace resdb
@@ -0,0 +1,264 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "interface/kv/async_kv_client.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "chain/storage/memory_db.h"
+#include "executor/kv/kv_executor.h"
+#include "platform/common/network/mock_socket.h"
+#include "platform/rdbc/async_client_acceptor.h"
+
+namespace resdb {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Test;
+
+// The replica listening on dead_port never accepts a connection and the one
+// on mute_port never responds. The others answer each op of a batch with the
+// key of the op, or run the batch on the executor if one is set.
+class TestAsyncKVClient : public AsyncKVClient {
+ public:
+  TestAsyncKVClient(const ResDBConfig& config, int dead_port,
+                    int mute_port = 0, int max_inflight = 1)
+      : AsyncKVClient(config, max_inflight, 64),
+        dead_port_(dead_port),
+        mute_port_(mute_port) {}
+  ~TestAsyncKVClient() { Stop(); }
+
+  std::atomic<int> batch_num = 0;
+
+  // Must be set before sending.
+  void SetExecutor(KVExecutor* executor) { executor_ = executor; }
+
+ protected:
+  std::unique_ptr<TransactionConstructor> NewChannel(int idx) override {
+    auto socket = std::make_unique<NiceMock<MockSocket>>();
+    auto port = std::make_shared<int>(0);
+    ON_CALL(*socket, Connect(_, _))
+        .WillByDefault(
+            Invoke([this, port](const std::string& ip, int dest_port) {
+              *port = dest_port;
+              return dest_port == dead_port_ ? -1 : 0;
+            }));
+    ON_CALL(*socket, Send(_))
+        .WillByDefault(Invoke([this](const std::string& data) {
+          ResDBMessage message;
+          Request request;
+          message.ParseFromString(data);
+          request.ParseFromString(message.data());
+          request_.ParseFromString(request.data());
+          batch_num++;
+          return 0;
+        }));
+    ON_CALL(*socket, Recv(_, _))
+        .WillByDefault(Invoke([this, port](void** buf, size_t* len) {
+          if (*port == mute_port_) {
+            return -1;
+          }
+          std::string resp_str;
+          if (executor_ != nullptr) {
+            resp_str = *executor_->ExecuteData(request_.SerializeAsString());
+          } else {
+            KVResponse response;
+            for (const KVRequest& op : request_.ops()) {
+              response.add_ops()->set_value(op.key());
+            }
+            response.SerializeToString(&resp_str);
+          }
+          *len = resp_str.size();
+          *buf = malloc(*len);
+          memcpy(*buf, resp_str.c_str(), *len);
+          return static_cast<int>(*len);
+        }));
+
+    auto channel = AsyncKVClient::NewChannel(idx);
+    channel->SetSocket(std::move(socket));
+    return channel;
+  }
+
+ private:
+  int dead_port_, mute_port_;
+  KVExecutor* executor_ = nullptr;
+  KVRequest request_;
+};
+
+class AsyncKVClientTest : public Test {
+ public:
+  AsyncKVClientTest() {
+    for (int i = 0; i < 2; ++i) {
+      ReplicaInfo replica;
+      replica.set_ip("127.0.0.1");
+      replica.set_port(1234 + i);
+      replicas_.push_back(replica);
+    }
+    config_ = std::make_unique<ResDBConfig>(replicas_, replicas_[0], KeyInfo(),
+                                            CertificateInfo());
+  }
+
+ protected:
+  std::vector<ReplicaInfo> replicas_;
+  std::unique_ptr<ResDBConfig> config_;
+};
+
+TEST_F(AsyncKVClientTest, GetInBatch) {
+  TestAsyncKVClient client(*config_, 0);
+
+  std::vector<std::future<std::unique_ptr<std::string>>> values;
+  for (int i = 0; i < 100; ++i) {
+    values.push_back(client.Get("key" + std::to_string(i)));
+  }
+  for (int i = 0; i < 100; ++i) {
+    std::unique_ptr<std::string> value = values[i].get();
+    ASSERT_TRUE(value != nullptr);
+    EXPECT_EQ(*value, "key" + std::to_string(i));
+  }
+  EXPECT_LT(client.batch_num, 100);
+}
+
+TEST_F(AsyncKVClientTest, Failover) {
+  TestAsyncKVClient client(*config_, 1234);
+  EXPECT_EQ(client.Set("key", "value").get(), 0);
+}
+
+TEST_F(AsyncKVClientTest, ResendReadsOnly) {
+  TestAsyncKVClient client(*config_, 0, 1234);
+  EXPECT_EQ(client.Set("key", "value").get(), -1);
+  EXPECT_EQ(client.batch_num, 1);
+
+  // The slot has moved to the next replica.
+  EXPECT_EQ(client.Set("key", "value").get(), 0);
+  EXPECT_EQ(client.batch_num, 2);
+}
+
+TEST_F(AsyncKVClientTest, ResendReads) {
+  TestAsyncKVClient client(*config_, 0, 1234);
+  std::unique_ptr<std::string> value = client.Get("key").get();
+  ASSERT_TRUE(value != nullptr);
+  EXPECT_EQ(*value, "key");
+  EXPECT_EQ(client.batch_num, 2);
+}
+
+TEST_F(AsyncKVClientTest, TxnInBatch) {
+  KVExecutor executor(std::make_unique<storage::MemoryDB>());
+  TestAsyncKVClient client(*config_, 0);
+  client.SetExecutor(&executor);
+  EXPECT_EQ(client.Set("from", "10").get(), 0);
+
+  KVRequest request;
+  request.set_cmd(KVRequest::TXN);
+  Condition* condition = request.add_conditions();
+  condition->set_type(Condition::VALUE_EQUAL);
+  condition->set_key("from");
+  condition->set_value("10");
+  KVRequest* op = request.add_ops();
+  op->set_cmd(KVRequest::ADD);
+  op->set_key("from");
+  op->set_delta(-3);
+
+  auto send = [&]() {
+    std::promise<std::unique_ptr<KVResponse>> done;
+    client.Send(request, [&done](std::unique_ptr<KVResponse> response) {
+      done.set_value(std::move(response));
+    });
+    return done.get_future().get();
+  };
+
+  std::unique_ptr<KVResponse> response = send();
+  ASSERT_TRUE(response != nullptr);
+  EXPECT_EQ(response->status(), KVResponse::OK);
+  ASSERT_EQ(response->ops_size(), 1);
+  EXPECT_EQ(response->ops(0).int_value(), 7);
+  std::unique_ptr<std::string> value = client.Get("from").get();
+  ASSERT_TRUE(value != nullptr);
+  EXPECT_EQ(*value, "7");
+
+  // The condition does not hold anymore.
+  response = send();
+  ASSERT_TRUE(response != nullptr);
+  EXPECT_EQ(response->status(), KVResponse::CONDITION_FAILED);
+  value = client.Get("from").get();
+  ASSERT_TRUE(value != nullptr);
+  EXPECT_EQ(*value, "7");
+}
+
+TEST_F(AsyncKVClientTest, StopFailsPendingOps) {
+  TestAsyncKVClient client(*config_, 0, 0, 0);
+  std::future<int> pending = client.Set("key", "value");
+  client.Stop();
+  EXPECT_EQ(pending.get(), -1);
+  EXPECT_EQ(client.Set("key", "value").get(), -1);
+}
+
+TEST_F(AsyncKVClientTest, SendOnAsyncClientPort) {
+  ResConfigData config_data;
+  auto region = config_data.add_region();
+  for (const ReplicaInfo& replica : replicas_) {
+    *region->add_replica_info() = replica;
+  }
+  config_data.set_async_client_port(1240);
+  config_->SetConfigData(config_data);
+
+  LockFreeQueue<QueueItem> input_queue("input");
+  AsyncClientAcceptor acceptor("127.0.0.1", 1240, 1, &input_queue);
+  acceptor.StartAccept();
+  std::atomic<bool> stop = false;
+  std::thread server([&]() {
+    while (!stop) {
+      auto item = input_queue.Pop(100);
+      if (item == nullptr) {
+        continue;
+      }
+      ResDBMessage message;
+      Request request;
+      KVRequest kv_request;
+      message.ParseFromArray(item->data->buff, item->data->data_len);
+      request.ParseFromString(message.data());
+      kv_request.ParseFromString(request.data());
+      KVResponse response;
+      for (const KVRequest& op : kv_request.ops()) {
+        response.add_ops()->set_value(op.key());
+      }
+      item->socket->Send(response.SerializeAsString());
+    }
+  });
+
+  {
+    AsyncKVClient client(*config_, 4, 8);
+    std::vector<std::future<std::unique_ptr<std::string>>> values;
+    for (int i = 0; i < 100; ++i) {
+      values.push_back(client.Get("key" + std::to_string(i)));
+    }
+    for (int i = 0; i < 100; ++i) {
+      std::unique_ptr<std::string> value = values[i].get();
+      ASSERT_TRUE(value != nullptr);
+      EXPECT_EQ(*value, "key" + std::to_string(i));
+    }
+  }
+  stop = true;
+  server.join();
+}
+
+}  // namespace
+}  // namespace resdb
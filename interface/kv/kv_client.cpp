@@ -145,4 +145,52 @@ std::unique_ptr<Items> KVClient::GetKeyTopHistory(const std::string& key,
   return std::make_unique<Items>(response.items());
 }
 
+std::unique_ptr<KVResponse> KVClient::CompareAndSet(
+    const std::string& key, const std::string& expected_data,
+    const std::string& data) {
+  KVRequest request;
+  request.set_cmd(KVRequest::CAS);
+  request.set_key(key);
+  request.set_expected_value(expected_data);
+  request.set_value(data);
+  return Execute(request);
+}
+
+std::unique_ptr<KVResponse> KVClient::Add(const std::string& key,
+                                          int64_t delta) {
+  KVRequest request;
+  request.set_cmd(KVRequest::ADD);
+  request.set_key(key);
+  request.set_delta(delta);
+  return Execute(request);
+}
+
+std::unique_ptr<KVResponse> KVClient::Append(const std::string& key,
+                                             const std::string& data) {
+  KVRequest request;
+  request.set_cmd(KVRequest::APPEND);
+  request.set_key(key);
+  request.set_value(data);
+  return Execute(request);
+}
+
+std::unique_ptr<KVResponse> KVClient::SetIfAbsent(const std::string& key,
+                                                  const std::string& data) {
+  KVRequest request;
+  request.set_cmd(KVRequest::SET_IF_ABSENT);
+  request.set_key(key);
+  request.set_value(data);
+  return Execute(request);
+}
+
+std::unique_ptr<KVResponse> KVClient::Execute(const KVRequest& request) {
+  std::unique_ptr<KVResponse> response = std::make_unique<KVResponse>();
+  int ret = SendRequest(request, response.get());
+  if (ret != 0) {
+    LOG(ERROR) << "send request fail, ret:" << ret;
+    return nullptr;
+  }
+  return response;
+}
+
 }  // namespace resdb
@@ -61,6 +61,20 @@ class KVClient : public TransactionConstructor {
   std::unique_ptr<std::string> GetAllValues();
   std::unique_ptr<std::string> GetRange(const std::string& min_key,
                                         const std::string& max_key);
+
+  // Conditional and read-modify-write interfaces, applied in one request.
+  // The status of the response tells whether the condition holds.
+  // Return nullptr if there is an error.
+  std::unique_ptr<KVResponse> CompareAndSet(const std::string& key,
+                                            const std::string& expected_data,
+                                            const std::string& data);
+  std::unique_ptr<KVResponse> Add(const std::string& key, int64_t delta);
+  std::unique_ptr<KVResponse> Append(const std::string& key,
+                                     const std::string& data);
+  std::unique_ptr<KVResponse> SetIfAbsent(const std::string& key,
+                                          const std::string& data);
+  // Send the request, e.g. a TXN built by the caller.
+  std::unique_ptr<KVResponse> Execute(const KVRequest& request);
 };
 
 }  // namespace resdb
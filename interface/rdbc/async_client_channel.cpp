@@ -0,0 +1,223 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "interface/rdbc/async_client_channel.h"
+
+#include <glog/logging.h>
+
+#include <future>
+#include <set>
+
+#include "interface/rdbc/net_channel.h"
+
+namespace resdb {
+
+namespace {
+
+// Frames larger than this are treated as a broken connection.
+constexpr uint64_t kMaxDataLen = 1ull << 30;
+
+}  // namespace
+
+AsyncClientChannel::AsyncClientChannel(const std::string& ip, int port)
+    : worker_(std::make_unique<boost::asio::io_service::work>(io_service_)),
+      socket_(io_service_),
+      endpoint_(boost::asio::ip::address::from_string(ip), port) {
+  io_thread_ = std::thread([&]() { io_service_.run(); });
+}
+
+AsyncClientChannel::~AsyncClientChannel() {
+  // Fail the requests left, after the ones already posted are queued.
+  io_service_.post([this]() { Fail(); });
+  worker_.reset();
+  if (io_thread_.joinable()) {
+    io_thread_.join();
+  }
+}
+
+void AsyncClientChannel::SetSignatureVerifier(SignatureVerifier* verifier) {
+  verifier_ = verifier;
+}
+
+void AsyncClientChannel::SendRequest(const google::protobuf::Message& message,
+                                     Request::Type type, Callback callback) {
+  Request header;
+  header.set_type(type);
+  header.set_need_response(true);
+  std::string data =
+      NetChannel::GetRawRequestString(header, message, verifier_);
+  if (data.empty()) {
+    callback(-1, nullptr);
+    return;
+  }
+  io_service_.post([this, data = std::move(data),
+                    callback = std::move(callback)]() mutable {
+    uint64_t request_id = ++next_request_id_;
+    std::string frame(kRequestFrameHeaderSize, 0);
+    EncodeRequestFrameHeader(data.size(), request_id, frame.data());
+    frame.append(data);
+    callbacks_[request_id] = std::move(callback);
+    write_queue_.push_back({request_id, std::move(frame)});
+    if (connected_) {
+      if (write_queue_.size() == 1) {
+        WriteNext();
+      }
+    } else if (!connecting_) {
+      Connect();
+    }
+  });
+}
+
+int AsyncClientChannel::SendRequest(const google::protobuf::Message& message,
+                                    google::protobuf::Message* response,
+                                    Request::Type type, int timeout_ms) {
+  auto done = std::make_shared<
+      std::promise<std::pair<int, std::unique_ptr<std::string>>>>();
+  std::future<std::pair<int, std::unique_ptr<std::string>>> done_future =
+      done->get_future();
+  SendRequest(message, type,
+              [done](int ret, std::unique_ptr<std::string> data) {
+                done->set_value(std::make_pair(ret, std::move(data)));
+              });
+  if (done_future.wait_for(std::chrono::milliseconds(timeout_ms)) !=
+      std::future_status::ready) {
+    return -3;
+  }
+  std::pair<int, std::unique_ptr<std::string>> ret = done_future.get();
+  if (ret.first != 0) {
+    return ret.first;
+  }
+  if (!response->ParseFromString(*ret.second)) {
+    LOG(ERROR) << "parse response fail:" << ret.second->size();
+    return -2;
+  }
+  return 0;
+}
+
+void AsyncClientChannel::Connect() {
+  connecting_ = true;
+  uint64_t version = ++conn_version_;
+  socket_.async_connect(
+      endpoint_, [this, version](const boost::system::error_code& ec) {
+        if (version != conn_version_) {
+          return;
+        }
+        connecting_ = false;
+        if (ec) {
+          LOG(ERROR) << "connect to " << endpoint_ << " fail:" << ec.message();
+          Fail();
+          return;
+        }
+        connected_ = true;
+        boost::system::error_code no_delay_ec;
+        socket_.set_option(boost::asio::ip::tcp::no_delay(true), no_delay_ec);
+        ReadHeader();
+        if (!write_queue_.empty()) {
+          WriteNext();
+        }
+      });
+}
+
+void AsyncClientChannel::WriteNext() {
+  uint64_t version = conn_version_;
+  boost::asio::async_write(
+      socket_, boost::asio::buffer(write_queue_.front().frame),
+      [this, version](const boost::system::error_code& ec, size_t) {
+        if (version != conn_version_) {
+          return;
+        }
+        if (ec) {
+          Fail();
+          return;
+        }
+        write_queue_.pop_front();
+        if (!write_queue_.empty()) {
+          WriteNext();
+        }
+      });
+}
+
+void AsyncClientChannel::ReadHeader() {
+  uint64_t version = conn_version_;
+  boost::asio::async_read(
+      socket_, boost::asio::buffer(header_, sizeof(header_)),
+      [this, version](const boost::system::error_code& ec, size_t) {
+        if (version != conn_version_) {
+          return;
+        }
+        if (ec) {
+          Fail();
+          return;
+        }
+        uint64_t data_len = 0;
+        DecodeRequestFrameHeader(header_, &data_len, &request_id_);
+        if (data_len > kMaxDataLen) {
+          LOG(ERROR) << "read data size:" << data_len << " close socket";
+          Fail();
+          return;
+        }
+        data_.resize(data_len);
+        ReadData();
+      });
+}
+
+void AsyncClientChannel::ReadData() {
+  uint64_t version = conn_version_;
+  boost::asio::async_read(
+      socket_, boost::asio::buffer(data_.data(), data_.size()),
+      [this, version](const boost::system::error_code& ec, size_t) {
+        if (version != conn_version_) {
+          return;
+        }
+        if (ec) {
+          Fail();
+          return;
+        }
+        auto it = callbacks_.find(request_id_);
+        if (it != callbacks_.end()) {
+          Callback callback = std::move(it->second);
+          callbacks_.erase(it);
+          callback(0, std::make_unique<std::string>(std::move(data_)));
+        }
+        ReadHeader();
+      });
+}
+
+void AsyncClientChannel::Fail() {
+  // Once connected, the front of the queue may be written in part.
+  std::set<uint64_t> not_sent;
+  for (size_t i = connected_ ? 1 : 0; i < write_queue_.size(); ++i) {
+    not_sent.insert(write_queue_[i].request_id);
+  }
+  write_queue_.clear();
+
+  ++conn_version_;
+  connected_ = false;
+  connecting_ = false;
+  boost::system::error_code ec;
+  socket_.close(ec);
+
+  std::map<uint64_t, Callback> callbacks;
+  callbacks.swap(callbacks_);
+  for (auto& [request_id, callback] : callbacks) {
+    callback(not_sent.count(request_id) ? -1 : -3, nullptr);
+  }
+}
+
+}  // namespace resdb
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <deque>
+#include <functional>
+#include <map>
+#include <thread>
+
+#include "common/crypto/signature_verifier.h"
+#include "platform/common/network/frame.h"
+#include "platform/proto/resdb.pb.h"
+
+namespace resdb {
+
+// AsyncClientChannel is the client side of AsyncClientAcceptor. It keeps one
+// long-lived connection to the server and sends the requests on it without
+// waiting for the responses, which are matched back by their request ids.
+// The messages are the same as the ones NetChannel sends, so the server
+// handles them like any other client request.
+//
+// The connection is opened on the first request and again after it breaks.
+// A broken connection fails all the requests on it.
+class AsyncClientChannel {
+ public:
+  // ret is 0 with the response data, -1 if the request was not sent, or -3
+  // if it was sent but no response came back.
+  typedef std::function<void(int ret, std::unique_ptr<std::string> data)>
+      Callback;
+
+  AsyncClientChannel(const std::string& ip, int port);
+  virtual ~AsyncClientChannel();
+
+  void SetSignatureVerifier(SignatureVerifier* verifier);
+
+  // Send the message as the data of a request of type. The callback is
+  // called from the I/O thread of the channel.
+  void SendRequest(const google::protobuf::Message& message, Request::Type type,
+                   Callback callback);
+
+  // Send the request and wait up to timeout_ms for the response. It returns
+  // the same codes as TransactionConstructor::SendRequest: -2 if the
+  // response can not be parsed, and -3 if it does not come in time.
+  virtual int SendRequest(const google::protobuf::Message& message,
+                          google::protobuf::Message* response,
+                          Request::Type type, int timeout_ms);
+
+ private:
+  struct PendingRequest {
+    uint64_t request_id;
+    std::string frame;
+  };
+
+  void Connect();
+  void WriteNext();
+  void ReadHeader();
+  void ReadData();
+  void Fail();
+
+ private:
+  SignatureVerifier* verifier_ = nullptr;
+  boost::asio::io_service io_service_;
+  std::unique_ptr<boost::asio::io_service::work> worker_;
+  boost::asio::ip::tcp::socket socket_;
+  boost::asio::ip::tcp::endpoint endpoint_;
+  std::thread io_thread_;
+
+  // Only used on the I/O thread.
+  bool connected_ = false;
+  bool connecting_ = false;
+  // Bumped on each new connection, so the handlers of a closed one do
+  // nothing.
+  uint64_t conn_version_ = 0;
+  uint64_t next_request_id_ = 0;
+  std::deque<PendingRequest> write_queue_;
+  std::map<uint64_t, Callback> callbacks_;
+  char header_[kRequestFrameHeaderSize];
+  uint64_t request_id_ = 0;
+  std::string data_;
+};
+
+}  // namespace resdb
@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "interface/rdbc/async_client_channel.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include "platform/common/network/tcp_socket.h"
+#include "platform/proto/client_test.pb.h"
+#include "platform/rdbc/async_client_acceptor.h"
+
+namespace resdb {
+namespace {
+
+std::unique_ptr<QueueItem> PopItem(LockFreeQueue<QueueItem>* queue) {
+  for (int i = 0; i < 100; ++i) {
+    auto item = queue->Pop(100);
+    if (item != nullptr) {
+      return item;
+    }
+  }
+  return nullptr;
+}
+
+// Answers a request with a ClientTestResponse holding the value it got.
+void Respond(QueueItem* item) {
+  ResDBMessage message;
+  ASSERT_TRUE(message.ParseFromArray(item->data->buff, item->data->data_len));
+  Request request;
+  ASSERT_TRUE(request.ParseFromString(message.data()));
+  EXPECT_EQ(request.type(), Request::TYPE_CLIENT_REQUEST);
+  EXPECT_TRUE(request.need_response());
+  ClientTestRequest client_request;
+  ASSERT_TRUE(client_request.ParseFromString(request.data()));
+
+  ClientTestResponse response;
+  response.set_value(client_request.value());
+  EXPECT_EQ(item->socket->Send(response.SerializeAsString()), 0);
+}
+
+class AsyncClientChannelTest : public ::testing::Test {
+ protected:
+  AsyncClientChannelTest() : acceptor_("127.0.0.1", 1260, 2, &input_queue_) {
+    acceptor_.StartAccept();
+  }
+
+ protected:
+  LockFreeQueue<QueueItem> input_queue_;
+  AsyncClientAcceptor acceptor_;
+};
+
+TEST_F(AsyncClientChannelTest, SendRequest) {
+  std::thread server([&]() {
+    auto item = PopItem(&input_queue_);
+    ASSERT_NE(item, nullptr);
+    Respond(item.get());
+  });
+
+  AsyncClientChannel channel("127.0.0.1", 1260);
+  ClientTestRequest request;
+  request.set_value("test");
+  ClientTestResponse response;
+  EXPECT_EQ(channel.SendRequest(request, &response,
+                                Request::TYPE_CLIENT_REQUEST, 2000),
+            0);
+  EXPECT_EQ(response.value(), "test");
+  server.join();
+}
+
+TEST_F(AsyncClientChannelTest, OutOfOrderResponses) {
+  AsyncClientChannel channel("127.0.0.1", 1260);
+  std::vector<std::promise<std::string>> responses(3);
+  for (int i = 0; i < 3; ++i) {
+    ClientTestRequest request;
+    request.set_value("request_" + std::to_string(i));
+    channel.SendRequest(
+        request, Request::TYPE_CLIENT_REQUEST,
+        [&responses, i](int ret, std::unique_ptr<std::string> data) {
+          EXPECT_EQ(ret, 0);
+          ClientTestResponse response;
+          EXPECT_TRUE(response.ParseFromString(*data));
+          responses[i].set_value(response.value());
+        });
+  }
+
+  std::vector<std::unique_ptr<QueueItem>> items;
+  for (int i = 0; i < 3; ++i) {
+    items.push_back(PopItem(&input_queue_));
+    ASSERT_NE(items.back(), nullptr);
+  }
+  for (int i = 2; i >= 0; --i) {
+    Respond(items[i].get());
+  }
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(responses[i].get_future().get(),
+              "request_" + std::to_string(i));
+  }
+}
+
+TEST(AsyncClientChannelCloseTest, ServerClosed) {
+  std::promise<bool> listening;
+  std::future<bool> listening_done = listening.get_future();
+  std::thread server([&]() {
+    TcpSocket svr_socket;
+    svr_socket.Listen("127.0.0.1", 1261);
+    listening.set_value(true);
+    auto client_socket = svr_socket.Accept();
+    client_socket->Close();
+    svr_socket.Close();
+  });
+  listening_done.get();
+
+  AsyncClientChannel channel("127.0.0.1", 1261);
+  ClientTestRequest request;
+  request.set_value("test");
+  ClientTestResponse response;
+  // Sent, but the server goes away before it responds.
+  EXPECT_EQ(channel.SendRequest(request, &response,
+                                Request::TYPE_CLIENT_REQUEST, 2000),
+            -3);
+  server.join();
+
+  // Nobody listens any more, so the next one is not sent at all.
+  EXPECT_EQ(channel.SendRequest(request, &response,
+                                Request::TYPE_CLIENT_REQUEST, 2000),
+            -1);
+}
+
+}  // namespace
+}  // namespace resdb
@@ -37,6 +37,7 @@ class MockNetChannel : public NetChannel {
   MOCK_METHOD(int, SendRawMessageData, (const std::string&), (override));
   MOCK_METHOD(int, RecvRawMessageStr, (std::string*), (override));
   MOCK_METHOD(int, RecvRawMessage, (google::protobuf::Message*), (override));
+  MOCK_METHOD(int, RecvRawMessageData, (std::string*), (override));
 };
 
 }  // namespace resdb
@@ -20,6 +20,8 @@
 #include "interface/rdbc/net_channel.h"
 
 #include <glog/logging.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 
 #include "platform/common/data_comm/data_comm.h"
 #include "platform/common/network/tcp_socket.h"
@@ -37,6 +39,8 @@ void NetChannel::SetRecvTimeout(int microseconds) {
   socket_->SetRecvTimeout(read_timeouts_);
 }
 
+void NetChannel::SetNoDelay(bool no_delay) { socket_->SetNoDelay(no_delay); }
+
 void NetChannel::SetAsyncSend(bool is_async_send) {
   is_async_send_ = is_async_send;
 }
@@ -154,6 +158,51 @@ std::string NetChannel::GetRawMessageString(
   return message_str;
 }
 
+std::string NetChannel::GetRawRequestString(
+    const Request& header, const google::protobuf::Message& message,
+    SignatureVerifier* verifier) {
+  using google::protobuf::internal::WireFormatLite;
+  using google::protobuf::io::CodedOutputStream;
+
+  // Request.data and ResDBMessage.data are bytes fields, which are encoded
+  // the same as sub messages.
+  size_t message_size = message.ByteSizeLong();
+  uint32_t data_tag = WireFormatLite::MakeTag(
+      Request::kDataFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  size_t request_size = header.ByteSizeLong() +
+                        CodedOutputStream::VarintSize32(data_tag) +
+                        CodedOutputStream::VarintSize64(message_size) +
+                        message_size;
+  uint32_t resdb_data_tag =
+      WireFormatLite::MakeTag(ResDBMessage::kDataFieldNumber,
+                              WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  size_t request_offset = CodedOutputStream::VarintSize32(resdb_data_tag) +
+                          CodedOutputStream::VarintSize64(request_size);
+
+  std::string message_str;
+  message_str.resize(request_offset + request_size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(&message_str[0]);
+  target = CodedOutputStream::WriteVarint32ToArray(resdb_data_tag, target);
+  target = CodedOutputStream::WriteVarint64ToArray(request_size, target);
+  target = header.SerializeWithCachedSizesToArray(target);
+  target = CodedOutputStream::WriteVarint32ToArray(data_tag, target);
+  target = CodedOutputStream::WriteVarint64ToArray(message_size, target);
+  message.SerializeWithCachedSizesToArray(target);
+
+  if (verifier != nullptr) {
+    auto signature_or =
+        verifier->SignMessage(message_str.substr(request_offset, request_size));
+    if (!signature_or.ok()) {
+      LOG(ERROR) << "Sign message fail";
+      return "";
+    }
+    ResDBMessage signature_message;
+    signature_message.mutable_signature()->Swap(&(*signature_or));
+    signature_message.AppendToString(&message_str);
+  }
+  return message_str;
+}
+
 int NetChannel::SendRawMessageData(const std::string& message_str) {
   return Send(message_str);
 }
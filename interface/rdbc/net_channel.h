@@ -80,8 +80,16 @@ class NetChannel {
   static std::string GetRawMessageString(
       const google::protobuf::Message& message,
       SignatureVerifier* verifier = nullptr);
+  // Same as GetRawMessageString(request) where request is header carrying
+  // message as its data. message is serialized into the output directly
+  // instead of being copied into the request first.
+  static std::string GetRawRequestString(
+      const Request& header, const google::protobuf::Message& message,
+      SignatureVerifier* verifier = nullptr);
 
   void SetRecvTimeout(int microseconds);
+  // Send small messages at once instead of coalescing them (TCP_NODELAY).
+  void SetNoDelay(bool no_delay);
   void IsLongConnection(bool long_connect_tion);
   void SetAsyncSend(bool is_async_send);
 
@@ -209,6 +209,67 @@ TEST_F(NetChannelTest, SignMessage) {
   EXPECT_EQ(client.SendRawMessage(client_request), 0);
 }
 
+TEST_F(NetChannelTest, GetRawRequestString) {
+  ClientTestRequest client_request;
+  client_request.set_value("test_value");
+
+  Request header;
+  header.set_type(Request::TYPE_CUSTOM_CONSENSUS);
+  header.set_user_type(2);
+  header.set_sender_id(3);
+
+  Request expected_request = header;
+  ASSERT_TRUE(
+      client_request.SerializeToString(expected_request.mutable_data()));
+
+  ResDBMessage resdb_message;
+  ASSERT_TRUE(resdb_message.ParseFromString(
+      NetChannel::GetRawRequestString(header, client_request)));
+  EXPECT_FALSE(resdb_message.has_signature());
+
+  Request request;
+  ASSERT_TRUE(request.ParseFromString(resdb_message.data()));
+  EXPECT_EQ(request.SerializeAsString(), expected_request.SerializeAsString());
+}
+
+TEST_F(NetChannelTest, GetSignedRawRequestString) {
+  SecretKey my_key = KeyGenerator ::GeneratorKeys(SignatureInfo::RSA);
+  int64_t my_node_id = 1;
+
+  KeyInfo private_key;
+  private_key.set_key(my_key.private_key());
+  private_key.set_hash_type(my_key.hash_type());
+  CertificateInfo cert_info;
+  cert_info.set_node_id(my_node_id);
+  cert_info.mutable_public_key()
+      ->mutable_public_key_info()
+      ->mutable_key()
+      ->set_key(my_key.public_key());
+  cert_info.mutable_public_key()
+      ->mutable_public_key_info()
+      ->mutable_key()
+      ->set_hash_type(my_key.hash_type());
+  cert_info.mutable_public_key()->mutable_public_key_info()->set_node_id(
+      my_node_id);
+
+  SignatureVerifier verifier(private_key, cert_info);
+
+  ClientTestRequest client_request;
+  client_request.set_value("test_value");
+  Request header;
+  header.set_type(Request::TYPE_CUSTOM_CONSENSUS);
+
+  ResDBMessage resdb_message;
+  ASSERT_TRUE(resdb_message.ParseFromString(
+      NetChannel::GetRawRequestString(header, client_request, &verifier)));
+  EXPECT_TRUE(
+      verifier.VerifyMessage(resdb_message.data(), resdb_message.signature()));
+
+  Request request;
+  ASSERT_TRUE(request.ParseFromString(resdb_message.data()));
+  EXPECT_EQ(request.data(), client_request.SerializeAsString());
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -21,6 +21,10 @@
 
 #include <glog/logging.h>
 
+#include "common/crypto/digest.h"
+#include "common/utils/utils.h"
+#include "platform/common/network/tcp_socket.h"
+
 namespace resdb {
 
 TransactionConstructor::TransactionConstructor(const ResDBConfig& config)
@@ -33,18 +37,18 @@ TransactionConstructor::TransactionConstructor(const ResDBConfig& config)
 
 absl::StatusOr<std::string> TransactionConstructor::GetResponseData(
     const Response& response) {
-  std::string hash_;
+  Digest hash_;
   std::set<int64_t> hash_counter;
   std::string resp_str;
   for (const auto& each_resp : response.resp()) {
     // Check signature
-    std::string hash = SignatureVerifier::CalculateHash(each_resp.data());
+    Digest hash = CalculateSHA256(each_resp.data());
 
-    if (!hash_.empty() && hash != hash_) {
+    if (!hash_counter.empty() && hash != hash_) {
       LOG(ERROR) << "hash not the same";
       return absl::InvalidArgumentError("hash not match");
     }
-    if (hash_.empty()) {
+    if (hash_counter.empty()) {
       hash_ = hash;
       resp_str = each_resp.data();
     }
@@ -60,30 +64,72 @@ absl::StatusOr<std::string> TransactionConstructor::GetResponseData(
   return absl::InvalidArgumentError("data not enough");
 }
 
+void TransactionConstructor::SetDestReplicaIndex(int idx) { dest_idx_ = idx; }
+
+int TransactionConstructor::GetReplicaNum() const {
+  return config_.GetReplicaInfos().size();
+}
+
+int TransactionConstructor::SelectNearestReplica() {
+  int nearest = -1;
+  int64_t min_time = 0;
+  for (int i = 0; i < GetReplicaNum(); ++i) {
+    int64_t connect_time = GetConnectTime(config_.GetReplicaInfos()[i]);
+    if (connect_time < 0) {
+      continue;
+    }
+    if (nearest == -1 || connect_time < min_time) {
+      nearest = i;
+      min_time = connect_time;
+    }
+  }
+  if (nearest >= 0) {
+    LOG(INFO) << "nearest replica:" << config_.GetReplicaInfos()[nearest].id()
+              << " connect time:" << min_time << "us";
+    SetDestReplicaIndex(nearest);
+  }
+  return nearest;
+}
+
+int64_t TransactionConstructor::GetConnectTime(const ReplicaInfo& replica) {
+  TcpSocket socket;
+  socket.SetSendTimeout(timeout_ms_ * 1000);
+  uint64_t start_time = GetCurrentTime();
+  if (socket.Connect(replica.ip(), replica.port()) != 0) {
+    return -1;
+  }
+  int64_t connect_time = GetCurrentTime() - start_time;
+  socket.Close();
+  return connect_time;
+}
+
 int TransactionConstructor::SendRequest(
     const google::protobuf::Message& message, Request::Type type) {
   // Use the replica obtained from the server.
-  NetChannel::SetDestReplicaInfo(config_.GetReplicaInfos()[0]);
+  NetChannel::SetDestReplicaInfo(
+      config_.GetReplicaInfos()[dest_idx_ % GetReplicaNum()]);
   return NetChannel::SendRequest(message, type, false);
 }
 
 int TransactionConstructor::SendRequest(
     const google::protobuf::Message& message,
     google::protobuf::Message* response, Request::Type type) {
-  NetChannel::SetDestReplicaInfo(config_.GetReplicaInfos()[0]);
+  NetChannel::SetDestReplicaInfo(
+      config_.GetReplicaInfos()[dest_idx_ % GetReplicaNum()]);
   int ret = NetChannel::SendRequest(message, type, true);
-  if (ret == 0) {
-    std::string resp_str;
-    int ret = NetChannel::RecvRawMessageData(&resp_str);
-    if (ret >= 0) {
-      if (!response->ParseFromString(resp_str)) {
-        LOG(ERROR) << "parse response fail:" << resp_str.size();
-        return -2;
-      }
-      return 0;
-    }
+  if (ret != 0) {
+    return -1;
+  }
+  std::string resp_str;
+  ret = NetChannel::RecvRawMessageData(&resp_str);
+  if (ret < 0) {
+    return -3;
+  }
+  if (!response->ParseFromString(resp_str)) {
+    LOG(ERROR) << "parse response fail:" << resp_str.size();
+    return -2;
   }
-  return -1;
+  return 0;
 }
 
 }  // namespace resdb
@@ -36,16 +36,34 @@ class TransactionConstructor : public NetChannel {
   int SendRequest(const google::protobuf::Message& message,
                   Request::Type type = Request::TYPE_CLIENT_REQUEST);
   // Send request with a command and wait for a response.
+  // Returns 0 on success, -1 if the request was not sent, -2 if the response
+  // can not be parsed and -3 if the request was sent but no response came.
   int SendRequest(const google::protobuf::Message& message,
                   google::protobuf::Message* response,
                   Request::Type type = Request::TYPE_CLIENT_REQUEST);
 
+  // Send the requests to the idx-th replica in the config instead of the
+  // first one. Any replica accepts client requests and forwards them to the
+  // primary.
+  void SetDestReplicaIndex(int idx);
+  int GetReplicaNum() const;
+
+  // Send the requests to the replica with the lowest connect time, so the
+  // client goes through its nearest proxy. Returns the index of the replica
+  // or -1 if none of them can be reached.
+  int SelectNearestReplica();
+
+ protected:
+  // The time to connect to the replica in microseconds, or -1 on failure.
+  virtual int64_t GetConnectTime(const ReplicaInfo& replica);
+
  private:
   absl::StatusOr<std::string> GetResponseData(const Response& response);
 
  private:
   ResDBConfig config_;
   int64_t timeout_ms_;  // microsecond for timeout.
+  int dest_idx_ = 0;
 };
 
 }  // namespace resdb
@@ -155,6 +155,52 @@ TEST_F(UserClientTest, RecvResponseFail) {
             0);
 }
 
+class NearestReplicaConstructor : public TransactionConstructor {
+ public:
+  NearestReplicaConstructor(const ResDBConfig& config)
+      : TransactionConstructor(config) {}
+
+  MOCK_METHOD(int64_t, GetConnectTime, (const ReplicaInfo&), (override));
+};
+
+TEST_F(UserClientTest, SelectNearestReplica) {
+  std::vector<ReplicaInfo> replicas;
+  for (int i = 1; i <= 3; ++i) {
+    ReplicaInfo info;
+    info.set_id(i);
+    info.set_ip("127.0.0.1");
+    info.set_port(1234 + i);
+    replicas.push_back(info);
+  }
+  ResDBConfig config(replicas, self_info_);
+
+  NearestReplicaConstructor client(config);
+  EXPECT_CALL(client, GetConnectTime)
+      .WillRepeatedly(Invoke([&](const ReplicaInfo& replica) -> int64_t {
+        switch (replica.id()) {
+          case 1:
+            return 3000;
+          case 2:
+            return -1;
+          default:
+            return 500;
+        }
+      }));
+  EXPECT_EQ(client.SelectNearestReplica(), 2);
+
+  std::unique_ptr<MockSocket> socket = std::make_unique<MockSocket>();
+  EXPECT_CALL(*socket, Connect("127.0.0.1", 1237)).WillOnce(Return(0));
+  EXPECT_CALL(*socket, Send).WillOnce(Return(0));
+  client.SetSocket(std::move(socket));
+  EXPECT_EQ(client.SendRequest(ClientTestRequest()), 0);
+}
+
+TEST_F(UserClientTest, NoReplicaReachable) {
+  NearestReplicaConstructor client(*config_);
+  EXPECT_CALL(client, GetConnectTime).WillRepeatedly(Return(-1));
+  EXPECT_EQ(client.SelectNearestReplica(), -1);
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -20,6 +20,7 @@
 #pragma once
 #include <stdlib.h>
 
+#include <functional>
 #include <memory>
 
 namespace resdb {
@@ -28,12 +29,19 @@ struct DataInfo {
   DataInfo() : buff(nullptr), data_len(0) {}
   ~DataInfo() {
     if (buff) {
-      free(buff);
+      if (release) {
+        release(buff);
+      } else {
+        free(buff);
+      }
       buff = nullptr;
     }
   }
   void* buff = nullptr;
   size_t data_len = 0;
+  // Gives buff back to where it comes from, like a buffer pool, instead of
+  // freeing it.
+  std::function<void(void*)> release;
 };
 
 }  // namespace resdb
@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/common/network/frame.h"
+
+#include <endian.h>
+#include <errno.h>
+#include <glog/logging.h>
+#include <string.h>
+#include <sys/socket.h>
+
+namespace resdb {
+
+void EncodeFrameHeader(uint64_t data_len, char* header) {
+  uint64_t le_len = htole64(data_len);
+  memcpy(header, &le_len, kFrameHeaderSize);
+}
+
+uint64_t DecodeFrameHeader(const char* header) {
+  uint64_t le_len;
+  memcpy(&le_len, header, kFrameHeaderSize);
+  return le64toh(le_len);
+}
+
+void EncodeRequestFrameHeader(uint64_t data_len, uint64_t request_id,
+                              char* header) {
+  EncodeFrameHeader(data_len, header);
+  EncodeFrameHeader(request_id, header + kFrameHeaderSize);
+}
+
+void DecodeRequestFrameHeader(const char* header, uint64_t* data_len,
+                              uint64_t* request_id) {
+  *data_len = DecodeFrameHeader(header);
+  *request_id = DecodeFrameHeader(header + kFrameHeaderSize);
+}
+
+int SendIov(int fd, struct iovec* iov, int iov_num) {
+  if (fd < 0) {
+    return -1;
+  }
+  size_t total = 0;
+  while (iov_num > 0) {
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_num;
+    ssize_t ret = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "send data fail, fd =" << fd << " error "
+                 << strerror(errno);
+      return -1;
+    }
+    total += ret;
+    // Skip what has been sent.
+    size_t sent = ret;
+    while (iov_num > 0 && sent >= iov->iov_len) {
+      sent -= iov->iov_len;
+      ++iov;
+      --iov_num;
+    }
+    if (iov_num > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + sent;
+      iov->iov_len -= sent;
+    }
+  }
+  return total;
+}
+
+}  // namespace resdb
@@ -0,0 +1,49 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace resdb {
+
+// A frame on the wire is a header holding the length of the data as a
+// fixed-width little-endian integer, followed by the data.
+constexpr size_t kFrameHeaderSize = sizeof(uint64_t);
+
+void EncodeFrameHeader(uint64_t data_len, char* header);
+uint64_t DecodeFrameHeader(const char* header);
+
+// A request frame also carries the id of the request after the length, so
+// the responses on a connection may come back in any order.
+constexpr size_t kRequestFrameHeaderSize = 2 * sizeof(uint64_t);
+
+void EncodeRequestFrameHeader(uint64_t data_len, uint64_t request_id,
+                              char* header);
+void DecodeRequestFrameHeader(const char* header, uint64_t* data_len,
+                              uint64_t* request_id);
+
+// Writes all of iov to fd, with one sendmsg call unless the kernel takes
+// only a part of it. iov is consumed. Returns the bytes sent or -1.
+int SendIov(int fd, struct iovec* iov, int iov_num);
+
+}  // namespace resdb
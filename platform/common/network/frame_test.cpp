@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/common/network/frame.h"
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+namespace resdb {
+namespace {
+
+TEST(FrameTest, LittleEndianHeader) {
+  char header[kFrameHeaderSize];
+  EncodeFrameHeader(0x0102030405060708ull, header);
+  EXPECT_EQ(header[0], 0x08);
+  EXPECT_EQ(header[7], 0x01);
+  EXPECT_EQ(DecodeFrameHeader(header), 0x0102030405060708ull);
+}
+
+TEST(FrameTest, RequestHeader) {
+  char header[kRequestFrameHeaderSize];
+  EncodeRequestFrameHeader(0x0102, 0x0304, header);
+  EXPECT_EQ(header[0], 0x02);
+  EXPECT_EQ(header[1], 0x01);
+  EXPECT_EQ(header[kFrameHeaderSize], 0x04);
+  EXPECT_EQ(header[kFrameHeaderSize + 1], 0x03);
+  uint64_t data_len = 0, request_id = 0;
+  DecodeRequestFrameHeader(header, &data_len, &request_id);
+  EXPECT_EQ(data_len, 0x0102u);
+  EXPECT_EQ(request_id, 0x0304u);
+}
+
+TEST(FrameTest, SendIov) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  std::string data_1 = "test", data_2(100000, 't');
+  char header[kFrameHeaderSize];
+  EncodeFrameHeader(data_1.size(), header);
+  struct iovec iov[3] = {
+      {header, kFrameHeaderSize},
+      {data_1.data(), data_1.size()},
+      {data_2.data(), data_2.size()},
+  };
+  size_t total = kFrameHeaderSize + data_1.size() + data_2.size();
+
+  std::string recv_data;
+  std::thread recv_thread([&]() {
+    char buf[4096];
+    while (recv_data.size() < total) {
+      int ret = read(fds[1], buf, sizeof(buf));
+      if (ret <= 0) {
+        break;
+      }
+      recv_data.append(buf, ret);
+    }
+  });
+  EXPECT_EQ(SendIov(fds[0], iov, 3), static_cast<int>(total));
+  recv_thread.join();
+
+  EXPECT_EQ(DecodeFrameHeader(recv_data.data()), data_1.size());
+  EXPECT_EQ(recv_data.substr(kFrameHeaderSize), data_1 + data_2);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST(FrameTest, SendIovToBadFd) {
+  char data[] = "test";
+  struct iovec iov[1] = {{data, 4}};
+  EXPECT_EQ(SendIov(-1, iov, 1), -1);
+}
+
+}  // namespace
+}  // namespace resdb
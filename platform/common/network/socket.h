@@ -45,6 +45,7 @@ class Socket {
 
   virtual void SetRecvTimeout(int64_t microseconds) {}
   virtual void SetSendTimeout(int64_t microseconds) {}
+  virtual void SetNoDelay(bool no_delay) {}
   virtual int SetAsync(bool is_open = true) { return -1; }
 };
 
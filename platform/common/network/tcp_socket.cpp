@@ -22,12 +22,16 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <glog/logging.h>
+#include <netinet/tcp.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include <thread>
 
+#include "platform/common/network/frame.h"
+
 namespace resdb {
 
 namespace {
@@ -48,23 +52,6 @@ int RecvInternal(int fd, void* buf, size_t len) {
   return pos;
 }
 
-int SendInternal(int fd, const void* buf, size_t len) {
-  if (fd < 0) {
-    return -2;
-  }
-  size_t pos = 0;
-  while (pos < len) {
-    int ret = send(fd, (char*)buf + pos, len - pos, 0);
-    if (ret < 0) {
-      LOG(ERROR) << "send data fail, fd =" << fd << " error "
-                 << strerror(errno);
-      return -1;
-    }
-    pos += ret;
-  }
-  return pos;
-}
-
 }  // namespace
 
 TcpSocket::TcpSocket() : socket_fd_(-1) { InitSocket(); }
@@ -113,7 +100,9 @@ int TcpSocket::Listen(const std::string& ip, int port) {
     return -1;
   }
 
-  if (listen(socket_fd_, 10) == -1) {
+  // Clients open a connection per request, a short backlog drops their SYNs
+  // and each retry waits a second.
+  if (listen(socket_fd_, SOMAXCONN) == -1) {
     LOG(ERROR) << "listen TcpSocket error: " << strerror(errno)
                << "(errno: " << errno << ")";
     return -1;
@@ -144,7 +133,9 @@ std::unique_ptr<Socket> TcpSocket::Accept() {
     //        << ")" << std::this_thread::get_id();
     return nullptr;
   }
-  return std::make_unique<TcpSocket>(conn_fd);
+  auto socket = std::make_unique<TcpSocket>(conn_fd);
+  socket->SetNoDelay(true);
+  return socket;
 }
 
 int TcpSocket::Connect(const std::string& ip, int port) {
@@ -165,7 +156,9 @@ int TcpSocket::Connect(const std::string& ip, int port) {
     return -1;
   }
   // LOG(ERROR) << "connect to:" << ip << " " << port;
-
+  // The messages are framed and sent at once, so there is nothing for Nagle
+  // to coalesce.
+  SetNoDelay(true);
   return 0;
 }
 
@@ -175,35 +168,29 @@ int TcpSocket::SetAsync(bool is_open) {
 }
 
 int TcpSocket::Send(const std::string& data) {
-  size_t data_size = data.size();
-  size_t send_ret = SendInternal(socket_fd_, &data_size, sizeof(data_size));
-  if (send_ret != sizeof(data_size)) {
-    if (static_cast<int>(send_ret) == -1) {
-      LOG(ERROR) << "send data error: " << strerror(errno)
-                 << "(errno: " << errno << ")";
-      return -1;
-    }
+  if (socket_fd_ < 0) {
     return -2;
   }
-
-  send_ret = SendInternal(socket_fd_, data.c_str(), data_size);
-  if (send_ret != data_size) {
-    if (static_cast<int>(send_ret) == -1) {
-      LOG(ERROR) << "send data not done: " << strerror(errno)
-                 << "(errno: " << errno << ")";
-      return -1;
-    } else {
-      return -2;
-    }
+  // Send the header and the data with one call.
+  char header[kFrameHeaderSize];
+  EncodeFrameHeader(data.size(), header);
+  struct iovec iov[2] = {
+      {header, kFrameHeaderSize},
+      {const_cast<char*>(data.data()), data.size()},
+  };
+  if (SendIov(socket_fd_, iov, 2) < 0) {
+    return -1;
   }
   return 0;
 }
 
 int TcpSocket::Recv(void** buf, size_t* len) {
-  int ret = RecvInternal(socket_fd_, len, sizeof(size_t));
+  char header[kFrameHeaderSize];
+  int ret = RecvInternal(socket_fd_, header, kFrameHeaderSize);
   if (ret <= 0) {
     return ret;
   }
+  *len = DecodeFrameHeader(header);
   *buf = malloc(*len);
   ret = RecvInternal(socket_fd_, *buf, *len);
   if (ret <= 0) {
@@ -234,4 +221,12 @@ void TcpSocket::SetSendTimeout(int64_t microseconds) {
   }
 }
 
+void TcpSocket::SetNoDelay(bool no_delay) {
+  int optval = no_delay ? 1 : 0;
+  if (setsockopt(socket_fd_, IPPROTO_TCP, TCP_NODELAY, &optval,
+                 sizeof(optval)) != 0) {
+    LOG(ERROR) << "set no delay failed:" << strerror(errno);
+  }
+}
+
 }  // namespace resdb
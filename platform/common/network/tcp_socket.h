@@ -47,6 +47,7 @@ class TcpSocket : public Socket {
 
   void SetRecvTimeout(int64_t microseconds) override;
   void SetSendTimeout(int64_t microseconds) override;
+  void SetNoDelay(bool no_delay) override;
   int SetAsync(bool is_open = true) override;
 
  private:
@@ -73,12 +73,16 @@ ResDBConfig::ResDBConfig(const ResConfigData& config_data,
   if (config_data_.output_worker_num() == 0) {
     config_data_.set_output_worker_num(output_worker_num_);
   }
+  if (config_data_.out_of_order_worker_num() == 0) {
+    config_data_.set_out_of_order_worker_num(out_of_order_worker_num_);
+  }
   if (config_data_.tcp_batch_num() == 0) {
     config_data_.set_tcp_batch_num(100);
   }
   if (config_data_.max_process_txn() == 0) {
     config_data_.set_max_process_txn(64);
   }
+  UpdateSnapshot();
 }
 
 void ResDBConfig::SetConfigData(const ResConfigData& config_data) {
@@ -98,6 +102,37 @@ void ResDBConfig::SetConfigData(const ResConfigData& config_data) {
   if (config_data_.view_change_timeout_ms() == 0) {
     config_data_.set_view_change_timeout_ms(viewchange_commit_timeout_ms_);
   }
+  UpdateSnapshot();
+}
+
+void ResDBConfig::UpdateSnapshot() {
+  auto snapshot = std::make_shared<ResConfigSnapshot>();
+  snapshot->enable_viewchange = config_data_.enable_viewchange();
+  snapshot->not_need_signature = config_data_.not_need_signature();
+  snapshot->is_performance_running =
+      is_performance_running_ || config_data_.is_performance_running();
+  snapshot->self_region_id = config_data_.self_region_id();
+  snapshot->region_num = config_data_.region_size();
+  snapshot->view_change_timeout_ms = config_data_.view_change_timeout_ms();
+  snapshot->config_data = std::make_shared<const ResConfigData>(config_data_);
+  std::atomic_store(&snapshot_,
+                    std::shared_ptr<const ResConfigSnapshot>(snapshot));
+}
+
+std::shared_ptr<const ResConfigSnapshot> ResDBConfig::GetSnapshot() const {
+  return std::atomic_load(&snapshot_);
+}
+
+bool ResDBConfig::IsViewChangeEnabled() const {
+  return GetSnapshot()->enable_viewchange;
+}
+
+bool ResDBConfig::NotNeedSignature() const {
+  return GetSnapshot()->not_need_signature;
+}
+
+int32_t ResDBConfig::GetSelfRegionId() const {
+  return GetSnapshot()->self_region_id;
 }
 
 KeyInfo ResDBConfig::GetPrivateKey() const { return private_key_; }
@@ -191,11 +226,12 @@ void ResDBConfig::SetSignatureVerifierEnabled(bool enable_sv) {
 
 // Performance setting
 bool ResDBConfig::IsPerformanceRunning() const {
-  return is_performance_running_ || GetConfigData().is_performance_running();
+  return GetSnapshot()->is_performance_running;
 }
 
 void ResDBConfig::RunningPerformance(bool is_performance_running) {
   is_performance_running_ = is_performance_running;
+  UpdateSnapshot();
 }
 
 void ResDBConfig::SetTestMode(bool is_test_mode) {
@@ -214,6 +250,7 @@ uint32_t ResDBConfig::GetMaxProcessTxn() const {
 void ResDBConfig::SetMaxProcessTxn(uint32_t num) {
   config_data_.set_max_process_txn(num);
   max_process_txn_ = num;
+  UpdateSnapshot();
 }
 
 uint32_t ResDBConfig::GetMaxClientComplaintNum() const {
@@ -237,6 +274,7 @@ uint32_t ResDBConfig::ClientBatchNum() const {
 
 void ResDBConfig::SetClientBatchNum(uint32_t num) {
   config_data_.set_client_batch_num(num);
+  UpdateSnapshot();
 }
 
 uint32_t ResDBConfig::GetWorkerNum() const { return config_data_.worker_num(); }
@@ -253,6 +291,19 @@ uint32_t ResDBConfig::GetTcpBatchNum() const {
   return config_data_.tcp_batch_num();
 }
 
+uint32_t ResDBConfig::GetOutOfOrderWorkerNum() const {
+  if (config_data_.out_of_order_worker_num()) {
+    return config_data_.out_of_order_worker_num();
+  }
+  return out_of_order_worker_num_;
+}
+
+void ResDBConfig::SetOutOfOrderWorkerNum(uint32_t num) {
+  config_data_.set_out_of_order_worker_num(num);
+  out_of_order_worker_num_ = num;
+  UpdateSnapshot();
+}
+
 uint32_t ResDBConfig::GetViewchangeCommitTimeout() const {
   return config_data_.view_change_timeout_ms()
              ? config_data_.view_change_timeout_ms()
@@ -261,6 +312,7 @@ uint32_t ResDBConfig::GetViewchangeCommitTimeout() const {
 
 void ResDBConfig::SetViewchangeCommitTimeout(uint64_t timeout_ms) {
   config_data_.set_view_change_timeout_ms(timeout_ms);
+  UpdateSnapshot();
 }
 
 //Added for Assignment 3 
@@ -19,11 +19,27 @@
 
 #pragma once
 
+#include <memory>
+
 #include "common/proto/signature_info.pb.h"
 #include "platform/proto/replica_info.pb.h"
 
 namespace resdb {
 
+// An immutable view of ResConfigData. The flags read on the message path are
+// plain fields and the rest of the data is shared instead of copied. A new
+// snapshot is built each time the config data changes and swapped in
+// atomically; readers keep using the one they loaded.
+struct ResConfigSnapshot {
+  bool enable_viewchange = false;
+  bool not_need_signature = false;
+  bool is_performance_running = false;
+  int32_t self_region_id = 0;
+  int region_num = 0;
+  uint32_t view_change_timeout_ms = 0;
+  std::shared_ptr<const ResConfigData> config_data;
+};
+
 // TODO read from a proto json file.
 class ResDBConfig {
  public:
@@ -50,8 +66,15 @@ class ResDBConfig {
   // Each replica infomation, including the binding urls(or ip,port).
   const std::vector<ReplicaInfo>& GetReplicaInfos() const;
 
+  // Return a copy of the whole config data. Use GetSnapshot() or the flag
+  // accessors below on the message path.
   ResConfigData GetConfigData() const;
 
+  std::shared_ptr<const ResConfigSnapshot> GetSnapshot() const;
+  bool IsViewChangeEnabled() const;
+  bool NotNeedSignature() const;
+  int32_t GetSelfRegionId() const;
+
   // The current replica infomation, including the binding urls(or ip,port).
   const ReplicaInfo& GetSelfInfo() const;
   // The total number of replicas.
@@ -117,12 +140,20 @@ class ResDBConfig {
   uint32_t GetOutputWorkerNum() const;
   uint32_t GetTcpBatchNum() const;
 
+  // The number of workers executing transactions in out-of-order mode.
+  uint32_t GetOutOfOrderWorkerNum() const;
+  void SetOutOfOrderWorkerNum(uint32_t num);
+
   // ViewChange Timeout
   uint32_t GetViewchangeCommitTimeout() const;
   void SetViewchangeCommitTimeout(uint64_t timeout_ms);
 
+ private:
+  void UpdateSnapshot();
+
  private:
   ResConfigData config_data_;
+  std::shared_ptr<const ResConfigSnapshot> snapshot_;
   std::vector<ReplicaInfo> replicas_;
   ReplicaInfo self_info_;
   const KeyInfo private_key_;
@@ -146,6 +177,7 @@ class ResDBConfig {
   uint32_t worker_num_ = 16;
   uint32_t input_worker_num_ = 5;
   uint32_t output_worker_num_ = 5;
+  uint32_t out_of_order_worker_num_ = 1;
   uint32_t client_batch_num_ = 100;
 };
 
@@ -121,6 +121,31 @@ TEST(TcpSocket, ResDBConfigWith2Replicas) {
   EXPECT_EQ(config.GetMinDataReceiveNum(), 1);
 }
 
+TEST(TcpSocket, ResDBConfigSnapshot) {
+  ReplicaInfo self_info = GenerateReplicaInfo("127.0.0.1", 1234);
+
+  ResConfigData config_data;
+  config_data.set_self_region_id(2);
+  config_data.add_region()->set_region_id(1);
+  config_data.add_region()->set_region_id(2);
+
+  ResDBConfig config(config_data, self_info, KeyInfo(), CertificateInfo());
+  auto snapshot = config.GetSnapshot();
+  EXPECT_FALSE(config.IsViewChangeEnabled());
+  EXPECT_EQ(config.GetSelfRegionId(), 2);
+  EXPECT_EQ(snapshot->region_num, 2);
+  EXPECT_THAT(*snapshot->config_data, EqualsProto(config.GetConfigData()));
+
+  config_data.set_enable_viewchange(true);
+  config.SetConfigData(config_data);
+  EXPECT_TRUE(config.IsViewChangeEnabled());
+  EXPECT_TRUE(config.GetSnapshot()->config_data->enable_viewchange());
+
+  // The old snapshot does not change.
+  EXPECT_FALSE(snapshot->enable_viewchange);
+  EXPECT_FALSE(snapshot->config_data->enable_viewchange());
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/consensus/checkpoint/checkpoint_digest.h"
+
+#include <string.h>
+
+#include <cryptopp/sha.h>
+
+namespace resdb {
+
+namespace {
+
+constexpr CryptoPP::byte kLeafPrefix = 0;
+constexpr CryptoPP::byte kNodePrefix = 1;
+constexpr int kDigestSize = CryptoPP::SHA256::DIGESTSIZE;
+// Fewer hashes than this are not worth handing to another thread.
+constexpr int kMinTaskSize = 256;
+
+void Update(CryptoPP::SHA256& sha, const std::string& data) {
+  sha.Update(reinterpret_cast<const CryptoPP::byte*>(data.data()),
+             data.size());
+}
+
+}  // namespace
+
+CheckPointDigest::CheckPointDigest(int thread_num)
+    : pool_("checkpoint_digest", thread_num) {}
+
+// Run func(sha, i) for i in [0, num). The work is split into at most one
+// task per thread, including the calling one, and each task reuses its
+// SHA-256 context.
+void CheckPointDigest::ParallelFor(
+    int num, const std::function<void(CryptoPP::SHA256&, int)>& func) {
+  int task_num = std::min(pool_.Size() + 1, num / kMinTaskSize);
+  if (task_num <= 1) {
+    CryptoPP::SHA256 sha;
+    for (int i = 0; i < num; ++i) {
+      func(sha, i);
+    }
+    return;
+  }
+  pool_.ParallelFor(task_num, [&](int task) {
+    CryptoPP::SHA256 sha;
+    int end = static_cast<int64_t>(num) * (task + 1) / task_num;
+    for (int i = static_cast<int64_t>(num) * task / task_num; i < end; ++i) {
+      func(sha, i);
+    }
+  });
+}
+
+std::string CheckPointDigest::GetWindowRoot(
+    const std::vector<std::string>& hashes) {
+  if (hashes.empty()) {
+    return "";
+  }
+  // The nodes of a level are stored back to back.
+  std::vector<CryptoPP::byte> level(hashes.size() * kDigestSize);
+  ParallelFor(hashes.size(), [&](CryptoPP::SHA256& sha, int i) {
+    sha.Update(&kLeafPrefix, 1);
+    Update(sha, hashes[i]);
+    sha.Final(&level[i * kDigestSize]);
+  });
+  size_t node_num = hashes.size();
+  std::vector<CryptoPP::byte> next;
+  while (node_num > 1) {
+    size_t next_num = (node_num + 1) / 2;
+    next.resize(next_num * kDigestSize);
+    ParallelFor(next_num, [&](CryptoPP::SHA256& sha, int i) {
+      if (2 * i + 1 == static_cast<int>(node_num)) {
+        memcpy(&next[i * kDigestSize], &level[2 * i * kDigestSize],
+               kDigestSize);
+        return;
+      }
+      sha.Update(&kNodePrefix, 1);
+      sha.Update(&level[2 * i * kDigestSize], 2 * kDigestSize);
+      sha.Final(&next[i * kDigestSize]);
+    });
+    level.swap(next);
+    node_num = next_num;
+  }
+  return std::string(level.begin(), level.begin() + kDigestSize);
+}
+
+std::string CheckPointDigest::GetDigest(
+    const std::string& last_digest, const std::vector<std::string>& hashes) {
+  return Chain(last_digest, GetWindowRoot(hashes));
+}
+
+std::string CheckPointDigest::Chain(const std::string& last_digest,
+                                    const std::string& root) {
+  CryptoPP::SHA256 sha;
+  Update(sha, last_digest);
+  Update(sha, root);
+  std::string digest(kDigestSize, 0);
+  sha.Final(reinterpret_cast<CryptoPP::byte*>(&digest[0]));
+  return digest;
+}
+
+}  // namespace resdb
@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <cryptopp/sha.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/utils/thread_pool.h"
+
+namespace resdb {
+
+// CheckPointDigest computes the hash announced at a checkpoint. The request
+// hashes of a checkpoint window are the leaves of a binary hash tree whose
+// root is chained with the digest of the previous checkpoint:
+//   leaf   = SHA256(0x00 || request hash)
+//   node   = SHA256(0x01 || left || right), a node without a sibling is
+//            carried up as it is
+//   digest = SHA256(previous digest || root)
+// The leaves and each level of the tree are hashed on several threads, each
+// with its own streaming SHA-256 context.
+class CheckPointDigest {
+ public:
+  CheckPointDigest(int thread_num = 4);
+
+  // The root of the tree over the request hashes of one window.
+  std::string GetWindowRoot(const std::vector<std::string>& hashes);
+
+  // The digest of the checkpoint ending the window of hashes.
+  std::string GetDigest(const std::string& last_digest,
+                        const std::vector<std::string>& hashes);
+
+  static std::string Chain(const std::string& last_digest,
+                           const std::string& root);
+
+ private:
+  void ParallelFor(int num,
+                   const std::function<void(CryptoPP::SHA256&, int)>& func);
+
+ private:
+  ThreadPool pool_;
+};
+
+}  // namespace resdb
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/consensus/checkpoint/checkpoint_digest.h"
+
+#include <gtest/gtest.h>
+
+namespace resdb {
+namespace {
+
+std::string SHA256(const std::string& data) {
+  std::string digest(CryptoPP::SHA256::DIGESTSIZE, 0);
+  CryptoPP::SHA256().CalculateDigest(
+      reinterpret_cast<CryptoPP::byte*>(&digest[0]),
+      reinterpret_cast<const CryptoPP::byte*>(data.data()), data.size());
+  return digest;
+}
+
+// The tree computed level by level on one thread.
+std::string GetRoot(const std::vector<std::string>& hashes) {
+  std::vector<std::string> level;
+  for (const std::string& hash : hashes) {
+    level.push_back(SHA256(std::string(1, '\0') + hash));
+  }
+  while (level.size() > 1) {
+    std::vector<std::string> next;
+    for (size_t i = 0; i < level.size(); i += 2) {
+      if (i + 1 == level.size()) {
+        next.push_back(level[i]);
+      } else {
+        next.push_back(SHA256(std::string(1, '\1') + level[i] + level[i + 1]));
+      }
+    }
+    level = next;
+  }
+  return level[0];
+}
+
+std::vector<std::string> GetHashes(int num) {
+  std::vector<std::string> hashes;
+  for (int i = 0; i < num; ++i) {
+    hashes.push_back(SHA256("request_" + std::to_string(i)));
+  }
+  return hashes;
+}
+
+TEST(CheckPointDigestTest, WindowRoot) {
+  CheckPointDigest digest;
+  std::vector<std::string> hashes = GetHashes(3);
+  std::string left = SHA256(std::string(1, '\1') +
+                            SHA256(std::string(1, '\0') + hashes[0]) +
+                            SHA256(std::string(1, '\0') + hashes[1]));
+  EXPECT_EQ(digest.GetWindowRoot(hashes),
+            SHA256(std::string(1, '\1') + left +
+                   SHA256(std::string(1, '\0') + hashes[2])));
+  EXPECT_EQ(digest.GetWindowRoot({}), "");
+}
+
+TEST(CheckPointDigestTest, ParallelWindowRoot) {
+  CheckPointDigest digest(4);
+  for (int num : {1, 255, 1000, 10001}) {
+    std::vector<std::string> hashes = GetHashes(num);
+    EXPECT_EQ(digest.GetWindowRoot(hashes), GetRoot(hashes)) << num;
+  }
+}
+
+TEST(CheckPointDigestTest, OrderMatters) {
+  CheckPointDigest digest;
+  std::vector<std::string> hashes = GetHashes(1000);
+  std::string root = digest.GetWindowRoot(hashes);
+  std::swap(hashes[10], hashes[11]);
+  EXPECT_NE(digest.GetWindowRoot(hashes), root);
+}
+
+TEST(CheckPointDigestTest, Chain) {
+  CheckPointDigest digest;
+  std::vector<std::string> hashes = GetHashes(100);
+  std::string root = digest.GetWindowRoot(hashes);
+  EXPECT_EQ(digest.GetDigest("last", hashes), SHA256("last" + root));
+  EXPECT_NE(digest.GetDigest("", hashes), digest.GetDigest("last", hashes));
+}
+
+}  // namespace
+}  // namespace resdb
@@ -0,0 +1,163 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "platform/consensus/execution/geo_fragment.h"
+
+#include <glog/logging.h>
+
+#include "common/crypto/digest.h"
+
+namespace resdb {
+
+CompactCerts ToCompactCerts(const Certs& certs) {
+  std::map<int64_t, const SignatureInfo*> signers;
+  for (const auto& cert : certs.committed_certs()) {
+    if (cert.node_id() <= 0) {
+      continue;
+    }
+    if (cert.hash_type() != certs.committed_certs(0).hash_type()) {
+      LOG(ERROR) << "mixed signature types, skip signer:" << cert.node_id();
+      continue;
+    }
+    signers.emplace(cert.node_id(), &cert);
+  }
+
+  CompactCerts compact_certs;
+  if (signers.empty()) {
+    return compact_certs;
+  }
+  compact_certs.set_hash_type(certs.committed_certs(0).hash_type());
+  std::string bitmap((signers.rbegin()->first + 7) / 8, 0);
+  for (const auto& it : signers) {
+    bitmap[(it.first - 1) / 8] |= 1 << ((it.first - 1) % 8);
+    compact_certs.add_signatures(it.second->signature());
+  }
+  compact_certs.set_signers(bitmap);
+  return compact_certs;
+}
+
+Certs FromCompactCerts(const CompactCerts& compact_certs) {
+  Certs certs;
+  int idx = 0;
+  const std::string& bitmap = compact_certs.signers();
+  for (size_t i = 0; i < bitmap.size() * 8; ++i) {
+    if (!(bitmap[i / 8] & (1 << (i % 8)))) {
+      continue;
+    }
+    if (idx >= compact_certs.signatures_size()) {
+      break;
+    }
+    SignatureInfo* cert = certs.add_committed_certs();
+    cert->set_hash_type(compact_certs.hash_type());
+    cert->set_node_id(i + 1);
+    cert->set_signature(compact_certs.signatures(idx++));
+  }
+  return certs;
+}
+
+std::unique_ptr<GeoFragment> NewGeoFragment(const BatchUserRequest& batch,
+                                            int region_id, int index,
+                                            int total_num) {
+  BatchUserRequest body = batch;
+  body.clear_committed_certs();
+  std::string data;
+  body.SerializeToString(&data);
+
+  ReedSolomon coder((total_num - 1) / 3 + 1, total_num);
+  auto fragment = std::make_unique<GeoFragment>();
+  fragment->set_seq(batch.seq());
+  fragment->set_region_id(region_id);
+  fragment->set_index(index);
+  fragment->set_data_num(coder.DataNum());
+  fragment->set_data_size(data.size());
+  std::vector<std::string> fragments = coder.Encode(data);
+  for (const std::string& piece : fragments) {
+    fragment->add_fragment_hashes(CalculateSHA256(piece).ToString());
+  }
+  fragment->set_data(std::move(fragments[index]));
+  *fragment->mutable_certs() = ToCompactCerts(batch.committed_certs());
+  return fragment;
+}
+
+std::unique_ptr<BatchUserRequest> GeoFragmentCollector::AddFragment(
+    const GeoFragment& fragment, std::vector<CompactCerts>* certs) {
+  int total_num = fragment.fragment_hashes_size();
+  if (fragment.data_num() <= 0 || fragment.data_num() > total_num ||
+      total_num > 256 || fragment.index() < 0 ||
+      fragment.index() >= total_num) {
+    LOG(ERROR) << "invalid fragment, index:" << fragment.index()
+               << " data num:" << fragment.data_num()
+               << " total num:" << total_num;
+    return nullptr;
+  }
+  if (!CalculateSHA256(fragment.data())
+           .Equals(fragment.fragment_hashes(fragment.index()))) {
+    LOG(ERROR) << "fragment hash not match, index:" << fragment.index();
+    return nullptr;
+  }
+
+  std::string key;
+  for (const auto& hash : fragment.fragment_hashes()) {
+    key += hash;
+  }
+
+  std::lock_guard<std::mutex> lk(mutex_);
+  Entry& entry =
+      entries_[std::make_pair(fragment.seq(), fragment.region_id())];
+  if (entry.done) {
+    return nullptr;
+  }
+  Group& group = entry.groups[key];
+  if (!group.fragments.emplace(fragment.index(), fragment.data()).second) {
+    return nullptr;
+  }
+  group.certs.push_back(fragment.certs());
+  if (group.batch == nullptr) {
+    if (static_cast<int>(group.fragments.size()) < fragment.data_num()) {
+      return nullptr;
+    }
+    ReedSolomon coder(fragment.data_num(), total_num);
+    auto data = coder.Decode(group.fragments, fragment.data_size());
+    auto batch = std::make_unique<BatchUserRequest>();
+    if (!data.ok() || !batch->ParseFromString(*data)) {
+      LOG(ERROR) << "rebuild batch fail, seq:" << fragment.seq()
+                 << " region:" << fragment.region_id();
+      return nullptr;
+    }
+    group.batch = std::move(batch);
+  }
+  certs->swap(group.certs);
+  group.certs.clear();
+  return std::make_unique<BatchUserRequest>(*group.batch);
+}
+
+void GeoFragmentCollector::Finish(uint64_t seq, int region_id) {
+  std::lock_guard<std::mutex> lk(mutex_);
+  Entry& entry = entries_[std::make_pair(seq, region_id)];
+  entry.done = true;
+  entry.groups.clear();
+}
+
+void GeoFragmentCollector::Clear(uint64_t min_seq) {
+  std::lock_guard<std::mutex> lk(mutex_);
+  while (!entries_.empty() && entries_.begin()->first.first < min_seq) {
+    entries_.erase(entries_.begin());
+  }
+}
+
+}  // namespace resdb
@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#pragma once
+
+#include <map>
+#include <mutex>
+
+#include "common/utils/reed_solomon.h"
+#include "platform/proto/resdb.pb.h"
+
+namespace resdb {
+
+// Stores the signer ids of the certs as a bitmap and the signature type
+// once. All the certs are expected to use the same signature type.
+CompactCerts ToCompactCerts(const Certs& certs);
+Certs FromCompactCerts(const CompactCerts& certs);
+
+// Builds the fragment at index of the batch, without its certs, for a
+// region of total_num replicas. Any f + 1 fragments rebuild the batch.
+std::unique_ptr<GeoFragment> NewGeoFragment(const BatchUserRequest& batch,
+                                            int region_id, int index,
+                                            int total_num);
+
+// Collects the fragments sent by the replicas of other regions and
+// rebuilds their batches.
+class GeoFragmentCollector {
+ public:
+  // Returns the rebuilt batch, without certs, once enough fragments of it
+  // have been received, until Finish() is called. certs holds the certs of
+  // the fragments which have not been returned before.
+  std::unique_ptr<BatchUserRequest> AddFragment(
+      const GeoFragment& fragment, std::vector<CompactCerts>* certs);
+
+  // The batch has been accepted; drop its fragments.
+  void Finish(uint64_t seq, int region_id);
+
+  // Drop everything below min_seq.
+  void Clear(uint64_t min_seq);
+
+ private:
+  struct Group {
+    std::map<int, std::string> fragments;
+    std::vector<CompactCerts> certs;
+    std::unique_ptr<BatchUserRequest> batch;
+  };
+  struct Entry {
+    bool done = false;
+    // Fragments of the same batch share the same fragment hashes.
+    std::map<std::string, Group> groups;
+  };
+
+  std::mutex mutex_;
+  std::map<std::pair<uint64_t, int>, Entry> entries_;
+};
+
+}  // namespace resdb
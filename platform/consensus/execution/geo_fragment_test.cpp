@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "platform/consensus/execution/geo_fragment.h"
+
+#include <gtest/gtest.h>
+
+#include "common/test/test_macros.h"
+
+namespace resdb {
+namespace {
+
+using ::resdb::testing::EqualsProto;
+
+BatchUserRequest GetBatch() {
+  BatchUserRequest batch;
+  batch.set_seq(3);
+  batch.set_hash("batch_hash");
+  for (int i = 0; i < 10; ++i) {
+    batch.add_user_requests()->mutable_request()->set_data(
+        "request_" + std::to_string(i));
+  }
+  for (int id : {4, 1, 3}) {
+    SignatureInfo* cert =
+        batch.mutable_committed_certs()->add_committed_certs();
+    cert->set_hash_type(SignatureInfo::ED25519);
+    cert->set_node_id(id);
+    cert->set_signature("sig_" + std::to_string(id));
+  }
+  return batch;
+}
+
+TEST(GeoFragmentTest, CompactCerts) {
+  BatchUserRequest batch = GetBatch();
+  CompactCerts compact_certs = ToCompactCerts(batch.committed_certs());
+  EXPECT_EQ(compact_certs.signers(), std::string(1, 0x0d));
+  EXPECT_EQ(compact_certs.signatures_size(), 3);
+
+  Certs certs = FromCompactCerts(compact_certs);
+  ASSERT_EQ(certs.committed_certs_size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    const SignatureInfo& cert = certs.committed_certs(i);
+    EXPECT_EQ(cert.hash_type(), SignatureInfo::ED25519);
+    EXPECT_EQ(cert.signature(), "sig_" + std::to_string(cert.node_id()));
+  }
+  EXPECT_EQ(certs.committed_certs(0).node_id(), 1);
+  EXPECT_EQ(certs.committed_certs(2).node_id(), 4);
+}
+
+TEST(GeoFragmentTest, RebuildFromFragments) {
+  BatchUserRequest batch = GetBatch();
+  BatchUserRequest body = batch;
+  body.clear_committed_certs();
+
+  GeoFragmentCollector collector;
+  std::vector<CompactCerts> certs;
+  // 7 replicas tolerate 2 faulty ones, so any 3 fragments are enough.
+  auto fragment_6 = NewGeoFragment(batch, 2, 6, 7);
+  EXPECT_EQ(fragment_6->data_num(), 3);
+  EXPECT_EQ(collector.AddFragment(*fragment_6, &certs), nullptr);
+  EXPECT_EQ(collector.AddFragment(*fragment_6, &certs), nullptr);
+
+  auto fragment_2 = NewGeoFragment(batch, 2, 2, 7);
+  fragment_2->set_data("bad data");
+  EXPECT_EQ(collector.AddFragment(*fragment_2, &certs), nullptr);
+  fragment_2 = NewGeoFragment(batch, 2, 2, 7);
+  EXPECT_EQ(collector.AddFragment(*fragment_2, &certs), nullptr);
+
+  auto ret = collector.AddFragment(*NewGeoFragment(batch, 2, 4, 7), &certs);
+  ASSERT_NE(ret, nullptr);
+  EXPECT_THAT(*ret, EqualsProto(body));
+  EXPECT_EQ(certs.size(), 3);
+
+  ret = collector.AddFragment(*NewGeoFragment(batch, 2, 0, 7), &certs);
+  ASSERT_NE(ret, nullptr);
+  EXPECT_EQ(certs.size(), 1);
+
+  collector.Finish(3, 2);
+  EXPECT_EQ(collector.AddFragment(*NewGeoFragment(batch, 2, 1, 7), &certs),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace resdb
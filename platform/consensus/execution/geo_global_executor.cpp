@@ -16,57 +16,83 @@
  * specific language governing permissions and limitations
  * under the License.
  */
-
 #include "platform/consensus/execution/geo_global_executor.h"
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 namespace resdb {
 
 GeoGlobalExecutor::GeoGlobalExecutor(
     std::unique_ptr<TransactionManager> global_transaction_manager,
     const ResDBConfig& config)
     : global_transaction_manager_(std::move(global_transaction_manager)),
+      pending_num_(0),
+      new_pending_(false),
+      next_pos_(0),
       config_(config),
-      is_stop_(false) {
+      is_stop_(false),
+      waiting_(false) {
   global_stats_ = Stats::GetGlobalStats();
-  region_size_ = config_.GetConfigData().region().size();
+  // Without region settings everything runs in a single region.
+  region_size_ = std::max(config_.GetSnapshot()->region_num, 1);
+  for (size_t i = 0; i < region_size_; ++i) {
+    rings_.push_back(std::make_unique<std::atomic<GeoEntry*>[]>(kWindowSize));
+    for (uint64_t j = 0; j < kWindowSize; ++j) {
+      rings_.back()[j] = nullptr;
+    }
+  }
+  my_region_ = config.GetSelfRegionId();
   order_thread_ = std::thread(&GeoGlobalExecutor::OrderRound, this);
-  my_region_ = config.GetConfigData().self_region_id();
 }
 
-GeoGlobalExecutor::~GeoGlobalExecutor() { Stop(); }
+GeoGlobalExecutor::~GeoGlobalExecutor() {
+  Stop();
+  for (auto& ring : rings_) {
+    for (uint64_t i = 0; i < kWindowSize; ++i) {
+      delete ring[i].exchange(nullptr);
+    }
+  }
+}
 
 void GeoGlobalExecutor::Stop() {
   is_stop_ = true;
+  cv_.notify_all();
   if (order_thread_.joinable()) {
     order_thread_.join();
   }
 }
 
 void GeoGlobalExecutor::Execute(std::unique_ptr<Request> request) {
-  BatchUserRequest batch_request;
-  if (!batch_request.ParseFromString(request->data())) {
+  auto batch_request = std::make_unique<BatchUserRequest>();
+  if (!batch_request->ParseFromString(request->data())) {
     LOG(ERROR) << "[GeoGlobalExecutor] parse data fail!";
     return;
   }
+  Execute(std::move(request), std::move(batch_request));
+}
+
+void GeoGlobalExecutor::Execute(
+    std::unique_ptr<Request> request,
+    std::unique_ptr<BatchUserRequest> batch_request) {
   if (request->data().empty()) {
     LOG(ERROR) << "[GeoGlobalExecutor] request->data() is empty ";
     return;
   }
 
   if (global_stats_) {
-    global_stats_->IncTotalGeoRequest(batch_request.user_requests_size());
+    global_stats_->IncTotalGeoRequest(batch_request->user_requests_size());
   }
   if (global_transaction_manager_) {
     auto batch_response =
-        global_transaction_manager_->ExecuteBatch(batch_request);
+        global_transaction_manager_->ExecuteBatch(*batch_request);
     if (batch_response != nullptr &&
         request->region_info().region_id() == my_region_) {
-      batch_response->set_createtime(batch_request.createtime());
-      batch_response->set_local_id(batch_request.local_id());
-      batch_response->set_proxy_id(batch_request.proxy_id());
-      batch_response->set_seq(batch_request.seq());
+      batch_response->set_createtime(batch_request->createtime());
+      batch_response->set_local_id(batch_request->local_id());
+      batch_response->set_proxy_id(batch_request->proxy_id());
+      batch_response->set_seq(batch_request->seq());
       resp_queue_.Push(std::move(batch_response));
     }
   }
@@ -75,52 +101,147 @@ void GeoGlobalExecutor::Execute(std::unique_ptr<Request> request) {
 bool GeoGlobalExecutor::IsStop() { return is_stop_; }
 
 int GeoGlobalExecutor::OrderGeoRequest(std::unique_ptr<Request> request) {
-  order_queue_.Push(std::move(request));
+  auto batch_request = std::make_unique<BatchUserRequest>();
+  if (!batch_request->ParseFromString(request->data())) {
+    LOG(ERROR) << "[GeoGlobalExecutor] parse data fail!";
+    return -2;
+  }
+  return OrderGeoRequest(std::move(request), std::move(batch_request));
+}
+
+int GeoGlobalExecutor::OrderGeoRequest(
+    std::unique_ptr<Request> request,
+    std::unique_ptr<BatchUserRequest> batch_request) {
+  int region_id = request->region_info().region_id();
+  if (region_id < 1 || region_id > static_cast<int>(region_size_)) {
+    LOG(ERROR) << "[GeoGlobalExecutor] invalid region:" << region_id;
+    return -2;
+  }
+  if (global_stats_) {
+    global_stats_->IncGeoRequest();
+  }
+  auto entry = std::make_unique<GeoEntry>();
+  entry->request = std::move(request);
+  entry->batch_request = std::move(batch_request);
+  if (!AddEntry(std::move(entry))) {
+    return 1;
+  }
+  if (waiting_) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    cv_.notify_one();
+  }
   return 0;
 }
 
-void GeoGlobalExecutor::AddData() {
-  auto request = order_queue_.Pop();
-  if (request == nullptr) {
-    return;
+uint64_t GeoGlobalExecutor::GetPosition(uint64_t seq, int region_id) const {
+  return (seq - 1) * region_size_ + region_id - 1;
+}
+
+// Returns false if the request has already been executed. Duplicates of
+// requests still waiting are left to GeoPBFTCommitment to filter.
+bool GeoGlobalExecutor::AddEntry(std::unique_ptr<GeoEntry> entry) {
+  uint64_t seq = entry->request->seq();
+  if (seq == 0) {
+    return false;
+  }
+  uint64_t pos = GetPosition(seq, entry->request->region_info().region_id());
+  if (pos < next_pos_) {
+    return false;
+  }
+  if (pos < next_pos_ + kWindowSize * region_size_ && AddToRing(pos, entry)) {
+    return true;
+  }
+  // Too far ahead, or the slot still holds a stale duplicate which only the
+  // execution thread can remove. Let the execution thread place it later.
+  std::lock_guard<std::mutex> lk(pending_mutex_);
+  if (!pending_.emplace(pos, std::move(entry)).second) {
+    return false;
+  }
+  pending_num_++;
+  new_pending_ = true;
+  return true;
+}
+
+bool GeoGlobalExecutor::AddToRing(uint64_t pos,
+                                  std::unique_ptr<GeoEntry>& entry) {
+  uint64_t seq = entry->request->seq();
+  int region_id = entry->request->region_info().region_id();
+  GeoEntry* expected = nullptr;
+  if (!rings_[region_id - 1][seq % kWindowSize].compare_exchange_strong(
+          expected, entry.get())) {
+    return false;
+  }
+  entry.release();
+  return true;
+}
+
+// Moves the pending requests which fit into the window into the rings.
+void GeoGlobalExecutor::MovePending() {
+  std::lock_guard<std::mutex> lk(pending_mutex_);
+  new_pending_ = false;
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (it->first >= next_pos_ + kWindowSize * region_size_) {
+      break;
+    }
+    if (it->first < next_pos_ || AddToRing(it->first, it->second)) {
+      it = pending_.erase(it);
+      pending_num_--;
+    } else {
+      ++it;
+    }
   }
-  global_stats_->IncGeoRequest();
-  uint64_t seq_num = request->seq();
-  int region_id = request->region_info().region_id();
-  execute_map_[std::make_pair(seq_num, region_id)] = std::move(request);
 }
 
-std::unique_ptr<Request> GeoGlobalExecutor::GetNextMap() {
-  if (execute_map_.empty()) {
-    return nullptr;
-  }
-  // LOG(ERROR) << "Next round seq: " << next_seq_ << ", current First in map: "
-  // << execute_map_.begin()->first << ", size: " <<
-
-  // LOG(ERROR)<<"get next seq:"<<next_seq_<<" region:"<<next_region_;
-  if (execute_map_.begin()->first == std::make_pair(next_seq_, next_region_)) {
-    std::unique_ptr<Request> res = std::move(execute_map_.begin()->second);
-    execute_map_.erase(execute_map_.begin());
-    next_region_++;
-    if (next_region_ > static_cast<int64_t>(region_size_)) {
-      next_region_ = 1;
-      next_seq_++;
+std::unique_ptr<GeoGlobalExecutor::GeoEntry>
+GeoGlobalExecutor::GetNextEntry() {
+  uint64_t seq = next_pos_ / region_size_ + 1;
+  int region_id = next_pos_ % region_size_ + 1;
+  std::atomic<GeoEntry*>& slot = rings_[region_id - 1][seq % kWindowSize];
+  for (int retry = 0; retry < 2; ++retry) {
+    GeoEntry* entry = slot.load();
+    if (entry != nullptr && entry->request->seq() == seq) {
+      // Move the position first so that late duplicates of this request are
+      // rejected once the slot is empty again.
+      next_pos_++;
+      slot.store(nullptr);
+      if (pending_num_ > 0 && next_pos_ % region_size_ == 0) {
+        MovePending();
+      }
+      return std::unique_ptr<GeoEntry>(entry);
     }
-    return res;
+    if (entry != nullptr) {
+      // A duplicate of an executed round which slipped in after its slot had
+      // been cleared.
+      slot.store(nullptr);
+      delete entry;
+    } else if (pending_num_ == 0) {
+      return nullptr;
+    }
+    MovePending();
   }
   return nullptr;
 }
 
+void GeoGlobalExecutor::WaitForEntry() {
+  std::unique_lock<std::mutex> lk(mutex_);
+  waiting_ = true;
+  uint64_t seq = next_pos_ / region_size_ + 1;
+  int region_id = next_pos_ % region_size_ + 1;
+  if (!new_pending_ &&
+      rings_[region_id - 1][seq % kWindowSize].load() == nullptr) {
+    cv_.wait_for(lk, std::chrono::milliseconds(100));
+  }
+  waiting_ = false;
+}
+
 void GeoGlobalExecutor::OrderRound() {
   while (!IsStop()) {
-    AddData();
-    while (!IsStop()) {
-      std::unique_ptr<Request> seq_map = GetNextMap();
-      if (seq_map == nullptr) {
-        break;
-      }
-      Execute(std::move(seq_map));
+    std::unique_ptr<GeoEntry> entry = GetNextEntry();
+    if (entry == nullptr) {
+      WaitForEntry();
+      continue;
     }
+    Execute(std::move(entry->request), std::move(entry->batch_request));
   }
 }
 
@@ -16,10 +16,13 @@
  * specific language governing permissions and limitations
  * under the License.
  */
-
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <mutex>
 #include <queue>
+#include <thread>
 #include <unordered_map>
 
 #include "executor/common/transaction_manager.h"
@@ -29,41 +32,73 @@
 
 namespace resdb {
 
+// Executes the geo requests committed by every region in the global order
+// (seq 1 region 1, seq 1 region 2, ..., seq 2 region 1, ...).
+//
+// Requests are parsed by the threads delivering them and placed into a
+// per-region ring indexed by seq, so the execution thread only has to pick
+// up the next slot. Requests of later rounds keep arriving and being parsed
+// while the current round is executing.
 class GeoGlobalExecutor {
  public:
   GeoGlobalExecutor(
       std::unique_ptr<TransactionManager> global_transaction_manager,
       const ResDBConfig& config);
   virtual ~GeoGlobalExecutor();
-  virtual void Execute(std::unique_ptr<Request> request);
+
+  void Execute(std::unique_ptr<Request> request);
+  virtual void Execute(std::unique_ptr<Request> request,
+                       std::unique_ptr<BatchUserRequest> batch_request);
+
   virtual int OrderGeoRequest(std::unique_ptr<Request> request);
+  // Same as above for callers which already parsed the request data.
+  virtual int OrderGeoRequest(std::unique_ptr<Request> request,
+                              std::unique_ptr<BatchUserRequest> batch_request);
 
   void Stop();
 
   std::unique_ptr<BatchUserResponse> GetResponseMsg();
 
+  // Number of rounds each region can run ahead of the execution.
+  static constexpr uint64_t kWindowSize = 1 << 12;
+
  private:
-  using ExecuteMap =
-      std::map<std::pair<uint64_t, int>, std::unique_ptr<Request>>;
+  struct GeoEntry {
+    std::unique_ptr<Request> request;
+    std::unique_ptr<BatchUserRequest> batch_request;
+  };
 
   bool IsStop();
   void OrderRound();
-  std::unique_ptr<Request> GetNextMap();
-  void AddData();
+  std::unique_ptr<GeoEntry> GetNextEntry();
+  bool AddEntry(std::unique_ptr<GeoEntry> entry);
+  bool AddToRing(uint64_t pos, std::unique_ptr<GeoEntry>& entry);
+  void MovePending();
+  void WaitForEntry();
+  // Position of (seq, region) in the global order, starting from 0.
+  uint64_t GetPosition(uint64_t seq, int region_id) const;
 
  protected:
   std::unique_ptr<TransactionManager> global_transaction_manager_;
   Stats* global_stats_;
-  std::thread execute_round_thread_, order_thread_;
-  ExecuteMap execute_map_;
-  uint64_t next_seq_ = 1;
-  int next_region_ = 1;
+  std::thread order_thread_;
+  // rings_[region - 1][seq % kWindowSize]. The delivering threads only
+  // fill empty slots, the execution thread is the only one clearing them.
+  std::vector<std::unique_ptr<std::atomic<GeoEntry*>[]>> rings_;
+  // Requests which arrived more than kWindowSize rounds ahead or whose
+  // slot was still taken, keyed by position.
+  std::map<uint64_t, std::unique_ptr<GeoEntry>> pending_;
+  std::atomic<int> pending_num_;
+  std::atomic<bool> new_pending_;
+  // Position of the next request to execute. Only the execution thread
+  // moves it forward.
+  std::atomic<uint64_t> next_pos_;
   size_t region_size_;
   ResDBConfig config_;
   std::atomic<bool> is_stop_;
-  std::mutex mutex_;
+  std::atomic<bool> waiting_;
+  std::mutex mutex_, pending_mutex_;
   std::condition_variable cv_;
-  LockFreeQueue<Request> order_queue_;
   LockFreeQueue<BatchUserResponse> resp_queue_;
   int my_region_;
 };
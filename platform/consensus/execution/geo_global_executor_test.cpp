@@ -33,6 +33,7 @@ namespace resdb {
 namespace {
 
 using ::resdb::testing::EqualsProto;
+using ::testing::Invoke;
 using ::testing::Test;
 
 class GlobalExecutorTest : public Test {
@@ -90,6 +91,56 @@ TEST_F(GlobalExecutorTest, ExecuteFailed) {
   global_executor.Execute(std::make_unique<Request>(request));
 }
 
+TEST_F(GlobalExecutorTest, ExecuteInGlobalOrder) {
+  ResConfigData config_data;
+  for (int i = 1; i <= 3; ++i) {
+    config_data.add_region()->set_region_id(i);
+  }
+  config_data.set_self_region_id(1);
+  ResDBConfig config({GenerateReplicaInfo(1, "127.0.0.1", 1234)},
+                     GenerateReplicaInfo(1, "127.0.0.1", 1234), config_data);
+
+  auto mock_executor = std::make_unique<MockTransactionManager>();
+  std::vector<std::string> executed;
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  EXPECT_CALL(*mock_executor, ExecuteBatch)
+      .Times(6)
+      .WillRepeatedly(Invoke([&](const BatchUserRequest& request) {
+        executed.push_back(request.user_requests(0).request().data());
+        if (executed.size() == 6) {
+          done.set_value(true);
+        }
+        return nullptr;
+      }));
+
+  GeoGlobalExecutor global_executor(std::move(mock_executor), config);
+  auto order = [&](uint64_t seq, int region_id) {
+    Request request;
+    request.set_seq(seq);
+    request.mutable_region_info()->set_region_id(region_id);
+    BatchUserRequest batch_request;
+    batch_request.add_user_requests()->mutable_request()->set_data(
+        std::to_string(seq) + "-" + std::to_string(region_id));
+    batch_request.SerializeToString(request.mutable_data());
+    return global_executor.OrderGeoRequest(std::make_unique<Request>(request));
+  };
+
+  // Round 2 and the later regions of round 1 arrive first.
+  EXPECT_EQ(order(2, 1), 0);
+  EXPECT_EQ(order(1, 3), 0);
+  EXPECT_EQ(order(1, 2), 0);
+  EXPECT_EQ(order(2, 3), 0);
+  EXPECT_EQ(order(2, 2), 0);
+  EXPECT_EQ(order(1, 4), -2);
+  EXPECT_EQ(order(1, 1), 0);
+  done_future.get();
+  EXPECT_EQ(order(1, 1), 1);
+
+  EXPECT_EQ(executed, std::vector<std::string>(
+                          {"1-1", "1-2", "1-3", "2-1", "2-2", "2-3"}));
+}
+
 }  // namespace
 
 }  // namespace resdb
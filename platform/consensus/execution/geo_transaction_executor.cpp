@@ -21,6 +21,7 @@
 
 #include <glog/logging.h>
 
+#include "platform/consensus/execution/geo_fragment.h"
 #include "platform/consensus/ordering/common/transaction_utils.h"
 
 namespace resdb {
@@ -73,54 +74,125 @@ void GeoTransactionExecutor::SendGeoMessages() {
 }
 
 void GeoTransactionExecutor::SendBatchGeoMessage(
-    const std::vector<std::unique_ptr<Request>>& batch_geo_request) {
-  ResConfigData config_data = config_.GetConfigData();
+    std::vector<std::unique_ptr<Request>>& batch_request) {
+  std::shared_ptr<const ResConfigData> config_data =
+      config_.GetSnapshot()->config_data;
 
-  int self_send = replica_communicator_->SendBatchMessage(
-      batch_geo_request, config_.GetSelfInfo());
-  if (self_send < 0) {
-    LOG(ERROR) << "send batch_geo_request to self FAIL!";
+  std::vector<std::unique_ptr<Request>> fragments;
+  std::vector<std::unique_ptr<Request>> geo_requests;
+  for (auto& request : batch_request) {
+    if (request->type() == Request::TYPE_GEO_FRAGMENT) {
+      fragments.push_back(std::move(request));
+    } else {
+      geo_requests.push_back(std::move(request));
+    }
+  }
+
+  if (!geo_requests.empty()) {
+    int self_send = replica_communicator_->SendBatchMessage(
+        geo_requests, config_.GetSelfInfo());
+    if (self_send < 0) {
+      LOG(ERROR) << "send batch_geo_request to self FAIL!";
+    }
   }
-  // Only for primary node: send out GEO_REQUEST to other regions.
-  if (config_.GetSelfInfo().id() == system_info_->GetPrimaryId()) {
-    for (const auto& region : config_data.region()) {
-      if (region.region_id() == config_data.self_region_id()) {
-        continue;
+
+  for (const auto& region : config_data->region()) {
+    if (region.region_id() == config_data->self_region_id()) {
+      continue;
+    }
+    // Every replica sends its own fragment to one replica of the region,
+    // which passes it on to the others.
+    int self_index = GetSelfIndex();
+    if (!fragments.empty() && self_index >= 0 &&
+        region.replica_info_size() > 0) {
+      replica_communicator_->SendBatchMessage(
+          fragments,
+          region.replica_info(self_index % region.replica_info_size()));
+    }
+    // Only for primary node: send out GEO_REQUEST to other regions.
+    if (geo_requests.empty() || config_data->enable_geo_erasure_coding() ||
+        config_.GetSelfInfo().id() != system_info_->GetPrimaryId()) {
+      continue;
+    }
+    // maximum number of faulty replicas in this region
+    int max_faulty = (region.replica_info_size() - 1) / 3;
+    int num_request_sent = 0;
+    for (const auto& replica : region.replica_info()) {
+      // send to f + 1 replicas in the region
+      if (num_request_sent > max_faulty) {
+        break;
       }
-      // maximum number of faulty replicas in this region
-      int max_faulty = (region.replica_info_size() - 1) / 3;
-      int num_request_sent = 0;
-      for (const auto& replica : region.replica_info()) {
-        // send to f + 1 replicas in the region
-        if (num_request_sent > max_faulty) {
-          break;
-        }
-        int ret =
-            replica_communicator_->SendBatchMessage(batch_geo_request, replica);
-        if (ret >= 0) {
-          num_request_sent++;
-        }
+      int ret = replica_communicator_->SendBatchMessage(geo_requests, replica);
+      if (ret >= 0) {
+        num_request_sent++;
       }
     }
-    // LOG(ERROR) << "local executor send out geo message";
   }
 }
 
+int GeoTransactionExecutor::GetSelfIndex() {
+  std::shared_ptr<const ResConfigData> config_data =
+      config_.GetSnapshot()->config_data;
+  for (const auto& region : config_data->region()) {
+    if (region.region_id() != config_data->self_region_id()) {
+      continue;
+    }
+    for (int i = 0; i < region.replica_info_size(); ++i) {
+      if (region.replica_info(i).id() == config_.GetSelfInfo().id()) {
+        return i;
+      }
+    }
+  }
+  return -1;
+}
+
+std::unique_ptr<Request> GeoTransactionExecutor::NewFragmentRequest(
+    const BatchUserRequest& request) {
+  std::shared_ptr<const ResConfigData> config_data =
+      config_.GetSnapshot()->config_data;
+  int self_index = GetSelfIndex();
+  if (self_index < 0) {
+    LOG(ERROR) << "self replica not found in region:"
+               << config_data->self_region_id();
+    return nullptr;
+  }
+  int replica_num = 0;
+  for (const auto& region : config_data->region()) {
+    if (region.region_id() == config_data->self_region_id()) {
+      replica_num = region.replica_info_size();
+    }
+  }
+  std::unique_ptr<GeoFragment> fragment = NewGeoFragment(
+      request, config_data->self_region_id(), self_index, replica_num);
+  std::unique_ptr<Request> fragment_request =
+      resdb::NewRequest(Request::TYPE_GEO_FRAGMENT, Request(),
+                        config_.GetSelfInfo().id(), config_.GetSelfRegionId());
+  fragment_request->set_seq(request.seq());
+  fragment->SerializeToString(fragment_request->mutable_data());
+  return fragment_request;
+}
+
 std::unique_ptr<BatchUserResponse> GeoTransactionExecutor::ExecuteBatch(
     const BatchUserRequest& request) {
   std::unique_ptr<Request> geo_request = resdb::NewRequest(
       Request::TYPE_GEO_REQUEST, Request(), config_.GetSelfInfo().id(),
-      config_.GetConfigData().self_region_id());
+      config_.GetSelfRegionId());
 
   geo_request->set_seq(request.seq());
   geo_request->set_proxy_id(request.proxy_id());
   geo_request->set_hash(SignatureVerifier::CalculateHash(
       geo_request->data() + std::to_string(request.seq()) +
-      std::to_string(config_.GetConfigData().self_region_id())));
+      std::to_string(config_.GetSelfRegionId())));
 
   request.SerializeToString(geo_request->mutable_data());
 
   queue_.Push(std::move(geo_request));
+  if (config_.GetSnapshot()->config_data->enable_geo_erasure_coding()) {
+    std::unique_ptr<Request> fragment_request = NewFragmentRequest(request);
+    if (fragment_request != nullptr) {
+      queue_.Push(std::move(fragment_request));
+    }
+  }
   return nullptr;
 }
 
@@ -39,8 +39,11 @@ class GeoTransactionExecutor : public TransactionManager {
 
  private:
   void SendGeoMessages();
-  void SendBatchGeoMessage(
-      const std::vector<std::unique_ptr<Request>>& requests);
+  void SendBatchGeoMessage(std::vector<std::unique_ptr<Request>>& requests);
+  // The erasure coded fragment of the request owned by this replica.
+  std::unique_ptr<Request> NewFragmentRequest(const BatchUserRequest& request);
+  // Index of this replica in the replicas of its region.
+  int GetSelfIndex();
 
  protected:
   ResDBConfig config_;
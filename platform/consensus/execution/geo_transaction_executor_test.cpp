@@ -145,6 +145,73 @@ TEST(LocalExecutorTest, PrimaryNodeBroadcast) {
   done_future.get();
 }
 
+TEST(LocalExecutorTest, SendFragments) {
+  auto mock_executor = std::make_unique<MockTransactionManager>();
+  auto replica_communicator = std::make_unique<MockReplicaCommunicator>();
+  ResConfigData config_data_ = ResConfigData();
+  config_data_.set_self_region_id(1);
+  config_data_.set_enable_geo_erasure_coding(true);
+
+  // setup region id=1
+  RegionInfo* region = config_data_.add_region();
+  region->set_region_id(1);
+  *region->add_replica_info() = GenerateReplicaInfo(1, "127.0.0.1", 10001);
+  *region->add_replica_info() = GenerateReplicaInfo(2, "127.0.0.1", 10002);
+  *region->add_replica_info() = GenerateReplicaInfo(3, "127.0.0.1", 10003);
+  *region->add_replica_info() = GenerateReplicaInfo(4, "127.0.0.1", 10004);
+
+  // setup region id=2
+  region = config_data_.add_region();
+  region->set_region_id(2);
+  *region->add_replica_info() = GenerateReplicaInfo(6, "127.0.0.1", 10006);
+  *region->add_replica_info() = GenerateReplicaInfo(7, "127.0.0.1", 10007);
+  *region->add_replica_info() = GenerateReplicaInfo(8, "127.0.0.1", 10008);
+  *region->add_replica_info() = GenerateReplicaInfo(9, "127.0.0.1", 10009);
+
+  ResDBConfig config_ =
+      ResDBConfig(config_data_, GenerateReplicaInfo(2, "127.0.0.1", 10002),
+                  KeyInfo(), CertificateInfo());
+  auto system_info_ = std::make_unique<SystemInfo>(config_);
+  system_info_->SetPrimary(2);
+  BatchUserRequest batch_request;
+  batch_request.set_seq(1);
+  batch_request.add_user_requests()->mutable_request()->set_data(
+      "local_execute_test");
+
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  std::vector<int> receivers;
+  EXPECT_CALL(*replica_communicator, SendBatchMessage)
+      .WillRepeatedly(
+          Invoke([&](const std::vector<std::unique_ptr<Request>>& messages,
+                     const ReplicaInfo& replica_info) {
+            EXPECT_EQ(messages.size(), 1);
+            if (replica_info.id() == 2) {
+              EXPECT_EQ(messages[0]->type(), Request::TYPE_GEO_REQUEST);
+            } else {
+              EXPECT_EQ(messages[0]->type(), Request::TYPE_GEO_FRAGMENT);
+              GeoFragment fragment;
+              EXPECT_TRUE(fragment.ParseFromString(messages[0]->data()));
+              EXPECT_EQ(fragment.index(), 1);
+              EXPECT_EQ(fragment.data_num(), 2);
+            }
+            receivers.push_back(replica_info.id());
+            if (receivers.size() == 2) {
+              done.set_value(true);
+            }
+            return 0;
+          }));
+
+  GeoTransactionExecutor local_executor = GeoTransactionExecutor(
+      config_, std::move(system_info_), std::move(replica_communicator),
+      std::move(mock_executor));
+  local_executor.ExecuteBatch(batch_request);
+  done_future.get();
+  // Only the fragment goes to the other region, to the replica with the
+  // same index.
+  EXPECT_EQ(receivers, std::vector<int>({2, 7}));
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -30,7 +30,9 @@ class MockGeoGlobalExecutor : public GeoGlobalExecutor {
       std::unique_ptr<TransactionExecutorImpl> global_transaction_manager,
       const ResDBConfig& config)
       : GeoGlobalExecutor(std::move(global_transaction_manager), config){};
-  MOCK_METHOD(void, Execute, (std::unique_ptr<Request>), (override));
+  MOCK_METHOD(void, Execute,
+              (std::unique_ptr<Request>, std::unique_ptr<BatchUserRequest>),
+              (override));
   ~MockGeoGlobalExecutor() { Stop(); }
 };
 
@@ -21,14 +21,69 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <limits>
+#include <map>
+
 namespace resdb {
 
+namespace {
+
+// Order the replicas by the time a primary needs to hear back from a
+// quorum, the config order breaking ties. Without the latencies it is the
+// config order.
+std::vector<uint32_t> GetLatencyAwareOrder(const ResDBConfig& config) {
+  const std::vector<ReplicaInfo>& replicas = config.GetReplicaInfos();
+  std::vector<uint32_t> order;
+  for (const auto& replica : replicas) {
+    order.push_back(replica.id());
+  }
+  auto config_data = config.GetSnapshot()->config_data;
+  if (config_data->replica_latency().empty()) {
+    return order;
+  }
+
+  std::map<std::pair<int64_t, int64_t>, int32_t> rtt;
+  for (const auto& latency : config_data->replica_latency()) {
+    rtt[std::make_pair(latency.src_id(), latency.dst_id())] = latency.rtt_ms();
+    rtt.emplace(std::make_pair(latency.dst_id(), latency.src_id()),
+                latency.rtt_ms());
+  }
+  size_t quorum = std::clamp<size_t>(config.GetMinDataReceiveNum(), 1,
+                                     replicas.size());
+
+  std::map<uint32_t, int32_t> quorum_latency;
+  for (const auto& primary : replicas) {
+    std::vector<int32_t> latency;
+    for (const auto& replica : replicas) {
+      if (replica.id() == primary.id()) {
+        latency.push_back(0);
+        continue;
+      }
+      auto it = rtt.find(std::make_pair(primary.id(), replica.id()));
+      latency.push_back(it == rtt.end() ? std::numeric_limits<int32_t>::max()
+                                        : it->second);
+    }
+    std::nth_element(latency.begin(), latency.begin() + quorum - 1,
+                     latency.end());
+    quorum_latency[primary.id()] = latency[quorum - 1];
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return quorum_latency[a] < quorum_latency[b];
+  });
+  return order;
+}
+
+}  // namespace
+
 SystemInfo::SystemInfo() : primary_id_(1), view_(1) {
   SetShardCount(4); // we do a little hardcoding
 }
 
 SystemInfo::SystemInfo(const ResDBConfig& config)
-    : primary_id_(config.GetReplicaInfos()[0].id()), view_(1) {
+    : primary_order_(GetLatencyAwareOrder(config)),
+      primary_id_(primary_order_[0]),
+      view_(1) {
   SetReplicas(config.GetReplicaInfos());
   SetShardCount(4); // we do a little hardcoding
   LOG(ERROR) << "get primary id:" << primary_id_;
@@ -42,6 +97,17 @@ uint64_t SystemInfo::GetCurrentView() const { return view_; }
 
 void SystemInfo::SetCurrentView(uint64_t view_id) { view_ = view_id; }
 
+uint32_t SystemInfo::GetPrimaryOfView(uint64_t view) const {
+  if (primary_order_.empty()) {
+    return primary_id_;
+  }
+  return primary_order_[(view - 1) % primary_order_.size()];
+}
+
+std::vector<uint32_t> SystemInfo::GetPrimaryOrder() const {
+  return primary_order_;
+}
+
 std::vector<ReplicaInfo> SystemInfo::GetReplicas() const { return replicas_; }
 
 void SystemInfo::SetReplicas(const std::vector<ReplicaInfo>& replicas) {
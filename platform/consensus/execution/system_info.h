@@ -46,6 +46,11 @@ class SystemInfo {
   uint64_t GetCurrentView() const;
   void SetCurrentView(uint64_t);
 
+  // The primary of a view. The replicas take turns in the primary order,
+  // which every replica derives from the same config.
+  uint32_t GetPrimaryOfView(uint64_t view) const;
+  std::vector<uint32_t> GetPrimaryOrder() const;
+
 
     // New Functions & Members
 
@@ -64,6 +69,7 @@ class SystemInfo {
 
  private:
   std::vector<ReplicaInfo> replicas_;
+  std::vector<uint32_t> primary_order_;
   std::atomic<uint32_t> primary_id_;
   std::atomic<uint64_t> view_;
 
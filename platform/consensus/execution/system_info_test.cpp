@@ -70,6 +70,46 @@ TEST(SystemInfoTest, GetReplicas) {
                                                 EqualsProto(new_replica)));
 }
 
+TEST(SystemInfoTest, PrimaryOrder) {
+  std::vector<ReplicaInfo> replicas;
+  for (int i = 1; i <= 4; ++i) {
+    replicas.push_back(GenerateReplicaInfo("127.0.0.1", 1233 + i, i));
+  }
+
+  SystemInfo system(ResDBConfig(replicas, replicas[0]));
+  EXPECT_THAT(system.GetPrimaryOrder(), ElementsAre(1, 2, 3, 4));
+  EXPECT_EQ(system.GetPrimaryId(), 1);
+  EXPECT_EQ(system.GetPrimaryOfView(2), 2);
+}
+
+TEST(SystemInfoTest, LatencyAwarePrimaryOrder) {
+  std::vector<ReplicaInfo> replicas;
+  for (int i = 1; i <= 4; ++i) {
+    replicas.push_back(GenerateReplicaInfo("127.0.0.1", 1233 + i, i));
+  }
+
+  // Replica 1 is far from the others.
+  ResConfigData data;
+  auto add_latency = [&](int src, int dst, int rtt_ms) {
+    auto latency = data.add_replica_latency();
+    latency->set_src_id(src);
+    latency->set_dst_id(dst);
+    latency->set_rtt_ms(rtt_ms);
+  };
+  add_latency(1, 2, 200);
+  add_latency(1, 3, 200);
+  add_latency(1, 4, 200);
+  add_latency(2, 3, 10);
+  add_latency(2, 4, 20);
+  add_latency(3, 4, 30);
+
+  SystemInfo system(ResDBConfig(replicas, replicas[0], data));
+  EXPECT_THAT(system.GetPrimaryOrder(), ElementsAre(2, 3, 4, 1));
+  EXPECT_EQ(system.GetPrimaryId(), 2);
+  EXPECT_EQ(system.GetPrimaryOfView(4), 1);
+  EXPECT_EQ(system.GetPrimaryOfView(5), 2);
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -20,6 +20,9 @@
 #include "platform/consensus/execution/transaction_executor.h"
 
 #include <glog/logging.h>
+
+#include <algorithm>
+
 #include "common/utils/utils.h"
 
 namespace resdb {
@@ -36,6 +39,16 @@ TransactionExecutor::TransactionExecutor(
       execute_queue_("execute"),
       stop_(false),
       duplicate_manager_(nullptr) {
+  // Checkpoints need the requests to be executed in order.
+  Storage* storage = GetStorage();
+  if (storage != nullptr && !transaction_manager_->IsOutOfOrder() &&
+      config_.GetConfigData().enable_execution_checkpoint() &&
+      storage->EnableCheckpoint()) {
+    checkpoint_storage_ = storage;
+    next_execute_seq_ = storage->GetCheckpointSeq() + 1;
+    LOG(ERROR) << "start execution from checkpoint:"
+               << storage->GetCheckpointSeq();
+  }
 
   memset(blucket_, 0, sizeof(blucket_));
   global_stats_ = Stats::GetGlobalStats();
@@ -45,15 +58,23 @@ TransactionExecutor::TransactionExecutor(
         std::thread(&TransactionExecutor::ExecuteMessage, this));
   }
 
-  for (int i = 0; i < 1; ++i) {
+  for (int i = 0; i < prepare_thread_num_; ++i) {
     prepare_thread_.push_back(
         std::thread(&TransactionExecutor::PrepareMessage, this));
   }
 
   if (transaction_manager_ && transaction_manager_->IsOutOfOrder()) {
-    execute_OOO_thread_ =
-        std::thread(&TransactionExecutor::ExecuteMessageOutOfOrder, this);
-    LOG(ERROR) << " is out of order:" << transaction_manager_->IsOutOfOrder();
+    int worker_num = std::max<int>(config_.GetOutOfOrderWorkerNum(), 1);
+    for (int i = 0; i < worker_num; ++i) {
+      execute_OOO_queue_.push_back(
+          std::make_unique<LockFreeQueue<SharedBatch>>("execute_ooo"));
+    }
+    for (int i = 0; i < worker_num; ++i) {
+      execute_OOO_thread_.push_back(
+          std::thread(&TransactionExecutor::ExecuteMessageOutOfOrder, this, i));
+    }
+    LOG(ERROR) << " is out of order:" << transaction_manager_->IsOutOfOrder()
+               << " workers:" << worker_num;
   }
 }
 
@@ -109,8 +130,10 @@ void TransactionExecutor::Stop() {
       th.join();
     }
   }
-  if (execute_OOO_thread_.joinable()) {
-    execute_OOO_thread_.join();
+  for (auto& th : execute_OOO_thread_) {
+    if (th.joinable()) {
+      th.join();
+    }
   }
 }
 
@@ -126,6 +149,24 @@ void TransactionExecutor::SetSeqUpdateNotifyFunc(SeqUpdateNotifyFunc func) {
   seq_update_notify_func_ = func;
 }
 
+void TransactionExecutor::SetCheckpointStateFunc(CheckpointStateFunc func) {
+  checkpoint_state_func_ = func;
+}
+
+std::vector<std::pair<uint64_t, std::string>>
+TransactionExecutor::GetCheckpointStates() {
+  if (checkpoint_storage_ == nullptr) {
+    return {};
+  }
+  return checkpoint_storage_->GetCheckpointStates();
+}
+
+void TransactionExecutor::DropCheckpointStates(uint64_t seq) {
+  if (checkpoint_storage_) {
+    checkpoint_storage_->DropCheckpointStates(seq);
+  }
+}
+
 bool TransactionExecutor::IsStop() { return stop_; }
 
 uint64_t TransactionExecutor::GetMaxPendingExecutedSeq() {
@@ -146,9 +187,14 @@ int TransactionExecutor::Commit(std::unique_ptr<Request> message) {
   if (transaction_manager_ && transaction_manager_->IsOutOfOrder()) {
     // LOG(ERROR)<<"add out of order exe:"<<message->seq()<<" from
     // proxy:"<<message->proxy_id();
-    std::unique_ptr<Request> msg = std::make_unique<Request>(*message);
-    execute_OOO_queue_.Push(std::move(message));
-    commit_queue_.Push(std::move(msg));
+    // The batch is parsed once and shared by the execution worker and the
+    // ordering path, which only builds the response from it.
+    SharedBatch batch = ParseBatch(*message);
+    uint64_t key = transaction_manager_->GetPartitionKey(*batch);
+    AddOutOfOrderBatch(batch);
+    execute_OOO_queue_[key % execute_OOO_queue_.size()]->Push(
+        std::make_unique<SharedBatch>(std::move(batch)));
+    commit_queue_.Push(std::move(message));
   } else {
     commit_queue_.Push(std::move(message));
   }
@@ -182,6 +228,7 @@ void TransactionExecutor::OrderMessage() {
       if (next_execute_seq_ > seq) {
         // LOG(INFO) << "request seq:" << seq << " has been executed"
         // << " next seq:" << next_execute_seq_;
+        TakeOutOfOrderBatch(seq);
         continue;
       }
 
@@ -234,34 +281,56 @@ void TransactionExecutor::ExecuteMessage() {
   }
 }
 
-void TransactionExecutor::ExecuteMessageOutOfOrder() {
+void TransactionExecutor::ExecuteMessageOutOfOrder(int worker_idx) {
+  LockFreeQueue<SharedBatch>* queue = execute_OOO_queue_[worker_idx].get();
   while (!IsStop()) {
-    auto message = execute_OOO_queue_.Pop();
-    if (message == nullptr) {
+    auto batch = queue->Pop();
+    if (batch == nullptr) {
       continue;
     }
-    OnlyExecute(std::move(message));
+    OnlyExecute(**batch);
   }
 }
 
-void TransactionExecutor::OnlyExecute(std::unique_ptr<Request> request) {
-  // Only Execute the request.
-  BatchUserRequest batch_request;
-  if (!batch_request.ParseFromString(request->data())) {
+TransactionExecutor::SharedBatch TransactionExecutor::ParseBatch(
+    const Request& request) {
+  auto batch_request = std::make_shared<BatchUserRequest>();
+  if (!batch_request->ParseFromString(request.data())) {
     LOG(ERROR) << "parse data fail";
   }
-  batch_request.set_seq(request->seq());
-  batch_request.set_hash(request->hash());
-  batch_request.set_proxy_id(request->proxy_id());
-  if (request->has_committed_certs()) {
-    *batch_request.mutable_committed_certs() = request->committed_certs();
+  batch_request->set_hash(request.hash());
+  if (request.has_committed_certs()) {
+    *batch_request->mutable_committed_certs() = request.committed_certs();
   }
+  batch_request->set_seq(request.seq());
+  batch_request->set_proxy_id(request.proxy_id());
+  return batch_request;
+}
 
+void TransactionExecutor::AddOutOfOrderBatch(SharedBatch batch) {
+  std::unique_lock<std::mutex> lk(ooo_mutex_);
+  ooo_batch_[batch->seq()] = std::move(batch);
+}
+
+TransactionExecutor::SharedBatch TransactionExecutor::TakeOutOfOrderBatch(
+    uint64_t seq) {
+  std::unique_lock<std::mutex> lk(ooo_mutex_);
+  auto it = ooo_batch_.find(seq);
+  if (it == ooo_batch_.end()) {
+    return nullptr;
+  }
+  SharedBatch batch = std::move(it->second);
+  ooo_batch_.erase(it);
+  return batch;
+}
+
+void TransactionExecutor::OnlyExecute(const BatchUserRequest& batch_request) {
+  // Only Execute the request. The stats details are recorded by the
+  // ordering path.
   // LOG(INFO) << " get request batch size:"
   //          << batch_request.user_requests_size()<<" proxy
-  //          id:"<<request->proxy_id();
+  //          id:"<<batch_request.proxy_id();
   std::unique_ptr<BatchUserResponse> response;
-   global_stats_->GetTransactionDetails(batch_request);
   if (transaction_manager_) {
     response = transaction_manager_->ExecuteBatch(batch_request);
   }
@@ -272,42 +341,40 @@ void TransactionExecutor::OnlyExecute(std::unique_ptr<Request> request) {
 
 void TransactionExecutor::Execute(std::unique_ptr<Request> request, bool need_execute) {
   // OK! This is the big one. It has to be. Right???
-  // This seems to just note the execution.
-  RegisterExecute(request->seq());
+  // This seems to just note the execution. Out-of-order requests are not
+  // executed here and never finish, so they are not registered.
+  if (need_execute) {
+    RegisterExecute(request->seq());
+  }
   // Let's get some data loaded
-  std::unique_ptr<BatchUserRequest> batch_request = nullptr;
   std::unique_ptr<std::vector<std::unique_ptr<google::protobuf::Message>>> data;
   std::vector<std::unique_ptr<google::protobuf::Message>> * data_p = nullptr;
-  // WHY IS THIS ALWAYS NULL? HUH. It gets updated later to contain request.
-  BatchUserRequest* batch_request_p = nullptr;
-
-  // Execute the request, then send the response back to the user.
-  if (batch_request_p == nullptr) {
-    // This  block of code always happens.
-
-    // Create new batch request, fill with data from request
-    batch_request = std::make_unique<BatchUserRequest>();
-    if (!batch_request->ParseFromString(request->data())) {
-      LOG(ERROR) << "parse data fail";
-    }
-    batch_request->set_hash(request->hash());
-    if (request->has_committed_certs()) {
-      *batch_request->mutable_committed_certs() = request->committed_certs();
-    }
-    batch_request->set_seq(request->seq());
-    batch_request->set_proxy_id(request->proxy_id());
 
-    // Set batch_request_p to this new request.
-    batch_request_p = batch_request.get();
-    // LOG(ERROR)<<"get data from req:";
+  // In out-of-order mode the batch has been parsed on commit. Otherwise it
+  // may have been parsed and validated by the pre-execution workers.
+  SharedBatch batch_request;
+  std::unique_ptr<PreparedBatch> prepared;
+  if (!need_execute) {
+    batch_request = TakeOutOfOrderBatch(request->seq());
   } else {
-    // This block of code NEVER HAPPENS?
-    assert(batch_request_p);
-    batch_request_p->set_seq(request->seq());
-    batch_request_p->set_proxy_id(request->proxy_id());
-    // LOG(ERROR)<<" get from cache:"<<uid;
+    prepared = TakePreparedBatch(*request);
   }
+  if (prepared != nullptr) {
+    batch_request = prepared->batch;
+    data = std::move(prepared->data);
+    data_p = data.get();
+  }
+  // Create new batch request, fill with data from request.
+  if (batch_request == nullptr) {
+    batch_request = ParseBatch(*request);
+  }
+  const BatchUserRequest* batch_request_p = batch_request.get();
   assert(batch_request_p);
+  bool valid = true;
+  if (need_execute) {
+    valid =
+        prepared != nullptr ? prepared->valid : VerifyBatch(*batch_request_p);
+  }
 
   // LOG(INFO) << " get request batch size:"
   // << batch_request.user_requests_size()<<" proxy id:"
@@ -321,11 +388,17 @@ void TransactionExecutor::Execute(std::unique_ptr<Request> request, bool need_ex
 
   // OK, so it seems like we have yet more obfuscation.
   if (transaction_manager_ && need_execute) {
-    if (execute_thread_num_ == 1) {
+    if (!valid) {
+      LOG(ERROR) << "invalid client signature, skip seq:" << request->seq();
+      WaitForExecute(request->seq());
+      Checkpoint(*request);
+      FinishExecute(request->seq());
+    } else if (execute_thread_num_ == 1) {
 
       // I think this is the rabbit hole to follow...
       // ... This function doesn't do anything.
       response = transaction_manager_->ExecuteBatch(*batch_request_p);
+      Checkpoint(*request);
     } else {
       std::vector<std::unique_ptr<std::string>> response_v;
 
@@ -349,6 +422,7 @@ void TransactionExecutor::Execute(std::unique_ptr<Request> request, bool need_ex
 	    else {
 		    response_v = transaction_manager_->ExecuteBatchData(*data_p);
 	    }
+      Checkpoint(*request);
       FinishExecute(request->seq());
 
       if(response == nullptr){
@@ -382,91 +456,56 @@ void TransactionExecutor::Execute(std::unique_ptr<Request> request, bool need_ex
   global_stats_->IncExecuteDone();
 }
 
+void TransactionExecutor::Checkpoint(const Request& request) {
+  if (checkpoint_storage_ == nullptr) {
+    return;
+  }
+  std::string state;
+  if (checkpoint_state_func_) {
+    state = checkpoint_state_func_(request);
+  }
+  if (!checkpoint_storage_->Checkpoint(request.seq(), state)) {
+    LOG(ERROR) << "write execution checkpoint fail, seq:" << request.seq();
+  }
+}
+
 void TransactionExecutor::SetDuplicateManager(DuplicateManager* manager) {
   duplicate_manager_ = manager;
 }
 
+void TransactionExecutor::SetSignatureVerifier(SignatureVerifier* verifier) {
+  verifier_ = verifier;
+}
 
-bool TransactionExecutor::SetFlag(uint64_t uid, int f) {
-  std::unique_lock<std::mutex> lk(f_mutex_[uid % mod]);
-  auto it = flag_[uid % mod].find(uid);
-  if (it == flag_[uid % mod].end()) {
-    flag_[uid % mod][uid] |= f;
-    // LOG(ERROR)<<"NO FUTURE uid:"<<uid;
+bool TransactionExecutor::VerifyBatch(const BatchUserRequest& batch_request) {
+  if (verifier_ == nullptr) {
     return true;
   }
-  assert(it != flag_[uid % mod].end());
-  if (f == Start_Prepare) {
-    if (flag_[uid % mod][uid] & Start_Execute) {
-      return false;
-    }
-  } else if(f == Start_Execute){
-    if (flag_[uid % mod][uid] & End_Prepare) {
-    //if (flag_[uid % mod][uid] & Start_Prepare) {
+  for (const auto& user_request : batch_request.user_requests()) {
+    if (!verifier_->VerifyMessage(user_request.request(),
+                                  user_request.signature())) {
+      LOG(ERROR) << "user request signature is not valid:"
+                 << user_request.signature().DebugString();
       return false;
     }
   }
-  flag_[uid % mod][uid] |= f;
   return true;
 }
 
-void TransactionExecutor::ClearPromise(uint64_t uid) {
-  std::unique_lock<std::mutex> lk(f_mutex_[uid % mod]);
-  auto it = pre_[uid % mod].find(uid);
-  if (it == pre_[uid % mod].end()) {
+void TransactionExecutor::Prepare(std::unique_ptr<Request> request) {
+  if (transaction_manager_ == nullptr || transaction_manager_->IsOutOfOrder() ||
+      request->seq() < next_execute_seq_) {
     return;
   }
-  // LOG(ERROR)<<"CLEAR UID:"<<uid;
-  assert(it != pre_[uid % mod].end());
-  assert(flag_[uid % mod].find(uid) != flag_[uid % mod].end());
-  //assert(data_[uid%mod].find(uid) != data_[uid%mod].end());
-  //assert(req_[uid%mod].find(uid) != req_[uid%mod].end());
-  //data_[uid%mod].erase(data_[uid%mod].find(uid));
-  //req_[uid%mod].erase(req_[uid%mod].find(uid));
-  pre_[uid % mod].erase(it);
-  flag_[uid % mod].erase(flag_[uid % mod].find(uid));
-}
-
-std::promise<int>* TransactionExecutor::GetPromise(uint64_t uid) {
-  std::unique_lock<std::mutex> lk(f_mutex_[uid % mod]);
-  auto it = pre_[uid % mod].find(uid);
-  if (it == pre_[uid % mod].end()) {
-    return nullptr;
-  }
-  return it->second.get();
-}
-
-std::unique_ptr<std::future<int>> TransactionExecutor::GetFuture(uint64_t uid) {
-  std::unique_lock<std::mutex> lk(f_mutex_[uid % mod]);
-  auto it = pre_[uid % mod].find(uid);
-  if (it == pre_[uid % mod].end()) {
-    return nullptr;
-  }
-  //return std::move(it->second);
-  // LOG(ERROR)<<"add future:"<<uid;
-  return std::make_unique<std::future<int>>(it->second->get_future());
-}
-
-bool TransactionExecutor::AddFuture(uint64_t uid) {
-  std::unique_lock<std::mutex> lk(f_mutex_[uid % mod]);
-  auto it = pre_[uid % mod].find(uid);
-  if (it == pre_[uid % mod].end()) {
-    // LOG(ERROR)<<"add future:"<<uid;
-    std::unique_ptr<std::promise<int>> p =
-        std::make_unique<std::promise<int>>();
-    //auto f = std::make_unique<std::future<int>>(p->get_future());
-    pre_[uid % mod][uid] = std::move(p);
-    //pre_f_[uid % mod][uid] = std::move(f);
-    flag_[uid % mod][uid] = 0;
-    return true;
-  }
-  return false;
-}
-
-void TransactionExecutor::Prepare(std::unique_ptr<Request> request) {
-  if (AddFuture(request->uid())) {
-    prepare_queue_.Push(std::move(request));
+  {
+    std::unique_lock<std::mutex> lk(prepare_mutex_);
+    auto it = prepared_.find(request->seq());
+    if (it != prepared_.end() && it->second.first == request->hash()) {
+      return;
+    }
+    prepared_[request->seq()] = std::make_pair(request->hash(), nullptr);
   }
+  prepare_queue_.Push(std::move(request));
 }
 
 void TransactionExecutor::PrepareMessage() {
@@ -475,61 +514,65 @@ void TransactionExecutor::PrepareMessage() {
     if (request == nullptr) {
       continue;
     }
-
-    uint64_t uid = request->uid();
-    int current_f = SetFlag(uid, Start_Prepare);
-    if (current_f == 0) {
-      // commit has done
-      // LOG(ERROR)<<" want prepare, commit started:"<<uid;
-//      ClearPromise(uid);
-      continue;
+    uint64_t seq = request->seq();
+    {
+      // The request has been committed or replaced before it was prepared.
+      std::unique_lock<std::mutex> lk(prepare_mutex_);
+      auto it = prepared_.find(seq);
+      if (it == prepared_.end() || it->second.first != request->hash()) {
+        continue;
+      }
     }
 
-    std::promise<int>* p = GetPromise(uid) ;
-    assert(p);
-    //LOG(ERROR)<<" prepare started:"<<uid;
-
-    // LOG(ERROR)<<" prepare uid:"<<uid;
-
-    // Execute the request, then send the response back to the user.
-    std::unique_ptr<BatchUserRequest> batch_request =
-        std::make_unique<BatchUserRequest>();
-    if (!batch_request->ParseFromString(request->data())) {
-      LOG(ERROR) << "parse data fail";
-    }
-    // batch_request = std::make_unique<BatchUserRequest>();
-    batch_request->set_seq(request->seq());
-    batch_request->set_hash(request->hash());
-    batch_request->set_proxy_id(request->proxy_id());
-    if (request->has_committed_certs()) {
-      *batch_request->mutable_committed_certs() = request->committed_certs();
+    auto prepared = std::make_unique<PreparedBatch>();
+    prepared->batch = ParseBatch(*request);
+    prepared->valid = VerifyBatch(*prepared->batch);
+    if (prepared->valid) {
+      prepared->data = transaction_manager_->Prepare(*prepared->batch);
+      for (const auto& data : *prepared->data) {
+        if (data != nullptr) {
+          transaction_manager_->Prefetch(*data);
+        }
+      }
     }
 
-    // LOG(ERROR)<<"prepare seq:"<<batch_request->seq()<<" proxy
-    // id:"<<request->proxy_id()<<" local id:"<<batch_request->local_id();
+    std::unique_lock<std::mutex> lk(prepare_mutex_);
+    auto it = prepared_.find(seq);
+    if (it != prepared_.end() && it->second.first == request->hash() &&
+        it->second.second == nullptr) {
+      it->second.second = std::move(prepared);
+    }
+  }
+}
 
-    std::unique_ptr<std::vector<std::unique_ptr<google::protobuf::Message>>>
-     request_v = transaction_manager_->Prepare(*batch_request);
-    {
-      std::unique_lock<std::mutex> lk(fd_mutex_[uid % mod]);
-   //   assert(request_v);
-      // assert(data_[uid%mod].find(uid) == data_[uid%mod].end());
-      data_[uid%mod][uid] = std::move(request_v);
-      req_[uid % mod][uid] = std::move(batch_request);
+std::unique_ptr<TransactionExecutor::PreparedBatch>
+TransactionExecutor::TakePreparedBatch(const Request& request) {
+  std::unique_ptr<PreparedBatch> prepared;
+  {
+    std::unique_lock<std::mutex> lk(prepare_mutex_);
+    auto it = prepared_.find(request.seq());
+    if (it == prepared_.end()) {
+      return nullptr;
     }
-    //LOG(ERROR)<<"set promise:"<<uid;
-    p->set_value(1);
-    {
-      int set_ret = SetFlag(uid, End_Prepare);
-      if (set_ret == 0) {
-        // LOG(ERROR)<<"commit interrupt:"<<uid;
-        //ClearPromise(uid);
-      } else {
-        //LOG(ERROR)<<"prepare done:"<<uid;
-      }
+    // If it is still being prepared, the result will be dropped.
+    prepared = std::move(it->second.second);
+    prepared_.erase(it);
+    // Drop the requests that were prepared but never committed, e.g. the
+    // ones proposed by a replaced primary.
+    while (!prepared_.empty() &&
+           prepared_.begin()->first + blucket_num_ < request.seq()) {
+      prepared_.erase(prepared_.begin());
     }
   }
+  if (prepared == nullptr || prepared->batch->hash() != request.hash()) {
+    return nullptr;
+  }
+  if (request.has_committed_certs()) {
+    auto batch = std::make_shared<BatchUserRequest>(*prepared->batch);
+    *batch->mutable_committed_certs() = request.committed_certs();
+    prepared->batch = std::move(batch);
+  }
+  return prepared;
 }
 
-
 }  // namespace resdb
@@ -21,6 +21,7 @@
 #include <functional>
 #include <thread>
 
+#include "common/crypto/signature_verifier.h"
 #include "executor/common/transaction_manager.h"
 #include "platform/common/queue/lock_free_queue.h"
 #include "platform/config/resdb_config.h"
@@ -39,6 +40,7 @@ class TransactionExecutor {
       PostExecuteFunc;
   typedef std::function<void(Request*)> PreExecuteFunc;
   typedef std::function<void(uint64_t seq)> SeqUpdateNotifyFunc;
+  typedef std::function<std::string(const Request&)> CheckpointStateFunc;
 
   TransactionExecutor(const ResDBConfig& config, PostExecuteFunc post_exec_func,
                       SystemInfo* system_info,
@@ -52,6 +54,8 @@ class TransactionExecutor {
   int Commit(std::unique_ptr<Request> request);
 
   // The max seq S that can be executed (have received all the seq before S).
+  // After a restart from an execution checkpoint, it starts from the seq of
+  // the checkpoint.
   uint64_t GetMaxPendingExecutedSeq();
 
   // When a transaction is ready to be executed (have received all the seq
@@ -60,8 +64,22 @@ class TransactionExecutor {
 
   void SetSeqUpdateNotifyFunc(SeqUpdateNotifyFunc func);
 
+  // Called in order with each executed request. The state it returns is
+  // written with the execution checkpoint of the request.
+  void SetCheckpointStateFunc(CheckpointStateFunc func);
+  // The states kept from the execution checkpoints up to the one the
+  // executor started from, in the order of their seq.
+  std::vector<std::pair<uint64_t, std::string>> GetCheckpointStates();
+  // The states up to seq are no longer needed. They are removed with the
+  // next execution checkpoint.
+  void DropCheckpointStates(uint64_t seq);
+
   void SetDuplicateManager(DuplicateManager* manager);
 
+  // If set, the client signature of each user request is verified before
+  // execution. Batches containing an invalid one are not executed.
+  void SetSignatureVerifier(SignatureVerifier* verifier);
+
   void AddExecuteMessage(std::unique_ptr<Request> message);
 
   Storage* GetStorage();
@@ -70,16 +88,26 @@ class TransactionExecutor {
   void WaitForExecute(int64_t seq);
   void FinishExecute(int64_t seq);
 
+  // Pre-execute a proposed request before it is committed: parse its user
+  // requests, verify their signatures and prefetch the state they touch.
+  // The commit of the same seq and hash then only runs the execution.
   void Prepare(std::unique_ptr<Request> request);
 
  private:
   void Execute(std::unique_ptr<Request> request, bool need_execute = true);
-  void OnlyExecute(std::unique_ptr<Request> request);
+  void OnlyExecute(const BatchUserRequest& batch_request);
 
   std::unique_ptr<std::string> DoExecute(const Request& request);
   void OrderMessage();
   void ExecuteMessage();
-  void ExecuteMessageOutOfOrder();
+  void ExecuteMessageOutOfOrder(int worker_idx);
+
+  // In out-of-order mode the batch is parsed once on commit and shared
+  // between the execution worker and the ordering path.
+  typedef std::shared_ptr<const BatchUserRequest> SharedBatch;
+  SharedBatch ParseBatch(const Request& request);
+  void AddOutOfOrderBatch(SharedBatch batch);
+  SharedBatch TakeOutOfOrderBatch(uint64_t seq);
 
   void AddNewData(std::unique_ptr<Request> message);
   std::unique_ptr<Request> GetNextData();
@@ -88,13 +116,21 @@ class TransactionExecutor {
 
   void UpdateMaxExecutedSeq(uint64_t seq);
 
-  bool SetFlag(uint64_t uid, int f);
-  void ClearPromise(uint64_t uid);
+  typedef std::unique_ptr<
+      std::vector<std::unique_ptr<google::protobuf::Message>>>
+      PreparedData;
+  struct PreparedBatch {
+    SharedBatch batch;
+    PreparedData data;
+    bool valid = true;
+  };
+
   void PrepareMessage();
+  std::unique_ptr<PreparedBatch> TakePreparedBatch(const Request& request);
+  bool VerifyBatch(const BatchUserRequest& batch_request);
 
-  bool AddFuture(uint64_t uid);
-  std::unique_ptr<std::future<int>> GetFuture(uint64_t uid);
-  std::promise<int>* GetPromise(uint64_t uid);
+  // Write the execution checkpoint of the request just executed.
+  void Checkpoint(const Request& request);
 
  protected:
   ResDBConfig config_;
@@ -107,9 +143,12 @@ class TransactionExecutor {
   SystemInfo* system_info_ = nullptr;
   std::unique_ptr<TransactionManager> transaction_manager_ = nullptr;
   std::map<uint64_t, std::unique_ptr<Request>> candidates_;
-  std::thread ordering_thread_, execute_OOO_thread_;
-  std::vector<std::thread> execute_thread_;
-  LockFreeQueue<Request> commit_queue_, execute_queue_, execute_OOO_queue_;
+  std::thread ordering_thread_;
+  std::vector<std::thread> execute_thread_, execute_OOO_thread_;
+  LockFreeQueue<Request> commit_queue_, execute_queue_;
+  std::vector<std::unique_ptr<LockFreeQueue<SharedBatch>>> execute_OOO_queue_;
+  std::mutex ooo_mutex_;
+  std::map<uint64_t, SharedBatch> ooo_batch_;
   std::atomic<bool> stop_;
   Stats* global_stats_ = nullptr;
   DuplicateManager* duplicate_manager_;
@@ -119,30 +158,22 @@ class TransactionExecutor {
   std::condition_variable cv_;
   std::mutex mutex_;
 
-  enum PrepareType {
-    Start_Prepare = 1,
-    Start_Execute = 2,
-    End_Prepare = 4,
-  };
-
+  SignatureVerifier* verifier_ = nullptr;
 
+  int prepare_thread_num_ = 4;
   std::vector<std::thread> prepare_thread_;
-  static const int mod = 2048;
-  std::mutex f_mutex_[mod], fd_mutex_[mod];
   LockFreeQueue<Request> prepare_queue_;
-  LockFreeQueue<int64_t> gc_queue_;
-  typedef std::unique_ptr<std::promise<int>> PromiseType;
-  std::map<uint64_t, PromiseType> pre_[mod];
-
-  std::map<uint64_t, std::unique_ptr<std::future<int>>> pre_f_[mod];
-  std::map<uint64_t, int> flag_[mod];
-
-  std::map<uint64_t, std::unique_ptr<BatchUserRequest>> req_[mod];
-  std::unordered_map<
-      uint64_t,
-      std::unique_ptr<std::vector<std::unique_ptr<google::protobuf::Message>>>>
-      data_[mod];
-
+  std::mutex prepare_mutex_;
+  // Prepared batches keyed by seq, with the hash of the proposal they come
+  // from. A null batch is still being prepared. A proposal with another hash
+  // for the seq replaces the entry, so a bogus one does not keep the real
+  // one from being prepared.
+  std::map<uint64_t, std::pair<std::string, std::unique_ptr<PreparedBatch>>>
+      prepared_;
+
+  // Set if the execution checkpoints are written to it.
+  Storage* checkpoint_storage_ = nullptr;
+  CheckpointStateFunc checkpoint_state_func_;
 };
 
 }  // namespace resdb
@@ -23,7 +23,12 @@
 #include <gtest/gtest.h>
 
 #include <future>
+#include <map>
+#include <set>
+#include <thread>
 
+#include "chain/storage/mock_storage.h"
+#include "common/crypto/mock_signature_verifier.h"
 #include "common/test/test_macros.h"
 #include "executor/common/mock_transaction_manager.h"
 
@@ -31,12 +36,59 @@ namespace resdb {
 namespace {
 
 using ::resdb::testing::EqualsProto;
+using ::testing::_;
 using ::testing::Invoke;
+using ::testing::Return;
 
 ResDBConfig GetResDBConfig() {
   return ResDBConfig({ReplicaInfo()}, ReplicaInfo());
 }
 
+// Parses each transaction into a Request and counts the pre-execution work.
+class PrepareTransactionManager : public TransactionManager {
+ public:
+  std::unique_ptr<google::protobuf::Message> ParseData(
+      const std::string& data) override {
+    parse_num++;
+    auto request = std::make_unique<Request>();
+    request->set_data(data);
+    return request;
+  }
+
+  void Prefetch(const google::protobuf::Message& request) override {
+    prefetch_num++;
+  }
+
+  std::unique_ptr<std::string> ExecuteRequest(
+      const google::protobuf::Message& request) override {
+    execute_num++;
+    return std::make_unique<std::string>(
+        dynamic_cast<const Request&>(request).data());
+  }
+
+  std::atomic<int> parse_num = 0, prefetch_num = 0, execute_num = 0;
+};
+
+class StorageTransactionManager : public PrepareTransactionManager {
+ public:
+  StorageTransactionManager(Storage* storage) : storage_(storage) {}
+  Storage* GetStorage() override { return storage_; }
+
+ private:
+  Storage* storage_;
+};
+
+std::unique_ptr<Request> GetBatchRequest(uint64_t seq, const std::string& hash,
+                                         const std::string& data) {
+  auto request = std::make_unique<Request>();
+  request->set_seq(seq);
+  request->set_hash(hash);
+  BatchUserRequest batch_request;
+  batch_request.add_user_requests()->mutable_request()->set_data(data);
+  batch_request.SerializeToString(request->mutable_data());
+  return request;
+}
+
 TEST(TransactionExecutorTest, ExecuteOne) {
   std::promise<bool> done;
   std::future<bool> done_future = done.get_future();
@@ -277,6 +329,285 @@ TEST(TransactionExecutorTest, CallBack) {
   done_future.get();
 }
 
+TEST(TransactionExecutorTest, OutOfOrderWorkersKeepKeyOrder) {
+  ResDBConfig config = GetResDBConfig();
+  config.SetOutOfOrderWorkerNum(4);
+
+  const int txn_num = 100;
+  const int key_num = 8;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int execute_num = 0, response_num = 0;
+  std::map<std::string, std::thread::id> key_thread;
+  std::map<std::string, uint64_t> key_seq;
+
+  // The transaction is the key itself.
+  class KeyedTransactionManager : public MockTransactionManager {
+   public:
+    KeyedTransactionManager() : MockTransactionManager(true) {}
+    uint64_t GetPartitionKey(const BatchUserRequest& request) override {
+      return std::hash<std::string>()(
+          request.user_requests(0).request().data());
+    }
+  };
+
+  SystemInfo system_info(config);
+  auto mock_executor = std::make_unique<KeyedTransactionManager>();
+  std::set<std::thread::id> threads;
+  EXPECT_CALL(*mock_executor, ExecuteBatch)
+      .Times(txn_num)
+      .WillRepeatedly(Invoke([&](const BatchUserRequest& request) {
+        std::unique_lock<std::mutex> lk(mutex);
+        threads.insert(std::this_thread::get_id());
+        const std::string& key = request.user_requests(0).request().data();
+        auto it = key_thread.find(key);
+        if (it == key_thread.end()) {
+          key_thread[key] = std::this_thread::get_id();
+        } else {
+          EXPECT_EQ(it->second, std::this_thread::get_id());
+        }
+        EXPECT_GT(request.seq(), key_seq[key]);
+        key_seq[key] = request.seq();
+        execute_num++;
+        cv.notify_all();
+        return nullptr;
+      }));
+
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request> request,
+          std::unique_ptr<BatchUserResponse> resp) {
+        std::unique_lock<std::mutex> lk(mutex);
+        EXPECT_EQ(request->seq(), resp->seq());
+        response_num++;
+        cv.notify_all();
+      },
+      &system_info, std::move(mock_executor));
+
+  for (int i = 1; i <= txn_num; ++i) {
+    Request request;
+    request.set_seq(i);
+    BatchUserRequest batch_request;
+    batch_request.add_user_requests()->mutable_request()->set_data(
+        "key_" + std::to_string(i % key_num));
+    batch_request.SerializeToString(request.mutable_data());
+    EXPECT_EQ(executor.Commit(std::make_unique<Request>(request)), 0);
+  }
+
+  std::unique_lock<std::mutex> lk(mutex);
+  cv.wait(lk, [&] {
+    return execute_num == txn_num && response_num == txn_num;
+  });
+  EXPECT_EQ(key_seq.size(), key_num);
+  EXPECT_GT(threads.size(), 1);
+}
+
+TEST(TransactionExecutorTest, OutOfOrderWithoutKeyRunsInOrder) {
+  ResDBConfig config = GetResDBConfig();
+  config.SetOutOfOrderWorkerNum(4);
+  EXPECT_EQ(config.GetSnapshot()->config_data->out_of_order_worker_num(), 4);
+
+  const int txn_num = 50;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<uint64_t> seqs;
+  int response_num = 0;
+
+  SystemInfo system_info(config);
+  auto mock_executor = std::make_unique<MockTransactionManager>(true);
+  EXPECT_CALL(*mock_executor, ExecuteBatch)
+      .Times(txn_num)
+      .WillRepeatedly(Invoke([&](const BatchUserRequest& request) {
+        std::unique_lock<std::mutex> lk(mutex);
+        seqs.push_back(request.seq());
+        cv.notify_all();
+        return nullptr;
+      }));
+
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request> request,
+          std::unique_ptr<BatchUserResponse> resp) {
+        std::unique_lock<std::mutex> lk(mutex);
+        response_num++;
+        cv.notify_all();
+      },
+      &system_info, std::move(mock_executor));
+
+  for (int i = 1; i <= txn_num; ++i) {
+    Request request;
+    request.set_seq(i);
+    BatchUserRequest batch_request;
+    // The same key with different payloads.
+    batch_request.add_user_requests()->mutable_request()->set_data(
+        "key:" + std::to_string(i));
+    batch_request.SerializeToString(request.mutable_data());
+    EXPECT_EQ(executor.Commit(std::make_unique<Request>(request)), 0);
+  }
+
+  std::unique_lock<std::mutex> lk(mutex);
+  cv.wait(lk, [&] {
+    return static_cast<int>(seqs.size()) == txn_num &&
+           response_num == txn_num;
+  });
+  for (int i = 0; i < txn_num; ++i) {
+    EXPECT_EQ(seqs[i], i + 1);
+  }
+}
+
+TEST(TransactionExecutorTest, PrepareBeforeCommit) {
+  ResDBConfig config = GetResDBConfig();
+  SystemInfo system_info(config);
+  auto manager = std::make_unique<PrepareTransactionManager>();
+  PrepareTransactionManager* manager_ptr = manager.get();
+
+  std::promise<std::unique_ptr<BatchUserResponse>> done;
+  std::future<std::unique_ptr<BatchUserResponse>> done_future =
+      done.get_future();
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request>, std::unique_ptr<BatchUserResponse> resp) {
+        done.set_value(std::move(resp));
+      },
+      &system_info, std::move(manager));
+
+  executor.Prepare(GetBatchRequest(1, "hash_1", "execute_1"));
+  while (manager_ptr->prefetch_num == 0) {
+    usleep(1000);
+  }
+  EXPECT_EQ(executor.Commit(GetBatchRequest(1, "hash_1", "execute_1")), 0);
+
+  std::unique_ptr<BatchUserResponse> resp = done_future.get();
+  ASSERT_EQ(resp->response_size(), 1);
+  EXPECT_EQ(resp->response(0), "execute_1");
+  EXPECT_EQ(manager_ptr->parse_num, 1);
+  EXPECT_EQ(manager_ptr->prefetch_num, 1);
+}
+
+TEST(TransactionExecutorTest, PrepareWithDifferentHash) {
+  ResDBConfig config = GetResDBConfig();
+  SystemInfo system_info(config);
+  auto manager = std::make_unique<PrepareTransactionManager>();
+  PrepareTransactionManager* manager_ptr = manager.get();
+
+  std::promise<std::unique_ptr<BatchUserResponse>> done;
+  std::future<std::unique_ptr<BatchUserResponse>> done_future =
+      done.get_future();
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request>, std::unique_ptr<BatchUserResponse> resp) {
+        done.set_value(std::move(resp));
+      },
+      &system_info, std::move(manager));
+
+  executor.Prepare(GetBatchRequest(1, "hash_1", "execute_1"));
+  while (manager_ptr->prefetch_num == 0) {
+    usleep(1000);
+  }
+  EXPECT_EQ(executor.Commit(GetBatchRequest(1, "hash_2", "execute_2")), 0);
+
+  std::unique_ptr<BatchUserResponse> resp = done_future.get();
+  ASSERT_EQ(resp->response_size(), 1);
+  EXPECT_EQ(resp->response(0), "execute_2");
+  EXPECT_EQ(manager_ptr->parse_num, 2);
+}
+
+TEST(TransactionExecutorTest, PrepareReplacedByOtherHash) {
+  ResDBConfig config = GetResDBConfig();
+  SystemInfo system_info(config);
+  auto manager = std::make_unique<PrepareTransactionManager>();
+  PrepareTransactionManager* manager_ptr = manager.get();
+
+  std::promise<std::unique_ptr<BatchUserResponse>> done;
+  std::future<std::unique_ptr<BatchUserResponse>> done_future =
+      done.get_future();
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request>, std::unique_ptr<BatchUserResponse> resp) {
+        done.set_value(std::move(resp));
+      },
+      &system_info, std::move(manager));
+
+  // A bogus proposal for the seq comes first.
+  executor.Prepare(GetBatchRequest(1, "hash_bogus", "execute_bogus"));
+  while (manager_ptr->prefetch_num == 0) {
+    usleep(1000);
+  }
+  executor.Prepare(GetBatchRequest(1, "hash_1", "execute_1"));
+  for (int i = 0; i < 1000 && manager_ptr->prefetch_num < 2; ++i) {
+    usleep(1000);
+  }
+  EXPECT_EQ(manager_ptr->prefetch_num, 2);
+  EXPECT_EQ(executor.Commit(GetBatchRequest(1, "hash_1", "execute_1")), 0);
+
+  std::unique_ptr<BatchUserResponse> resp = done_future.get();
+  ASSERT_EQ(resp->response_size(), 1);
+  EXPECT_EQ(resp->response(0), "execute_1");
+  // Executed from the prepared batch, not parsed again.
+  EXPECT_EQ(manager_ptr->parse_num, 2);
+}
+
+TEST(TransactionExecutorTest, InvalidSignatureNotExecuted) {
+  ResDBConfig config = GetResDBConfig();
+  SystemInfo system_info(config);
+  auto manager = std::make_unique<PrepareTransactionManager>();
+  PrepareTransactionManager* manager_ptr = manager.get();
+  MockSignatureVerifier verifier;
+  EXPECT_CALL(verifier, VerifyMessage(_, _)).WillRepeatedly(Return(false));
+
+  std::promise<std::unique_ptr<BatchUserResponse>> done;
+  std::future<std::unique_ptr<BatchUserResponse>> done_future =
+      done.get_future();
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request>, std::unique_ptr<BatchUserResponse> resp) {
+        done.set_value(std::move(resp));
+      },
+      &system_info, std::move(manager));
+  executor.SetSignatureVerifier(&verifier);
+
+  EXPECT_EQ(executor.Commit(GetBatchRequest(1, "hash_1", "execute_1")), 0);
+
+  std::unique_ptr<BatchUserResponse> resp = done_future.get();
+  EXPECT_EQ(resp->response_size(), 0);
+  EXPECT_EQ(resp->seq(), 1);
+  EXPECT_EQ(manager_ptr->execute_num, 0);
+}
+
+TEST(TransactionExecutorTest, ExecuteFromCheckpoint) {
+  ResDBConfig config = GetResDBConfig();
+  // SetConfigData() resets the replicas taken from the config data.
+  SystemInfo system_info(config);
+  ResConfigData config_data = config.GetConfigData();
+  config_data.set_enable_execution_checkpoint(true);
+  config.SetConfigData(config_data);
+
+  MockStorage storage;
+  EXPECT_CALL(storage, EnableCheckpoint).WillOnce(Return(true));
+  EXPECT_CALL(storage, GetCheckpointSeq).WillRepeatedly(Return(10));
+  EXPECT_CALL(storage, Checkpoint(11, "state_hash_11")).WillOnce(Return(true));
+
+  std::promise<std::unique_ptr<BatchUserResponse>> done;
+  std::future<std::unique_ptr<BatchUserResponse>> done_future =
+      done.get_future();
+  TransactionExecutor executor(
+      config,
+      [&](std::unique_ptr<Request>, std::unique_ptr<BatchUserResponse> resp) {
+        done.set_value(std::move(resp));
+      },
+      &system_info, std::make_unique<StorageTransactionManager>(&storage));
+  EXPECT_EQ(executor.GetMaxPendingExecutedSeq(), 10);
+  executor.SetCheckpointStateFunc(
+      [](const Request& request) { return "state_" + request.hash(); });
+
+  EXPECT_EQ(executor.Commit(GetBatchRequest(11, "hash_11", "execute_11")), 0);
+
+  std::unique_ptr<BatchUserResponse> resp = done_future.get();
+  EXPECT_EQ(resp->seq(), 11);
+  EXPECT_EQ(resp->response(0), "execute_11");
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -49,15 +49,24 @@ bool ProtocolBase::IsStop() { return stop_; }
 int ProtocolBase::SendMessage(int msg_type,
                               const google::protobuf::Message& msg,
                               int node_id) {
+  if (channel_ != nullptr) {
+    return channel_->SendMsg(msg_type, msg, node_id);
+  }
   return single_call_(msg_type, msg, node_id);
 }
 
 int ProtocolBase::Broadcast(int msg_type,
                             const google::protobuf::Message& msg) {
+  if (channel_ != nullptr) {
+    return channel_->Broadcast(msg_type, msg);
+  }
   return broadcast_call_(msg_type, msg);
 }
 
 int ProtocolBase::Commit(const google::protobuf::Message& msg) {
+  if (channel_ != nullptr) {
+    return channel_->CommitMsg(msg);
+  }
   return commit_(msg);
 }
 
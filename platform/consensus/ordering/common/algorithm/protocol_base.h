@@ -28,6 +28,19 @@
 namespace resdb {
 namespace common {
 
+// Implemented by the framework hosting the protocol. Protocols holding a
+// channel call it directly instead of going through the std::function
+// callbacks.
+class ProtocolChannel {
+ public:
+  virtual ~ProtocolChannel() = default;
+
+  virtual int SendMsg(int type, const google::protobuf::Message& msg,
+                      int node_id) = 0;
+  virtual int Broadcast(int type, const google::protobuf::Message& msg) = 0;
+  virtual int CommitMsg(const google::protobuf::Message& msg) = 0;
+};
+
 class ProtocolBase {
  public:
   typedef std::function<int(int, const google::protobuf::Message& msg, int)>
@@ -62,6 +75,9 @@ class ProtocolBase {
     verifier_ = verifier;
   }
 
+  // Takes over the callbacks above.
+  inline void SetChannel(ProtocolChannel* channel) { channel_ = channel; }
+
  protected:
   int SendMessage(int msg_type, const google::protobuf::Message& msg,
                   int node_id);
@@ -79,6 +95,7 @@ class ProtocolBase {
   std::function<int(int, const google::protobuf::Message& msg)> broadcast_call_;
   std::function<int(const google::protobuf::Message& msg)> commit_;
   std::atomic<bool> stop_;
+  ProtocolChannel* channel_ = nullptr;
 
   SignatureVerifier* verifier_;
 };
@@ -42,6 +42,10 @@ Consensus::Consensus(const ResDBConfig& config,
             << config_.IsPerformanceRunning();
   is_stop_ = false;
   global_stats_ = Stats::GetGlobalStats();
+  // The requests made up in performance mode are not signed by clients.
+  if (!config_.NotNeedSignature() && !config_.IsPerformanceRunning()) {
+    transaction_executor_->SetSignatureVerifier(GetSignatureVerifier());
+  }
 }
 
 void Consensus::Init() {
@@ -63,18 +67,7 @@ void Consensus::Init() {
 }
 
 void Consensus::InitProtocol(ProtocolBase* protocol) {
-  protocol->SetSingleCallFunc(
-      [&](int type, const google::protobuf::Message& msg, int node_id) {
-        return SendMsg(type, msg, node_id);
-      });
-
-  protocol->SetBroadcastCallFunc(
-      [&](int type, const google::protobuf::Message& msg) {
-        return Broadcast(type, msg);
-      });
-
-  protocol->SetCommitFunc(
-      [&](const google::protobuf::Message& msg) { return CommitMsg(msg); });
+  protocol->SetChannel(this);
 }
 
 Consensus::~Consensus() { is_stop_ = true; }
@@ -96,23 +89,21 @@ void Consensus::SetCommunicator(ReplicaCommunicator* replica_communicator) {
 
 int Consensus::Broadcast(int type, const google::protobuf::Message& msg) {
   Request request;
-  msg.SerializeToString(request.mutable_data());
   request.set_type(Request::TYPE_CUSTOM_CONSENSUS);
   request.set_user_type(type);
   request.set_sender_id(config_.GetSelfInfo().id());
 
-  replica_communicator_->BroadCast(request);
+  replica_communicator_->BroadCastRequest(request, msg);
   return 0;
 }
 
 int Consensus::SendMsg(int type, const google::protobuf::Message& msg,
                        int node_id) {
   Request request;
-  msg.SerializeToString(request.mutable_data());
   request.set_type(Request::TYPE_CUSTOM_CONSENSUS);
   request.set_user_type(type);
   request.set_sender_id(config_.GetSelfInfo().id());
-  replica_communicator_->SendMessage(request, node_id);
+  replica_communicator_->SendRequest(request, msg, node_id);
   return 0;
 }
 
@@ -139,13 +130,29 @@ int Consensus::ConsensusCommit(std::unique_ptr<Context> context,
       return ProcessNewTransaction(std::move(request));
     }
     case Request::TYPE_CUSTOM_CONSENSUS: {
-      return ProcessCustomConsensus(std::move(request));
+      // The sender_id in the request is filled in by the sender; use the
+      // node the signature was verified against when there is one.
+      int sender_id = request->sender_id();
+      if (context != nullptr && context->signature.node_id() > 0) {
+        if (context->signature.node_id() != sender_id) {
+          LOG(ERROR) << "sender:" << sender_id
+                     << " does not match the signature of:"
+                     << context->signature.node_id();
+          return -2;
+        }
+      } else if (GetSignatureVerifier() != nullptr &&
+                 !config_.NotNeedSignature()) {
+        LOG(ERROR) << "unsigned consensus message from:" << sender_id;
+        return -2;
+      }
+      return ProcessCustomConsensus(sender_id, std::move(request));
     }
   }
   return 0;
 }
 
-int Consensus::ProcessCustomConsensus(std::unique_ptr<Request> request) {
+int Consensus::ProcessCustomConsensus(int sender_id,
+                                      std::unique_ptr<Request> request) {
   return 0;
 }
 
@@ -29,7 +29,7 @@
 namespace resdb {
 namespace common {
 
-class Consensus : public ConsensusManager {
+class Consensus : public ConsensusManager, public ProtocolChannel {
  public:
   Consensus(const ResDBConfig& config,
             std::unique_ptr<TransactionManager> transaction_manager);
@@ -46,13 +46,16 @@ class Consensus : public ConsensusManager {
   void InitProtocol(ProtocolBase* protocol);
 
  protected:
-  virtual int ProcessCustomConsensus(std::unique_ptr<Request> request);
+  // sender_id is the replica which signed the message.
+  virtual int ProcessCustomConsensus(int sender_id,
+                                     std::unique_ptr<Request> request);
   virtual int ProcessNewTransaction(std::unique_ptr<Request> request);
-  virtual int CommitMsg(const google::protobuf::Message& msg);
+  int CommitMsg(const google::protobuf::Message& msg) override;
 
  protected:
-  int SendMsg(int type, const google::protobuf::Message& msg, int node_id);
-  int Broadcast(int type, const google::protobuf::Message& msg);
+  int SendMsg(int type, const google::protobuf::Message& msg,
+              int node_id) override;
+  int Broadcast(int type, const google::protobuf::Message& msg) override;
   int ResponseMsg(const BatchUserResponse& batch_resp);
   void AsyncSend();
   bool IsStop();
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <glog/logging.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace resdb {
+namespace common {
+
+// Routes the custom consensus messages of a protocol by their type.
+// Handlers are member functions of Protocol bound at compile time, e.g.
+//   dispatcher.Register<Proposal, &PoE::ReceivePrepare>(MessageType::Prepare);
+// and each message is parsed straight into its concrete type. Handlers get
+// the id of the sender as authenticated by the network layer; ids carried in
+// the message itself are chosen by the sender and must not be trusted.
+template <typename Protocol>
+class MessageDispatcher {
+ public:
+  template <typename Message,
+            bool (Protocol::*Handler)(int, std::unique_ptr<Message>)>
+  void Register(int type) {
+    if (type < 0) {
+      return;
+    }
+    if (static_cast<size_t>(type) >= handlers_.size()) {
+      handlers_.resize(type + 1, nullptr);
+    }
+    handlers_[type] = &Invoke<Message, Handler>;
+  }
+
+  // Returns -1 if the type is not registered or the data can not be parsed.
+  int Dispatch(Protocol* protocol, int type, int sender_id,
+               const std::string& data) const {
+    if (type < 0 || static_cast<size_t>(type) >= handlers_.size() ||
+        handlers_[type] == nullptr) {
+      LOG(ERROR) << "unknown message type:" << type;
+      return -1;
+    }
+    return handlers_[type](protocol, sender_id, data);
+  }
+
+ private:
+  template <typename Message,
+            bool (Protocol::*Handler)(int, std::unique_ptr<Message>)>
+  static int Invoke(Protocol* protocol, int sender_id,
+                    const std::string& data) {
+    std::unique_ptr<Message> message = std::make_unique<Message>();
+    if (!message->ParseFromString(data)) {
+      LOG(ERROR) << "parse message fail";
+      return -1;
+    }
+    (protocol->*Handler)(sender_id, std::move(message));
+    return 0;
+  }
+
+ private:
+  std::vector<int (*)(Protocol*, int, const std::string&)> handlers_;
+};
+
+}  // namespace common
+}  // namespace resdb
@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/consensus/ordering/common/framework/message_dispatcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "platform/proto/resdb.pb.h"
+
+namespace resdb {
+namespace common {
+namespace {
+
+class FakeProtocol {
+ public:
+  bool ReceiveRequest(int sender_id, std::unique_ptr<Request> request) {
+    requests.push_back(request->seq());
+    senders.push_back(sender_id);
+    return true;
+  }
+
+  bool ReceiveCerts(int sender_id, std::unique_ptr<Certs> certs) {
+    certs_num.push_back(certs->committed_certs_size());
+    senders.push_back(sender_id);
+    return true;
+  }
+
+  std::vector<uint64_t> requests;
+  std::vector<int> certs_num;
+  std::vector<int> senders;
+};
+
+TEST(MessageDispatcherTest, DispatchByType) {
+  MessageDispatcher<FakeProtocol> dispatcher;
+  dispatcher.Register<Request, &FakeProtocol::ReceiveRequest>(1);
+  dispatcher.Register<Certs, &FakeProtocol::ReceiveCerts>(3);
+
+  FakeProtocol protocol;
+  Request request;
+  request.set_seq(10);
+  // Not the sender passed in by the network.
+  request.set_sender_id(4);
+  Certs certs;
+  certs.add_committed_certs();
+  certs.add_committed_certs();
+
+  EXPECT_EQ(
+      dispatcher.Dispatch(&protocol, 1, 2, request.SerializeAsString()), 0);
+  EXPECT_EQ(dispatcher.Dispatch(&protocol, 3, 3, certs.SerializeAsString()),
+            0);
+  EXPECT_THAT(protocol.requests, ::testing::ElementsAre(10));
+  EXPECT_THAT(protocol.certs_num, ::testing::ElementsAre(2));
+  EXPECT_THAT(protocol.senders, ::testing::ElementsAre(2, 3));
+}
+
+TEST(MessageDispatcherTest, UnknownType) {
+  MessageDispatcher<FakeProtocol> dispatcher;
+  dispatcher.Register<Request, &FakeProtocol::ReceiveRequest>(1);
+
+  FakeProtocol protocol;
+  EXPECT_EQ(dispatcher.Dispatch(&protocol, 0, 1, ""), -1);
+  EXPECT_EQ(dispatcher.Dispatch(&protocol, 2, 1, ""), -1);
+  EXPECT_EQ(dispatcher.Dispatch(&protocol, -1, 1, ""), -1);
+  EXPECT_EQ(dispatcher.Dispatch(&protocol, 1, 1, "bad data"), -1);
+  EXPECT_TRUE(protocol.requests.empty());
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace resdb
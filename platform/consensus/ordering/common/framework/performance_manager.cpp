@@ -49,6 +49,7 @@ PerformanceManager::PerformanceManager(
   }
   global_stats_ = Stats::GetGlobalStats();
   send_num_ = 0;
+  min_response_num_ = config_.GetMinClientReceiveNum();
   total_num_ = 0;
   replica_num_ = config_.GetReplicaNum();
   id_ = config_.GetSelfInfo().id();
@@ -79,6 +80,10 @@ void PerformanceManager::SetDataFunc(std::function<std::string()> func) {
   data_func_ = std::move(func);
 }
 
+void PerformanceManager::SetMinResponseNum(int num) {
+  min_response_num_ = num;
+}
+
 int PerformanceManager::StartEval() {
   if (eval_started_) {
     return 0;
@@ -154,7 +159,7 @@ CollectorResultCode PerformanceManager::AddResponseMsg(
       return CollectorResultCode::OK;
     }
     response_[idx][seq]++;
-    if (response_[idx][seq] >= config_.GetMinClientReceiveNum()) {
+    if (response_[idx][seq] >= min_response_num_) {
       response_[idx].erase(response_[idx].find(seq));
       done = true;
     }
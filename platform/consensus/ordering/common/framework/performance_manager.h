@@ -44,6 +44,10 @@ class PerformanceManager {
                          std::unique_ptr<Request> request);
   void SetDataFunc(std::function<std::string()> func);
 
+  // Number of matching responses required before a request is done.
+  // Default to ResDBConfig::GetMinClientReceiveNum().
+  void SetMinResponseNum(int num);
+
  protected:
   virtual void SendMessage(const Request& request);
 
@@ -78,6 +82,7 @@ class PerformanceManager {
   std::atomic<int> total_num_;
   SignatureVerifier* verifier_;
   SignatureInfo sig_;
+  int min_response_num_;
   std::function<std::string()> data_func_;
   std::future<bool> eval_ready_future_;
   std::promise<bool> eval_ready_promise_;
@@ -47,6 +47,7 @@ ResponseManager::ResponseManager(const ResDBConfig& config,
   }
   global_stats_ = Stats::GetGlobalStats();
   send_num_ = 0;
+  min_response_num_ = config_.GetMinClientReceiveNum();
 }
 
 ResponseManager::~ResponseManager() {
@@ -59,6 +60,8 @@ ResponseManager::~ResponseManager() {
 // use system info
 int ResponseManager::GetPrimary() { return 1; }
 
+void ResponseManager::SetMinResponseNum(int num) { min_response_num_ = num; }
+
 int ResponseManager::NewUserRequest(std::unique_ptr<Context> context,
                                     std::unique_ptr<Request> user_request) {
   context->client = nullptr;
@@ -119,7 +122,7 @@ CollectorResultCode ResponseManager::AddResponseMsg(
       return CollectorResultCode::OK;
     }
     response_[idx][seq]++;
-    if (response_[idx][seq] >= config_.GetMinClientReceiveNum()) {
+    if (response_[idx][seq] >= min_response_num_) {
       response_[idx][seq] = -1;
       done = true;
     }
@@ -44,6 +44,10 @@ class ResponseManager {
   int ProcessResponseMsg(std::unique_ptr<Context> context,
                          std::unique_ptr<Request> request);
 
+  // Number of matching responses required before a request is done.
+  // Default to ResDBConfig::GetMinClientReceiveNum().
+  void SetMinResponseNum(int num);
+
  private:
   // Add response messages which will be sent back to the caller
   // if there are f+1 same messages.
@@ -70,6 +74,7 @@ class ResponseManager {
   Stats* global_stats_;
   std::atomic<int> send_num_;
   SignatureVerifier* verifier_;
+  int min_response_num_;
   static const int response_set_size_ = 6000000;
   std::map<int64_t, int> response_[response_set_size_];
   std::mutex response_lock_[response_set_size_];
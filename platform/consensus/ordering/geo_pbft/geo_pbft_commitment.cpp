@@ -34,7 +34,8 @@ GeoPBFTCommitment::GeoPBFTCommitment(
       config_(std::move(config)),
       system_info_(std::move(system_info)),
       replica_communicator_(std::move(replica_communicator)),
-      verifier_(verifier) {
+      verifier_(verifier),
+      verify_pool_(std::make_unique<ThreadPool>("geo_verify", 0)) {
   global_stats_ = Stats::GetGlobalStats();
   executed_thread_ =
       std::thread(&GeoPBFTCommitment::PostProcessExecutedMsg, this);
@@ -49,17 +50,22 @@ GeoPBFTCommitment::~GeoPBFTCommitment() {
 
 bool GeoPBFTCommitment::VerifyCerts(const BatchUserRequest& request,
                                     const std::string& raw_data) {
-  if (verifier_) {
-    std::string hash = request.hash();
-    for (const auto& sig : request.committed_certs().committed_certs()) {
-      bool valid = verifier_->VerifyMessage(hash, sig);
-      if (!valid) {
-        LOG(ERROR) << "sign is not valid:" << sig.DebugString();
-        return false;
-      }
-    }
+  if (verifier_ == nullptr) {
+    return true;
   }
-  return true;
+  const std::string& hash = request.hash();
+  const auto& certs = request.committed_certs().committed_certs();
+  std::atomic<bool> valid(true);
+  verify_pool_->ParallelFor(certs.size(), [&](int i) {
+    if (!valid) {
+      return;
+    }
+    if (!verifier_->VerifyMessage(hash, certs[i])) {
+      LOG(ERROR) << "sign is not valid:" << certs[i].DebugString();
+      valid = false;
+    }
+  });
+  return valid;
 }
 
 bool GeoPBFTCommitment::AddNewReq(uint64_t seq, uint32_t sender_region) {
@@ -72,11 +78,39 @@ bool GeoPBFTCommitment::AddNewReq(uint64_t seq, uint32_t sender_region) {
   return ret.second;
 }
 
-void GeoPBFTCommitment::UpdateSeq(uint64_t seq) {
+bool GeoPBFTCommitment::IsNewReq(uint64_t seq, uint32_t sender_region) {
   std::lock_guard<std::mutex> lk(mutex_);
-  if (seq > min_seq_) {
+  if (seq < min_seq_) {
+    return false;
+  }
+  return checklist_[seq % (1 << 20)].count(sender_region) == 0;
+}
+
+void GeoPBFTCommitment::UpdateSeq(uint64_t seq) {
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (seq <= min_seq_) {
+      return;
+    }
     min_seq_ = seq;
   }
+  fragment_collector_.Clear(seq);
+}
+
+int GeoPBFTCommitment::GetReplicaIndex(int region_id, int64_t sender_id) {
+  std::shared_ptr<const ResConfigData> config_data =
+      config_.GetSnapshot()->config_data;
+  for (const auto& region : config_data->region()) {
+    if (region.region_id() != region_id) {
+      continue;
+    }
+    for (int i = 0; i < region.replica_info_size(); ++i) {
+      if (region.replica_info(i).id() == sender_id) {
+        return i;
+      }
+    }
+  }
+  return -1;
 }
 
 int GeoPBFTCommitment::GeoProcessCcm(std::unique_ptr<Context> context,
@@ -91,22 +125,21 @@ int GeoPBFTCommitment::GeoProcessCcm(std::unique_ptr<Context> context,
   }
   // global_stats_->IncGeoRequest();
 
-  BatchUserRequest batch_request;
-  if (!batch_request.ParseFromString(request->data())) {
+  auto batch_request = std::make_unique<BatchUserRequest>();
+  if (!batch_request->ParseFromString(request->data())) {
     LOG(ERROR) << "[GeoGlobalExecutor] parse data fail!";
     return -2;
   }
 
-  if (!batch_request.has_committed_certs() ||
-      !VerifyCerts(batch_request, request->data())) {
+  if (!batch_request->has_committed_certs() ||
+      !VerifyCerts(*batch_request, request->data())) {
     // CheckCertificates
     LOG(ERROR) << "no certs";
     return -2;
   }
   // return global_executor_->OrderGeoRequest(std::move(request));
 
-  ResConfigData config_data = config_.GetConfigData();
-  int self_region_id = config_data.self_region_id();
+  int self_region_id = config_.GetSelfRegionId();
   // LOG(ERROR)<<"get request seq:"<<request->seq()<<" from:"<<sender_region_id;
   // if the request comes from another region, do local broadcast
   if (sender_region_id != self_region_id) {
@@ -117,7 +150,102 @@ int GeoPBFTCommitment::GeoProcessCcm(std::unique_ptr<Context> context,
     // ";
     replica_communicator_->BroadCast(*broadcast_geo_req);
   }
-  return global_executor_->OrderGeoRequest(std::move(request));
+  return global_executor_->OrderGeoRequest(std::move(request),
+                                           std::move(batch_request));
+}
+
+int GeoPBFTCommitment::GeoProcessFragment(std::unique_ptr<Context> context,
+                                          std::unique_ptr<Request> request) {
+  int self_region_id = config_.GetSelfRegionId();
+  bool is_relay = false;
+  if (request->region_info().region_id() == self_region_id) {
+    // Passed on by a local replica, check the signature of the replica from
+    // the other region which sent it.
+    GeoFragmentRelay relay;
+    auto fragment_request = std::make_unique<Request>();
+    if (!relay.ParseFromString(request->data()) ||
+        !fragment_request->ParseFromString(relay.request())) {
+      LOG(ERROR) << "parse fragment relay fail";
+      return -2;
+    }
+    if (verifier_ && !config_.NotNeedSignature() &&
+        !verifier_->VerifyMessage(relay.request(), relay.signature())) {
+      LOG(ERROR) << "fragment relay signature is not valid";
+      return -2;
+    }
+    request = std::move(fragment_request);
+    is_relay = true;
+  }
+
+  GeoFragment fragment;
+  if (!fragment.ParseFromString(request->data())) {
+    LOG(ERROR) << "parse fragment fail";
+    return -2;
+  }
+  int region_id = fragment.region_id();
+  if (region_id == self_region_id ||
+      region_id != request->region_info().region_id() ||
+      GetReplicaIndex(region_id, request->sender_id()) != fragment.index()) {
+    LOG(ERROR) << "invalid fragment from:" << request->sender_id()
+               << " region:" << region_id << " index:" << fragment.index();
+    return -2;
+  }
+  if (!IsNewReq(fragment.seq(), region_id)) {
+    return 1;
+  }
+  if (!is_relay) {
+    // Pass on the bytes that were signed; serializing the parsed request
+    // again is not guaranteed to give the same bytes.
+    GeoFragmentRelay relay;
+    if (!context->signed_data.empty()) {
+      *relay.mutable_request() = std::move(context->signed_data);
+    } else {
+      request->SerializeToString(relay.mutable_request());
+    }
+    *relay.mutable_signature() = context->signature;
+    std::unique_ptr<Request> relay_request =
+        resdb::NewRequest(Request::TYPE_GEO_FRAGMENT, Request(),
+                          config_.GetSelfInfo().id(), self_region_id);
+    relay_request->set_seq(request->seq());
+    relay.SerializeToString(relay_request->mutable_data());
+    replica_communicator_->BroadCast(*relay_request);
+  }
+
+  std::vector<CompactCerts> certs_list;
+  std::unique_ptr<BatchUserRequest> batch_request =
+      fragment_collector_.AddFragment(fragment, &certs_list);
+  if (batch_request == nullptr) {
+    return 0;
+  }
+  // The fragments only carry the certs of their senders, use the first one
+  // which is valid.
+  bool valid = false;
+  for (const CompactCerts& certs : certs_list) {
+    *batch_request->mutable_committed_certs() = FromCompactCerts(certs);
+    if (batch_request->committed_certs().committed_certs_size() > 0 &&
+        VerifyCerts(*batch_request, "")) {
+      valid = true;
+      break;
+    }
+  }
+  if (!valid) {
+    LOG(ERROR) << "no valid certs yet, seq:" << fragment.seq()
+               << " region:" << region_id;
+    return 0;
+  }
+  fragment_collector_.Finish(fragment.seq(), region_id);
+  if (!AddNewReq(fragment.seq(), region_id)) {
+    return 1;
+  }
+
+  std::unique_ptr<Request> geo_request =
+      resdb::NewRequest(Request::TYPE_GEO_REQUEST, Request(),
+                        request->sender_id(), region_id);
+  geo_request->set_seq(fragment.seq());
+  geo_request->set_proxy_id(batch_request->proxy_id());
+  batch_request->SerializeToString(geo_request->mutable_data());
+  return global_executor_->OrderGeoRequest(std::move(geo_request),
+                                           std::move(batch_request));
 }
 
 int GeoPBFTCommitment::PostProcessExecutedMsg() {
@@ -19,7 +19,9 @@
 
 #pragma once
 
+#include "common/utils/thread_pool.h"
 #include "platform/config/resdb_config.h"
+#include "platform/consensus/execution/geo_fragment.h"
 #include "platform/consensus/execution/geo_global_executor.h"
 #include "platform/consensus/execution/system_info.h"
 #include "platform/consensus/ordering/geo_pbft/hash_set.h"
@@ -42,11 +44,20 @@ class GeoPBFTCommitment {
   int GeoProcessCcm(std::unique_ptr<Context> context,
                     std::unique_ptr<Request> request);
 
+  // Collects the erasure coded fragments of the geo requests from other
+  // regions. A fragment received from the other region is passed on to the
+  // local replicas and every replica rebuilds the request itself.
+  int GeoProcessFragment(std::unique_ptr<Context> context,
+                         std::unique_ptr<Request> request);
+
  private:
   bool VerifyCerts(const BatchUserRequest& request,
                    const std::string& raw_data);
 
   bool AddNewReq(uint64_t seq, uint32_t sender_region);
+  bool IsNewReq(uint64_t seq, uint32_t sender_region);
+  // Returns the index of the sender in the replicas of its region.
+  int GetReplicaIndex(int region_id, int64_t sender_id);
   void UpdateSeq(uint64_t seq);
 
   int PostProcessExecutedMsg();
@@ -59,6 +70,9 @@ class GeoPBFTCommitment {
   std::unique_ptr<SystemInfo> system_info_ = nullptr;
   ReplicaCommunicator* replica_communicator_;
   SignatureVerifier* verifier_;
+  // Verifies the certificates of one request in parallel.
+  std::unique_ptr<ThreadPool> verify_pool_;
+  GeoFragmentCollector fragment_collector_;
   Stats* global_stats_;
   std::mutex mutex_;
   std::thread executed_thread_;
@@ -0,0 +1,239 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/consensus/ordering/pbft/catch_up_manager.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "common/crypto/digest.h"
+
+namespace resdb {
+
+struct CatchUpManager::Chunk {
+  uint64_t min_seq;
+  uint64_t max_seq;
+  std::vector<Request> requests;
+  bool ok = false;
+  bool done = false;
+  std::mutex mutex;
+  std::condition_variable cv;
+};
+
+CatchUpManager::CatchUpManager(ResDBTxnAccessor* txn_accessor,
+                               CommitFunc commit_func, int water_mark,
+                               int chunk_size, int fetch_thread_num)
+    : txn_accessor_(txn_accessor),
+      commit_func_(commit_func),
+      water_mark_(water_mark),
+      chunk_size_(chunk_size),
+      fetch_pool_("catch_up", fetch_thread_num),
+      stop_(false) {
+  thread_ = std::thread(&CatchUpManager::Run, this);
+}
+
+CatchUpManager::~CatchUpManager() { Stop(); }
+
+void CatchUpManager::Stop() {
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    stop_ = true;
+    cv_.notify_all();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void CatchUpManager::SetDoneFunc(DoneFunc func) { done_func_ = func; }
+
+uint64_t CatchUpManager::GetCaughtUpSeq() {
+  std::lock_guard<std::mutex> lk(mutex_);
+  return caught_up_seq_;
+}
+
+void CatchUpManager::AddTarget(uint64_t start_seq,
+                               const std::string& start_hash,
+                               uint64_t target_seq,
+                               const std::string& target_hash,
+                               const std::vector<ReplicaInfo>& replicas) {
+  std::lock_guard<std::mutex> lk(mutex_);
+  if (target_seq <= caught_up_seq_ || target_seq <= start_seq) {
+    return;
+  }
+  if (target_ != nullptr && target_->target_seq > target_seq) {
+    return;
+  }
+  target_ = std::make_unique<Target>(
+      Target{start_seq, start_hash, target_seq, target_hash, replicas});
+  cv_.notify_all();
+}
+
+void CatchUpManager::Run() {
+  while (!stop_) {
+    std::unique_ptr<Target> target;
+    {
+      std::unique_lock<std::mutex> lk(mutex_);
+      cv_.wait_for(lk, std::chrono::seconds(1),
+                   [&] { return target_ != nullptr || stop_; });
+      target = std::move(target_);
+    }
+    if (target == nullptr) {
+      continue;
+    }
+    CatchUp(*target);
+  }
+}
+
+bool CatchUpManager::CatchUp(const Target& target) {
+  uint64_t seq = target.start_seq;
+  std::string hash = target.start_hash;
+  {
+    // Continue from the requests committed by the last catch-up, which may
+    // not have been executed yet.
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (caught_up_seq_ > seq) {
+      seq = caught_up_seq_;
+      hash = caught_up_hash_;
+    }
+  }
+  if (seq >= target.target_seq || target.replicas.empty()) {
+    return false;
+  }
+
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  for (uint64_t min_seq = seq + 1; min_seq <= target.target_seq;
+       min_seq += chunk_size_) {
+    auto chunk = std::make_unique<Chunk>();
+    chunk->min_seq = min_seq;
+    chunk->max_seq = std::min(min_seq + chunk_size_ - 1, target.target_seq);
+    chunks.push_back(std::move(chunk));
+  }
+  // Spread the chunks over the replicas. A chunk that fails is fetched from
+  // the next replica.
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    Chunk* chunk = chunks[i].get();
+    fetch_pool_.Submit([this, chunk, &target, i]() {
+      FetchChunk(chunk, target.replicas, i % target.replicas.size());
+    });
+  }
+
+  // Digest the windows in order while the later chunks are still being
+  // fetched. Every chunk has to be waited for as the fetching threads refer
+  // to them.
+  bool valid = true;
+  std::vector<std::string> window;
+  window.reserve(water_mark_);
+  for (auto& chunk : chunks) {
+    {
+      std::unique_lock<std::mutex> lk(chunk->mutex);
+      chunk->cv.wait(lk, [&] { return chunk->done; });
+    }
+    if (!valid) {
+      continue;
+    }
+    if (!chunk->ok) {
+      LOG(ERROR) << "fetch requests fail:" << chunk->min_seq << " "
+                 << chunk->max_seq;
+      valid = false;
+      continue;
+    }
+    for (const Request& request : chunk->requests) {
+      window.push_back(request.hash());
+      if (static_cast<int>(window.size()) == water_mark_) {
+        hash = digest_.GetDigest(hash, window);
+        window.clear();
+      }
+    }
+  }
+  if (!valid) {
+    return false;
+  }
+  if (!window.empty()) {
+    hash = digest_.GetDigest(hash, window);
+  }
+  if (hash != target.target_hash) {
+    LOG(ERROR) << "The hash of requests returned do not match. " << seq + 1
+               << " " << target.target_seq;
+    return false;
+  }
+
+  for (auto& chunk : chunks) {
+    for (Request& request : chunk->requests) {
+      commit_func_(std::make_unique<Request>(std::move(request)));
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    caught_up_seq_ = target.target_seq;
+    caught_up_hash_ = hash;
+  }
+  if (done_func_) {
+    done_func_(target.target_seq);
+  }
+  return true;
+}
+
+void CatchUpManager::FetchChunk(Chunk* chunk,
+                                const std::vector<ReplicaInfo>& replicas,
+                                int first_replica) {
+  for (size_t i = 0; i < replicas.size() && !stop_ && !chunk->ok; ++i) {
+    const ReplicaInfo& replica =
+        replicas[(first_replica + i) % replicas.size()];
+    auto requests = txn_accessor_->GetRequestFromReplica(
+        chunk->min_seq, chunk->max_seq, replica);
+    if (!requests.ok()) {
+      continue;
+    }
+    if (requests->size() != chunk->max_seq - chunk->min_seq + 1) {
+      LOG(ERROR) << "requests from replica:" << replica.id()
+                 << " are not complete:" << requests->size();
+      continue;
+    }
+    // The idle workers help hashing when there are fewer chunks than them.
+    std::vector<std::string_view> data;
+    data.reserve(requests->size());
+    for (const Request& request : *requests) {
+      data.push_back(request.data());
+    }
+    std::vector<Digest> digests;
+    CalculateSHA256Batch(data, &digests, &fetch_pool_);
+    bool ok = true;
+    for (size_t j = 0; j < requests->size() && ok; ++j) {
+      const Request& request = (*requests)[j];
+      if (request.seq() != chunk->min_seq + j ||
+          !digests[j].Equals(request.hash())) {
+        LOG(ERROR) << "The hash of the request does not match the data. "
+                   << "replica:" << replica.id() << " seq:" << request.seq();
+        ok = false;
+      }
+    }
+    if (ok) {
+      chunk->requests = std::move(*requests);
+      chunk->ok = true;
+    }
+  }
+
+  std::lock_guard<std::mutex> lk(chunk->mutex);
+  chunk->done = true;
+  chunk->cv.notify_all();
+}
+
+}  // namespace resdb
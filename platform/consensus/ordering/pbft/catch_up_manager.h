@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "common/utils/thread_pool.h"
+#include "platform/consensus/checkpoint/checkpoint_digest.h"
+#include "interface/common/resdb_txn_accessor.h"
+#include "platform/config/resdb_config.h"
+#include "platform/proto/resdb.pb.h"
+
+namespace resdb {
+
+// CatchUpManager fetches the committed requests a replica is missing from
+// the replicas that voted for a checkpoint. The range is split into chunks
+// fetched from several replicas in parallel. Each request is checked against
+// its hash on the fetching thread, and the checkpoint digest of each window
+// is computed in order as the chunks arrive. Once the digest matches the
+// checkpoint hash, the requests are passed to the commit function. All of it
+// runs on its own threads, so the caller only posts the target and returns.
+class CatchUpManager {
+ public:
+  typedef std::function<void(std::unique_ptr<Request>)> CommitFunc;
+  typedef std::function<void(uint64_t seq)> DoneFunc;
+
+  // water_mark is the number of requests of a checkpoint window.
+  CatchUpManager(ResDBTxnAccessor* txn_accessor, CommitFunc commit_func,
+                 int water_mark, int chunk_size = 1000,
+                 int fetch_thread_num = 4);
+  ~CatchUpManager();
+
+  void Stop();
+
+  // Called after the requests up to seq have been committed.
+  void SetDoneFunc(DoneFunc func);
+
+  // Catch up from the checkpoint at start_seq, whose digest is start_hash,
+  // to the checkpoint at target_seq whose digest is target_hash. A newer
+  // target replaces the one that has not been started yet.
+  void AddTarget(uint64_t start_seq, const std::string& start_hash,
+                 uint64_t target_seq, const std::string& target_hash,
+                 const std::vector<ReplicaInfo>& replicas);
+
+  // The highest seq that has been committed by the catch-up.
+  uint64_t GetCaughtUpSeq();
+
+ private:
+  struct Target {
+    uint64_t start_seq;
+    std::string start_hash;
+    uint64_t target_seq;
+    std::string target_hash;
+    std::vector<ReplicaInfo> replicas;
+  };
+  struct Chunk;
+
+  void Run();
+  bool CatchUp(const Target& target);
+  void FetchChunk(Chunk* chunk, const std::vector<ReplicaInfo>& replicas,
+                  int first_replica);
+
+ private:
+  ResDBTxnAccessor* txn_accessor_;
+  CommitFunc commit_func_;
+  DoneFunc done_func_;
+  int water_mark_;
+  int chunk_size_;
+  CheckPointDigest digest_;
+  ThreadPool fetch_pool_;
+  std::thread thread_;
+  std::atomic<bool> stop_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unique_ptr<Target> target_;
+  uint64_t caught_up_seq_ = 0;
+  std::string caught_up_hash_;
+};
+
+}  // namespace resdb
@@ -0,0 +1,172 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/consensus/ordering/pbft/catch_up_manager.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include "common/crypto/digest.h"
+#include "interface/common/mock_resdb_txn_accessor.h"
+
+namespace resdb {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Test;
+
+class CatchUpManagerTest : public Test {
+ public:
+  CatchUpManagerTest()
+      : config_({ReplicaInfo()}, ReplicaInfo()), accessor_(config_) {
+    for (int i = 1; i <= 1000; ++i) {
+      Request request;
+      request.set_seq(i);
+      request.set_data("data_" + std::to_string(i));
+      request.set_hash(CalculateSHA256(request.data()).ToString());
+      requests_.push_back(request);
+    }
+    for (int i = 2; i <= 4; ++i) {
+      ReplicaInfo replica;
+      replica.set_id(i);
+      replicas_.push_back(replica);
+    }
+    // Replica 3 returns requests whose data do not match their hash.
+    EXPECT_CALL(accessor_, GetRequestFromReplica(_, _, _))
+        .WillRepeatedly(Invoke([&](uint64_t min_seq, uint64_t max_seq,
+                                  const ReplicaInfo& replica) {
+          std::lock_guard<std::mutex> lk(mutex_);
+          min_seqs_.push_back(min_seq);
+          std::vector<Request> requests(requests_.begin() + min_seq - 1,
+                                        requests_.begin() + max_seq);
+          if (replica.id() == 3) {
+            requests[0].set_data("fake");
+          }
+          return requests;
+        }));
+  }
+
+  // The digest of the checkpoint at seq, with windows of 100 requests.
+  std::string GetHash(uint64_t seq) {
+    CheckPointDigest digest;
+    std::string hash;
+    std::vector<std::string> window;
+    for (uint64_t i = 0; i < seq; ++i) {
+      window.push_back(requests_[i].hash());
+      if (window.size() == 100 || i + 1 == seq) {
+        hash = digest.GetDigest(hash, window);
+        window.clear();
+      }
+    }
+    return hash;
+  }
+
+ protected:
+  ResDBConfig config_;
+  MockResDBTxnAccessor accessor_;
+  std::vector<Request> requests_;
+  std::vector<ReplicaInfo> replicas_;
+  std::mutex mutex_;
+  std::vector<uint64_t> min_seqs_;
+};
+
+TEST_F(CatchUpManagerTest, CatchUpFromReplicas) {
+  std::vector<uint64_t> seqs;
+  std::promise<uint64_t> done;
+  std::future<uint64_t> done_future = done.get_future();
+  CatchUpManager manager(
+      &accessor_,
+      [&](std::unique_ptr<Request> request) { seqs.push_back(request->seq()); },
+      /*water_mark=*/100, /*chunk_size=*/100);
+  manager.SetDoneFunc([&](uint64_t seq) { done.set_value(seq); });
+
+  manager.AddTarget(0, "", 1000, GetHash(1000), replicas_);
+
+  EXPECT_EQ(done_future.get(), 1000);
+  ASSERT_EQ(seqs.size(), 1000);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(seqs[i], i + 1);
+  }
+  EXPECT_EQ(manager.GetCaughtUpSeq(), 1000);
+}
+
+TEST_F(CatchUpManagerTest, HashNotMatch) {
+  std::atomic<int> commit_num = 0;
+  std::promise<uint64_t> done;
+  std::future<uint64_t> done_future = done.get_future();
+  CatchUpManager manager(
+      &accessor_, [&](std::unique_ptr<Request> request) { commit_num++; },
+      /*water_mark=*/100, /*chunk_size=*/100);
+  manager.SetDoneFunc([&](uint64_t seq) { done.set_value(seq); });
+
+  manager.AddTarget(0, "", 500, GetHash(499), replicas_);
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lk(mutex_);
+      if (min_seqs_.size() >= 5) {
+        break;
+      }
+    }
+    usleep(1000);
+  }
+  EXPECT_EQ(commit_num, 0);
+
+  // Try again with the right hash.
+  manager.AddTarget(0, "", 500, GetHash(500), replicas_);
+  EXPECT_EQ(done_future.get(), 500);
+  EXPECT_EQ(commit_num, 500);
+}
+
+TEST_F(CatchUpManagerTest, ContinueFromLastCatchUp) {
+  std::atomic<int> commit_num = 0;
+  std::promise<bool> done;
+  std::future<bool> done_future = done.get_future();
+  CatchUpManager manager(
+      &accessor_, [&](std::unique_ptr<Request> request) { commit_num++; },
+      /*water_mark=*/100, /*chunk_size=*/100);
+  manager.SetDoneFunc([&](uint64_t seq) {
+    if (seq == 1000) {
+      done.set_value(true);
+    }
+  });
+
+  manager.AddTarget(0, "", 500, GetHash(500), replicas_);
+  while (manager.GetCaughtUpSeq() < 500) {
+    usleep(1000);
+  }
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    min_seqs_.clear();
+  }
+  // The requests up to 500 have not been executed yet.
+  manager.AddTarget(0, "", 1000, GetHash(1000), replicas_);
+  done_future.get();
+  EXPECT_EQ(commit_num, 1000);
+  std::lock_guard<std::mutex> lk(mutex_);
+  for (uint64_t min_seq : min_seqs_) {
+    EXPECT_GT(min_seq, 500);
+  }
+}
+
+}  // namespace
+
+}  // namespace resdb
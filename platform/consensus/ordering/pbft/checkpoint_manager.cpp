@@ -37,10 +37,28 @@ CheckPointManager::CheckPointManager(const ResDBConfig& config,
       txn_accessor_(config),
       highest_prepared_seq_(0) {
   current_stable_seq_ = 0;
-  if (config_.GetConfigData().enable_viewchange()) {
+  if (config_.IsViewChangeEnabled()) {
     config_.EnableCheckPoint(true);
   }
   if (config_.IsCheckPointEnabled()) {
+    catch_up_manager_ = std::make_unique<CatchUpManager>(
+        &txn_accessor_,
+        [&](std::unique_ptr<Request> request) {
+          {
+            // The requests after the last checkpoint may have been
+            // committed already.
+            std::lock_guard<std::mutex> lk(lt_mutex_);
+            if (request->seq() <= last_seq_) {
+              return;
+            }
+          }
+          if (executor_) {
+            executor_->Commit(std::move(request));
+          }
+        },
+        config_.GetCheckPointWaterMark());
+    catch_up_manager_->SetDoneFunc(
+        [&](uint64_t seq) { SetHighestPreparedSeq(seq); });
     stable_checkpoint_thread_ =
         std::thread(&CheckPointManager::UpdateStableCheckPointStatus, this);
     checkpoint_thread_ =
@@ -59,10 +77,88 @@ void CheckPointManager::Stop() {
   if (stable_checkpoint_thread_.joinable()) {
     stable_checkpoint_thread_.join();
   }
+  if (catch_up_manager_) {
+    catch_up_manager_->Stop();
+  }
+}
+
+void CheckPointManager::SetExecutor(TransactionExecutor* executor) {
+  executor_ = executor;
+  {
+    std::lock_guard<std::mutex> lk(lt_mutex_);
+    last_seq_ = executor->GetMaxPendingExecutedSeq();
+  }
+  if (config_.IsCheckPointEnabled()) {
+    RestoreLedgerState(executor->GetCheckpointStates());
+    executor->SetCheckpointStateFunc(
+        [this](const Request& request) { return GetLedgerState(request); });
+  }
 }
 
-std::string GetHash(const std::string& h1, const std::string& h2) {
-  return SignatureVerifier::CalculateHash(h1 + h2);
+std::string CheckPointManager::GetLedgerState(const Request& request) {
+  LedgerState state;
+  {
+    std::lock_guard<std::mutex> lk(lt_mutex_);
+    state.set_last_ckpt_seq(last_ckpt_seq_);
+    state.set_last_hash(last_hash_);
+  }
+  state.set_hash(request.hash());
+  // The state of this request carries the new digest, so the states of the
+  // requests it covers go with the same write.
+  if (state.last_ckpt_seq() > dropped_ckpt_seq_) {
+    executor_->DropCheckpointStates(state.last_ckpt_seq());
+    dropped_ckpt_seq_ = state.last_ckpt_seq();
+  }
+  std::string state_str;
+  state.SerializeToString(&state_str);
+  return state_str;
+}
+
+void CheckPointManager::RestoreLedgerState(
+    const std::vector<std::pair<uint64_t, std::string>>& states) {
+  if (states.empty()) {
+    return;
+  }
+  LedgerState last_state;
+  if (!last_state.ParseFromString(states.back().second)) {
+    LOG(ERROR) << "parse ledger state fail, seq:" << states.back().first;
+    return;
+  }
+  int water_mark = config_.GetCheckPointWaterMark();
+  uint64_t seq = last_state.last_ckpt_seq();
+  uint64_t ckpt_seq = seq;
+  std::string hash = last_state.last_hash();
+  std::vector<std::string> window_hashes;
+  for (const auto& [state_seq, state_str] : states) {
+    if (state_seq <= last_state.last_ckpt_seq()) {
+      continue;
+    }
+    LedgerState state;
+    if (state_seq != seq + 1 || !state.ParseFromString(state_str)) {
+      LOG(ERROR) << "ledger state missing after:" << seq;
+      return;
+    }
+    seq++;
+    window_hashes.push_back(state.hash());
+    if (seq % water_mark == 0) {
+      hash = digest_.GetDigest(hash, window_hashes);
+      window_hashes.clear();
+      ckpt_seq = seq;
+    }
+  }
+
+  std::lock_guard<std::mutex> lk(lt_mutex_);
+  if (seq != last_seq_) {
+    LOG(ERROR) << "ledger state ends at:" << seq
+               << " but the execution checkpoint is:" << last_seq_;
+    return;
+  }
+  last_ckpt_seq_ = ckpt_seq;
+  last_hash_ = hash;
+  restored_window_hashes_ = std::move(window_hashes);
+  dropped_ckpt_seq_ = last_state.last_ckpt_seq();
+  LOG(ERROR) << "restore ledger digest at:" << last_ckpt_seq_
+             << " window size:" << restored_window_hashes_.size();
 }
 
 ChainState* CheckPointManager::GetTxnDB() { return txn_db_.get(); }
@@ -164,7 +260,6 @@ bool CheckPointManager::Wait() {
 }
 
 void CheckPointManager::UpdateStableCheckPointStatus() {
-  uint64_t last_committable_seq = 0;
   while (!stop_) {
     if (!Wait()) {
       continue;
@@ -181,56 +276,29 @@ void CheckPointManager::UpdateStableCheckPointStatus() {
           std::set<uint32_t> senders_ =
               sender_ckpt_[std::make_pair(committable_seq_, committable_hash_)];
           sem_post(&committable_seq_signal_);
-          if (last_seq_ < committable_seq_ &&
-              last_committable_seq < committable_seq_) {
-            auto replicas_ = config_.GetReplicaInfos();
-            for (auto& replica_ : replicas_) {
-              std::string last_hash;
-              uint64_t last_seq;
-              {
-                std::lock_guard<std::mutex> lk(lt_mutex_);
-                last_hash = last_hash_;
-                // last_seq_ = last_seq > last_committable_seq ? last_seq :
-                // last_committable_seq;
-                last_seq = last_seq_;
-              }
-              if (senders_.count(replica_.id()) &&
-                  last_seq < committable_seq_) {
-                // LOG(ERROR) << "GetRequestFromReplica " << last_seq_ + 1 << "
-                // " << committable_seq_;
-                auto requests = txn_accessor_.GetRequestFromReplica(
-                    last_seq + 1, committable_seq_, replica_);
-                if (requests.ok()) {
-                  bool fail = false;
-                  for (auto& request : *requests) {
-                    if (SignatureVerifier::CalculateHash(request.data()) !=
-                        request.hash()) {
-                      LOG(ERROR)
-                          << "The hash of the request does not match the data.";
-                      fail = true;
-                      break;
-                    }
-                    last_hash = GetHash(last_hash, request.hash());
-                  }
-                  if (fail) {
-                    continue;
-                  } else if (last_hash != committable_hash_) {
-                    LOG(ERROR) << "The hash of requests returned do not match. "
-                               << last_seq + 1 << " " << committable_seq_;
-                  } else {
-                    last_committable_seq = committable_seq_;
-                    for (auto& request : *requests) {
-                      if (executor_) {
-                        executor_->Commit(std::make_unique<Request>(request));
-                      }
-                    }
-                    SetHighestPreparedSeq(committable_seq_);
-                    // LOG(ERROR) << "[4]";
-                    break;
-                  }
-                }
+          std::string last_hash;
+          uint64_t last_seq, last_ckpt_seq;
+          {
+            std::lock_guard<std::mutex> lk(lt_mutex_);
+            last_hash = last_hash_;
+            last_seq = last_seq_;
+            last_ckpt_seq = last_ckpt_seq_;
+          }
+          if (last_seq < committable_seq_) {
+            // Fetch the missing requests in the background so that the
+            // checkpoint votes are not blocked by the network.
+            std::vector<ReplicaInfo> replicas;
+            for (const auto& replica : config_.GetReplicaInfos()) {
+              if (senders_.count(replica.id()) &&
+                  replica.id() != config_.GetSelfInfo().id()) {
+                replicas.push_back(replica);
               }
             }
+            // The digest is only known at a checkpoint, so the catch-up
+            // starts from the last one.
+            catch_up_manager_->AddTarget(last_ckpt_seq, last_hash,
+                                         committable_seq_, committable_hash_,
+                                         replicas);
           }
         }
         if (it.second.size() >=
@@ -288,11 +356,12 @@ void CheckPointManager::TimeoutHandler() {
 }
 
 void CheckPointManager::UpdateCheckPointStatus() {
-  uint64_t last_ckpt_seq = 0;
   int water_mark = config_.GetCheckPointWaterMark();
   int timeout_ms = config_.GetViewchangeCommitTimeout();
   std::vector<std::string> stable_hashs;
   std::vector<uint64_t> stable_seqs;
+  std::vector<std::string> window_hashes;
+  window_hashes.reserve(water_mark);
   while (!stop_) {
     auto request = data_queue_.Pop(timeout_ms);
     if (request == nullptr) {
@@ -309,17 +378,28 @@ void CheckPointManager::UpdateCheckPointStatus() {
     }
     {
       std::lock_guard<std::mutex> lk(lt_mutex_);
-      last_hash_ = GetHash(last_hash_, request->hash());
+      if (!restored_window_hashes_.empty()) {
+        window_hashes = std::move(restored_window_hashes_);
+        restored_window_hashes_.clear();
+      }
       last_seq_++;
     }
+    window_hashes.push_back(request->hash());
     bool is_recovery = request->is_recovery();
     txn_db_->Put(std::move(request));
 
-    if (current_seq == last_ckpt_seq + water_mark) {
-      last_ckpt_seq = current_seq;
+    // The windows are aligned to the water mark, also when the ledger
+    // starts from an execution checkpoint.
+    if (current_seq % water_mark == 0) {
+      std::string hash = digest_.GetDigest(last_hash_, window_hashes);
+      window_hashes.clear();
+      {
+        std::lock_guard<std::mutex> lk(lt_mutex_);
+        last_hash_ = hash;
+        last_ckpt_seq_ = current_seq;
+      }
       if (!is_recovery) {
-        BroadcastCheckPoint(last_ckpt_seq, last_hash_, stable_hashs,
-                            stable_seqs);
+        BroadcastCheckPoint(current_seq, hash, stable_hashs, stable_seqs);
       }
     }
   }
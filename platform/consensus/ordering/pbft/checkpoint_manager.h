@@ -23,10 +23,12 @@
 
 #include "chain/state/chain_state.h"
 #include "common/crypto/signature_verifier.h"
-#include "interface/common/resdb_txn_accessor.h"
+#include "interface/common/async_txn_accessor.h"
 #include "platform/config/resdb_config.h"
 #include "platform/consensus/checkpoint/checkpoint.h"
+#include "platform/consensus/checkpoint/checkpoint_digest.h"
 #include "platform/consensus/execution/transaction_executor.h"
+#include "platform/consensus/ordering/pbft/catch_up_manager.h"
 #include "platform/networkstrate/replica_communicator.h"
 #include "platform/networkstrate/server_comm.h"
 #include "platform/proto/checkpoint_info.pb.h"
@@ -63,7 +65,8 @@ class CheckPointManager : public CheckPoint {
   void WaitSignal();
   std::unique_ptr<std::pair<uint64_t, std::string>> PopStableSeqHash();
 
-  void SetExecutor(TransactionExecutor* executor) { executor_ = executor; }
+  // The ledger continues from the requests the executor has executed.
+  void SetExecutor(TransactionExecutor* executor);
 
   uint64_t GetHighestPreparedSeq();
 
@@ -83,6 +86,13 @@ class CheckPointManager : public CheckPoint {
   void Notify();
   bool Wait();
 
+  // The digest chain after request, written with its execution checkpoint.
+  // Called on the executor thread in the order of execution.
+  std::string GetLedgerState(const Request& request);
+  // Continue the digest chain from the states of the execution checkpoints.
+  void RestoreLedgerState(
+      const std::vector<std::pair<uint64_t, std::string>>& states);
+
  protected:
   ResDBConfig config_;
   ReplicaCommunicator* replica_communicator_;
@@ -105,14 +115,23 @@ class CheckPointManager : public CheckPoint {
   int new_data_ = 0;
   LockFreeQueue<std::pair<uint64_t, std::string>> stable_hash_queue_;
   std::condition_variable signal_;
-  ResDBTxnAccessor txn_accessor_;
+  AsyncResDBTxnAccessor txn_accessor_;
   std::mutex lt_mutex_;
   uint64_t last_seq_ = 0;
   TransactionExecutor* executor_;
   std::atomic<uint64_t> highest_prepared_seq_;
   uint64_t committable_seq_ = 0;
+  // The digest of the checkpoint at last_ckpt_seq_.
+  uint64_t last_ckpt_seq_ = 0;
   std::string last_hash_, committable_hash_;
+  // The hashes of the partial window restored from an execution checkpoint.
+  std::vector<std::string> restored_window_hashes_;
+  // The execution checkpoint states up to it have been dropped. Only used on
+  // the executor thread.
+  uint64_t dropped_ckpt_seq_ = 0;
+  CheckPointDigest digest_;
   sem_t committable_seq_signal_;
+  std::unique_ptr<CatchUpManager> catch_up_manager_;
 };
 
 }  // namespace resdb
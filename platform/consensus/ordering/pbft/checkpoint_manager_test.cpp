@@ -25,9 +25,11 @@
 
 #include <future>
 
+#include "chain/storage/mock_storage.h"
 #include "common/crypto/mock_signature_verifier.h"
 #include "common/test/test_macros.h"
 #include "platform/config/resdb_config_utils.h"
+#include "platform/consensus/execution/system_info.h"
 #include "platform/consensus/ordering/pbft/transaction_utils.h"
 #include "platform/networkstrate/mock_replica_communicator.h"
 #include "platform/proto/checkpoint_info.pb.h"
@@ -59,6 +61,15 @@ class MyCheckPointManager : public CheckPointManager {
   std::function<void(int64_t)> call_back_;
 };
 
+class StorageTransactionManager : public TransactionManager {
+ public:
+  StorageTransactionManager(Storage* storage) : storage_(storage) {}
+  Storage* GetStorage() override { return storage_; }
+
+ private:
+  Storage* storage_;
+};
+
 ResConfigData GetConfigData() {
   Stats::GetGlobalStats(/*int sleep_seconds = */ 1);
   std::string json =
@@ -283,6 +294,144 @@ TEST_F(CheckPointManagerTest, Votes) {
   EXPECT_EQ(ckpt.signatures_size(), 3);
 }
 
+TEST_F(CheckPointManagerTest, ContinueDigestFromExecutionCheckpoint) {
+  ResConfigData config_data = config_.GetConfigData();
+  config_data.set_enable_execution_checkpoint(true);
+  config_.SetConfigData(config_data);
+  config_.SetViewchangeCommitTimeout(100);
+
+  // Executed up to 7 before the restart, the ledger digest is at 5. The
+  // states up to 5 have been dropped.
+  std::vector<std::pair<uint64_t, std::string>> restored_states;
+  for (int i = 6; i <= 7; ++i) {
+    LedgerState state;
+    state.set_last_ckpt_seq(5);
+    state.set_last_hash("hash_5");
+    state.set_hash("hash_" + std::to_string(i));
+    restored_states.emplace_back(i, state.SerializeAsString());
+  }
+
+  MockStorage storage;
+  std::map<uint64_t, LedgerState> states;
+  EXPECT_CALL(storage, EnableCheckpoint).WillOnce(Return(true));
+  EXPECT_CALL(storage, GetCheckpointSeq).WillRepeatedly(Return(7));
+  EXPECT_CALL(storage, GetCheckpointStates).WillOnce(Return(restored_states));
+  EXPECT_CALL(storage, Checkpoint)
+      .WillRepeatedly(Invoke([&](uint64_t seq, const std::string& state_str) {
+        EXPECT_TRUE(states[seq].ParseFromString(state_str));
+        return true;
+      }));
+  EXPECT_CALL(storage, DropCheckpointStates).Times(0);
+
+  std::promise<CheckPointData> checkpoint;
+  std::future<CheckPointData> checkpoint_future = checkpoint.get_future();
+  EXPECT_CALL(replica_communicator_, BroadCast)
+      .WillOnce(Invoke([&](const google::protobuf::Message& message) {
+        CheckPointData checkpoint_data;
+        EXPECT_TRUE(checkpoint_data.ParseFromString(
+            dynamic_cast<const Request&>(message).data()));
+        checkpoint.set_value(checkpoint_data);
+      }));
+
+  CheckPointManager manager(config_, &replica_communicator_, nullptr);
+  SystemInfo system_info(config_);
+  TransactionExecutor executor(
+      config_,
+      [&](std::unique_ptr<Request> request,
+          std::unique_ptr<BatchUserResponse> resp) {
+        manager.AddCommitData(std::move(request));
+      },
+      &system_info, std::make_unique<StorageTransactionManager>(&storage));
+  manager.SetExecutor(&executor);
+
+  for (int i = 8; i <= 10; ++i) {
+    std::unique_ptr<Request> request = std::make_unique<Request>();
+    request->set_seq(i);
+    request->set_hash("hash_" + std::to_string(i));
+    BatchUserRequest().SerializeToString(request->mutable_data());
+    executor.Commit(std::move(request));
+  }
+
+  CheckPointData checkpoint_data = checkpoint_future.get();
+  EXPECT_EQ(checkpoint_data.seq(), 10);
+  EXPECT_EQ(checkpoint_data.hash(),
+            CheckPointDigest().GetDigest(
+                "hash_5", {"hash_6", "hash_7", "hash_8", "hash_9", "hash_10"}));
+
+  executor.Stop();
+  // Each state only adds the hash of its request.
+  ASSERT_EQ(states.count(8), 1);
+  EXPECT_EQ(states[8].last_ckpt_seq(), 5);
+  EXPECT_EQ(states[8].last_hash(), "hash_5");
+  EXPECT_EQ(states[8].hash(), "hash_8");
+}
+
+TEST_F(CheckPointManagerTest, DropLedgerStatesOfDigestedWindow) {
+  ResConfigData config_data = config_.GetConfigData();
+  config_data.set_enable_execution_checkpoint(true);
+  config_.SetConfigData(config_data);
+  config_.SetViewchangeCommitTimeout(100);
+
+  MockStorage storage;
+  std::map<uint64_t, LedgerState> states;
+  EXPECT_CALL(storage, EnableCheckpoint).WillOnce(Return(true));
+  EXPECT_CALL(storage, GetCheckpointSeq).WillRepeatedly(Return(0));
+  EXPECT_CALL(storage, GetCheckpointStates)
+      .WillOnce(Return(std::vector<std::pair<uint64_t, std::string>>()));
+  EXPECT_CALL(storage, Checkpoint)
+      .WillRepeatedly(Invoke([&](uint64_t seq, const std::string& state_str) {
+        EXPECT_TRUE(states[seq].ParseFromString(state_str));
+        return true;
+      }));
+
+  std::promise<bool> checkpoint;
+  std::future<bool> checkpoint_future = checkpoint.get_future();
+  EXPECT_CALL(replica_communicator_, BroadCast)
+      .WillOnce(Invoke([&](const google::protobuf::Message& message) {
+        checkpoint.set_value(true);
+      }));
+
+  std::promise<bool> executed;
+  std::future<bool> executed_future = executed.get_future();
+  CheckPointManager manager(config_, &replica_communicator_, nullptr);
+  SystemInfo system_info(config_);
+  TransactionExecutor executor(
+      config_,
+      [&](std::unique_ptr<Request> request,
+          std::unique_ptr<BatchUserResponse> resp) {
+        if (request->seq() == 6) {
+          executed.set_value(true);
+        }
+        manager.AddCommitData(std::move(request));
+      },
+      &system_info, std::make_unique<StorageTransactionManager>(&storage));
+  manager.SetExecutor(&executor);
+
+  auto commit = [&](int seq) {
+    std::unique_ptr<Request> request = std::make_unique<Request>();
+    request->set_seq(seq);
+    request->set_hash("hash_" + std::to_string(seq));
+    BatchUserRequest().SerializeToString(request->mutable_data());
+    executor.Commit(std::move(request));
+  };
+  for (int i = 1; i <= 5; ++i) {
+    commit(i);
+  }
+  checkpoint_future.get();
+
+  // The first state carrying the digest at 5 drops the states it covers.
+  EXPECT_CALL(storage, DropCheckpointStates(5)).Times(1);
+  commit(6);
+  executed_future.get();
+  executor.Stop();
+  ASSERT_EQ(states.count(6), 1);
+  EXPECT_EQ(states[6].last_ckpt_seq(), 5);
+  EXPECT_EQ(states[6].last_hash(),
+            CheckPointDigest().GetDigest(
+                "", {"hash_1", "hash_2", "hash_3", "hash_4", "hash_5"}));
+  EXPECT_EQ(states[6].hash(), "hash_6");
+}
+
 /*
 TEST_F(CheckPointManagerTest, SetTimeoutHandler) {
   CheckPointManager manager(config_, &replica_communicator_, nullptr);
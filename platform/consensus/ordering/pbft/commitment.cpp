@@ -22,6 +22,7 @@
 #include <glog/logging.h>
 #include <unistd.h>
 
+#include "common/crypto/digest.h"
 #include "common/utils/utils.h"
 #include "platform/consensus/ordering/pbft/transaction_utils.h"
 
@@ -96,12 +97,10 @@ int Commitment::ProcessNewRequest(std::unique_ptr<Context> context, std::unique_
     return -3;
   }
 
-  /*
-  if(SignatureVerifier::CalculateHash(user_request->data()) !=
-  user_request->hash()){ LOG(ERROR) << "the hash and data of the user request
-  don't match, reject"; return -2;
+  if (!CalculateSHA256(user_request->data()).Equals(user_request->hash())) {
+    LOG(ERROR) << "the hash and data of the user request don't match, reject";
+    return -2;
   }
-  */
 
   // check signatures
   bool valid = verifier_->VerifyMessage(user_request->data(),
@@ -199,15 +198,14 @@ int Commitment::ProcessProposeMsg(std::unique_ptr<Context> context, std::unique_
     return -2;
   }
 
-  /*
-    if(request->hash() != "null" + std::to_string(request->seq())
-        && SignatureVerifier::CalculateHash(request->data()) != request->hash())
-    { LOG(ERROR) << "the hash and data of the request don't match, reject";
+  if (request->sender_id() != config_.GetSelfInfo().id()) {
+    // The primary checked its own proposals as new requests. The requests
+    // filling the holes of a new view carry no data.
+    if (request->hash() != "null" + std::to_string(request->seq()) &&
+        !CalculateSHA256(request->data()).Equals(request->hash())) {
+      LOG(ERROR) << "the hash and data of the request don't match, reject";
       return -2;
     }
-    */
-
-  if (request->sender_id() != config_.GetSelfInfo().id()) {
     if (pre_verify_func_ && !pre_verify_func_(*request)) {
       LOG(ERROR) << " check by the user func fail";
       return -2;
@@ -239,6 +237,9 @@ int Commitment::ProcessProposeMsg(std::unique_ptr<Context> context, std::unique_
       Request::TYPE_PREPARE, *request, config_.GetSelfInfo().id());
   prepare_request->clear_data();
 
+  // Parse and prefetch the transactions while waiting for the commit.
+  message_manager_->PrepareExecution(*request);
+
   // Add request to message_manager.
   // Changed for project 3
   CollectorResultCode ret = message_manager_->AddConsensusMsg(context->signature, std::move(request));
@@ -25,6 +25,7 @@
 
 #include <future>
 
+#include "common/crypto/digest.h"
 #include "common/crypto/mock_signature_verifier.h"
 #include "common/test/test_macros.h"
 #include "interface/rdbc/mock_net_channel.h"
@@ -83,6 +84,7 @@ class CommitmentTest : public Test {
     request.set_need_response(need_resp);
     request.set_proxy_id(proxy_id);
     request.set_data(data_);
+    request.set_hash(CalculateSHA256(data_).ToString());
 
     return commitment_->ProcessProposeMsg(std::move(context),
                                           std::make_unique<Request>(request));
@@ -157,6 +159,7 @@ TEST_F(CommitmentTest, NewRequest) {
   context->signature.set_signature("signature");
   Request request;
   request.set_data("data");
+  request.set_hash(CalculateSHA256(request.data()).ToString());
 
   std::promise<bool> propose_done;
   std::future<bool> propose_done_future = propose_done.get_future();
@@ -193,7 +196,7 @@ TEST_F(CommitmentTest, SeqConsumeAll) {
     context->signature.set_signature("signature");
     Request request;
     request.set_data("sig" + std::to_string(i));
-    request.set_hash("hash" + std::to_string(i));
+    request.set_hash(CalculateSHA256(request.data()).ToString());
     if (i < 2) {
       EXPECT_EQ(commitment_->ProcessNewRequest(
                     std::move(context), std::make_unique<Request>(request)),
@@ -226,6 +229,25 @@ TEST_F(CommitmentTest, ProposeMsg) {
   EXPECT_EQ(AddProposeMsg(Request::TYPE_PRE_PREPARE, 1), 0);
 }
 
+TEST_F(CommitmentTest, ProposeMsgHashMismatch) {
+  system_info_.SetPrimary(3);
+  EXPECT_CALL(replica_communicator_, BroadCast).Times(0);
+  EXPECT_CALL(verifier_, VerifyMessage).Times(0);
+
+  auto context = std::make_unique<Context>();
+  context->signature.set_signature("signature");
+  Request request;
+  request.set_current_view(1);
+  request.set_seq(1);
+  request.set_type(Request::TYPE_PRE_PREPARE);
+  request.set_sender_id(3);
+  request.set_data("data");
+  request.set_hash(CalculateSHA256("other data").ToString());
+  EXPECT_EQ(commitment_->ProcessProposeMsg(std::move(context),
+                                           std::make_unique<Request>(request)),
+            -2);
+}
+
 TEST_F(CommitmentTest, ProposeMsgOnlyBCOnce) {
   system_info_.SetPrimary(3);
   BatchUserRequest request;
@@ -23,6 +23,7 @@
 #include <unistd.h>
 
 #include "common/crypto/signature_verifier.h"
+#include "common/utils/utils.h"
 
 namespace resdb {
 
@@ -62,7 +63,31 @@ ConsensusManagerPBFT::ConsensusManagerPBFT(
   global_stats_ = Stats::GetGlobalStats();
 
   view_change_manager_->SetDuplicateManager(commitment_->GetDuplicateManager());
+  // The requests made up in performance mode are not signed by clients.
+  if (!config_.NotNeedSignature() && !config_.IsPerformanceRunning()) {
+    message_manager_->SetSignatureVerifier(GetSignatureVerifier());
+  }
+  SetRecovering(true);
+  view_change_manager_->SetRecovering(true);
+}
+
+ConsensusManagerPBFT::~ConsensusManagerPBFT() {
+  if (recovery_thread_.joinable()) {
+    recovery_thread_.join();
+  }
+}
+
+void ConsensusManagerPBFT::SetNeedCommitQC(bool need_qc) {
+  commitment_->SetNeedCommitQC(need_qc);
+}
+
+void ConsensusManagerPBFT::Start() {
+  ConsensusManager::Start();
+  recovery_thread_ = std::thread(&ConsensusManagerPBFT::Recover, this);
+}
 
+void ConsensusManagerPBFT::Recover() {
+  uint64_t start_time = GetCurrentTime();
   recovery_->ReadLogs(
       [&](const SystemInfoData& data) {
         system_info_->SetCurrentView(data.view());
@@ -71,13 +96,52 @@ ConsensusManagerPBFT::ConsensusManagerPBFT(
       [&](std::unique_ptr<Context> context, std::unique_ptr<Request> request) {
         return InternalConsensusCommit(std::move(context), std::move(request));
       });
-}
+  LOG(ERROR) << "read logs done, time:" << GetCurrentTime() - start_time
+             << "us";
 
-void ConsensusManagerPBFT::SetNeedCommitQC(bool need_qc) {
-  commitment_->SetNeedCommitQC(need_qc);
+  // Process the requests received during the recovery in their order, then
+  // let the new ones through.
+  while (true) {
+    std::queue<std::pair<std::unique_ptr<Context>, std::unique_ptr<Request>>>
+        requests;
+    {
+      std::lock_guard<std::mutex> lk(recovering_mutex_);
+      if (request_recovering_.empty()) {
+        SetRecovering(false);
+        view_change_manager_->SetRecovering(false);
+        break;
+      }
+      requests.swap(request_recovering_);
+    }
+    LOG(ERROR) << "process requests received during recovery:"
+               << requests.size();
+    while (!requests.empty()) {
+      ProcessConsensusCommit(std::move(requests.front().first),
+                             std::move(requests.front().second));
+      requests.pop();
+    }
+  }
+  LOG(ERROR) << "recovery done, time:" << GetCurrentTime() - start_time
+             << "us";
 }
 
-void ConsensusManagerPBFT::Start() { ConsensusManager::Start(); }
+bool ConsensusManagerPBFT::AddRecoveringRequest(
+    std::unique_ptr<Context>* context, std::unique_ptr<Request>* request) {
+  std::lock_guard<std::mutex> lk(recovering_mutex_);
+  if (!IsRecovering()) {
+    return false;
+  }
+  if (request_recovering_.size() >= kMaxRecoveringRequests) {
+    request_recovering_.pop();
+    if (dropped_recovering_num_++ % kMaxRecoveringRequests == 0) {
+      LOG(ERROR) << "too many requests received during recovery, dropped:"
+                 << dropped_recovering_num_;
+    }
+  }
+  request_recovering_.push(
+      std::make_pair(std::move(*context), std::move(*request)));
+  return true;
+}
 
 std::vector<ReplicaInfo> ConsensusManagerPBFT::GetReplicas() {
   return message_manager_->GetReplicas();
@@ -135,16 +199,24 @@ ConsensusManagerPBFT::PopComplainedRequest() {
   return new_request;
 }
 
-// The implementation of PBFT.
 int ConsensusManagerPBFT::ConsensusCommit(std::unique_ptr<Context> context,
                                           std::unique_ptr<Request> request) {
+  if (IsRecovering() && AddRecoveringRequest(&context, &request)) {
+    return 0;
+  }
+  return ProcessConsensusCommit(std::move(context), std::move(request));
+}
+
+// The implementation of PBFT.
+int ConsensusManagerPBFT::ProcessConsensusCommit(
+    std::unique_ptr<Context> context, std::unique_ptr<Request> request) {
   // LOG(INFO) << "recv impl type:" << request->type() << " "
   //          << "sender id:" << request->sender_id();
   // If it is in viewchange, push the request to the queue
   // for the requests from the new view which come before
   // the local new view done.
   recovery_->AddRequest(context.get(), request.get());
-  if (config_.GetConfigData().enable_viewchange()) {
+  if (config_.IsViewChangeEnabled()) {
     view_change_manager_->MayStart();
     if (view_change_manager_->IsInViewChange()) {
       // If we are in viewchange, then we can add this new txn to the queue
@@ -173,7 +245,7 @@ int ConsensusManagerPBFT::ConsensusCommit(std::unique_ptr<Context> context,
   }
   // Now, we have that the queue is empty, we start moving these things to internal commit
   int ret = InternalConsensusCommit(std::move(context), std::move(request));
-  if (config_.GetConfigData().enable_viewchange()) {
+  if (config_.IsViewChangeEnabled()) {
     if (ret == -4) {
       while (true) {
         auto new_request = PopComplainedRequest();
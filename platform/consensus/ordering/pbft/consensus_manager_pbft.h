@@ -38,7 +38,7 @@ class ConsensusManagerPBFT : public ConsensusManager {
   ConsensusManagerPBFT(const ResDBConfig& config,
                        std::unique_ptr<TransactionManager> executor,
                        std::unique_ptr<CustomQuery> query_executor = nullptr);
-  virtual ~ConsensusManagerPBFT() = default;
+  virtual ~ConsensusManagerPBFT();
 
   int ConsensusCommit(std::unique_ptr<Context> context,
                       std::unique_ptr<Request> request) override;
@@ -49,6 +49,8 @@ class ConsensusManagerPBFT : public ConsensusManager {
 
   void SetPrimary(uint32_t primary, uint64_t version) override;
 
+  // Starts the network side and recovers from the logs in the background.
+  // The messages received meanwhile are processed once it is done.
   void Start() override;
   void SetupPerformanceDataFunc(std::function<std::string()> func);
 
@@ -67,6 +69,14 @@ class ConsensusManagerPBFT : public ConsensusManager {
   absl::StatusOr<std::pair<std::unique_ptr<Context>, std::unique_ptr<Request>>>
   PopComplainedRequest();
 
+ private:
+  void Recover();
+  // Holds the request if the replica is still recovering.
+  bool AddRecoveringRequest(std::unique_ptr<Context>* context,
+                            std::unique_ptr<Request>* request);
+  int ProcessConsensusCommit(std::unique_ptr<Context> context,
+                             std::unique_ptr<Request> request);
+
  protected:
   std::unique_ptr<SystemInfo> system_info_;
   std::unique_ptr<CheckPointManager> checkpoint_manager_;
@@ -83,6 +93,16 @@ class ConsensusManagerPBFT : public ConsensusManager {
   std::queue<std::pair<std::unique_ptr<Context>, std::unique_ptr<Request>>>
       request_complained_;
   std::mutex mutex_;
+
+ private:
+  std::thread recovery_thread_;
+  std::queue<std::pair<std::unique_ptr<Context>, std::unique_ptr<Request>>>
+      request_recovering_;
+  std::mutex recovering_mutex_;
+  // Once full, the oldest held requests are dropped. The replica catches up
+  // on them through the checkpoints.
+  static constexpr size_t kMaxRecoveringRequests = 100000;
+  uint64_t dropped_recovering_num_ = 0;
 };
 
 }  // namespace resdb
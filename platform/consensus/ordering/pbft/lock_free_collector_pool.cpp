@@ -35,7 +35,8 @@ uint32_t GetCapacity(uint32_t size) {
 LockFreeCollectorPool::LockFreeCollectorPool(const std::string& name,
                                              uint32_t size,
                                              TransactionExecutor* executor,
-                                             bool enable_viewchange)
+                                             bool enable_viewchange,
+                                             uint64_t start_seq)
     : name_(name),
       capacity_(GetCapacity(size * 2)),
       mask_((capacity_ << 1) - 1),
@@ -43,7 +44,8 @@ LockFreeCollectorPool::LockFreeCollectorPool(const std::string& name,
       enable_viewchange_(enable_viewchange) {
   collector_.resize(capacity_ << 1);
   for (size_t i = 0; i < (capacity_ << 1); ++i) {
-    collector_[i] = std::make_unique<TransactionCollector>(i, executor_,
+    uint64_t seq = start_seq + ((i - start_seq) & mask_);
+    collector_[i] = std::make_unique<TransactionCollector>(seq, executor_,
                                                            enable_viewchange_);
   }
   LOG(ERROR) << "name:" << name_ << " create pool done. capacity:" << capacity_
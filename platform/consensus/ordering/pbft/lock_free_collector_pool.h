@@ -27,9 +27,11 @@ namespace resdb {
 
 class LockFreeCollectorPool {
  public:
+  // The collectors start from start_seq.
   LockFreeCollectorPool(const std::string& name, uint32_t size,
                         TransactionExecutor* executor,
-                        bool enable_viewchange = false);
+                        bool enable_viewchange = false,
+                        uint64_t start_seq = 0);
 
   TransactionCollector* GetCollector(uint64_t seq);
   void Update(uint64_t seq);
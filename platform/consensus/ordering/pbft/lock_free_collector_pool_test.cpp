@@ -59,6 +59,17 @@ TEST_F(CollectorPoolTest, AddRequest) {
   EXPECT_EQ(AddRequest(&pool, 16), 0);
 }
 
+TEST_F(CollectorPoolTest, AddRequestFromStartSeq) {
+  LockFreeCollectorPool pool("test", 2, nullptr, false, 21);
+  for (int i = 21; i < 37; ++i) {
+    int ret = AddRequest(&pool, i);
+    EXPECT_EQ(ret, 0);
+  }
+  EXPECT_EQ(AddRequest(&pool, 37), -2);
+  pool.Update(29);
+  EXPECT_EQ(AddRequest(&pool, 37), 0);
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -59,8 +59,12 @@ MessageManager::MessageManager(
           system_info_, std::move(transaction_manager))),
       collector_pool_(std::make_unique<LockFreeCollectorPool>(
           "txn", config_.GetMaxProcessTxn(), transaction_executor_.get(),
-          config_.GetConfigData().enable_viewchange())) {
+          config_.IsViewChangeEnabled(),
+          transaction_executor_->GetMaxPendingExecutedSeq() + 1)) {
   global_stats_ = Stats::GetGlobalStats();
+  // The requests up to the execution checkpoint have been executed before
+  // a restart.
+  next_seq_ = transaction_executor_->GetMaxPendingExecutedSeq() + 1;
   transaction_executor_->SetSeqUpdateNotifyFunc(
       [&](uint64_t seq) { collector_pool_->Update(seq - 1); });
   checkpoint_manager_->SetExecutor(transaction_executor_.get());
@@ -253,6 +257,19 @@ bool MessageManager::MayConsensusChangeStatus(
 // The commit messages only include post(pre-prepare), prepare and commit
 // messages. Messages are handled by state (PREPARE,COMMIT,READY_EXECUTE).
 
+void MessageManager::PrepareExecution(const Request& request) {
+  std::unique_ptr<Request> prepare_request = std::make_unique<Request>();
+  prepare_request->set_data(request.data());
+  prepare_request->set_seq(request.seq());
+  prepare_request->set_hash(request.hash());
+  prepare_request->set_proxy_id(request.proxy_id());
+  transaction_executor_->Prepare(std::move(prepare_request));
+}
+
+void MessageManager::SetSignatureVerifier(SignatureVerifier* verifier) {
+  transaction_executor_->SetSignatureVerifier(verifier);
+}
+
 // If there are enough messages and the state is changed after adding the
 // message, return 1, otherwise return 0. Return -2 if the request is not valid.
 CollectorResultCode MessageManager::AddConsensusMsg(
@@ -276,6 +293,10 @@ CollectorResultCode MessageManager::AddConsensusMsg(
       });
   if (ret == 1) {
     SetLastCommittedTime(proxy_id);
+    std::lock_guard<std::mutex> lk(committed_callback_mutex_);
+    if (committed_callback_) {
+      committed_callback_(proxy_id);
+    }
   } else if (ret != 0) {
     return CollectorResultCode::INVALID;
   }
@@ -338,6 +359,12 @@ uint64_t MessageManager::GetLastCommittedTime(uint64_t proxy_id) {
   return value;
 }
 
+void MessageManager::SetCommittedCallback(
+    std::function<void(uint64_t)> callback) {
+  std::lock_guard<std::mutex> lk(committed_callback_mutex_);
+  committed_callback_ = std::move(callback);
+}
+
 bool MessageManager::IsPreapared(uint64_t seq) {
   return collector_pool_->GetCollector(seq)->IsPrepared();
 }
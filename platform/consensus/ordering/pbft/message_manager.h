@@ -21,12 +21,14 @@
 
 #include <stdint.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <queue>
 #include <set>
 
 #include "chain/state/chain_state.h"
+#include "common/crypto/signature_verifier.h"
 #include "executor/common/transaction_manager.h"
 #include "platform/common/queue/lock_free_queue.h"
 #include "platform/config/resdb_config.h"
@@ -66,6 +68,11 @@ class MessageManager {
   CollectorResultCode AddConsensusMsg(const SignatureInfo& signature,
                                       std::unique_ptr<Request> request);
 
+  // Start pre-executing a proposed request while it is being agreed on.
+  void PrepareExecution(const Request& request);
+  // Check the client signatures of the batches before executing them.
+  void SetSignatureVerifier(SignatureVerifier* verifier);
+
   // Obtain the request that has been executed from Executor.
   // The messages that have been executed from Executor will save inside
   // Message Manager. Consensus Service can obtain the message then send back
@@ -100,6 +107,9 @@ class MessageManager {
 
   uint64_t GetLastCommittedTime(uint64_t proxy_id);
 
+  // Called with the proxy id each time a request of that proxy commits.
+  void SetCommittedCallback(std::function<void(uint64_t)> callback);
+
   bool IsPreapared(uint64_t seq);
 
   uint64_t GetHighestPreparedSeq();
@@ -150,6 +160,9 @@ class MessageManager {
 
   std::mutex lct_lock_;
   std::map<uint64_t, uint64_t> last_committed_time_;
+
+  std::mutex committed_callback_mutex_;
+  std::function<void(uint64_t)> committed_callback_;
 };
 
 }  // namespace resdb
@@ -25,23 +25,6 @@
 
 namespace resdb {
 
-PerformanceClientTimeout::PerformanceClientTimeout(std::string hash_,
-                                                   uint64_t time_) {
-  this->hash = hash_;
-  this->timeout_time = time_;
-}
-
-PerformanceClientTimeout::PerformanceClientTimeout(
-    const PerformanceClientTimeout& other) {
-  this->hash = other.hash;
-  this->timeout_time = other.timeout_time;
-}
-
-bool PerformanceClientTimeout::operator<(
-    const PerformanceClientTimeout& other) const {
-  return timeout_time > other.timeout_time;
-}
-
 PerformanceManager::PerformanceManager(
     const ResDBConfig& config, ReplicaCommunicator* replica_communicator,
     SystemInfo* system_info, SignatureVerifier* verifier)
@@ -68,8 +51,9 @@ PerformanceManager::PerformanceManager(
     }
   }
 
-  checking_timeout_thread_ =
-      std::thread(&PerformanceManager::MonitoringClientTimeOut, this);
+  if (config_.IsViewChangeEnabled()) {
+    timer_wheel_ = TimerWheel::GetGlobalTimerWheel();
+  }
   global_stats_ = Stats::GetGlobalStats();
   for (size_t i = 0; i <= config_.GetReplicaNum(); i++) {
     send_num_.push_back(0);
@@ -85,8 +69,16 @@ PerformanceManager::~PerformanceManager() {
       user_req_thread_[i].join();
     }
   }
-  if (checking_timeout_thread_.joinable()) {
-    checking_timeout_thread_.join();
+  // Make sure no timer refers to the waiting requests once they are gone.
+  std::vector<TimerWheel::TimerId> timer_ids;
+  {
+    std::lock_guard<std::mutex> lk(pm_lock_);
+    for (const auto& it : waiting_response_batches_) {
+      timer_ids.push_back(it.second.timer_id);
+    }
+  }
+  for (TimerWheel::TimerId id : timer_ids) {
+    timer_wheel_->Cancel(id);
   }
 }
 
@@ -351,69 +343,51 @@ int PerformanceManager::DoBatch(
 
 void PerformanceManager::AddWaitingResponseRequest(
     std::unique_ptr<Request> request) {
-  if (!config_.GetConfigData().enable_viewchange()) {
+  if (!config_.IsViewChangeEnabled()) {
     return;
   }
-  pm_lock_.lock();
-  uint64_t time = GetCurrentTime() + this->timeout_length_;
-  client_timeout_min_heap_.push(
-      PerformanceClientTimeout(request->hash(), time));
-  waiting_response_batches_.insert(
-      make_pair(request->hash(), std::move(request)));
-  pm_lock_.unlock();
-  sem_post(&request_sent_signal_);
+  const Request* request_ptr = request.get();
+  std::lock_guard<std::mutex> lk(pm_lock_);
+  WaitingResponse& waiting = waiting_response_batches_[request->hash()];
+  if (waiting.request != nullptr) {
+    return;
+  }
+  waiting.request = std::move(request);
+  waiting.timer_id = timer_wheel_->Add(
+      timeout_length_, [this, request_ptr]() { ClientTimeOut(request_ptr); });
 }
 
-void PerformanceManager::RemoveWaitingResponseRequest(std::string hash) {
-  if (!config_.GetConfigData().enable_viewchange()) {
+void PerformanceManager::RemoveWaitingResponseRequest(const std::string& hash) {
+  if (!config_.IsViewChangeEnabled()) {
     return;
   }
-  pm_lock_.lock();
-  if (waiting_response_batches_.find(hash) != waiting_response_batches_.end()) {
-    waiting_response_batches_.erase(waiting_response_batches_.find(hash));
+  WaitingResponse waiting;
+  {
+    std::lock_guard<std::mutex> lk(pm_lock_);
+    auto it = waiting_response_batches_.find(hash);
+    if (it == waiting_response_batches_.end()) {
+      return;
+    }
+    waiting = std::move(it->second);
+    waiting_response_batches_.erase(it);
   }
-  pm_lock_.unlock();
-}
-
-bool PerformanceManager::CheckTimeOut(std::string hash) {
-  pm_lock_.lock();
-  bool value =
-      (waiting_response_batches_.find(hash) != waiting_response_batches_.end());
-  pm_lock_.unlock();
-  return value;
+  // The request is released after its timer is cancelled or has finished.
+  timer_wheel_->Cancel(waiting.timer_id);
 }
 
-std::unique_ptr<Request> PerformanceManager::GetTimeOutRequest(
-    std::string hash) {
-  pm_lock_.lock();
-  auto value = std::move(waiting_response_batches_.find(hash)->second);
-  pm_lock_.unlock();
-  return value;
-}
-
-void PerformanceManager::MonitoringClientTimeOut() {
-  while (!stop_) {
-    sem_wait(&request_sent_signal_);
-    pm_lock_.lock();
-    if (client_timeout_min_heap_.empty()) {
-      pm_lock_.unlock();
-      continue;
-    }
-    auto client_timeout = client_timeout_min_heap_.top();
-    client_timeout_min_heap_.pop();
-    pm_lock_.unlock();
-
-    if (client_timeout.timeout_time > GetCurrentTime()) {
-      usleep(client_timeout.timeout_time - GetCurrentTime());
-    }
-
-    if (CheckTimeOut(client_timeout.hash)) {
-      auto request = GetTimeOutRequest(client_timeout.hash);
-      if (request) {
-        replica_communicator_->BroadCast(*request);
-      }
+void PerformanceManager::ClientTimeOut(const Request* request) {
+  std::unique_ptr<Request> timeout_request;
+  {
+    std::lock_guard<std::mutex> lk(pm_lock_);
+    auto it = waiting_response_batches_.find(request->hash());
+    if (it == waiting_response_batches_.end() ||
+        it->second.request.get() != request) {
+      return;
     }
+    timeout_request = std::move(it->second.request);
+    waiting_response_batches_.erase(it);
   }
+  replica_communicator_->BroadCast(*timeout_request);
 }
 
 }  // namespace resdb
@@ -24,6 +24,7 @@
 #include <future>
 #include <queue>
 
+#include "common/utils/timer_wheel.h"
 #include "platform/config/resdb_config.h"
 #include "platform/consensus/ordering/pbft/lock_free_collector_pool.h"
 #include "platform/consensus/ordering/pbft/transaction_utils.h"
@@ -32,16 +33,6 @@
 
 namespace resdb {
 
-class PerformanceClientTimeout {
- public:
-  PerformanceClientTimeout(std::string hash_, uint64_t time_);
-  PerformanceClientTimeout(const PerformanceClientTimeout& other);
-  bool operator<(const PerformanceClientTimeout& other) const;
-
-  std::string hash;
-  uint64_t timeout_time;
-};
-
 class PerformanceManager {
  public:
   PerformanceManager(const ResDBConfig& config,
@@ -78,11 +69,9 @@ class PerformanceManager {
   std::unique_ptr<Request> GenerateUserRequest();
 
   void AddWaitingResponseRequest(std::unique_ptr<Request> request);
-  void RemoveWaitingResponseRequest(std::string hash);
-  bool CheckTimeOut(std::string hash);
-  void ResponseTimer(std::string hash);
-  void MonitoringClientTimeOut();
-  std::unique_ptr<Request> GetTimeOutRequest(std::string hash);
+  void RemoveWaitingResponseRequest(const std::string& hash);
+  // Broadcast the request if it is still waiting for the responses.
+  void ClientTimeOut(const Request* request);
 
  private:
   ResDBConfig config_;
@@ -105,12 +94,14 @@ class PerformanceManager {
   std::atomic<bool> eval_started_;
   std::atomic<int> fail_num_;
 
-  std::thread checking_timeout_thread_;
-  std::map<std::string, std::unique_ptr<Request>> waiting_response_batches_;
-  std::priority_queue<PerformanceClientTimeout> client_timeout_min_heap_;
+  struct WaitingResponse {
+    std::unique_ptr<Request> request;
+    TimerWheel::TimerId timer_id = 0;
+  };
+  TimerWheel* timer_wheel_ = nullptr;
+  std::map<std::string, WaitingResponse> waiting_response_batches_;
   std::mutex pm_lock_;
   uint64_t timeout_length_;
-  sem_t request_sent_signal_;
   uint64_t highest_seq_;
   uint64_t highest_seq_primary_id_;
 };
@@ -20,6 +20,9 @@
 #include "platform/consensus/ordering/pbft/query.h"
 
 #include <glog/logging.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <string.h>
 #include <unistd.h>
 
 namespace resdb {
@@ -28,9 +31,15 @@ Query::Query(const ResDBConfig& config, MessageManager* message_manager,
              std::unique_ptr<CustomQuery> executor)
     : config_(config),
       message_manager_(message_manager),
-      custom_query_executor_(std::move(executor)) {}
+      custom_query_executor_(std::move(executor)),
+      txn_cache_(kTxnCacheSize),
+      keep_alive_pool_(
+          std::make_unique<ThreadPool>("query_keep_alive", kKeepAliveThreads)) {}
 
-Query::~Query() {}
+Query::~Query() {
+  stop_ = true;
+  keep_alive_pool_.reset();
+}
 
 int Query::ProcessGetReplicaState(std::unique_ptr<Context> context,
                                   std::unique_ptr<Request> request) {
@@ -54,36 +63,7 @@ int Query::ProcessQuery(std::unique_ptr<Context> context,
           .public_key()
           .public_key_info()
           .type() == CertificateKeyInfo::CLIENT) {
-    auto find_primary = [&]() {
-      auto config_data = config_.GetConfigData();
-      for (const auto& r : config_data.region()) {
-        for (const auto& replica : r.replica_info()) {
-          if (replica.id() == 1) {
-            return replica;
-          }
-        }
-      }
-    };
-    ReplicaInfo primary = find_primary();
-    std::string ip = primary.ip();
-    int port = primary.port();
-
-    LOG(ERROR) << "redirect to primary:" << ip << " port:" << port;
-    auto client = std::make_unique<NetChannel>(ip, port);
-    if (client->SendRawMessage(*request) == 0) {
-      QueryResponse resp;
-      if (client->RecvRawMessage(&resp) == 0) {
-        if (context != nullptr && context->client != nullptr) {
-          LOG(ERROR) << "send response from primary:"
-                     << resp.transactions_size();
-          int ret = context->client->SendRawMessage(resp);
-          if (ret) {
-            LOG(ERROR) << "send resp fail ret:" << ret;
-          }
-        }
-      }
-    }
-    return 0;
+    return ForwardQuery(std::move(context), std::move(request));
   }
 
   QueryRequest query;
@@ -91,29 +71,189 @@ int Query::ProcessQuery(std::unique_ptr<Context> context,
     LOG(ERROR) << "parse data fail";
     return -2;
   }
+  if (context == nullptr || context->client == nullptr) {
+    return 0;
+  }
+
+  int ret = SendQueryResponse(context->client.get(), query);
+  if (ret != 0 || !query.keep_alive()) {
+    return 0;
+  }
+  if (keep_alive_num_++ >= kKeepAliveThreads) {
+    keep_alive_num_--;
+    return 0;
+  }
+  std::shared_ptr<Context> keep_alive_context = std::move(context);
+  keep_alive_pool_->Submit([this, keep_alive_context]() {
+    ServeKeepAlive(keep_alive_context->client.get());
+    keep_alive_num_--;
+  });
+  return 0;
+}
+
+void Query::ServeKeepAlive(NetChannel* client) {
+  client->SetRecvTimeout(kKeepAliveTimeoutUs);
+  Request request;
+  QueryRequest query;
+  while (!stop_) {
+    std::string request_str;
+    if (client->RecvRawMessageStr(&request_str) != 0 ||
+        !request.ParseFromString(request_str) ||
+        request.type() != Request::TYPE_QUERY ||
+        !query.ParseFromString(request.data())) {
+      break;
+    }
+    if (SendQueryResponse(client, query) != 0) {
+      break;
+    }
+  }
+}
 
-  QueryResponse response;
+int Query::SendQueryResponse(NetChannel* client, const QueryRequest& query) {
+  int ret = 0;
   if (query.max_seq() == 0 && query.min_seq() == 0) {
+    QueryResponse response;
     uint64_t mseq = message_manager_->GetNextSeq();
     response.set_max_seq(mseq - 1);
     LOG(ERROR) << "get max seq:" << mseq;
+    ret = client->SendRawMessage(response);
   } else {
-    for (uint64_t i = query.min_seq(); i <= query.max_seq(); ++i) {
-      Request* ret_request = message_manager_->GetRequest(i);
-      if (ret_request == nullptr) {
-        break;
-      }
-      Request* txn = response.add_transactions();
-      txn->set_data(ret_request->data());
-      txn->set_hash(ret_request->hash());
-      txn->set_seq(ret_request->seq());
-      txn->set_proxy_id(ret_request->proxy_id());
+    ret = client->SendRawMessageData(GetQueryPage(query));
+  }
+  if (ret) {
+    LOG(ERROR) << "send resp fail ret:" << ret;
+  }
+  return ret;
+}
+
+std::string Query::GetQueryPage(const QueryRequest& query) {
+  using google::protobuf::internal::WireFormatLite;
+  using google::protobuf::io::CodedOutputStream;
+
+  uint64_t max_bytes = kMaxPageBytes;
+  if (query.max_bytes() > 0 && query.max_bytes() < max_bytes) {
+    max_bytes = query.max_bytes();
+  }
+  std::vector<std::shared_ptr<const std::string>> txns;
+  size_t txns_size = 0;
+  uint64_t next_seq = 0;
+  for (uint64_t seq = query.min_seq(); seq <= query.max_seq(); ++seq) {
+    if (query.max_txns() > 0 && txns.size() >= query.max_txns()) {
+      next_seq = seq;
+      break;
+    }
+    std::shared_ptr<const std::string> txn = GetSerializedTxn(seq);
+    if (txn == nullptr) {
+      break;
+    }
+    // A page holds at least one transaction, however large.
+    if (!txns.empty() && txns_size + txn->size() > max_bytes) {
+      next_seq = seq;
+      break;
+    }
+    txns_size += txn->size();
+    txns.push_back(std::move(txn));
+  }
+
+  // The QueryResponse is the concatenation of its encoded fields, so the
+  // cached transactions are copied into the message as they are.
+  uint32_t next_seq_tag = WireFormatLite::MakeTag(
+      QueryResponse::kNextSeqFieldNumber, WireFormatLite::WIRETYPE_VARINT);
+  size_t response_size = txns_size;
+  if (next_seq > 0) {
+    response_size += CodedOutputStream::VarintSize32(next_seq_tag) +
+                     CodedOutputStream::VarintSize64(next_seq);
+  }
+  uint32_t data_tag =
+      WireFormatLite::MakeTag(ResDBMessage::kDataFieldNumber,
+                              WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  size_t response_offset = CodedOutputStream::VarintSize32(data_tag) +
+                           CodedOutputStream::VarintSize64(response_size);
+
+  std::string message_str;
+  message_str.resize(response_offset + response_size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(&message_str[0]);
+  target = CodedOutputStream::WriteVarint32ToArray(data_tag, target);
+  target = CodedOutputStream::WriteVarint64ToArray(response_size, target);
+  for (const auto& txn : txns) {
+    memcpy(target, txn->data(), txn->size());
+    target += txn->size();
+  }
+  if (next_seq > 0) {
+    target = CodedOutputStream::WriteVarint32ToArray(next_seq_tag, target);
+    CodedOutputStream::WriteVarint64ToArray(next_seq, target);
+  }
+  return message_str;
+}
+
+std::shared_ptr<const std::string> Query::GetSerializedTxn(uint64_t seq) {
+  using google::protobuf::internal::WireFormatLite;
+  using google::protobuf::io::CodedOutputStream;
+
+  {
+    std::lock_guard<std::mutex> lk(cache_mutex_);
+    std::shared_ptr<const std::string> txn = txn_cache_.Get(seq);
+    if (txn != nullptr) {
+      return txn;
+    }
+  }
+
+  Request* ret_request = message_manager_->GetRequest(seq);
+  if (ret_request == nullptr) {
+    return nullptr;
+  }
+  Request txn;
+  txn.set_data(ret_request->data());
+  txn.set_hash(ret_request->hash());
+  txn.set_seq(ret_request->seq());
+  txn.set_proxy_id(ret_request->proxy_id());
+
+  uint32_t tag =
+      WireFormatLite::MakeTag(QueryResponse::kTransactionsFieldNumber,
+                              WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  size_t txn_size = txn.ByteSizeLong();
+  std::string txn_str;
+  txn_str.resize(CodedOutputStream::VarintSize32(tag) +
+                 CodedOutputStream::VarintSize64(txn_size) + txn_size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(&txn_str[0]);
+  target = CodedOutputStream::WriteVarint32ToArray(tag, target);
+  target = CodedOutputStream::WriteVarint64ToArray(txn_size, target);
+  txn.SerializeWithCachedSizesToArray(target);
+
+  auto value = std::make_shared<const std::string>(std::move(txn_str));
+  std::lock_guard<std::mutex> lk(cache_mutex_);
+  txn_cache_.Put(seq, value);
+  return value;
+}
+
+int Query::ForwardQuery(std::unique_ptr<Context> context,
+                        std::unique_ptr<Request> request) {
+  QueryRequest query;
+  if (!query.ParseFromString(request->data())) {
+    LOG(ERROR) << "parse data fail";
+    return -2;
+  }
+  query.set_keep_alive(true);
+  query.SerializeToString(request->mutable_data());
+
+  std::string response_str;
+  auto forward = [&](NetChannel* channel) {
+    return channel->SendRawMessage(*request) == 0 &&
+           channel->RecvRawMessageData(&response_str) > 0;
+  };
+  std::unique_ptr<NetChannel> channel = GetPrimaryChannel();
+  if (channel == nullptr || !forward(channel.get())) {
+    // The primary closes pooled connections that stay idle for too long.
+    channel = NewPrimaryChannel(GetPrimary());
+    if (!forward(channel.get())) {
+      LOG(ERROR) << "forward query to primary fail";
+      return 0;
     }
   }
+  ReturnPrimaryChannel(std::move(channel));
 
   if (context != nullptr && context->client != nullptr) {
-    // LOG(ERROR) << "send response:" << response.DebugString();
-    int ret = context->client->SendRawMessage(response);
+    int ret = context->client->SendRawMessageData(response_str);
     if (ret) {
       LOG(ERROR) << "send resp fail ret:" << ret;
     }
@@ -121,6 +261,42 @@ int Query::ProcessQuery(std::unique_ptr<Context> context,
   return 0;
 }
 
+ReplicaInfo Query::GetPrimary() {
+  int64_t primary_id = message_manager_->GetCurrentPrimary();
+  for (const auto& replica : config_.GetReplicaInfos()) {
+    if (replica.id() == primary_id) {
+      return replica;
+    }
+  }
+  return ReplicaInfo();
+}
+
+std::unique_ptr<NetChannel> Query::NewPrimaryChannel(
+    const ReplicaInfo& primary) {
+  LOG(ERROR) << "redirect to primary:" << primary.ip()
+             << " port:" << primary.port();
+  auto channel = std::make_unique<NetChannel>(primary.ip(), primary.port());
+  channel->IsLongConnection(true);
+  return channel;
+}
+
+std::unique_ptr<NetChannel> Query::GetPrimaryChannel() {
+  std::lock_guard<std::mutex> lk(channel_mutex_);
+  if (primary_channels_.empty()) {
+    return nullptr;
+  }
+  std::unique_ptr<NetChannel> channel = std::move(primary_channels_.back());
+  primary_channels_.pop_back();
+  return channel;
+}
+
+void Query::ReturnPrimaryChannel(std::unique_ptr<NetChannel> channel) {
+  std::lock_guard<std::mutex> lk(channel_mutex_);
+  if (primary_channels_.size() < kMaxPrimaryChannels) {
+    primary_channels_.push_back(std::move(channel));
+  }
+}
+
 int Query::ProcessCustomQuery(std::unique_ptr<Context> context,
                               std::unique_ptr<Request> request) {
   if (custom_query_executor_ == nullptr) {
@@ -19,7 +19,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/lru/lru_cache.h"
+#include "common/utils/thread_pool.h"
 #include "executor/common/custom_query.h"
+#include "interface/rdbc/net_channel.h"
 #include "platform/config/resdb_config.h"
 #include "platform/consensus/ordering/pbft/message_manager.h"
 
@@ -39,10 +47,59 @@ class Query {
   virtual int ProcessCustomQuery(std::unique_ptr<Context> context,
                                  std::unique_ptr<Request> request);
 
+  // The ResDBMessage carrying one page of the transactions in
+  // [query.min_seq, query.max_seq]. The page stops at the first missing
+  // transaction or once it is full, in which case next_seq is set.
+  std::string GetQueryPage(const QueryRequest& query);
+
+ protected:
+  virtual std::unique_ptr<NetChannel> NewPrimaryChannel(
+      const ReplicaInfo& primary);
+
+ private:
+  int SendQueryResponse(NetChannel* client, const QueryRequest& query);
+  // Serve the following queries sent on the connection until it is closed
+  // or stays idle. Runs on keep_alive_pool_.
+  void ServeKeepAlive(NetChannel* client);
+  // The transaction of seq, encoded as a QueryResponse.transactions field.
+  std::shared_ptr<const std::string> GetSerializedTxn(uint64_t seq);
+
+  int ForwardQuery(std::unique_ptr<Context> context,
+                   std::unique_ptr<Request> request);
+  ReplicaInfo GetPrimary();
+  std::unique_ptr<NetChannel> GetPrimaryChannel();
+  void ReturnPrimaryChannel(std::unique_ptr<NetChannel> channel);
+
  protected:
   ResDBConfig config_;
   MessageManager* message_manager_;
   std::unique_ptr<CustomQuery> custom_query_executor_;
+
+  // The page size when the query does not ask for a smaller one.
+  static constexpr uint64_t kMaxPageBytes = 4 << 20;
+  static constexpr int kTxnCacheSize = 100000;
+  static constexpr size_t kMaxPrimaryChannels = 4;
+  // How long a kept alive connection may stay idle, in microseconds.
+  static constexpr int kKeepAliveTimeoutUs = 1000000;
+  // Kept alive connections are served by their own threads, one each, so
+  // they do not hold the workers of the service network. Connections over
+  // the limit are closed after the first response.
+  static constexpr int kKeepAliveThreads = 4;
+
+ private:
+  // Committed transactions do not change, so their encoding is kept
+  // across queries.
+  std::mutex cache_mutex_;
+  LRUCache<uint64_t, std::shared_ptr<const std::string>> txn_cache_;
+
+  // Idle connections to the primary, used by client nodes to forward
+  // queries.
+  std::mutex channel_mutex_;
+  std::vector<std::unique_ptr<NetChannel>> primary_channels_;
+
+  std::atomic<bool> stop_ = false;
+  std::atomic<int> keep_alive_num_ = 0;
+  std::unique_ptr<ThreadPool> keep_alive_pool_;
 };
 
 }  // namespace resdb
@@ -142,6 +142,13 @@ class QueryTest : public Test {
   Commitment commitment_;
 };
 
+MATCHER_P(EqualsQueryResponse, response, "") {
+  ResDBMessage message;
+  QueryResponse x;
+  return message.ParseFromString(arg) && x.ParseFromString(message.data()) &&
+         ::google::protobuf::util::MessageDifferencer::Equals(x, response);
+}
+
 MATCHER_P(EqualsProtoNoConfigData, replica, "") {
   ReplicaState x = dynamic_cast<const ReplicaState&>(arg);
   ReplicaState y = replica;
@@ -182,7 +189,8 @@ TEST_F(QueryTest, QueryTxn) {
 
   std::unique_ptr<MockNetChannel> channel =
       std::make_unique<MockNetChannel>("127.0.0.1", 0);
-  EXPECT_CALL(*channel, SendRawMessage(EqualsProto(response))).Times(1);
+  EXPECT_CALL(*channel, SendRawMessageData(EqualsQueryResponse(response)))
+      .Times(1);
 
   auto context = std::make_unique<Context>();
   context->client = std::move(channel);
@@ -200,6 +208,166 @@ TEST_F(QueryTest, QueryTxn) {
   EXPECT_EQ(ret, 0);
 }
 
+TEST_F(QueryTest, QueryPage) {
+  for (int i = 1; i <= 5; ++i) {
+    auto request = std::make_unique<Request>();
+    request->set_seq(i);
+    request->set_data("txn" + std::to_string(i));
+    checkpoint_manager_.GetTxnDB()->Put(std::move(request));
+  }
+  auto get_page = [&](uint64_t min_seq, uint64_t max_seq, uint32_t max_txns,
+                      uint64_t max_bytes) {
+    QueryRequest query;
+    query.set_min_seq(min_seq);
+    query.set_max_seq(max_seq);
+    query.set_max_txns(max_txns);
+    query.set_max_bytes(max_bytes);
+    ResDBMessage message;
+    QueryResponse response;
+    EXPECT_TRUE(message.ParseFromString(query_.GetQueryPage(query)));
+    EXPECT_TRUE(response.ParseFromString(message.data()));
+    return response;
+  };
+
+  QueryResponse response = get_page(1, 5, 2, 0);
+  EXPECT_EQ(response.transactions_size(), 2);
+  EXPECT_EQ(response.transactions(1).data(), "txn2");
+  EXPECT_EQ(response.next_seq(), 3);
+
+  // A page holds one transaction even if it is larger than max_bytes.
+  response = get_page(3, 5, 0, 1);
+  EXPECT_EQ(response.transactions_size(), 1);
+  EXPECT_EQ(response.transactions(0).data(), "txn3");
+  EXPECT_EQ(response.next_seq(), 4);
+
+  response = get_page(4, 10, 0, 0);
+  EXPECT_EQ(response.transactions_size(), 2);
+  EXPECT_EQ(response.transactions(1).seq(), 5);
+  EXPECT_EQ(response.next_seq(), 0);
+
+  // Served from the cache.
+  response = get_page(1, 5, 0, 0);
+  EXPECT_EQ(response.transactions_size(), 5);
+  EXPECT_EQ(response.transactions(0).data(), "txn1");
+  EXPECT_EQ(response.next_seq(), 0);
+}
+
+TEST_F(QueryTest, QueryKeepAlive) {
+  for (int i = 1; i <= 2; ++i) {
+    auto request = std::make_unique<Request>();
+    request->set_seq(i);
+    checkpoint_manager_.GetTxnDB()->Put(std::move(request));
+  }
+
+  QueryResponse response1, response2;
+  response1.add_transactions()->set_seq(1);
+  response2.add_transactions()->set_seq(2);
+
+  Request request;
+  request.set_type(Request::TYPE_QUERY);
+  QueryRequest query;
+  query.set_keep_alive(true);
+  query.set_min_seq(2);
+  query.set_max_seq(2);
+  query.SerializeToString(request.mutable_data());
+
+  std::unique_ptr<MockNetChannel> channel =
+      std::make_unique<MockNetChannel>("127.0.0.1", 0);
+  EXPECT_CALL(*channel, SendRawMessageData(EqualsQueryResponse(response1)))
+      .WillOnce(Return(0));
+  EXPECT_CALL(*channel, SendRawMessageData(EqualsQueryResponse(response2)))
+      .WillOnce(Return(0));
+  // The connection is served on its own thread once ProcessQuery returns.
+  std::promise<void> returned, closed;
+  std::future<void> returned_future = returned.get_future();
+  EXPECT_CALL(*channel, RecvRawMessageStr)
+      .WillOnce(Invoke([&](std::string* data) {
+        returned_future.wait();
+        request.SerializeToString(data);
+        return 0;
+      }))
+      .WillOnce(Invoke([&](std::string* data) {
+        closed.set_value();
+        return -1;
+      }));
+
+  auto context = std::make_unique<Context>();
+  context->client = std::move(channel);
+
+  query.set_min_seq(1);
+  query.set_max_seq(1);
+  Request first_request = request;
+  query.SerializeToString(first_request.mutable_data());
+  EXPECT_EQ(query_.ProcessQuery(std::move(context),
+                                std::make_unique<Request>(first_request)),
+            0);
+  returned.set_value();
+  closed.get_future().wait();
+}
+
+CertificateInfo GetClientCertificateInfo() {
+  CertificateInfo info;
+  info.mutable_public_key()->mutable_public_key_info()->set_type(
+      CertificateKeyInfo::CLIENT);
+  return info;
+}
+
+class MockPrimaryQuery : public Query {
+ public:
+  MockPrimaryQuery(const ResDBConfig& config, MessageManager* message_manager)
+      : Query(config, message_manager) {}
+
+  MOCK_METHOD(std::unique_ptr<NetChannel>, NewPrimaryChannel,
+              (const ReplicaInfo&), (override));
+};
+
+TEST_F(QueryTest, ForwardQueryOnPooledChannel) {
+  ResDBConfig config({GenerateReplicaInfo(1, "127.0.0.1", 1234)},
+                     GenerateReplicaInfo(5, "127.0.0.1", 1238), KeyInfo(),
+                     GetClientCertificateInfo());
+  MockPrimaryQuery query(config, &message_manager_);
+
+  QueryRequest query_request;
+  query_request.set_min_seq(1);
+  query_request.set_max_seq(1);
+  QueryRequest forward_request = query_request;
+  forward_request.set_keep_alive(true);
+  Request request;
+  request.set_type(Request::TYPE_QUERY);
+  query_request.SerializeToString(request.mutable_data());
+
+  EXPECT_CALL(query, NewPrimaryChannel)
+      .WillOnce(Invoke([&](const ReplicaInfo&) {
+        auto channel = std::make_unique<MockNetChannel>("127.0.0.1", 0);
+        EXPECT_CALL(*channel, SendRawMessage)
+            .Times(2)
+            .WillRepeatedly(Invoke([&](const google::protobuf::Message& msg) {
+              QueryRequest sent;
+              EXPECT_TRUE(sent.ParseFromString(
+                  dynamic_cast<const Request&>(msg).data()));
+              EXPECT_THAT(sent, EqualsProto(forward_request));
+              return 0;
+            }));
+        EXPECT_CALL(*channel, RecvRawMessageData)
+            .Times(2)
+            .WillRepeatedly(Invoke([&](std::string* data) {
+              *data = "response";
+              return 1;
+            }));
+        return channel;
+      }));
+
+  for (int i = 0; i < 2; ++i) {
+    auto channel = std::make_unique<MockNetChannel>("127.0.0.1", 0);
+    EXPECT_CALL(*channel, SendRawMessageData("response")).WillOnce(Return(0));
+    auto context = std::make_unique<Context>();
+    context->client = std::move(channel);
+    EXPECT_EQ(query.ProcessQuery(std::move(context),
+                                 std::make_unique<Request>(request)),
+              0);
+  }
+}
+
 }  // namespace
 
 }  // namespace resdb
@@ -25,23 +25,6 @@
 
 namespace resdb {
 
-ResponseClientTimeout::ResponseClientTimeout(std::string hash_,
-                                             uint64_t time_) {
-  this->hash = hash_;
-  this->timeout_time = time_;
-}
-
-ResponseClientTimeout::ResponseClientTimeout(
-    const ResponseClientTimeout& other) {
-  this->hash = other.hash;
-  this->timeout_time = other.timeout_time;
-}
-
-bool ResponseClientTimeout::operator<(
-    const ResponseClientTimeout& other) const {
-  return timeout_time > other.timeout_time;
-}
-
 ResponseManager::ResponseManager(const ResDBConfig& config,
                                  ReplicaCommunicator* replica_communicator,
                                  SystemInfo* system_info,
@@ -66,9 +49,8 @@ ResponseManager::ResponseManager(const ResDBConfig& config,
       config_.IsTestMode()) {
     user_req_thread_ = std::thread(&ResponseManager::BatchProposeMsg, this);
   }
-  if (config_.GetConfigData().enable_viewchange()) {
-    checking_timeout_thread_ =
-        std::thread(&ResponseManager::MonitoringClientTimeOut, this);
+  if (config_.IsViewChangeEnabled()) {
+    timer_wheel_ = TimerWheel::GetGlobalTimerWheel();
   }
   global_stats_ = Stats::GetGlobalStats();
   send_num_ = 0;
@@ -79,8 +61,16 @@ ResponseManager::~ResponseManager() {
   if (user_req_thread_.joinable()) {
     user_req_thread_.join();
   }
-  if (checking_timeout_thread_.joinable()) {
-    checking_timeout_thread_.join();
+  // Make sure no timer refers to the waiting requests once they are gone.
+  std::vector<TimerWheel::TimerId> timer_ids;
+  {
+    std::lock_guard<std::mutex> lk(pm_lock_);
+    for (const auto& it : waiting_response_batches_) {
+      timer_ids.push_back(it.second.timer_id);
+    }
+  }
+  for (TimerWheel::TimerId id : timer_ids) {
+    timer_wheel_->Cancel(id);
   }
 }
 
@@ -345,67 +335,51 @@ int ResponseManager::DoBatch(
 
 void ResponseManager::AddWaitingResponseRequest(
     std::unique_ptr<Request> request) {
-  if (!config_.GetConfigData().enable_viewchange()) {
+  if (!config_.IsViewChangeEnabled()) {
+    return;
+  }
+  const Request* request_ptr = request.get();
+  std::lock_guard<std::mutex> lk(pm_lock_);
+  WaitingResponse& waiting = waiting_response_batches_[request->hash()];
+  if (waiting.request != nullptr) {
     return;
   }
-  pm_lock_.lock();
-  assert(timeout_length_ > 0);
-  uint64_t time = GetCurrentTime() + timeout_length_;
-  client_timeout_min_heap_.push(ResponseClientTimeout(request->hash(), time));
-  waiting_response_batches_.insert(
-      make_pair(request->hash(), std::move(request)));
-  pm_lock_.unlock();
-  sem_post(&request_sent_signal_);
+  waiting.request = std::move(request);
+  waiting.timer_id = timer_wheel_->Add(
+      timeout_length_, [this, request_ptr]() { ClientTimeOut(request_ptr); });
 }
 
 void ResponseManager::RemoveWaitingResponseRequest(const std::string& hash) {
-  if (!config_.GetConfigData().enable_viewchange()) {
+  if (!config_.IsViewChangeEnabled()) {
     return;
   }
-  pm_lock_.lock();
-  if (waiting_response_batches_.find(hash) != waiting_response_batches_.end()) {
-    waiting_response_batches_.erase(waiting_response_batches_.find(hash));
+  WaitingResponse waiting;
+  {
+    std::lock_guard<std::mutex> lk(pm_lock_);
+    auto it = waiting_response_batches_.find(hash);
+    if (it == waiting_response_batches_.end()) {
+      return;
+    }
+    waiting = std::move(it->second);
+    waiting_response_batches_.erase(it);
   }
-  pm_lock_.unlock();
+  // The request is released after its timer is cancelled or has finished.
+  timer_wheel_->Cancel(waiting.timer_id);
 }
 
-bool ResponseManager::CheckTimeOut(std::string hash) {
-  pm_lock_.lock();
-  bool value =
-      (waiting_response_batches_.find(hash) != waiting_response_batches_.end());
-  pm_lock_.unlock();
-  return value;
-}
-
-std::unique_ptr<Request> ResponseManager::GetTimeOutRequest(std::string hash) {
-  pm_lock_.lock();
-  auto value = std::move(waiting_response_batches_.find(hash)->second);
-  pm_lock_.unlock();
-  return value;
-}
-
-void ResponseManager::MonitoringClientTimeOut() {
-  while (!stop_) {
-    sem_wait(&request_sent_signal_);
-    pm_lock_.lock();
-    if (client_timeout_min_heap_.empty()) {
-      pm_lock_.unlock();
-      continue;
-    }
-    auto client_timeout = client_timeout_min_heap_.top();
-    client_timeout_min_heap_.pop();
-    pm_lock_.unlock();
-
-    if (client_timeout.timeout_time > GetCurrentTime()) {
-      usleep(client_timeout.timeout_time - GetCurrentTime());
-    }
-
-    if (CheckTimeOut(client_timeout.hash)) {
-      auto request = GetTimeOutRequest(client_timeout.hash);
-      if (request) {
-        replica_communicator_->BroadCast(*request);
-      }
+void ResponseManager::ClientTimeOut(const Request* request) {
+  std::unique_ptr<Request> timeout_request;
+  {
+    std::lock_guard<std::mutex> lk(pm_lock_);
+    auto it = waiting_response_batches_.find(request->hash());
+    if (it == waiting_response_batches_.end() ||
+        it->second.request.get() != request) {
+      return;
     }
+    timeout_request = std::move(it->second.request);
+    waiting_response_batches_.erase(it);
   }
+  replica_communicator_->BroadCast(*timeout_request);
 }
+
 }  // namespace resdb
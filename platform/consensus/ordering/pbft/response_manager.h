@@ -18,8 +18,7 @@
  */
 
 #pragma once
-#include <semaphore.h>
-
+#include "common/utils/timer_wheel.h"
 #include "platform/config/resdb_config.h"
 #include "platform/consensus/ordering/pbft/lock_free_collector_pool.h"
 #include "platform/consensus/ordering/pbft/transaction_utils.h"
@@ -28,16 +27,6 @@
 
 namespace resdb {
 
-class ResponseClientTimeout {
- public:
-  ResponseClientTimeout(std::string hash_, uint64_t time_);
-  ResponseClientTimeout(const ResponseClientTimeout& other);
-  bool operator<(const ResponseClientTimeout& other) const;
-
-  std::string hash;
-  uint64_t timeout_time;
-};
-
 class ResponseManager {
  public:
   ResponseManager(const ResDBConfig& config,
@@ -78,10 +67,8 @@ class ResponseManager {
 
   void AddWaitingResponseRequest(std::unique_ptr<Request> request);
   void RemoveWaitingResponseRequest(const std::string& hash);
-  bool CheckTimeOut(std::string hash);
-  void ResponseTimer(std::string hash);
-  void MonitoringClientTimeOut();
-  std::unique_ptr<Request> GetTimeOutRequest(std::string hash);
+  // Broadcast the request if it is still waiting for the responses.
+  void ClientTimeOut(const Request* request);
 
  private:
   ResDBConfig config_;
@@ -96,12 +83,14 @@ class ResponseManager {
   std::atomic<int> send_num_;
   SignatureVerifier* verifier_;
 
-  std::thread checking_timeout_thread_;
-  std::map<std::string, std::unique_ptr<Request>> waiting_response_batches_;
-  std::priority_queue<ResponseClientTimeout> client_timeout_min_heap_;
+  struct WaitingResponse {
+    std::unique_ptr<Request> request;
+    TimerWheel::TimerId timer_id = 0;
+  };
+  TimerWheel* timer_wheel_ = nullptr;
+  std::map<std::string, WaitingResponse> waiting_response_batches_;
   std::mutex pm_lock_;
   uint64_t timeout_length_;
-  sem_t request_sent_signal_;
   uint64_t highest_seq_;
   uint64_t highest_seq_primary_id_;
 };
@@ -40,28 +40,38 @@ std::shared_ptr<ViewChangeTimeout> ComplaningClients::SetComplaining(
   auto info = std::make_shared<ViewChangeTimeout>(
       ViewChangeTimerType::TYPE_COMPLAINT, view, this->proxy_id, hash,
       GetCurrentTime(), this->timeout_length_);
-  this->viewchange_timeout_set.insert(hash);
+  this->viewchange_timers_[hash] = 0;
   this->complain_state_lock.unlock();
   return info;
 }
 
-uint ComplaningClients::CountViewChangeTimeout(std::string hash) {
+void ComplaningClients::SetTimer(std::string hash,
+                                 TimerWheel::TimerId timer_id) {
   this->complain_state_lock.lock();
-  uint value = this->viewchange_timeout_set.count(hash);
+  auto it = this->viewchange_timers_.find(hash);
+  if (it != this->viewchange_timers_.end()) {
+    it->second = timer_id;
+  }
   this->complain_state_lock.unlock();
-  return value;
 }
 
-void ComplaningClients::EraseViewChangeTimeout(std::string hash) {
+bool ComplaningClients::EraseViewChangeTimeout(std::string hash) {
   this->complain_state_lock.lock();
-  this->viewchange_timeout_set.erase(hash);
+  bool erased = this->viewchange_timers_.erase(hash) > 0;
   this->complain_state_lock.unlock();
+  return erased;
 }
 
-void ComplaningClients::ReleaseComplaining(std::string hash) {
+std::vector<TimerWheel::TimerId> ComplaningClients::ReleaseComplaining() {
+  std::vector<TimerWheel::TimerId> timer_ids;
   this->complain_state_lock.lock();
-  this->viewchange_timeout_set.erase(hash);
+  for (const auto& it : this->viewchange_timers_) {
+    timer_ids.push_back(it.second);
+  }
+  this->viewchange_timers_.clear();
+  this->is_complaining = false;
   this->complain_state_lock.unlock();
+  return timer_ids;
 }
 
 // A manager to address View change process.
@@ -84,20 +94,30 @@ ViewChangeManager::ViewChangeManager(const ResDBConfig& config,
       stop_(false) {
   view_change_counter_ = 1;
   global_stats_ = Stats::GetGlobalStats();
-  if (config_.GetConfigData().enable_viewchange()) {
+  if (config_.IsViewChangeEnabled()) {
     collector_pool_ = message_manager->GetCollectorPool();
-    sem_init(&viewchange_timer_signal_, 0, 0);
-    server_checking_timeout_thread_ =
-        std::thread(&ViewChangeManager::MonitoringViewChangeTimeOut, this);
+    timer_wheel_ = TimerWheel::GetGlobalTimerWheel();
+    message_manager_->SetCommittedCallback(
+        [this](uint64_t proxy_id) { ReleaseComplaints(proxy_id); });
     checkpoint_state_thread_ =
         std::thread(&ViewChangeManager::MonitoringCheckpointState, this);
   }
 }
 
 ViewChangeManager::~ViewChangeManager() {
+  if (config_.IsViewChangeEnabled()) {
+    message_manager_->SetCommittedCallback(nullptr);
+  }
   checkpoint_manager_->Stop();
-  if (server_checking_timeout_thread_.joinable()) {
-    server_checking_timeout_thread_.join();
+  std::vector<TimerWheel::TimerId> timer_ids;
+  {
+    std::lock_guard<std::mutex> lk(vc_mutex_);
+    for (const auto& it : viewchange_timers_) {
+      timer_ids.insert(timer_ids.end(), it.second.begin(), it.second.end());
+    }
+  }
+  for (TimerWheel::TimerId id : timer_ids) {
+    timer_wheel_->Cancel(id);
   }
   if (checkpoint_state_thread_.joinable()) {
     checkpoint_state_thread_.join();
@@ -121,6 +141,10 @@ void ViewChangeManager::MayStart() {
 
   checkpoint_manager_->SetTimeoutHandler([&]() {
     // LOG(ERROR) << "checkpoint timeout";
+    if (is_recovering_) {
+      LOG(ERROR) << "skip view change while recovering";
+      return;
+    }
     if (status_ == ViewChangeStatus::NONE) {
       view_change_counter_ = 1;
     } else if (status_ == ViewChangeStatus::READY_NEW_VIEW) {
@@ -136,12 +160,7 @@ void ViewChangeManager::MayStart() {
           config_.GetSelfInfo().id(), "null", GetCurrentTime(),
           timeout_length_);
       std::lock_guard<std::mutex> lk(vc_mutex_);
-      if (viewchange_timeout_min_heap_[config_.GetSelfInfo().id()].size() <
-          config_.GetMaxClientComplaintNum()) {
-        viewchange_timeout_min_heap_[config_.GetSelfInfo().id()].push(
-            viewchange_timer);
-        sem_post(&viewchange_timer_signal_);
-      }
+      AddTimer(viewchange_timer);
     }
   });
 }
@@ -215,17 +234,14 @@ uint32_t ViewChangeManager::AddRequest(
 
 bool ViewChangeManager::IsNextPrimary(uint64_t view_number) {
   std::lock_guard<std::mutex> lk(mutex_);
-  const std::vector<ReplicaInfo>& replicas = config_.GetReplicaInfos();
-  return config_.GetReplicaInfos()[(view_number - 1) % replicas.size()].id() ==
+  return system_info_->GetPrimaryOfView(view_number) ==
          config_.GetSelfInfo().id();
 }
 
 void ViewChangeManager::SetCurrentViewAndNewPrimary(uint64_t view_number) {
   system_info_->SetCurrentView(view_number);
 
-  const std::vector<ReplicaInfo>& replicas = config_.GetReplicaInfos();
-  uint32_t id =
-      config_.GetReplicaInfos()[(view_number - 1) % replicas.size()].id();
+  uint32_t id = system_info_->GetPrimaryOfView(view_number);
   system_info_->SetPrimary(id);
   global_stats_->ChangePrimary(id);
   LOG(ERROR) << "View Change Happened";
@@ -404,12 +420,7 @@ int ViewChangeManager::ProcessViewChange(std::unique_ptr<Context> context,
           config_.GetSelfInfo().id(), "null", GetCurrentTime(),
           timeout_length_);
       std::lock_guard<std::mutex> lk(vc_mutex_);
-      if (viewchange_timeout_min_heap_[config_.GetSelfInfo().id()].size() <
-          config_.GetMaxClientComplaintNum()) {
-        viewchange_timeout_min_heap_[config_.GetSelfInfo().id()].push(
-            newview_timer);
-        sem_post(&viewchange_timer_signal_);
-      }
+      AddTimer(newview_timer);
     }
     ChangeStatue(ViewChangeStatus::READY_NEW_VIEW);
   }
@@ -509,6 +520,9 @@ void ViewChangeManager::SendViewChangeMsg() {
 }
 
 void ViewChangeManager::AddComplaintTimer(uint64_t proxy_id, std::string hash) {
+  if (is_recovering_) {
+    return;
+  }
   LOG(ERROR) << "ADDING COMPLAINT";
   std::lock_guard<std::mutex> lk(vc_mutex_);
   if (complaining_clients_.count(proxy_id) == 0) {
@@ -516,82 +530,98 @@ void ViewChangeManager::AddComplaintTimer(uint64_t proxy_id, std::string hash) {
   }
   auto complaint_ = complaining_clients_[proxy_id].SetComplaining(
       hash, system_info_->GetCurrentView());
-  if (viewchange_timeout_min_heap_[proxy_id].size() <
-      config_.GetMaxClientComplaintNum()) {
-    viewchange_timeout_min_heap_[proxy_id].push(complaint_);
-    sem_post(&viewchange_timer_signal_);
-  } else {
+  complaint_num_++;
+  AddTimer(complaint_);
+  complaining_clients_[proxy_id].SetTimer(hash, complaint_->timer_id);
+}
+
+void ViewChangeManager::ReleaseComplaints(uint64_t proxy_id) {
+  if (complaint_num_ == 0) {
+    return;
+  }
+  std::vector<TimerWheel::TimerId> timer_ids;
+  {
+    std::lock_guard<std::mutex> lk(vc_mutex_);
+    auto it = complaining_clients_.find(proxy_id);
+    if (it == complaining_clients_.end()) {
+      return;
+    }
+    timer_ids = it->second.ReleaseComplaining();
+    complaint_num_ -= timer_ids.size();
+    std::set<TimerWheel::TimerId>& timers = viewchange_timers_[proxy_id];
+    for (TimerWheel::TimerId id : timer_ids) {
+      timers.erase(id);
+    }
+  }
+  // Cancel waits for a running callback, which takes vc_mutex_.
+  for (TimerWheel::TimerId id : timer_ids) {
+    if (id != 0) {
+      timer_wheel_->Cancel(id);
+    }
+  }
+}
+
+void ViewChangeManager::AddTimer(std::shared_ptr<ViewChangeTimeout> timeout) {
+  std::set<TimerWheel::TimerId>& timers = viewchange_timers_[timeout->proxy_id];
+  if (timers.size() >= config_.GetMaxClientComplaintNum()) {
     // LOG(INFO) << "The number of complaints reaches the maximum value";
+    return;
   }
+  timeout->timer_id = timer_wheel_->Add(
+      timeout->timeout_time - timeout->start_time, [this, timeout]() {
+        {
+          std::lock_guard<std::mutex> lk(vc_mutex_);
+          viewchange_timers_[timeout->proxy_id].erase(timeout->timer_id);
+        }
+        ViewChangeTimeOut(*timeout);
+      });
+  timers.insert(timeout->timer_id);
 }
 
-void ViewChangeManager::MonitoringViewChangeTimeOut() {
-  while (!stop_) {
-    // [DK3] After timer is out, the client will check if the corresponding
-    // client request has recevied sufficient valid responses
-    sem_wait(&viewchange_timer_signal_);
-    vc_mutex_.lock();
-    bool empty = true;
-    std::shared_ptr<ViewChangeTimeout> viewchange_timeout;
-    for (auto& heap : viewchange_timeout_min_heap_) {
-      if (!heap.second.empty()) {
-        viewchange_timeout = heap.second.top();
-        heap.second.pop();
-        vc_mutex_.unlock();
-        empty = false;
-        break;
-      }
-    }
-    if (empty) {
-      vc_mutex_.unlock();
-      continue;
+// [DK3] After timer is out, the client will check if the corresponding
+// client request has recevied sufficient valid responses
+void ViewChangeManager::ViewChangeTimeOut(
+    const ViewChangeTimeout& viewchange_timeout) {
+  // [DK3] if not enough responses are received, the client broadcasts the
+  // client request to all replicas
+  if (viewchange_timeout.type == ViewChangeTimerType::TYPE_NEWVIEW) {
+    if (status_ == ViewChangeStatus::READY_NEW_VIEW &&
+        viewchange_timeout.view == system_info_->GetCurrentView()) {
+      // [DK12] if the replicas cannot receive a newview message in a timely
+      // manner, they will enter the next view and starts a new round of
+      // viewchange. SetCurrentViewAndNewPrimary(viewchange_timeout.view + 1);
+      LOG(ERROR) << "It is time to start a new viewchange";
+      checkpoint_manager_->TimeoutHandler();
     }
-    auto current_time = GetCurrentTime();
-    if (viewchange_timeout->timeout_time > current_time) {
-      usleep(viewchange_timeout->timeout_time - current_time);
+  } else if (viewchange_timeout.type ==
+             ViewChangeTimerType::TYPE_VIEWCHANGE) {
+    // [DK9] if the primary cannot get enough viewchange messages before the
+    // timer is out, then it broadcasts its viewchanges messages and starts
+    // the timer again.
+    if (status_ == ViewChangeStatus::READY_VIEW_CHANGE &&
+        viewchange_timeout.view == system_info_->GetCurrentView()) {
+      LOG(ERROR) << "It is time to rebroacast viewchange messages";
+      ChangeStatue(ViewChangeStatus::VIEW_CHANGE_FAIL);
+      checkpoint_manager_->TimeoutHandler();
     }
-    // [DK3] if not enough responses are received, the client broadcasts the
-    // client request to all replicas
-    if (viewchange_timeout->type == ViewChangeTimerType::TYPE_NEWVIEW) {
-      if (status_ == ViewChangeStatus::READY_NEW_VIEW &&
-          viewchange_timeout->view == system_info_->GetCurrentView()) {
-        // [DK12] if the replicas cannot receive a newview message in a timely
-        // manner, they will enter the next view and starts a new round of
-        // viewchange. SetCurrentViewAndNewPrimary(viewchange_timeout->view +
-        // 1);
-        LOG(ERROR) << "It is time to start a new viewchange";
-        checkpoint_manager_->TimeoutHandler();
+  } else if (viewchange_timeout.type == ViewChangeTimerType::TYPE_COMPLAINT) {
+    // [DK7] if the primary does not broadcast the request in a timely manner,
+    // the replica starts a viewchange
+    {
+      std::lock_guard<std::mutex> lk(vc_mutex_);
+      if (complaining_clients_[viewchange_timeout.proxy_id]
+              .EraseViewChangeTimeout(viewchange_timeout.hash)) {
+        complaint_num_--;
       }
-    } else if (viewchange_timeout->type ==
-               ViewChangeTimerType::TYPE_VIEWCHANGE) {
-      // [DK9] if the primary cannot get enough viewchange messages before the
-      // timer is out, then it broadcasts its viewchanges messages and starts
-      // the timer again.
-      if (status_ == ViewChangeStatus::READY_VIEW_CHANGE &&
-          viewchange_timeout->view == system_info_->GetCurrentView()) {
-        LOG(ERROR) << "It is time to rebroacast viewchange messages";
-        ChangeStatue(ViewChangeStatus::VIEW_CHANGE_FAIL);
+    }
+    std::lock_guard<std::mutex> lk(status_mutex_);
+    if (status_ == ViewChangeStatus::NONE &&
+        viewchange_timeout.view == system_info_->GetCurrentView()) {
+      if (viewchange_timeout.start_time >=
+          message_manager_->GetLastCommittedTime(viewchange_timeout.proxy_id)) {
+        LOG(ERROR) << "It is time to start a viewchange";
         checkpoint_manager_->TimeoutHandler();
-      }
-    } else if (viewchange_timeout->type ==
-               ViewChangeTimerType::TYPE_COMPLAINT) {
-      // [DK7] if the primary does not broadcast the request in a timely manner,
-      // the replica starts a viewchange
-      if (complaining_clients_[viewchange_timeout->proxy_id]
-              .CountViewChangeTimeout(viewchange_timeout->hash)) {
-        complaining_clients_[viewchange_timeout->proxy_id]
-            .EraseViewChangeTimeout(viewchange_timeout->hash);
-      }
-      std::lock_guard<std::mutex> lk(status_mutex_);
-      if (status_ == ViewChangeStatus::NONE &&
-          viewchange_timeout->view == system_info_->GetCurrentView()) {
-        if (viewchange_timeout->start_time >=
-            message_manager_->GetLastCommittedTime(
-                viewchange_timeout->proxy_id)) {
-          LOG(ERROR) << "It is time to start a viewchange";
-          checkpoint_manager_->TimeoutHandler();
-          assert(status_ == ViewChangeStatus::READY_VIEW_CHANGE);
-        }
+        assert(status_ == ViewChangeStatus::READY_VIEW_CHANGE);
       }
     }
   }
@@ -615,4 +645,8 @@ void ViewChangeManager::SetDuplicateManager(DuplicateManager* manager) {
   duplicate_manager_ = manager;
 }
 
+void ViewChangeManager::SetRecovering(bool is_recovering) {
+  is_recovering_ = is_recovering;
+}
+
 }  // namespace resdb
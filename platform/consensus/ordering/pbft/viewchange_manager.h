@@ -22,6 +22,7 @@
 #include <semaphore.h>
 
 #include "common/crypto/signature_verifier.h"
+#include "common/utils/timer_wheel.h"
 #include "platform/config/resdb_config.h"
 #include "platform/consensus/execution/system_info.h"
 #include "platform/consensus/ordering/pbft/checkpoint_manager.h"
@@ -52,10 +53,7 @@ class ViewChangeTimeout {
   std::string hash;
   uint64_t start_time;
   uint64_t timeout_time;
-
-  bool operator<(const ViewChangeTimeout& other) const {
-    return timeout_time > other.timeout_time;
-  }
+  TimerWheel::TimerId timer_id = 0;
 };
 
 class ComplaningClients {
@@ -64,18 +62,21 @@ class ComplaningClients {
   ComplaningClients(uint64_t proxy_id);
   std::shared_ptr<ViewChangeTimeout> SetComplaining(std::string hash,
                                                     uint64_t view);
-  void ReleaseComplaining(std::string hash);
+  void SetTimer(std::string hash, TimerWheel::TimerId timer_id);
+  // Drop all the complaints and return their timers so that they can be
+  // cancelled.
+  std::vector<TimerWheel::TimerId> ReleaseComplaining();
   void set_proxy_id(uint64_t proxy_id) { this->proxy_id = proxy_id; }
 
-  uint CountViewChangeTimeout(std::string hash);
-  void EraseViewChangeTimeout(std::string hash);
+  // Return true if the complaint was still outstanding.
+  bool EraseViewChangeTimeout(std::string hash);
 
  protected:
   uint64_t proxy_id;
   bool is_complaining;
   uint64_t timeout_length_;
   std::mutex complain_state_lock;
-  std::set<std::string> viewchange_timeout_set;
+  std::map<std::string, TimerWheel::TimerId> viewchange_timers_;
 };
 
 class ViewChangeManager {
@@ -103,10 +104,15 @@ class ViewChangeManager {
   };
 
   void AddComplaintTimer(uint64_t proxy_id, std::string hash);
+  // Cancel the complaints of the proxy once one of its requests commits.
+  void ReleaseComplaints(uint64_t proxy_id);
   void AddViewChangeTimer();
   void AddNewViewTimer();
   void CheckComplaintTimeout();
   void SetDuplicateManager(DuplicateManager* manager);
+  // A recovering replica is behind on purpose. It neither complains about
+  // the primary nor starts a view change until it is done.
+  void SetRecovering(bool is_recovering);
 
  private:
   void SendViewChangeMsg();
@@ -121,8 +127,10 @@ class ViewChangeManager {
 
   bool ChangeStatue(ViewChangeStatus status);
 
-  void MonitoringViewChangeTimeOut();
-  bool CheckTimeOut(ViewChangeTimeout& info);
+  // Start the timer unless its proxy has too many of them outstanding.
+  // vc_mutex_ must be held.
+  void AddTimer(std::shared_ptr<ViewChangeTimeout> timeout);
+  void ViewChangeTimeOut(const ViewChangeTimeout& timeout);
   void MonitoringCheckpointState();
 
  protected:
@@ -142,14 +150,13 @@ class ViewChangeManager {
   uint32_t view_change_counter_;
 
   std::mutex vc_mutex_;
-  std::thread server_checking_timeout_thread_;
   std::thread checkpoint_state_thread_;
-  sem_t timeout_cnt_;
-  sem_t viewchange_timer_signal_;
-  // LockFreeQueue<ViewChangeTimeout> timeout_info_queue;
-  std::map<uint64_t, std::priority_queue<std::shared_ptr<ViewChangeTimeout>>>
-      viewchange_timeout_min_heap_;
+  TimerWheel* timer_wheel_ = nullptr;
+  // The outstanding timers of each proxy.
+  std::map<uint64_t, std::set<TimerWheel::TimerId>> viewchange_timers_;
   std::map<uint64_t, ComplaningClients> complaining_clients_;
+  std::atomic<uint64_t> complaint_num_ = 0;
+  std::atomic<bool> is_recovering_ = false;
   std::atomic<bool> stop_;
   uint64_t timeout_length_ = 10000000;
 
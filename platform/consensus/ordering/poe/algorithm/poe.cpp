@@ -21,43 +21,181 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 #include "common/crypto/signature_verifier.h"
 #include "common/utils/utils.h"
 
 namespace resdb {
 namespace poe {
 
-PoE::PoE(int id, int f, int total_num, SignatureVerifier* verifier)
-    : ProtocolBase(id, f, total_num), verifier_(verifier) {
+PoE::PoE(int id, int f, int total_num, SignatureVerifier* verifier,
+         int window_size, int checkpoint_interval)
+    : ProtocolBase(id, f, total_num),
+      window_size_(window_size),
+      checkpoint_interval_(checkpoint_interval),
+      verifier_(verifier) {
   LOG(ERROR) << "get proposal graph";
   id_ = id;
   total_num_ = total_num;
   f_ = f;
   is_stop_ = false;
-  seq_ = 0;
+  seq_ = 1;
+  stable_seq_ = 0;
+  slots_ = std::make_unique<Slot[]>(window_size_);
+  for (int i = 0; i < window_size_; ++i) {
+    Slot& slot = slots_[i];
+    slot.seq = 0;
+    slot.ready = false;
+    slot.committed = false;
+    slot.votes = 0;
+    slot.voters.resize((total_num_ + 63) / 64, 0);
+  }
 }
 
-PoE::~PoE() { is_stop_ = true; }
+PoE::~PoE() {
+  {
+    std::lock_guard<std::mutex> lk(seq_mutex_);
+    is_stop_ = true;
+  }
+  seq_cv_.notify_all();
+}
 
 bool PoE::IsStop() { return is_stop_; }
 
+bool PoE::IsReplica(int sender) const {
+  return sender >= 1 && sender <= total_num_;
+}
+
+bool PoE::InWindow(int64_t seq) const {
+  int64_t stable_seq = stable_seq_;
+  return seq > stable_seq && seq <= stable_seq + window_size_;
+}
+
+bool PoE::IsFuture(int64_t seq) const {
+  int64_t stable_seq = stable_seq_;
+  return seq > stable_seq + window_size_ &&
+         seq <= stable_seq + 2 * window_size_;
+}
+
+int64_t PoE::GetStableSeq() const { return stable_seq_; }
+
+int PoE::GetPrimary() const { return view_ % total_num_ + 1; }
+
+int64_t PoE::GetCommittedSeq() {
+  std::lock_guard<std::mutex> lk(commit_mutex_);
+  return committed_seq_;
+}
+
+int PoE::GetPendingNum() {
+  int num = 0;
+  for (int i = 0; i < window_size_; ++i) {
+    std::lock_guard<std::mutex> lk(slots_[i].mutex);
+    if (slots_[i].txn != nullptr || !slots_[i].early_votes.empty()) {
+      num++;
+    }
+  }
+  std::lock_guard<std::mutex> lk(future_mutex_);
+  return num + future_txns_.size();
+}
+
+PoE::Slot* PoE::GetSlot(int64_t seq) {
+  if (seq <= 0) {
+    return nullptr;
+  }
+  // A slot keeps its proposal until it is reused, so a proposal arriving
+  // after its checkpoint becomes stable can still be committed.
+  Slot* slot = &slots_[seq % window_size_];
+  if (slot->seq == seq) {
+    return slot;
+  }
+  if (!InWindow(seq)) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lk(slot->mutex);
+  if (slot->seq == seq) {
+    return slot;
+  }
+  if (slot->seq > stable_seq_) {
+    return nullptr;
+  }
+  if (slot->seq > 0 && !slot->committed) {
+    LOG(ERROR) << "seq:" << slot->seq << " is dropped before committed";
+  }
+  slot->ready = false;
+  slot->committed = false;
+  slot->hash.clear();
+  slot->txn = nullptr;
+  slot->early_votes.clear();
+  std::fill(slot->voters.begin(), slot->voters.end(), 0);
+  slot->votes = 0;
+  slot->seq = seq;
+  return slot;
+}
+
 bool PoE::ReceiveTransaction(std::unique_ptr<Transaction> txn) {
   // LOG(ERROR)<<"recv txn:";
   txn->set_create_time(GetCurrentTime());
-  txn->set_seq(seq_++);
+  {
+    // Wait for the checkpoint to move if the window is full.
+    std::unique_lock<std::mutex> lk(seq_mutex_);
+    while (!IsStop() && seq_ > stable_seq_ + window_size_) {
+      seq_cv_.wait_for(lk, std::chrono::milliseconds(100));
+    }
+    if (IsStop()) {
+      return false;
+    }
+    txn->set_seq(seq_++);
+  }
   txn->set_proposer(id_);
 
   Broadcast(MessageType::Propose, *txn);
   return true;
 }
 
-bool PoE::ReceivePropose(std::unique_ptr<Transaction> txn) {
+bool PoE::ReceivePropose(int sender, std::unique_ptr<Transaction> txn) {
+  // Only the primary assigns the seqs. Checked before the slot is taken, so
+  // another replica can not claim a seq ahead of it.
+  if (sender != GetPrimary()) {
+    LOG(ERROR) << "propose from non-primary:" << sender
+               << " primary:" << GetPrimary();
+    return false;
+  }
   std::string hash = txn->hash();
   int64_t seq = txn->seq();
-  int proposer = txn->proposer();
+  Slot* slot = GetSlot(seq);
+  if (slot == nullptr) {
+    std::lock_guard<std::mutex> lk(future_mutex_);
+    if (IsFuture(seq)) {
+      future_txns_[seq] = std::make_pair(sender, std::move(txn));
+      return true;
+    }
+    slot = GetSlot(seq);
+    if (slot == nullptr) {
+      LOG(ERROR) << "seq:" << seq << " out of window, stable:" << stable_seq_;
+      return false;
+    }
+  }
+
+  bool quorum = false;
   {
-    std::unique_lock<std::mutex> lk(mutex_);
-    data_[txn->hash()] = std::move(txn);
+    std::unique_lock<std::mutex> lk(slot->mutex);
+    if (slot->seq != seq || slot->ready) {
+      return false;
+    }
+    slot->hash = hash;
+    slot->txn = std::move(txn);
+    slot->ready = true;
+    for (const auto& vote : slot->early_votes) {
+      if (vote.second == hash && AddVote(slot, vote.first)) {
+        quorum = true;
+      }
+    }
+    slot->early_votes.clear();
+  }
+  if (quorum) {
+    CommitSlot(slot, seq);
+    UpdateCommittedSeq();
   }
 
   Proposal proposal;
@@ -68,24 +206,174 @@ bool PoE::ReceivePropose(std::unique_ptr<Transaction> txn) {
   return true;
 }
 
-bool PoE::ReceivePrepare(std::unique_ptr<Proposal> proposal) {
-  std::unique_ptr<Transaction> txn = nullptr;
+bool PoE::ReceivePrepare(int sender, std::unique_ptr<Proposal> proposal) {
+  if (!IsReplica(sender)) {
+    LOG(ERROR) << "prepare from unknown sender:" << sender;
+    return false;
+  }
+  int64_t seq = proposal->seq();
+  Slot* slot = GetSlot(seq);
+  if (slot == nullptr) {
+    std::lock_guard<std::mutex> lk(future_mutex_);
+    if (IsFuture(seq)) {
+      future_votes_.emplace(seq, std::make_pair(sender, std::move(proposal)));
+      return true;
+    }
+    slot = GetSlot(seq);
+    if (slot == nullptr) {
+      return false;
+    }
+  }
   {
-    std::unique_lock<std::mutex> lk(mutex_);
-    received_[proposal->hash()].insert(proposal->proposer());
-    auto it = data_.find(proposal->hash());
-    if (it != data_.end()) {
-      if (received_[proposal->hash()].size() >= 2 * f_ + 1) {
-        txn = std::move(it->second);
-        data_.erase(it);
+    std::unique_lock<std::mutex> lk(slot->mutex);
+    if (slot->seq != seq || slot->committed) {
+      // The slot has been reused or the proposal is done.
+      return false;
+    }
+    if (!slot->ready) {
+      for (const auto& vote : slot->early_votes) {
+        if (vote.first == sender) {
+          return true;
+        }
       }
+      slot->early_votes.push_back(std::make_pair(sender, proposal->hash()));
+      return true;
+    }
+    if (slot->hash != proposal->hash()) {
+      LOG(ERROR) << "prepare hash does not match, seq:" << seq
+                 << " from:" << sender;
+      return false;
+    }
+    if (!AddVote(slot, sender)) {
+      return true;
     }
   }
-  if (txn != nullptr) {
-    commit_(*txn);
+  CommitSlot(slot, seq);
+  UpdateCommittedSeq();
+  return true;
+}
+
+bool PoE::AddVote(Slot* slot, int sender) {
+  uint64_t bit = 1ull << ((sender - 1) % 64);
+  uint64_t& voters = slot->voters[(sender - 1) / 64];
+  if (voters & bit) {
+    return false;
+  }
+  voters |= bit;
+  return ++slot->votes == 2 * f_ + 1;
+}
+
+void PoE::CommitSlot(Slot* slot, int64_t seq) {
+  std::unique_lock<std::mutex> lk(slot->mutex);
+  if (slot->seq != seq || slot->txn == nullptr) {
+    return;
   }
+  Commit(*slot->txn);
+  slot->committed = true;
+}
+
+void PoE::UpdateCommittedSeq() {
+  std::vector<CheckpointInfo> checkpoints;
+  {
+    std::lock_guard<std::mutex> lk(commit_mutex_);
+    while (true) {
+      int64_t next_seq = committed_seq_ + 1;
+      Slot& slot = slots_[next_seq % window_size_];
+      std::lock_guard<std::mutex> slot_lk(slot.mutex);
+      if (slot.seq != next_seq || !slot.committed) {
+        break;
+      }
+      committed_hash_ =
+          SignatureVerifier::CalculateHash(committed_hash_ + slot.hash);
+      committed_seq_ = next_seq;
+      if (committed_seq_ % checkpoint_interval_ == 0) {
+        CheckpointInfo checkpoint;
+        checkpoint.set_seq(committed_seq_);
+        checkpoint.set_hash(committed_hash_);
+        checkpoint.set_proposer(id_);
+        checkpoints.push_back(checkpoint);
+      }
+    }
+  }
+  for (const CheckpointInfo& checkpoint : checkpoints) {
+    Broadcast(MessageType::Checkpoint, checkpoint);
+  }
+  GarbageCollect();
+}
+
+bool PoE::ReceiveCheckpoint(int sender,
+                            std::unique_ptr<CheckpointInfo> checkpoint) {
+  if (!IsReplica(sender)) {
+    LOG(ERROR) << "checkpoint from unknown sender:" << sender;
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lk(checkpoint_mutex_);
+    if (checkpoint->seq() <= stable_seq_) {
+      return true;
+    }
+    auto& senders = checkpoints_[checkpoint->seq()][checkpoint->hash()];
+    senders.insert(sender);
+    if (static_cast<int>(senders.size()) < 2 * f_ + 1) {
+      return true;
+    }
+    stable_seq_ = checkpoint->seq();
+    checkpoints_.erase(checkpoints_.begin(),
+                       checkpoints_.upper_bound(checkpoint->seq()));
+  }
+  {
+    std::lock_guard<std::mutex> lk(seq_mutex_);
+    seq_cv_.notify_all();
+  }
+  GarbageCollect();
+  ReplayFuture();
   return true;
 }
 
+// The replicas move their windows at different times, so a replica may
+// receive messages of the next window before its own checkpoint is stable.
+void PoE::ReplayFuture() {
+  std::vector<std::pair<int, std::unique_ptr<Transaction>>> txns;
+  std::vector<std::pair<int, std::unique_ptr<Proposal>>> votes;
+  {
+    std::lock_guard<std::mutex> lk(future_mutex_);
+    int64_t max_seq = stable_seq_ + window_size_;
+    auto txn_end = future_txns_.upper_bound(max_seq);
+    for (auto it = future_txns_.begin(); it != txn_end; ++it) {
+      txns.push_back(std::move(it->second));
+    }
+    future_txns_.erase(future_txns_.begin(), txn_end);
+
+    auto vote_end = future_votes_.upper_bound(max_seq);
+    for (auto it = future_votes_.begin(); it != vote_end; ++it) {
+      votes.push_back(std::move(it->second));
+    }
+    future_votes_.erase(future_votes_.begin(), vote_end);
+  }
+  for (auto& txn : txns) {
+    ReceivePropose(txn.first, std::move(txn.second));
+  }
+  for (auto& vote : votes) {
+    ReceivePrepare(vote.first, std::move(vote.second));
+  }
+}
+
+// Releases the proposals which are both committed locally and covered by
+// the stable checkpoint. Their slots are reused by the next window.
+void PoE::GarbageCollect() {
+  std::lock_guard<std::mutex> lk(commit_mutex_);
+  int64_t max_seq = std::min<int64_t>(stable_seq_, committed_seq_);
+  for (int64_t seq = gc_seq_ + 1; seq <= max_seq; ++seq) {
+    Slot& slot = slots_[seq % window_size_];
+    std::lock_guard<std::mutex> slot_lk(slot.mutex);
+    if (slot.seq == seq) {
+      slot.txn = nullptr;
+      slot.hash.clear();
+      slot.hash.shrink_to_fit();
+    }
+  }
+  gc_seq_ = std::max(gc_seq_, max_seq);
+}
+
 }  // namespace poe
 }  // namespace resdb
@@ -16,13 +16,15 @@
  * specific language governing permissions and limitations
  * under the License.
  */
-
 #pragma once
 
-#include <deque>
+#include <atomic>
+#include <condition_variable>
 #include <map>
-#include <queue>
+#include <mutex>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include "platform/common/queue/lock_free_queue.h"
 #include "platform/consensus/ordering/common/algorithm/protocol_base.h"
@@ -32,24 +34,105 @@
 namespace resdb {
 namespace poe {
 
+// Proposals are kept in a ring of window_size slots indexed by seq. Only the
+// seqs in (stable checkpoint, stable checkpoint + window_size] are accepted
+// (messages of the next window are held until it moves) and the primary
+// stops assigning new seqs once the window is full. Every
+// checkpoint_interval committed seqs the replicas exchange a checkpoint;
+// once 2f+1 of them match, the slots below it are released.
+//
+// Commits are speculative: a proposal is executed as soon as 2f+1 prepares
+// arrive, so the client has to wait for 2f+1 matching responses.
 class PoE : public common::ProtocolBase {
  public:
-  PoE(int id, int f, int total_num, SignatureVerifier* verifier);
+  PoE(int id, int f, int total_num, SignatureVerifier* verifier,
+      int window_size = 4096, int checkpoint_interval = 1024);
   ~PoE();
 
   bool ReceiveTransaction(std::unique_ptr<Transaction> txn);
-  bool ReceivePropose(std::unique_ptr<Transaction> txn);
-  bool ReceivePrepare(std::unique_ptr<Proposal> proposal);
+  // sender is the replica which sent the message, as authenticated by the
+  // network layer.
+  bool ReceivePropose(int sender, std::unique_ptr<Transaction> txn);
+  bool ReceivePrepare(int sender, std::unique_ptr<Proposal> proposal);
+  bool ReceiveCheckpoint(int sender,
+                         std::unique_ptr<CheckpointInfo> checkpoint);
+
+  // All the seqs up to it have been committed locally.
+  int64_t GetCommittedSeq();
+  // Low watermark: 2f+1 replicas have committed all the seqs up to it.
+  int64_t GetStableSeq() const;
+  // Number of slots still holding a proposal.
+  int GetPendingNum();
+  // The replica proposing in the current view.
+  int GetPrimary() const;
 
  private:
+  struct Slot {
+    std::mutex mutex;
+    // The seq using this slot, 0 if never used.
+    std::atomic<int64_t> seq;
+    // The proposal has been received. The fields below are guarded by
+    // mutex, which is also held while the slot is handed to a new seq.
+    std::atomic<bool> ready;
+    std::atomic<bool> committed;
+    std::string hash;
+    std::unique_ptr<Transaction> txn;
+    // Prepares received before the proposal, as (sender, hash).
+    std::vector<std::pair<int, std::string>> early_votes;
+    // Bit (sender - 1) is set once the prepare of sender is counted.
+    std::vector<uint64_t> voters;
+    int votes;
+  };
+
   bool IsStop();
+  bool InWindow(int64_t seq) const;
+  // seq belongs to the next window.
+  bool IsFuture(int64_t seq) const;
+  // Returns the slot of seq, taking it over from an older seq if needed.
+  // Returns nullptr if seq is outside the window.
+  Slot* GetSlot(int64_t seq);
+  bool IsReplica(int sender) const;
+  // Counts the prepare of sender, with slot->mutex held. Returns true if it
+  // is the vote completing the quorum.
+  bool AddVote(Slot* slot, int sender);
+  void CommitSlot(Slot* slot, int64_t seq);
+  void UpdateCommittedSeq();
+  void GarbageCollect();
+  void ReplayFuture();
 
  private:
-  std::mutex mutex_;
-  std::map<std::string, std::set<int32_t> > received_;
-  std::map<std::string, std::unique_ptr<Transaction> > data_;
+  const int window_size_;
+  const int checkpoint_interval_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // There is no view change yet, so the view stays 0.
+  std::atomic<int64_t> view_ = 0;
 
+  // Next seq to propose, only used by the primary.
+  std::mutex seq_mutex_;
+  std::condition_variable seq_cv_;
   int64_t seq_;
+
+  // Committed prefix and the hash chain over it.
+  std::mutex commit_mutex_;
+  int64_t committed_seq_ = 0;
+  std::string committed_hash_;
+  // Proposals up to it have been released.
+  int64_t gc_seq_ = 0;
+
+  std::mutex checkpoint_mutex_;
+  // seq -> hash -> senders
+  std::map<int64_t, std::map<std::string, std::set<int32_t>>> checkpoints_;
+  std::atomic<int64_t> stable_seq_;
+
+  // Messages of the next window, replayed once the window moves.
+  std::mutex future_mutex_;
+  // seq -> (sender, message)
+  std::map<int64_t, std::pair<int, std::unique_ptr<Transaction>>>
+      future_txns_;
+  std::multimap<int64_t, std::pair<int, std::unique_ptr<Proposal>>>
+      future_votes_;
+
   bool is_stop_;
   SignatureVerifier* verifier_;
   Stats* global_stats_;
@@ -0,0 +1,258 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/consensus/ordering/poe/algorithm/poe.h"
+
+#include <glog/logging.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "platform/common/queue/lock_free_queue.h"
+
+namespace resdb {
+namespace poe {
+namespace {
+
+// Connects the replicas in process. Each replica handles its messages in
+// its own thread.
+class PoETest : public ::testing::Test {
+ protected:
+  struct Message {
+    int type;
+    int sender;
+    std::string data;
+  };
+
+  void Start(int replica_num, int window_size, int checkpoint_interval) {
+    int f = (replica_num - 1) / 3;
+    committed_.resize(replica_num + 1);
+    for (int i = 1; i <= replica_num; ++i) {
+      queues_.push_back(std::make_unique<LockFreeQueue<Message>>("poe"));
+    }
+    for (int i = 1; i <= replica_num; ++i) {
+      auto poe = std::make_unique<PoE>(i, f, replica_num, nullptr,
+                                       window_size, checkpoint_interval);
+      poe->SetBroadcastCallFunc(
+          [&, i](int type, const google::protobuf::Message& msg) {
+            for (auto& queue : queues_) {
+              auto message = std::make_unique<Message>();
+              message->type = type;
+              message->sender = i;
+              msg.SerializeToString(&message->data);
+              queue->Push(std::move(message));
+            }
+            return 0;
+          });
+      poe->SetCommitFunc([&, i](const google::protobuf::Message& msg) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        committed_[i].push_back(dynamic_cast<const Transaction&>(msg).seq());
+        return 0;
+      });
+      replicas_.push_back(std::move(poe));
+    }
+    for (int i = 0; i < replica_num; ++i) {
+      threads_.push_back(std::thread([this, i]() { Process(i); }));
+    }
+  }
+
+  void TearDown() override {
+    stop_ = true;
+    for (auto& th : threads_) {
+      th.join();
+    }
+  }
+
+  void Process(int idx) {
+    while (!stop_) {
+      std::unique_ptr<Message> message = queues_[idx]->Pop();
+      if (message == nullptr) {
+        continue;
+      }
+      if (message->type == MessageType::Propose) {
+        auto txn = std::make_unique<Transaction>();
+        txn->ParseFromString(message->data);
+        replicas_[idx]->ReceivePropose(message->sender, std::move(txn));
+      } else if (message->type == MessageType::Prepare) {
+        auto proposal = std::make_unique<Proposal>();
+        proposal->ParseFromString(message->data);
+        replicas_[idx]->ReceivePrepare(message->sender, std::move(proposal));
+      } else if (message->type == MessageType::Checkpoint) {
+        auto checkpoint = std::make_unique<CheckpointInfo>();
+        checkpoint->ParseFromString(message->data);
+        replicas_[idx]->ReceiveCheckpoint(message->sender,
+                                          std::move(checkpoint));
+      }
+    }
+  }
+
+  bool WaitForCommitted(int64_t seq) {
+    for (int i = 0; i < 500; ++i) {
+      bool done = true;
+      for (auto& replica : replicas_) {
+        if (replica->GetCommittedSeq() < seq ||
+            replica->GetStableSeq() < seq) {
+          done = false;
+        }
+      }
+      if (done) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+ protected:
+  std::vector<std::unique_ptr<PoE>> replicas_;
+  std::vector<std::unique_ptr<LockFreeQueue<Message>>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<bool> stop_ = false;
+  std::mutex mutex_;
+  std::vector<std::vector<int64_t>> committed_;
+};
+
+TEST_F(PoETest, CommitMoreThanWindow) {
+  Start(4, 16, 4);
+
+  int txn_num = 100;
+  for (int i = 0; i < txn_num; ++i) {
+    auto txn = std::make_unique<Transaction>();
+    txn->set_data("txn" + std::to_string(i));
+    txn->set_hash("hash" + std::to_string(i));
+    EXPECT_TRUE(replicas_[0]->ReceiveTransaction(std::move(txn)));
+  }
+
+  EXPECT_TRUE(WaitForCommitted(txn_num));
+  std::lock_guard<std::mutex> lk(mutex_);
+  for (int i = 1; i <= 4; ++i) {
+    std::vector<int64_t> seqs = committed_[i];
+    std::sort(seqs.begin(), seqs.end());
+    ASSERT_EQ(seqs.size(), txn_num);
+    for (int j = 0; j < txn_num; ++j) {
+      EXPECT_EQ(seqs[j], j + 1);
+    }
+    EXPECT_EQ(replicas_[i - 1]->GetPendingNum(), 0);
+  }
+}
+
+TEST_F(PoETest, RejectOutOfWindow) {
+  Start(4, 16, 4);
+
+  // Beyond the next window.
+  auto txn = std::make_unique<Transaction>();
+  txn->set_seq(33);
+  txn->set_hash("hash");
+  EXPECT_FALSE(replicas_[1]->ReceivePropose(1, std::move(txn)));
+
+  // Held until the window moves.
+  txn = std::make_unique<Transaction>();
+  txn->set_seq(17);
+  txn->set_hash("hash");
+  EXPECT_TRUE(replicas_[1]->ReceivePropose(1, std::move(txn)));
+
+  txn = std::make_unique<Transaction>();
+  txn->set_seq(16);
+  txn->set_hash("hash");
+  EXPECT_TRUE(replicas_[1]->ReceivePropose(1, std::move(txn)));
+  EXPECT_EQ(replicas_[1]->GetPendingNum(), 2);
+}
+
+TEST(PoEProposeTest, IgnoreNonPrimary) {
+  PoE poe(2, 1, 4, nullptr, 16, 4);
+  std::vector<std::string> prepared;
+  poe.SetBroadcastCallFunc([&](int type, const google::protobuf::Message& msg) {
+    prepared.push_back(dynamic_cast<const Proposal&>(msg).hash());
+    return 0;
+  });
+
+  auto txn = std::make_unique<Transaction>();
+  txn->set_seq(1);
+  txn->set_hash("fake_hash");
+  EXPECT_FALSE(poe.ReceivePropose(3, std::move(txn)));
+  EXPECT_EQ(poe.GetPendingNum(), 0);
+
+  // The seq is still free for the primary.
+  txn = std::make_unique<Transaction>();
+  txn->set_seq(1);
+  txn->set_hash("hash");
+  EXPECT_TRUE(poe.ReceivePropose(poe.GetPrimary(), std::move(txn)));
+  EXPECT_EQ(prepared, std::vector<std::string>({"hash"}));
+}
+
+TEST(PoEVoteTest, CountSendersNotPayload) {
+  PoE poe(1, 1, 4, nullptr, 16, 4);
+  int committed = 0;
+  poe.SetBroadcastCallFunc(
+      [](int type, const google::protobuf::Message& msg) { return 0; });
+  poe.SetCommitFunc([&](const google::protobuf::Message& msg) {
+    committed++;
+    return 0;
+  });
+
+  auto txn = std::make_unique<Transaction>();
+  txn->set_seq(1);
+  txn->set_hash("hash");
+  EXPECT_TRUE(poe.ReceivePropose(1, std::move(txn)));
+
+  // One replica claiming to be the others.
+  for (int proposer = 2; proposer <= 4; ++proposer) {
+    auto proposal = std::make_unique<Proposal>();
+    proposal->set_seq(1);
+    proposal->set_hash("hash");
+    proposal->set_proposer(proposer);
+    EXPECT_TRUE(poe.ReceivePrepare(2, std::move(proposal)));
+  }
+  EXPECT_FALSE(poe.ReceivePrepare(5, std::make_unique<Proposal>()));
+  EXPECT_EQ(committed, 0);
+
+  for (int sender = 3; sender <= 4; ++sender) {
+    auto proposal = std::make_unique<Proposal>();
+    proposal->set_seq(1);
+    proposal->set_hash("hash");
+    EXPECT_TRUE(poe.ReceivePrepare(sender, std::move(proposal)));
+  }
+  EXPECT_EQ(committed, 1);
+}
+
+TEST(PoEVoteTest, CheckpointQuorumOfSenders) {
+  PoE poe(1, 1, 4, nullptr, 16, 4);
+  poe.SetBroadcastCallFunc(
+      [](int type, const google::protobuf::Message& msg) { return 0; });
+
+  for (int proposer = 1; proposer <= 4; ++proposer) {
+    auto checkpoint = std::make_unique<CheckpointInfo>();
+    checkpoint->set_seq(4);
+    checkpoint->set_hash("hash");
+    checkpoint->set_proposer(proposer);
+    EXPECT_TRUE(poe.ReceiveCheckpoint(2, std::move(checkpoint)));
+  }
+  EXPECT_EQ(poe.GetStableSeq(), 0);
+
+  for (int sender = 3; sender <= 4; ++sender) {
+    auto checkpoint = std::make_unique<CheckpointInfo>();
+    checkpoint->set_seq(4);
+    checkpoint->set_hash("hash");
+    EXPECT_TRUE(poe.ReceiveCheckpoint(sender, std::move(checkpoint)));
+  }
+  EXPECT_EQ(poe.GetStableSeq(), 4);
+}
+
+}  // namespace
+}  // namespace poe
+}  // namespace resdb
@@ -34,6 +34,14 @@ Consensus::Consensus(const ResDBConfig& config,
   int f = (total_replicas - 1) / 3;
 
   Init();
+  // PoE executes speculatively, so a result is only final once 2f+1
+  // replicas return the same response.
+  if (performance_manager_ != nullptr) {
+    performance_manager_->SetMinResponseNum(2 * f + 1);
+  }
+  if (response_manager_ != nullptr) {
+    response_manager_->SetMinResponseNum(2 * f + 1);
+  }
 
   start_ = 0;
 
@@ -44,30 +52,18 @@ Consensus::Consensus(const ResDBConfig& config,
     poe_ = std::make_unique<PoE>(config_.GetSelfInfo().id(), f, total_replicas,
                                  GetSignatureVerifier());
     InitProtocol(poe_.get());
+    dispatcher_.Register<Transaction, &PoE::ReceivePropose>(
+        MessageType::Propose);
+    dispatcher_.Register<Proposal, &PoE::ReceivePrepare>(MessageType::Prepare);
+    dispatcher_.Register<CheckpointInfo, &PoE::ReceiveCheckpoint>(
+        MessageType::Checkpoint);
   }
 }
 
-int Consensus::ProcessCustomConsensus(std::unique_ptr<Request> request) {
-  if (request->user_type() == MessageType::Propose) {
-    std::unique_ptr<Transaction> txn = std::make_unique<Transaction>();
-    if (!txn->ParseFromString(request->data())) {
-      assert(1 == 0);
-      LOG(ERROR) << "parse proposal fail";
-      return -1;
-    }
-    poe_->ReceivePropose(std::move(txn));
-    return 0;
-  } else if (request->user_type() == MessageType::Prepare) {
-    std::unique_ptr<Proposal> proposal = std::make_unique<Proposal>();
-    if (!proposal->ParseFromString(request->data())) {
-      LOG(ERROR) << "parse proposal fail";
-      assert(1 == 0);
-      return -1;
-    }
-    poe_->ReceivePrepare(std::move(proposal));
-    return 0;
-  }
-  return 0;
+int Consensus::ProcessCustomConsensus(int sender_id,
+                                      std::unique_ptr<Request> request) {
+  return dispatcher_.Dispatch(poe_.get(), request->user_type(), sender_id,
+                              request->data());
 }
 
 int Consensus::ProcessNewTransaction(std::unique_ptr<Request> request) {
@@ -21,6 +21,7 @@
 
 #include "executor/common/transaction_manager.h"
 #include "platform/consensus/ordering/common/framework/consensus.h"
+#include "platform/consensus/ordering/common/framework/message_dispatcher.h"
 #include "platform/consensus/ordering/poe/algorithm/poe.h"
 #include "platform/networkstrate/consensus_manager.h"
 
@@ -34,7 +35,8 @@ class Consensus : public common::Consensus {
   virtual ~Consensus() = default;
 
  private:
-  int ProcessCustomConsensus(std::unique_ptr<Request> request) override;
+  int ProcessCustomConsensus(int sender_id,
+                             std::unique_ptr<Request> request) override;
   int ProcessNewTransaction(std::unique_ptr<Request> request) override;
   int CommitMsg(const google::protobuf::Message& msg) override;
   int CommitMsgInternal(const Transaction& txn);
@@ -43,6 +45,7 @@ class Consensus : public common::Consensus {
 
  protected:
   std::unique_ptr<PoE> poe_;
+  common::MessageDispatcher<PoE> dispatcher_;
   Stats* global_stats_;
   int64_t start_;
   std::mutex mutex_;
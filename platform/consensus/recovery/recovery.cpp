@@ -396,6 +396,15 @@ Recovery::GetRecoveryFiles() {
       last_ckpt = ckpt;
     }
   }
+  // The storage holds the state right after the checkpoint, so only the
+  // files containing later requests are needed.
+  bool from_execution_checkpoint =
+      storage_ != nullptr &&
+      config_.GetConfigData().enable_execution_checkpoint();
+  if (from_execution_checkpoint) {
+    last_ckpt = storage_->GetCheckpointSeq();
+    LOG(INFO) << "replay logs after execution checkpoint:" << last_ckpt;
+  }
   std::vector<std::pair<int64_t, std::string>> list;
 
   std::vector<std::pair<int64_t, std::string>> e_list;
@@ -421,7 +430,9 @@ Recovery::GetRecoveryFiles() {
 
     if (min_seq == -1) {
       e_list.push_back(std::make_pair(time, entry.path()));
-    } else if ((min_seq <= last_ckpt && max_seq >= last_ckpt)) {
+    } else if (from_execution_checkpoint ? max_seq > last_ckpt
+                                         : (min_seq <= last_ckpt &&
+                                            max_seq >= last_ckpt)) {
       list.push_back(std::make_pair(time, entry.path()));
     }
   }
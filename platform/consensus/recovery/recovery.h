@@ -74,6 +74,8 @@ class Recovery {
   void SwitchFile(const std::string& path);
 
   void UpdateStableCheckPoint();
+  // Returns the files to replay and the seq after which their requests are
+  // replayed. With an execution checkpoint, it is the seq of the checkpoint.
   std::pair<std::vector<std::pair<int64_t, std::string>>, int64_t>
   GetRecoveryFiles();
   void ReadLogsFromFiles(
@@ -335,6 +335,71 @@ TEST_F(RecoveryTest, CheckPoint2) {
   }
 }
 
+TEST_F(RecoveryTest, ExecutionCheckPoint) {
+  ResConfigData config_data = GetConfigData(1024);
+  config_data.set_enable_execution_checkpoint(true);
+  ResDBConfig config(config_data, ReplicaInfo(), KeyInfo(), CertificateInfo());
+  MockStorage storage;
+  EXPECT_CALL(storage, Flush).WillRepeatedly(Return(true));
+  EXPECT_CALL(storage, GetCheckpointSeq).WillRepeatedly(Return(12));
+
+  std::vector<int> types = {Request::TYPE_PRE_PREPARE, Request::TYPE_PREPARE,
+                            Request::TYPE_COMMIT};
+
+  std::promise<bool> insert_done, ckpt;
+  std::future<bool> insert_done_future = insert_done.get_future(),
+                    ckpt_future = ckpt.get_future();
+  int time = 1;
+  EXPECT_CALL(checkpoint_, GetStableCheckpoint()).WillRepeatedly(Invoke([&]() {
+    if (time == 1) {
+      insert_done_future.get();
+    } else if (time == 2) {
+      ckpt.set_value(true);
+    }
+    time++;
+    return 5;
+  }));
+
+  {
+    Recovery recovery(config, &checkpoint_, &system_info_, &storage);
+
+    for (int i = 1; i < 10; ++i) {
+      for (int t : types) {
+        std::unique_ptr<Request> request =
+            NewRequest(static_cast<resdb::Request_Type>(t), Request(), i);
+        request->set_seq(i);
+        recovery.AddRequest(nullptr, request.get());
+      }
+    }
+    insert_done.set_value(true);
+    ckpt_future.get();
+    for (int i = 10; i < 20; ++i) {
+      for (int t : types) {
+        std::unique_ptr<Request> request =
+            NewRequest(static_cast<resdb::Request_Type>(t), Request(), i);
+        request->set_seq(i);
+        recovery.AddRequest(nullptr, request.get());
+      }
+    }
+  }
+  std::vector<std::string> log_list = Listlogs(log_path);
+  EXPECT_EQ(log_list.size(), 2);
+  {
+    // Only the requests after the checkpoint are replayed.
+    std::vector<uint64_t> seqs;
+    Recovery recovery(config, &checkpoint_, &system_info_, &storage);
+    recovery.ReadLogs([&](const SystemInfoData &data) {},
+                      [&](std::unique_ptr<Context> context,
+                          std::unique_ptr<Request> request) {
+                        seqs.push_back(request->seq());
+                      });
+
+    EXPECT_EQ(seqs.size(), types.size() * 7);
+    EXPECT_EQ(seqs.front(), 13);
+    EXPECT_EQ(seqs.back(), 19);
+  }
+}
+
 TEST_F(RecoveryTest, SystemInfo) {
   ResDBConfig config(GetConfigData(1024), ReplicaInfo(), KeyInfo(),
                      CertificateInfo());
@@ -53,9 +53,9 @@ void AsyncAcceptor::Session::Close() {
 void AsyncAcceptor::Session::StartRead() {
   if (status_ == 0) {
     // read len
-    recv_buffer_ = reinterpret_cast<char*>(&data_size_);
+    recv_buffer_ = header_;
     data_size_ = 0;
-    need_size_ = sizeof(data_size_);
+    need_size_ = kFrameHeaderSize;
     current_idx_ = 0;
     memset(recv_buffer_, 0, need_size_);
     OnRead();
@@ -76,10 +76,9 @@ void AsyncAcceptor::Session::ReadDone() {
     call_back_func_(recv_buffer_, data_size_);
     delete recv_buffer_;
   } else {
-    data_size_ = *reinterpret_cast<size_t*>(recv_buffer_);
+    data_size_ = DecodeFrameHeader(header_);
     if (data_size_ > 1e10) {
-      LOG(ERROR) << "read data size:" << data_size_
-                 << " data size:" << sizeof(data_size_) << " close socket";
+      LOG(ERROR) << "read data size:" << data_size_ << " close socket";
       Close();
       return;
     }
@@ -155,6 +154,9 @@ void AsyncAcceptor::OnAccept(boost::shared_ptr<Session> client_session,
 
   StartAccept();  // Add the next accept event.
 
+  boost::system::error_code no_delay_ec;
+  client_session->GetSocket()->set_option(
+      boost::asio::ip::tcp::no_delay(true), no_delay_ec);
   sessions_.push_back(client_session);
   client_session->StartRead();
 }
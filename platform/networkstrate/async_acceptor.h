@@ -21,6 +21,8 @@
 #include <boost/asio.hpp>
 #include <memory>
 
+#include "platform/common/network/frame.h"
+
 namespace resdb {
 
 class AsyncAcceptor {
@@ -51,6 +53,7 @@ class AsyncAcceptor {
    private:
     boost::asio::io_service* io_service_ = nullptr;
     boost::asio::ip::tcp::socket client_socket_;
+    char header_[kFrameHeaderSize];
     size_t data_size_ = 0;
     size_t need_size_ = 0;
     size_t current_idx_ = 0;
@@ -21,11 +21,19 @@
 
 #include <boost/bind/bind.hpp>
 
+#include "platform/common/network/frame.h"
 #include "platform/common/queue/lock_free_queue.h"
 #include "platform/proto/replica_info.pb.h"
 
 namespace resdb {
 
+namespace {
+
+// The most messages coalesced into one write.
+constexpr size_t kMaxBatchSize = 64;
+
+}  // namespace
+
 AsyncReplicaClient::AsyncReplicaClient(boost::asio::io_service* io_service,
                                        const std::string& ip, int port,
                                        bool is_use_long_conn)
@@ -48,60 +56,88 @@ int AsyncReplicaClient::SendMessage(const std::string& data) {
   return 0;
 }
 
+bool AsyncReplicaClient::IsPeerClosed() {
+  if (!socket_.is_open()) {
+    return false;
+  }
+  // Nothing is sent back on this connection, so anything readable is the
+  // peer closing it.
+  char c;
+  int ret = recv(socket_.native_handle(), &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  return ret == 0 || (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+}
+
 void AsyncReplicaClient::OnSendNewMessage() {
-  std::unique_ptr<std::string> data = queue_.Pop(0);
-  if (data == nullptr || data->empty()) {
+  pending_data_.clear();
+  while (pending_data_.size() < kMaxBatchSize) {
+    std::unique_ptr<std::string> data = queue_.Pop(0);
+    if (data == nullptr) {
+      break;
+    }
+    if (!data->empty()) {
+      pending_data_.push_back(std::move(data));
+    }
+  }
+  if (pending_data_.empty()) {
     in_process_ = false;
     return;
   }
-  pending_data_ = std::move(data);
-  status_ = 0;
-  OnSendMessage();
-}
 
-void AsyncReplicaClient::OnSendMessage() {
-  if (status_ == 0) {
-    data_size_ = pending_data_->size();
-    sending_data_size_ = sizeof(data_size_);
-    sending_data_ptr_ = reinterpret_cast<char*>(&data_size_);
-    sending_data_idx_ = 0;
-    status_ = 1;
-    OnSend();
-  } else if (status_ == 1) {
-    sending_data_size_ = data_size_;
-    sending_data_ptr_ = pending_data_->c_str();
-    sending_data_idx_ = 0;
-    status_ = 2;
-    OnSend();
-  } else {
-    status_ = 0;
-    OnSendNewMessage();
+  headers_.resize(pending_data_.size() * kFrameHeaderSize);
+  buffers_.clear();
+  for (size_t i = 0; i < pending_data_.size(); ++i) {
+    char* header = headers_.data() + i * kFrameHeaderSize;
+    EncodeFrameHeader(pending_data_[i]->size(), header);
+    buffers_.push_back(boost::asio::buffer(header, kFrameHeaderSize));
+    buffers_.push_back(boost::asio::buffer(*pending_data_[i]));
+  }
+  // A write to a connection the peer has closed still succeeds once, so
+  // check it before writing rather than losing the batch.
+  if (IsPeerClosed()) {
+    ReConnect();
+    return;
   }
+  OnSend();
 }
 
 void AsyncReplicaClient::OnSend() {
-  socket_.async_write_some(
-      boost::asio::buffer(sending_data_ptr_ + sending_data_idx_,
-                          sending_data_size_ - sending_data_idx_),
+  boost::asio::async_write(
+      socket_, buffers_,
       [&](const boost::system::error_code& error, size_t send_size) {
         if (error) {
+          DropSentFrames(send_size);
           ReConnect();
         } else {
-          sending_data_idx_ += send_size;
-          if (sending_data_idx_ >= sending_data_size_) {
-            OnSendMessage();
-          } else {
-            OnSend();
-          }
+          OnSendNewMessage();
         }
       });
 }
 
+// The frames written in full are not sent again. The receiver drops a frame
+// cut off by the broken connection, so the rest restarts at its boundary.
+void AsyncReplicaClient::DropSentFrames(size_t send_size) {
+  size_t sent_buffers = 0;
+  while (sent_buffers + 1 < buffers_.size()) {
+    size_t frame_size =
+        buffers_[sent_buffers].size() + buffers_[sent_buffers + 1].size();
+    if (send_size < frame_size) {
+      break;
+    }
+    send_size -= frame_size;
+    sent_buffers += 2;
+  }
+  buffers_.erase(buffers_.begin(), buffers_.begin() + sent_buffers);
+}
+
 void AsyncReplicaClient::ReConnect() {
+  boost::system::error_code ec;
+  socket_.close(ec);
   socket_.async_connect(endpoint_, [&](const boost::system::error_code& error) {
     if (!error) {
-      status_ = 0;
-      OnSendMessage();
+      boost::system::error_code ec;
+      socket_.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+      // Resend the rest of the batch on the new connection.
+      OnSend();
     } else {
       usleep(10000);
       ReConnect();
@@ -38,8 +38,9 @@ class AsyncReplicaClient {
  private:
   void ReConnect();
   void OnSendNewMessage();
-  void OnSendMessage();
   void OnSend();
+  bool IsPeerClosed();
+  void DropSentFrames(size_t send_size);
 
  private:
   LockFreeQueue<std::string> queue_;
@@ -50,14 +51,11 @@ class AsyncReplicaClient {
   std::atomic<bool> in_process_;
 
   // ===== for async send =====
-  std::unique_ptr<std::string> pending_data_;
-
-  size_t data_size_ = 0;          // the size of the data needed to be sent.
-  size_t sending_data_idx_ = 0;   // the current pos to be sent in data_ptr.
-  size_t sending_data_size_ = 0;  // the size needed to be sent.
-  const char* sending_data_ptr_ = nullptr;  // point to the data.
-
-  int status_ = 0;  // sending status.
+  // The messages taken from the queue, written together with their headers
+  // in one gather write.
+  std::vector<std::unique_ptr<std::string>> pending_data_;
+  std::vector<char> headers_;
+  std::vector<boost::asio::const_buffer> buffers_;
 };
 
 }  // namespace resdb
@@ -22,6 +22,7 @@
 #include <glog/logging.h>
 #include <unistd.h>
 
+#include "common/utils/utils.h"
 #include "platform/proto/broadcast.pb.h"
 
 namespace resdb {
@@ -68,6 +69,33 @@ SignatureVerifier* ConsensusManager::GetSignatureVerifier() {
 
 bool ConsensusManager::IsReady() const { return is_ready_; }
 
+bool ConsensusManager::IsRecovering() const { return is_recovering_; }
+
+void ConsensusManager::SetRecovering(bool is_recovering) {
+  if (is_recovering_.exchange(is_recovering) == is_recovering) {
+    return;
+  }
+  LOG(ERROR) << "server:" << config_.GetSelfInfo().id()
+             << " is recovering:" << is_recovering;
+  if (!is_recovering && IsRunning() && config_.HeartBeatEnabled() &&
+      verifier_) {
+    std::unique_lock<std::mutex> lk(hb_mutex_);
+    SendHeartBeat();
+  }
+}
+
+HeartBeatInfo::State ConsensusManager::GetReplicaState(int64_t node_id) {
+  std::unique_lock<std::mutex> lk(hb_mutex_);
+  auto it = peers_.find(node_id);
+  return it == peers_.end() ? HeartBeatInfo::READY : it->second.state;
+}
+
+uint64_t ConsensusManager::GetReplicaRtt(int64_t node_id) {
+  std::unique_lock<std::mutex> lk(hb_mutex_);
+  auto it = peers_.find(node_id);
+  return it == peers_.end() ? 0 : it->second.rtt;
+}
+
 void ConsensusManager::Stop() {
   ServiceInterface::Stop();
   if (heartbeat_thread_.joinable()) {
@@ -108,22 +136,56 @@ void ConsensusManager::HeartBeat() {
 }
 
 void ConsensusManager::SendHeartBeat() {
-  auto keys = verifier_->GetAllPublicKeys();
-
   std::vector<ReplicaInfo> replicas = GetAllReplicas();
   LOG(ERROR) << "all replicas:" << replicas.size();
+  uint64_t key_version = verifier_->GetKeyVersion();
+  // Only carry the certificates if someone has not got this key set yet.
+  // Replicas report back which key set they hold, clients get the keys when
+  // they show up or restart.
+  bool send_keys = key_version != sent_key_version_;
+  if (send_keys_to_clients_.exchange(false)) {
+    send_keys = true;
+  }
+  for (const auto& replica : replicas) {
+    if (replica.id() == config_.GetSelfInfo().id()) {
+      continue;
+    }
+    auto it = peers_.find(replica.id());
+    if (it == peers_.end() || it->second.acked_key_version != key_version) {
+      send_keys = true;
+    }
+  }
   std::vector<ReplicaInfo> client_replicas = GetClientReplicas();
+  for (const auto& client : client_replicas) {
+    replicas.push_back(client);
+  }
+
+  uint64_t now = GetCurrentTime();
   HeartBeatInfo hb_info;
   hb_info.set_sender(config_.GetSelfInfo().id());
   hb_info.set_ip(config_.GetSelfInfo().ip());
   hb_info.set_port(config_.GetSelfInfo().port());
   hb_info.set_hb_version(version_);
-  for (const auto& key : keys) {
-    *hb_info.add_public_keys() = key;
-    hb_info.add_node_version(hb_[key.public_key_info().node_id()]);
+  hb_info.set_state(is_recovering_ ? HeartBeatInfo::RECOVERING
+                                   : HeartBeatInfo::READY);
+  hb_info.set_key_version(key_version);
+  hb_info.set_timestamp(now);
+
+  if (send_keys) {
+    for (const auto& key : verifier_->GetAllPublicKeys()) {
+      *hb_info.add_public_keys() = key;
+      hb_info.add_node_version(hb_[key.public_key_info().node_id()]);
+    }
+    sent_key_version_ = key_version;
   }
-  for (const auto& client : client_replicas) {
-    replicas.push_back(client);
+  for (const auto& [node_id, peer] : peers_) {
+    auto* peer_info = hb_info.add_peers();
+    peer_info->set_node_id(node_id);
+    peer_info->set_key_version(peer.key_version);
+    if (peer.timestamp > 0) {
+      peer_info->set_timestamp(peer.timestamp);
+      peer_info->set_delay(now - peer.recv_time);
+    }
   }
   auto client = GetReplicaClient(replicas, false);
   if (client == nullptr) {
@@ -141,12 +203,13 @@ void ConsensusManager::SendHeartBeat() {
   LOG(ERROR) << " server:" << config_.GetSelfInfo().id() << " sends HB"
              << " is ready:" << is_ready_
              << " client size:" << client_replicas.size()
-             << " svr size:" << replicas.size();
+             << " svr size:" << replicas.size()
+             << " key version:" << key_version << " with keys:" << send_keys;
 
   Request request;
   request.set_type(Request::TYPE_HEART_BEAT);
   request.mutable_region_info()->set_region_id(
-      config_.GetConfigData().self_region_id());
+      config_.GetSelfRegionId());
   hb_info.SerializeToString(request.mutable_data());
 
   int ret = client->SendHeartBeat(request);
@@ -177,6 +240,12 @@ int ConsensusManager::Process(std::unique_ptr<Context> context,
   }
 
   if (request->type() == Request::TYPE_HEART_BEAT) {
+    // A heartbeat may carry the key of its own signer, so it is checked
+    // after the keys are added.
+    if (context != nullptr) {
+      context->signature = message.signature();
+      context->signed_data = std::move(*message.mutable_data());
+    }
     return Dispatch(std::move(context), std::move(request));
   }
 
@@ -196,6 +265,7 @@ int ConsensusManager::Process(std::unique_ptr<Context> context,
   // forward the signature to the request so that it can be included in the
   // request/response set if needed.
   context->signature = message.signature();
+  context->signed_data = std::move(*message.mutable_data());
   // LOG(ERROR) << "======= server:" << config_.GetSelfInfo().id()
   //          << " get request type:" << request->type()
   //         << " from:" << request->sender_id();
@@ -229,10 +299,12 @@ int ConsensusManager::ProcessHeartBeat(std::unique_ptr<Context> context,
              << " from region:" << request->region_info().region_id()
              << " sender:" << hb_info.sender()
              << " last send:" << hb_info.hb_version()
-             << " current v:" << hb_[hb_info.sender()];
+             << " current v:" << hb_[hb_info.sender()]
+             << " state:" << HeartBeatInfo::State_Name(hb_info.state())
+             << " key version:" << hb_info.key_version();
 
   if (request->region_info().region_id() ==
-      config_.GetConfigData().self_region_id()) {
+      config_.GetSelfRegionId()) {
     if (config_.GetPublicKeyCertificateInfo()
             .public_key()
             .public_key_info()
@@ -251,7 +323,7 @@ int ConsensusManager::ProcessHeartBeat(std::unique_ptr<Context> context,
       continue;
     }
     if (request->region_info().region_id() !=
-        config_.GetConfigData().self_region_id()) {
+        config_.GetSelfRegionId()) {
       // LOG(ERROR) << "key from other region:"
       //           << request->region_info().region_id();
       continue;
@@ -279,6 +351,17 @@ int ConsensusManager::ProcessHeartBeat(std::unique_ptr<Context> context,
     }
   }
 
+  // The peer states drive the key exchange and the replica states, so they
+  // are only taken from replicas which signed their heartbeat.
+  PeerState* peer = nullptr;
+  ReplicaInfo sender_info;
+  sender_info.set_id(hb_info.sender());
+  if (ReplicaExisted(sender_info, replicas) &&
+      IsSignedBy(context.get(), hb_info.sender())) {
+    peer = &peers_[hb_info.sender()];
+    UpdatePeerState(hb_info, peer);
+  }
+
   if (!hb_info.ip().empty() && hb_info.hb_version() > 0 &&
       hb_[hb_info.sender()] != hb_info.hb_version()) {
     ReplicaInfo info;
@@ -287,6 +370,12 @@ int ConsensusManager::ProcessHeartBeat(std::unique_ptr<Context> context,
     info.set_id(hb_info.sender());
     // bc_client_->Flush(info);
     hb_[hb_info.sender()] = hb_info.hb_version();
+    // The sender has restarted and lost the keys.
+    if (peer != nullptr) {
+      peer->acked_key_version = 0;
+    } else if (ReplicaExisted(info, GetClientReplicas())) {
+      send_keys_to_clients_ = true;
+    }
     SendHeartBeat();
   }
 
@@ -299,6 +388,41 @@ int ConsensusManager::ProcessHeartBeat(std::unique_ptr<Context> context,
   return 0;
 }
 
+bool ConsensusManager::IsSignedBy(const Context* context, int64_t node_id) {
+  if (verifier_ == nullptr || config_.NotNeedSignature()) {
+    // Nothing is signed, so there is nothing to check either.
+    return true;
+  }
+  if (context == nullptr || context->signature.node_id() != node_id) {
+    return false;
+  }
+  return verifier_->VerifyMessage(context->signed_data, context->signature);
+}
+
+void ConsensusManager::UpdatePeerState(const HeartBeatInfo& hb_info,
+                                       PeerState* peer) {
+  uint64_t now = GetCurrentTime();
+  peer->state = hb_info.state();
+  if (hb_info.timestamp() > 0) {
+    peer->timestamp = hb_info.timestamp();
+    peer->recv_time = now;
+  }
+  for (const auto& peer_info : hb_info.peers()) {
+    if (peer_info.node_id() != config_.GetSelfInfo().id()) {
+      continue;
+    }
+    peer->acked_key_version = peer_info.key_version();
+    // The timestamp is our own, so the clocks do not need to be in sync.
+    if (peer_info.timestamp() > 0 &&
+        now >= peer_info.timestamp() + peer_info.delay()) {
+      peer->rtt = now - peer_info.timestamp() - peer_info.delay();
+    }
+  }
+  if (hb_info.public_keys_size() > 0) {
+    peer->key_version = hb_info.key_version();
+  }
+}
+
 int ConsensusManager::ConsensusCommit(std::unique_ptr<Context> context,
                                       std::unique_ptr<Request> request) {
   return -1;
@@ -309,9 +433,9 @@ std::vector<ReplicaInfo> ConsensusManager::GetClientReplicas() {
 }
 
 std::vector<ReplicaInfo> ConsensusManager::GetAllReplicas() {
-  auto config_data = config_.GetConfigData();
+  auto config_data = config_.GetSnapshot()->config_data;
   std::vector<ReplicaInfo> ret;
-  for (const auto& r : config_data.region()) {
+  for (const auto& r : config_data->region()) {
     for (const auto& replica : r.replica_info()) {
       ret.push_back(replica);
     }
@@ -351,7 +475,7 @@ std::unique_ptr<ReplicaCommunicator> ConsensusManager::GetReplicaClient(
     const std::vector<ReplicaInfo>& replicas, bool is_use_long_conn) {
   return std::make_unique<ReplicaCommunicator>(
       replicas,
-      verifier_ == nullptr || config_.GetConfigData().not_need_signature()
+      verifier_ == nullptr || config_.NotNeedSignature()
           ? nullptr
           : verifier_.get(),
       is_use_long_conn, config_.GetOutputWorkerNum(), config_.GetTcpBatchNum());
@@ -361,6 +485,7 @@ void ConsensusManager::AddNewReplica(const ReplicaInfo& info) {}
 
 void ConsensusManager::AddNewClient(const ReplicaInfo& info) {
   clients_.push_back(info);
+  send_keys_to_clients_ = true;
   bc_client_->UpdateClientReplicas(clients_);
 }
 
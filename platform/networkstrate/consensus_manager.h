@@ -48,6 +48,17 @@ class ConsensusManager : public ServiceInterface {
   bool IsReady() const;
   void Stop();
 
+  // A recovering replica accepts messages and sends heartbeats, but only
+  // takes part in the consensus once it has replayed its own logs. It does
+  // not wait for its peers: what it missed while down is fetched later by
+  // the checkpoint catch-up, if checkpoints are enabled.
+  bool IsRecovering() const;
+  // The state a replica advertised in its last heartbeat.
+  HeartBeatInfo::State GetReplicaState(int64_t node_id);
+  // The round trip time to a replica measured by the heartbeats, in us.
+  // Returns 0 if it has not been measured yet.
+  uint64_t GetReplicaRtt(int64_t node_id);
+
   // Should be called by the instance or test.
   void Start();
 
@@ -87,6 +98,9 @@ class ConsensusManager : public ServiceInterface {
 
   SignatureVerifier* GetSignatureVerifier();
 
+  // Leaving the recovering state is advertised right away.
+  void SetRecovering(bool is_recovering);
+
  private:
   void HeartBeat();
   void SendHeartBeat();
@@ -103,11 +117,32 @@ class ConsensusManager : public ServiceInterface {
  private:
   std::thread heartbeat_thread_;
   std::atomic<bool> is_ready_ = false;
+  std::atomic<bool> is_recovering_ = false;
   std::unique_ptr<ReplicaCommunicator> bc_client_;
   std::vector<ReplicaInfo> clients_;
   Stats* global_stats_;
   uint64_t version_;
   std::map<int, uint64_t> hb_;
+  // What the heartbeats tell about each peer.
+  struct PeerState {
+    HeartBeatInfo::State state = HeartBeatInfo::READY;
+    // The version of the peer's key set we hold.
+    uint64_t key_version = 0;
+    // The version of our key set the peer holds.
+    uint64_t acked_key_version = 0;
+    // The timestamp of the peer's last heartbeat and when we got it.
+    uint64_t timestamp = 0;
+    uint64_t recv_time = 0;
+    uint64_t rtt = 0;
+  };
+  bool IsSignedBy(const Context* context, int64_t node_id);
+  void UpdatePeerState(const HeartBeatInfo& hb_info, PeerState* peer);
+  // Keyed by the signer of the heartbeats, replicas only.
+  std::map<int64_t, PeerState> peers_;
+  // Set when a client may not hold our key set.
+  std::atomic<bool> send_keys_to_clients_ = false;
+  // The version of the key set in the last heartbeat carrying the keys.
+  uint64_t sent_key_version_ = 0;
   std::mutex hb_mutex_;
 };
 
@@ -24,6 +24,7 @@
 #include <future>
 
 #include "common/test/test_macros.h"
+#include "common/utils/utils.h"
 #include "platform/networkstrate/mock_replica_communicator.h"
 
 namespace resdb {
@@ -67,6 +68,10 @@ class MockConsensusManager : public ConsensusManager {
     return ConsensusManager::GetBroadCastClient();
   }
 
+  void SetRecovering(bool is_recovering) {
+    return ConsensusManager::SetRecovering(is_recovering);
+  }
+
  public:
   int Dispatch(std::unique_ptr<Context> context,
                std::unique_ptr<Request> request) {
@@ -124,6 +129,75 @@ TEST_F(ConsensusManagerTest, SendHB) {
   hb_done.get();
 }
 
+TEST_F(ConsensusManagerTest, SendHBWhenRecovering) {
+  std::promise<HeartBeatInfo::State> hb;
+  std::future<HeartBeatInfo::State> hb_done = hb.get_future();
+  EXPECT_CALL(*impl_, GetReplicaClient)
+      .Times(AtLeast(1))
+      .WillRepeatedly(
+          Invoke([&](const std::vector<ReplicaInfo>& replicas, bool) {
+            auto client = std::make_unique<MockReplicaCommunicator>(replicas);
+            EXPECT_CALL(*client, SendHeartBeat)
+                .WillRepeatedly(Invoke([&](const Request& request) {
+                  HeartBeatInfo hb_info;
+                  EXPECT_TRUE(hb_info.ParseFromString(request.data()));
+                  try {
+                    hb.set_value(hb_info.state());
+                  } catch (...) {
+                  }
+                  return 0;
+                }));
+            return client;
+          }));
+  impl_->SetRecovering(true);
+  EXPECT_TRUE(impl_->IsRecovering());
+  impl_->Start();
+  EXPECT_EQ(hb_done.get(), HeartBeatInfo::RECOVERING);
+}
+
+TEST_F(ConsensusManagerTest, SendKeysOnlyOnNewVersion) {
+  std::promise<bool> first_hb, second_hb;
+  std::future<bool> first_hb_done = first_hb.get_future();
+  std::future<bool> second_hb_done = second_hb.get_future();
+  int hb_num = 0;
+  EXPECT_CALL(*impl_, GetReplicaClient)
+      .Times(AtLeast(1))
+      .WillRepeatedly(
+          Invoke([&](const std::vector<ReplicaInfo>& replicas, bool) {
+            auto client = std::make_unique<MockReplicaCommunicator>(replicas);
+            EXPECT_CALL(*client, SendHeartBeat)
+                .WillRepeatedly(Invoke([&](const Request& request) {
+                  HeartBeatInfo hb_info;
+                  EXPECT_TRUE(hb_info.ParseFromString(request.data()));
+                  EXPECT_GT(hb_info.key_version(), 0u);
+                  hb_num++;
+                  if (hb_num == 1) {
+                    first_hb.set_value(hb_info.public_keys_size() > 0);
+                  } else if (hb_num == 2) {
+                    second_hb.set_value(hb_info.public_keys_size() > 0);
+                  }
+                  return 0;
+                }));
+            return client;
+          }));
+  impl_->Start();
+  EXPECT_TRUE(first_hb_done.get());
+
+  // A heartbeat from a new peer triggers another one, which does not need
+  // to carry the keys again.
+  HeartBeatInfo hb;
+  hb.set_sender(2);
+  hb.set_ip("127.0.0.1");
+  hb.set_port(1236);
+  hb.set_hb_version(1);
+  auto request = std::make_unique<Request>();
+  request->set_type(Request::TYPE_HEART_BEAT);
+  hb.SerializeToString(request->mutable_data());
+  EXPECT_EQ(impl_->Dispatch(std::make_unique<Context>(), std::move(request)),
+            0);
+  EXPECT_FALSE(second_hb_done.get());
+}
+
 TEST_F(ConsensusManagerTest, SendHBToClient) {
   std::promise<bool> hb;
   std::future<bool> hb_done = hb.get_future();
@@ -272,6 +346,90 @@ TEST_F(ConsensusManagerTest, DiscoverNewClient) {
   EXPECT_EQ(client_infos.size(), 1);
 }
 
+TEST_F(ConsensusManagerTest, ReplicaState) {
+  config_.SetSignatureVerifierEnabled(false);
+  impl_ = std::make_unique<MockConsensusManager>(config_);
+  replicas_[1].set_id(2);
+  ON_CALL(*impl_, GetReplicas).WillByDefault(Return(replicas_));
+  impl_->Start();
+
+  HeartBeatInfo hb;
+  hb.set_sender(2);
+  hb.set_state(HeartBeatInfo::RECOVERING);
+
+  auto request = std::make_unique<Request>();
+  request->set_type(Request::TYPE_HEART_BEAT);
+  hb.SerializeToString(request->mutable_data());
+  EXPECT_EQ(impl_->Dispatch(std::make_unique<Context>(), std::move(request)),
+            0);
+
+  EXPECT_EQ(impl_->GetReplicaState(2), HeartBeatInfo::RECOVERING);
+  EXPECT_EQ(impl_->GetReplicaState(3), HeartBeatInfo::READY);
+}
+
+TEST_F(ConsensusManagerTest, ReplicaRtt) {
+  config_.SetSignatureVerifierEnabled(false);
+  impl_ = std::make_unique<MockConsensusManager>(config_);
+  replicas_[1].set_id(2);
+  ON_CALL(*impl_, GetReplicas).WillByDefault(Return(replicas_));
+  impl_->Start();
+
+  // The peer echoes a heartbeat we sent 10ms ago which it held for 2ms.
+  HeartBeatInfo hb;
+  hb.set_sender(2);
+  hb.set_timestamp(GetCurrentTime());
+  auto* peer_info = hb.add_peers();
+  peer_info->set_node_id(self_info_.id());
+  peer_info->set_timestamp(GetCurrentTime() - 10000);
+  peer_info->set_delay(2000);
+
+  auto request = std::make_unique<Request>();
+  request->set_type(Request::TYPE_HEART_BEAT);
+  hb.SerializeToString(request->mutable_data());
+  EXPECT_EQ(impl_->Dispatch(std::make_unique<Context>(), std::move(request)),
+            0);
+
+  EXPECT_GE(impl_->GetReplicaRtt(2), 8000u);
+  EXPECT_LT(impl_->GetReplicaRtt(2), 1000000u);
+  EXPECT_EQ(impl_->GetReplicaRtt(3), 0u);
+}
+
+TEST_F(ConsensusManagerTest, IgnoreStateFromNonReplica) {
+  config_.SetSignatureVerifierEnabled(false);
+  impl_ = std::make_unique<MockConsensusManager>(config_);
+  ON_CALL(*impl_, GetReplicas).WillByDefault(Return(replicas_));
+  impl_->Start();
+
+  HeartBeatInfo hb;
+  hb.set_sender(5);
+  hb.set_state(HeartBeatInfo::RECOVERING);
+
+  auto request = std::make_unique<Request>();
+  request->set_type(Request::TYPE_HEART_BEAT);
+  hb.SerializeToString(request->mutable_data());
+  EXPECT_EQ(impl_->Dispatch(std::make_unique<Context>(), std::move(request)),
+            0);
+
+  EXPECT_EQ(impl_->GetReplicaState(5), HeartBeatInfo::READY);
+}
+
+TEST_F(ConsensusManagerTest, IgnoreStateFromUnsignedHeartBeat) {
+  replicas_[1].set_id(2);
+  ON_CALL(*impl_, GetReplicas).WillByDefault(Return(replicas_));
+
+  HeartBeatInfo hb;
+  hb.set_sender(2);
+  hb.set_state(HeartBeatInfo::RECOVERING);
+
+  auto request = std::make_unique<Request>();
+  request->set_type(Request::TYPE_HEART_BEAT);
+  hb.SerializeToString(request->mutable_data());
+  EXPECT_EQ(impl_->Dispatch(std::make_unique<Context>(), std::move(request)),
+            0);
+
+  EXPECT_EQ(impl_->GetReplicaState(2), HeartBeatInfo::READY);
+}
+
 TEST_F(ConsensusManagerTest, DispatchOK) {
   Request expected_request;
   expected_request.set_type(Request::TYPE_CLIENT_REQUEST);
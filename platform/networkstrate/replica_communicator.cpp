@@ -94,6 +94,9 @@ int ReplicaCommunicator::SendHeartBeat(const Request& hb_info) {
   int ret = 0;
   for (const auto& replica : replicas_) {
     NetChannel client(replica.ip(), replica.port());
+    // Receivers only trust what a heartbeat says about its sender once the
+    // signature checks out.
+    client.SetSignatureVerifier(verifier_);
     if (client.SendRawMessage(hb_info) == 0) {
       ret++;
     }
@@ -171,27 +174,29 @@ void ReplicaCommunicator::StartSingleInBackGround(const std::string& ip, int por
 
 int ReplicaCommunicator::SendSingleMessage(const google::protobuf::Message& message, 
 const ReplicaInfo& replica_info) {
-
-  std::string ip = replica_info.ip();
-  int port = replica_info.port();
-
-    //LOG(ERROR)<<" send msg ip:"<<ip<<" port:"<<port;
   global_stats_->BroadCastMsg();
   if (is_use_long_conn_) {
     auto item = std::make_unique<QueueItem>();
     item->data = NetChannel::GetRawMessageString(message, verifier_);
-    std::lock_guard<std::mutex> lk(smutex_);
-    if(single_bq_.find(std::make_pair(ip, port)) == single_bq_.end()){
-      StartSingleInBackGround(ip, port);
-    }
-    assert(single_bq_[std::make_pair(ip, port)] != nullptr);
-    single_bq_[std::make_pair(ip, port)]->Push(std::move(item));
+    PushSingle(replica_info, std::move(item));
     return 0;
   } else {
     return SendMessageInternal(message, replicas_);
   }
 }
 
+void ReplicaCommunicator::PushSingle(const ReplicaInfo& replica_info,
+                                     std::unique_ptr<QueueItem> item) {
+  std::string ip = replica_info.ip();
+  int port = replica_info.port();
+  std::lock_guard<std::mutex> lk(smutex_);
+  if(single_bq_.find(std::make_pair(ip, port)) == single_bq_.end()){
+    StartSingleInBackGround(ip, port);
+  }
+  assert(single_bq_[std::make_pair(ip, port)] != nullptr);
+  single_bq_[std::make_pair(ip, port)]->Push(std::move(item));
+}
+
 int ReplicaCommunicator::SendMessage(const google::protobuf::Message& message) {
   global_stats_->BroadCastMsg();
   if (is_use_long_conn_) {
@@ -463,8 +468,55 @@ void ReplicaCommunicator::BroadCast(const google::protobuf::Message& message) {
   }
 }
 
+void ReplicaCommunicator::BroadCastRequest(
+    const Request& header, const google::protobuf::Message& message) {
+  if (!is_use_long_conn_) {
+    Request request(header);
+    message.SerializeToString(request.mutable_data());
+    BroadCast(request);
+    return;
+  }
+  global_stats_->BroadCastMsg();
+  auto item = std::make_unique<QueueItem>();
+  item->data = NetChannel::GetRawRequestString(header, message, verifier_);
+  batch_queue_.Push(std::move(item));
+}
+
+void ReplicaCommunicator::SendRequest(const Request& header,
+                                      const google::protobuf::Message& message,
+                                      int64_t node_id) {
+  if (!is_use_long_conn_) {
+    Request request(header);
+    message.SerializeToString(request.mutable_data());
+    SendMessage(request, node_id);
+    return;
+  }
+  ReplicaInfo target_replica = GetReplicaInfo(node_id);
+  if (target_replica.ip().empty()) {
+    LOG(ERROR) << "no replica info";
+    return;
+  }
+  global_stats_->BroadCastMsg();
+  auto item = std::make_unique<QueueItem>();
+  item->data = NetChannel::GetRawRequestString(header, message, verifier_);
+  PushSingle(target_replica, std::move(item));
+}
+
 void ReplicaCommunicator::SendMessage(const google::protobuf::Message& message,
                                       int64_t node_id) {
+  ReplicaInfo target_replica = GetReplicaInfo(node_id);
+  if (target_replica.ip().empty()) {
+    LOG(ERROR) << "no replica info";
+    return;
+  }
+
+  int ret = SendMessage(message, target_replica);
+  if (ret < 0) {
+    LOG(ERROR) << "broadcast request fail:";
+  }
+}
+
+ReplicaInfo ReplicaCommunicator::GetReplicaInfo(int64_t node_id) {
   ReplicaInfo target_replica;
   for (const auto& replica : replicas_) {
     if (replica.id() == node_id) {
@@ -480,16 +532,7 @@ void ReplicaCommunicator::SendMessage(const google::protobuf::Message& message,
       }
     }
   }
-
-  if (target_replica.ip().empty()) {
-    LOG(ERROR) << "no replica info";
-    return;
-  }
-
-  int ret = SendMessage(message, target_replica);
-  if (ret < 0) {
-    LOG(ERROR) << "broadcast request fail:";
-  }
+  return target_replica;
 }
 
 }  // namespace resdb
@@ -59,6 +59,15 @@ class ReplicaCommunicator {
       const std::vector<std::unique_ptr<Request>>& messages,
       const ReplicaInfo& replica_info);
 
+  // Same as BroadCast() and SendMessage(message, node_id) for a Request
+  // built from header with message as its data. message is serialized
+  // into the outgoing frame directly.
+  virtual void BroadCastRequest(const Request& header,
+                                const google::protobuf::Message& message);
+  virtual void SendRequest(const Request& header,
+                           const google::protobuf::Message& message,
+                           int64_t node_id);
+
   // /**
   // * Broadcasts a message to all nodes in a specified shard, it shard_id is not provided
   // * Use current shard to commence broadcast
@@ -156,6 +165,8 @@ class ReplicaCommunicator {
   int SendSingleMessage(const google::protobuf::Message& message, 
       const ReplicaInfo& replica_info);
 
+  ReplicaInfo GetReplicaInfo(int64_t node_id);
+
  private:
   std::vector<ReplicaInfo> replicas_;
   SignatureVerifier* verifier_;
@@ -167,6 +178,9 @@ class ReplicaCommunicator {
     std::string data;
     std::vector<ReplicaInfo> dest_replicas;
   };
+  void PushSingle(const ReplicaInfo& replica_info,
+                  std::unique_ptr<QueueItem> item);
+
   BatchQueue<std::unique_ptr<QueueItem>> batch_queue_;
   bool is_use_long_conn_ = false;
 
@@ -27,6 +27,9 @@ namespace resdb {
 struct Context {
   std::unique_ptr<NetChannel> client;
   SignatureInfo signature;
+  // The bytes the signature was checked against, so the message can be
+  // passed on to others with the signature of its sender.
+  std::string signed_data;
 };
 
 }  // namespace resdb
@@ -51,6 +51,14 @@ ServiceNetwork::ServiceNetwork(const ResDBConfig& config,
       std::bind(&ServiceNetwork::AcceptorHandler, this, std::placeholders::_1,
                 std::placeholders::_2));
   async_acceptor_->StartAccept();
+
+  int async_client_port = config_.GetConfigData().async_client_port();
+  if (async_client_port > 0) {
+    async_client_acceptor_ = std::make_unique<AsyncClientAcceptor>(
+        config.GetSelfInfo().ip(), async_client_port,
+        config.GetInputWorkerNum(), &input_queue_);
+    async_client_acceptor_->StartAccept();
+  }
   global_stats_ = Stats::GetGlobalStats();
 }
 
@@ -133,6 +141,9 @@ bool ServiceNetwork::IsRunning() { return service_->IsRunning(); }
 
 void ServiceNetwork::Stop() {
   acceptor_->Stop();
+  if (async_client_acceptor_) {
+    async_client_acceptor_->Stop();
+  }
   service_->Stop();
 }
 
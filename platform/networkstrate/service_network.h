@@ -27,6 +27,7 @@
 #include "platform/networkstrate/async_acceptor.h"
 #include "platform/networkstrate/service_interface.h"
 #include "platform/rdbc/acceptor.h"
+#include "platform/rdbc/async_client_acceptor.h"
 #include "platform/statistic/stats.h"
 
 namespace resdb {
@@ -61,6 +62,7 @@ class ServiceNetwork {
   bool is_running = false;
   LockFreeQueue<QueueItem> input_queue_, resp_queue_;
   std::unique_ptr<AsyncAcceptor> async_acceptor_;
+  std::unique_ptr<AsyncClientAcceptor> async_client_acceptor_;
   ResDBConfig config_;
   Stats* global_stats_;
 };
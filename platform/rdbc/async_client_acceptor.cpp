@@ -0,0 +1,283 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/rdbc/async_client_acceptor.h"
+
+#include <glog/logging.h>
+
+#include <deque>
+#include <mutex>
+
+#include "platform/common/network/frame.h"
+
+namespace resdb {
+
+namespace {
+
+// Frames larger than this are treated as a broken connection.
+constexpr uint64_t kMaxDataLen = 1ull << 30;
+
+}  // namespace
+
+// Keeps the receive buffers of the small requests for reuse. Larger ones
+// are allocated and freed as before.
+class AsyncClientAcceptor::BufferPool {
+ public:
+  ~BufferPool() {
+    for (void* buff : buffers_) {
+      free(buff);
+    }
+  }
+
+  void* Get(size_t len) {
+    if (len > kBufferSize) {
+      return malloc(len);
+    }
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (buffers_.empty()) {
+      return malloc(kBufferSize);
+    }
+    void* buff = buffers_.back();
+    buffers_.pop_back();
+    return buff;
+  }
+
+  void Put(void* buff, size_t len) {
+    if (len <= kBufferSize) {
+      std::lock_guard<std::mutex> lk(mutex_);
+      if (buffers_.size() < kMaxBuffers) {
+        buffers_.push_back(buff);
+        return;
+      }
+    }
+    free(buff);
+  }
+
+ private:
+  static constexpr size_t kBufferSize = 16 << 10;
+  static constexpr size_t kMaxBuffers = 4096;
+  std::mutex mutex_;
+  std::vector<void*> buffers_;
+};
+
+// The socket given to the service along with a request. Sending on it
+// writes the response of that request to its connection.
+class AsyncClientAcceptor::SessionSocket : public Socket {
+ public:
+  SessionSocket(std::shared_ptr<Session> session, uint64_t request_id)
+      : session_(session), request_id_(request_id) {}
+
+  int Send(const std::string& data) override;
+
+  int Recv(void** buf, size_t* len) override { return -1; }
+  int Connect(const std::string& ip, int port) override { return -1; }
+  int Listen(const std::string& ip, int port) override { return -1; }
+  void ReInit() override {}
+  void Close() override {}
+  std::unique_ptr<Socket> Accept() override { return nullptr; }
+  int GetBindingPort() override { return 0; }
+
+ private:
+  std::shared_ptr<Session> session_;
+  uint64_t request_id_;
+};
+
+// One client connection. It reads the requests one after another and writes
+// the responses in the order they are ready. All the socket operations run
+// on the strand, so the workers only hand the responses over.
+class AsyncClientAcceptor::Session
+    : public std::enable_shared_from_this<Session> {
+ public:
+  Session(boost::asio::io_service* io_service,
+          std::shared_ptr<BufferPool> buffer_pool,
+          LockFreeQueue<QueueItem>* input_queue, Stats* global_stats)
+      : socket_(*io_service),
+        strand_(*io_service),
+        buffer_pool_(buffer_pool),
+        input_queue_(input_queue),
+        global_stats_(global_stats) {}
+
+  boost::asio::ip::tcp::socket* GetSocket() { return &socket_; }
+
+  void Start() {
+    boost::system::error_code ec;
+    socket_.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+    strand_.post([self = shared_from_this()]() { self->ReadHeader(); });
+  }
+
+  int Write(uint64_t request_id, const std::string& data) {
+    if (closed_) {
+      return -1;
+    }
+    std::string frame(kRequestFrameHeaderSize, 0);
+    EncodeRequestFrameHeader(data.size(), request_id, frame.data());
+    frame.append(data);
+    strand_.post(
+        [self = shared_from_this(), frame = std::move(frame)]() mutable {
+          self->write_queue_.push_back(std::move(frame));
+          if (self->write_queue_.size() == 1) {
+            self->WriteNext();
+          }
+        });
+    return 0;
+  }
+
+ private:
+  void ReadHeader() {
+    boost::asio::async_read(
+        socket_, boost::asio::buffer(header_, sizeof(header_)),
+        strand_.wrap([self = shared_from_this()](
+                         const boost::system::error_code& ec, size_t) {
+          if (ec) {
+            self->Close();
+            return;
+          }
+          DecodeRequestFrameHeader(self->header_, &self->data_len_,
+                                   &self->request_id_);
+          if (self->data_len_ == 0 || self->data_len_ > kMaxDataLen) {
+            LOG(ERROR) << "read data size:" << self->data_len_
+                       << " close socket";
+            self->Close();
+            return;
+          }
+          self->ReadData();
+        }));
+  }
+
+  void ReadData() {
+    size_t data_len = data_len_;
+    void* buff = buffer_pool_->Get(data_len);
+    boost::asio::async_read(
+        socket_, boost::asio::buffer(buff, data_len),
+        strand_.wrap([self = shared_from_this(), buff, data_len](
+                         const boost::system::error_code& ec, size_t) {
+          if (ec) {
+            self->buffer_pool_->Put(buff, data_len);
+            self->Close();
+            return;
+          }
+          auto data = std::make_unique<DataInfo>();
+          data->buff = buff;
+          data->data_len = data_len;
+          data->release = [buffer_pool = self->buffer_pool_,
+                           data_len](void* buff) {
+            buffer_pool->Put(buff, data_len);
+          };
+          auto item = std::make_unique<QueueItem>();
+          item->socket =
+              std::make_unique<SessionSocket>(self, self->request_id_);
+          item->data = std::move(data);
+          self->global_stats_->ServerCall();
+          self->input_queue_->Push(std::move(item));
+          // Read the next request without waiting for the response.
+          self->ReadHeader();
+        }));
+  }
+
+  void WriteNext() {
+    boost::asio::async_write(
+        socket_, boost::asio::buffer(write_queue_.front()),
+        strand_.wrap([self = shared_from_this()](
+                         const boost::system::error_code& ec, size_t) {
+          if (ec) {
+            self->Close();
+            return;
+          }
+          self->write_queue_.pop_front();
+          if (!self->write_queue_.empty()) {
+            self->WriteNext();
+          }
+        }));
+  }
+
+  void Close() {
+    closed_ = true;
+    boost::system::error_code ec;
+    socket_.close(ec);
+  }
+
+ private:
+  boost::asio::ip::tcp::socket socket_;
+  boost::asio::io_service::strand strand_;
+  std::shared_ptr<BufferPool> buffer_pool_;
+  LockFreeQueue<QueueItem>* input_queue_;
+  Stats* global_stats_;
+  char header_[kRequestFrameHeaderSize];
+  uint64_t data_len_ = 0;
+  uint64_t request_id_ = 0;
+  std::deque<std::string> write_queue_;
+  std::atomic<bool> closed_ = false;
+};
+
+int AsyncClientAcceptor::SessionSocket::Send(const std::string& data) {
+  return session_->Write(request_id_, data);
+}
+
+AsyncClientAcceptor::AsyncClientAcceptor(const std::string& ip, int port,
+                                         int thread_num,
+                                         LockFreeQueue<QueueItem>* input_queue)
+    : acceptor_(io_service_,
+                boost::asio::ip::tcp::endpoint(
+                    boost::asio::ip::address::from_string(ip), port)),
+      buffer_pool_(std::make_shared<BufferPool>()),
+      input_queue_(input_queue),
+      global_stats_(Stats::GetGlobalStats()) {
+  LOG(ERROR) << "listen clients on ip:" << ip << " port:" << port;
+  worker_ = std::make_unique<boost::asio::io_service::work>(io_service_);
+  for (int i = 0; i < thread_num; ++i) {
+    worker_threads_.push_back(std::thread([&]() { io_service_.run(); }));
+  }
+}
+
+AsyncClientAcceptor::~AsyncClientAcceptor() { Stop(); }
+
+void AsyncClientAcceptor::StartAccept() {
+  auto session = std::make_shared<Session>(&io_service_, buffer_pool_,
+                                           input_queue_, global_stats_);
+  acceptor_.async_accept(*session->GetSocket(),
+                         std::bind(&AsyncClientAcceptor::OnAccept, this,
+                                   session, std::placeholders::_1));
+}
+
+void AsyncClientAcceptor::OnAccept(std::shared_ptr<Session> session,
+                                   const boost::system::error_code& ec) {
+  if (ec) {
+    if (ec != boost::asio::error::operation_aborted) {
+      LOG(ERROR) << "accept fail:" << ec.message();
+      StartAccept();
+    }
+    return;
+  }
+  StartAccept();  // Add the next accept event.
+  session->Start();
+}
+
+void AsyncClientAcceptor::Stop() {
+  boost::system::error_code ec;
+  acceptor_.close(ec);
+  worker_.reset();
+  io_service_.stop();
+  for (auto& worker : worker_threads_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+}  // namespace resdb
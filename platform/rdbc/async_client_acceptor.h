@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+#include <boost/asio.hpp>
+#include <memory>
+#include <thread>
+
+#include "platform/common/data_comm/network_comm.h"
+#include "platform/common/queue/lock_free_queue.h"
+#include "platform/statistic/stats.h"
+
+namespace resdb {
+
+// AsyncClientAcceptor serves the clients on long-lived connections from a
+// few event-driven threads. A client may send many requests on one
+// connection without waiting for their responses. Each frame, in both
+// directions, is a request frame (see frame.h): the data length and the
+// request id, then the data. The response to a request carries its id, so
+// the responses may come back in any order. AsyncClientChannel is the client
+// side.
+//
+// Like Acceptor, it pushes the requests to input_queue. The socket of each
+// QueueItem sends the response back on the connection the request came from.
+class AsyncClientAcceptor {
+ public:
+  AsyncClientAcceptor(const std::string& ip, int port, int thread_num,
+                      LockFreeQueue<QueueItem>* input_queue);
+  ~AsyncClientAcceptor();
+
+  void StartAccept();
+  void Stop();
+
+ private:
+  class BufferPool;
+  class Session;
+  class SessionSocket;
+
+  void OnAccept(std::shared_ptr<Session> session,
+                const boost::system::error_code& ec);
+
+ private:
+  boost::asio::io_service io_service_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  std::unique_ptr<boost::asio::io_service::work> worker_;
+  std::vector<std::thread> worker_threads_;
+  // Shared with the requests, which may outlive the acceptor.
+  std::shared_ptr<BufferPool> buffer_pool_;
+  LockFreeQueue<QueueItem>* input_queue_;
+  Stats* global_stats_;
+};
+
+}  // namespace resdb
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "platform/rdbc/async_client_acceptor.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "platform/common/network/frame.h"
+
+namespace resdb {
+namespace {
+
+using boost::asio::ip::tcp;
+void SendFrame(tcp::socket* socket, uint64_t request_id,
+               const std::string& data) {
+  char header[kRequestFrameHeaderSize];
+  EncodeRequestFrameHeader(data.size(), request_id, header);
+  boost::asio::write(*socket, boost::asio::buffer(header, sizeof(header)));
+  boost::asio::write(*socket, boost::asio::buffer(data));
+}
+
+std::pair<uint64_t, std::string> RecvFrame(tcp::socket* socket) {
+  char header[kRequestFrameHeaderSize];
+  boost::asio::read(*socket, boost::asio::buffer(header, sizeof(header)));
+  uint64_t data_len = 0, request_id = 0;
+  DecodeRequestFrameHeader(header, &data_len, &request_id);
+  std::string data(data_len, 0);
+  boost::asio::read(*socket, boost::asio::buffer(data.data(), data.size()));
+  return std::make_pair(request_id, data);
+}
+
+std::unique_ptr<QueueItem> PopItem(LockFreeQueue<QueueItem>* queue) {
+  for (int i = 0; i < 100; ++i) {
+    auto item = queue->Pop(100);
+    if (item != nullptr) {
+      return item;
+    }
+  }
+  return nullptr;
+}
+
+class AsyncClientAcceptorTest : public ::testing::Test {
+ protected:
+  AsyncClientAcceptorTest()
+      : acceptor_("127.0.0.1", 1250, 2, &input_queue_), socket_(io_service_) {
+    acceptor_.StartAccept();
+    socket_.connect(tcp::endpoint(
+        boost::asio::ip::address::from_string("127.0.0.1"), 1250));
+  }
+
+ protected:
+  LockFreeQueue<QueueItem> input_queue_;
+  AsyncClientAcceptor acceptor_;
+  boost::asio::io_service io_service_;
+  tcp::socket socket_;
+};
+
+TEST_F(AsyncClientAcceptorTest, RecvRequests) {
+  SendFrame(&socket_, 1, "request_1");
+  SendFrame(&socket_, 2, "request_2");
+
+  for (int i = 1; i <= 2; ++i) {
+    auto item = PopItem(&input_queue_);
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(std::string(static_cast<char*>(item->data->buff),
+                          item->data->data_len),
+              "request_" + std::to_string(i));
+  }
+}
+
+TEST_F(AsyncClientAcceptorTest, OutOfOrderResponses) {
+  SendFrame(&socket_, 1, "request_1");
+  SendFrame(&socket_, 2, "request_2");
+
+  auto item_1 = PopItem(&input_queue_);
+  auto item_2 = PopItem(&input_queue_);
+  ASSERT_NE(item_1, nullptr);
+  ASSERT_NE(item_2, nullptr);
+
+  EXPECT_EQ(item_2->socket->Send("response_2"), 0);
+  EXPECT_EQ(item_1->socket->Send("response_1"), 0);
+
+  auto response = RecvFrame(&socket_);
+  EXPECT_EQ(response.first, 2u);
+  EXPECT_EQ(response.second, "response_2");
+  response = RecvFrame(&socket_);
+  EXPECT_EQ(response.first, 1u);
+  EXPECT_EQ(response.second, "response_1");
+}
+
+TEST_F(AsyncClientAcceptorTest, RespondAfterClose) {
+  SendFrame(&socket_, 1, "request_1");
+  auto item = PopItem(&input_queue_);
+  ASSERT_NE(item, nullptr);
+
+  socket_.close();
+  // The response is dropped once the server sees the connection closed.
+  for (int i = 0; i < 100 && item->socket->Send("response_1") == 0; ++i) {
+    usleep(10000);
+  }
+  EXPECT_EQ(item->socket->Send("response_1"), -1);
+}
+
+}  // namespace
+
+}  // namespace resdb
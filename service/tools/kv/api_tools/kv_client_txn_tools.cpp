@@ -19,16 +19,16 @@
 
 #include <glog/logging.h>
 
-#include "interface/common/resdb_txn_accessor.h"
+#include "interface/common/async_txn_accessor.h"
 #include "platform/config/resdb_config_utils.h"
 #include "proto/kv/kv.pb.h"
 
+using resdb::AsyncResDBTxnAccessor;
 using resdb::BatchUserRequest;
 using resdb::GenerateResDBConfig;
 using resdb::KVRequest;
 using resdb::Request;
 using resdb::ResDBConfig;
-using resdb::ResDBTxnAccessor;
 
 int main(int argc, char** argv) {
   if (argc < 2) {
@@ -47,7 +47,7 @@ int main(int argc, char** argv) {
 
   ResDBConfig config = GenerateResDBConfig(config_file);
 
-  ResDBTxnAccessor client(config);
+  AsyncResDBTxnAccessor client(config);
   auto resp = client.GetTxn(min_seq, max_seq);
   if (!resp.ok()) {
     LOG(ERROR) << "get replica state fail";
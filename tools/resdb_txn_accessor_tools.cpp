@@ -19,13 +19,13 @@
 
 #include <glog/logging.h>
 
-#include "interface/common/resdb_txn_accessor.h"
+#include "interface/common/async_txn_accessor.h"
 #include "platform/config/resdb_config_utils.h"
 
+using resdb::AsyncResDBTxnAccessor;
 using resdb::GenerateReplicaInfo;
 using resdb::ReplicaInfo;
 using resdb::ResDBConfig;
-using resdb::ResDBTxnAccessor;
 
 int main(int argc, char** argv) {
   if (argc < 6) {
@@ -44,7 +44,7 @@ int main(int argc, char** argv) {
   std::unique_ptr<ResDBConfig> config =
       GenerateResDBConfig(config_file, private_key_file, cert_file, self_info);
 
-  ResDBTxnAccessor client(*config);
+  AsyncResDBTxnAccessor client(*config);
   auto resp = client.GetTxn(min_seq, max_seq);
   absl::StatusOr<std::vector<std::pair<uint64_t, std::string>>> GetTxn(
       uint64_t min_seq, uint64_t max_seq);